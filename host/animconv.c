@@ -0,0 +1,1304 @@
+//*****************************************************************************
+//
+// animconv.c - Convert GIF and PNG sequences to firmware animations.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// This program reads image sequences and writes a C source file holding a
+// tAnim for each, in the format test_tlc5941/anim.h describes, and the
+// g_ppsAnims table of them all. Every image is scaled to 8x8 by averaging,
+// the colors of all of an animation's frames reduced by median cut to the
+// 15 that the palette holds besides black, and the frames coded against
+// the ones before. Repeated frames are merged into one longer hold.
+//
+// Each animation is then played through the firmware's AnimStart and
+// AnimFrame and checked against its frames, and reported: its size in
+// flash against 192-byte RGB frames (the stream format) and against 32-byte
+// palette frames, and the Cortex-M4 cycles its frames take to decode, from
+// the instruction counts of AnimDecode.
+//
+// Inputs:
+// - GIF: every frame, composited over the ones before as the GIF asks, for
+//   its delay. A delay under 20ms is taken as 100ms, as browsers do, and
+//   disposal to the background clears to black.
+// - PNG (when built with libpng): one frame per file.
+//
+// Usage: animconv [-o out.c] -n name [-d ms] anim.gif|frame.png ...
+//                 [-n name ...]
+//   -o  output file (default stdout)
+//   -n  start an animation, g_sAnim<name>; the inputs that follow are its
+//       frames
+//   -d  duration of each following PNG frame (default 100ms)
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef ANIMCONV_PNG
+#include <png.h>
+#endif
+#include "benchutil.h"
+#include "palette.h"
+#include "anim.h"
+
+#define CONV_MAX_ANIMS      16
+#define CONV_MAX_IMAGES     1024
+#define CONV_MAX_NAME       32
+
+//
+// A tAnim, less its data, is 76 bytes on the Cortex-M4
+//
+#define CONV_ANIM_BYTES     76
+
+typedef struct
+{
+    uint8_t pppui8RGB[8][8][3];
+    uint32_t ui32Ms;
+}
+tConvImage;
+
+typedef struct
+{
+    char pcName[CONV_MAX_NAME];
+    tConvImage *psImages;
+    uint32_t ui32NumImages;
+    uint32_t ui32Ms;
+
+    //
+    // Made from the images
+    //
+    uint32_t pui32Palette[PALETTE_ENTRIES];
+    uint32_t ui32Colors;
+    tPaletteFrame *psFrames;            // one per image
+    uint8_t *pui8Data;
+    uint32_t ui32Bytes;
+    uint32_t ui32Loop;
+    uint32_t ui32Frames;
+    uint32_t *pui32Offsets;             // of each coded frame, and the end
+}
+tConvAnim;
+
+static tConvAnim g_psConvAnims[CONV_MAX_ANIMS];
+static uint32_t g_ui32ConvAnims;
+
+//*****************************************************************************
+//
+// Add an image, averaging each 8x8th of it into a pixel.
+//
+//*****************************************************************************
+static void
+ConvAddImage(tConvAnim *psAnim, const uint8_t *pui8RGB, uint32_t ui32Width,
+             uint32_t ui32Height, uint32_t ui32Ms)
+{
+    tConvImage *psImage;
+    uint32_t ui32Row, ui32Col, ui32X, ui32Y, ui32Pixels, pui32Sum[3], idx;
+
+    if(psAnim->ui32NumImages == CONV_MAX_IMAGES)
+    {
+        fprintf(stderr, "animconv: %s has more than %d frames\n",
+                psAnim->pcName, CONV_MAX_IMAGES);
+        exit(1);
+    }
+    psImage = &psAnim->psImages[psAnim->ui32NumImages++];
+    psImage->ui32Ms = ui32Ms;
+    psAnim->ui32Ms += ui32Ms;
+
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        for(ui32Col = 0; ui32Col < 8; ui32Col++)
+        {
+            memset(pui32Sum, 0, sizeof(pui32Sum));
+            ui32Pixels = 0;
+            for(ui32Y = ui32Row * ui32Height / 8;
+                ui32Y < (ui32Row + 1) * ui32Height / 8; ui32Y++)
+            {
+                for(ui32X = ui32Col * ui32Width / 8;
+                    ui32X < (ui32Col + 1) * ui32Width / 8; ui32X++)
+                {
+                    for(idx = 0; idx < 3; idx++)
+                    {
+                        pui32Sum[idx] += pui8RGB[(ui32Y * ui32Width + ui32X) *
+                                                 3 + idx];
+                    }
+                    ui32Pixels++;
+                }
+            }
+            for(idx = 0; idx < 3; idx++)
+            {
+                psImage->pppui8RGB[ui32Row][ui32Col][idx] =
+                    (pui32Sum[idx] + ui32Pixels / 2) / ui32Pixels;
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// GIF reader
+//
+//*****************************************************************************
+typedef struct
+{
+    const uint8_t *pui8Data;
+    size_t szSize;
+    size_t szPos;
+}
+tConvGIF;
+
+static int
+ConvGIFByte(tConvGIF *psGIF)
+{
+    return((psGIF->szPos < psGIF->szSize) ?
+           psGIF->pui8Data[psGIF->szPos++] : -1);
+}
+
+static uint32_t
+ConvGIFWord(tConvGIF *psGIF)
+{
+    uint32_t ui32Low;
+
+    ui32Low = ConvGIFByte(psGIF) & 0xFF;
+    return(ui32Low | ((ConvGIFByte(psGIF) & 0xFF) << 8));
+}
+
+//
+// Gather a run of sub-blocks into one buffer, to be freed. Returns NULL if
+// the file ends first.
+//
+static uint8_t *
+ConvGIFBlocks(tConvGIF *psGIF, size_t *pszSize)
+{
+    uint8_t *pui8Data;
+    int iLen;
+
+    pui8Data = malloc(psGIF->szSize + 1);
+    *pszSize = 0;
+    while((iLen = ConvGIFByte(psGIF)) > 0)
+    {
+        if(psGIF->szPos + iLen > psGIF->szSize)
+        {
+            break;
+        }
+        memcpy(pui8Data + *pszSize, psGIF->pui8Data + psGIF->szPos, iLen);
+        *pszSize += iLen;
+        psGIF->szPos += iLen;
+    }
+    if(iLen != 0)
+    {
+        free(pui8Data);
+        return(NULL);
+    }
+    return(pui8Data);
+}
+
+//
+// Decode LZW-coded color indices. Pixels the data stops short of are left
+// at 0. Returns non-zero on a bad code.
+//
+static int
+ConvGIFDecode(const uint8_t *pui8Data, size_t szSize, uint32_t ui32MinSize,
+              uint8_t *pui8Out, uint32_t ui32Count)
+{
+    static uint16_t pui16Prefix[4096];
+    static uint8_t pui8Suffix[4096], pui8Stack[4097];
+    uint32_t ui32Clear, ui32Size, ui32Next, ui32Code, ui32In, ui32First;
+    uint32_t ui32Bits, ui32NumBits, ui32Out, ui32Depth;
+    int32_t i32Prev;
+    size_t szPos;
+
+    if((ui32MinSize < 2) || (ui32MinSize > 11))
+    {
+        return(1);
+    }
+    ui32Clear = 1 << ui32MinSize;
+    ui32Size = ui32MinSize + 1;
+    ui32Next = ui32Clear + 2;
+    i32Prev = -1;
+    ui32First = 0;
+    ui32Bits = 0;
+    ui32NumBits = 0;
+    ui32Out = 0;
+    szPos = 0;
+    memset(pui8Out, 0, ui32Count);
+
+    while(ui32Out < ui32Count)
+    {
+        while((ui32NumBits < ui32Size) && (szPos < szSize))
+        {
+            ui32Bits |= pui8Data[szPos++] << ui32NumBits;
+            ui32NumBits += 8;
+        }
+        if(ui32NumBits < ui32Size)
+        {
+            break;
+        }
+        ui32Code = ui32Bits & ((1 << ui32Size) - 1);
+        ui32Bits >>= ui32Size;
+        ui32NumBits -= ui32Size;
+
+        if(ui32Code == ui32Clear)
+        {
+            ui32Size = ui32MinSize + 1;
+            ui32Next = ui32Clear + 2;
+            i32Prev = -1;
+            continue;
+        }
+        if(ui32Code == ui32Clear + 1)
+        {
+            break;
+        }
+        if(i32Prev < 0)
+        {
+            if(ui32Code > ui32Clear)
+            {
+                return(1);
+            }
+            pui8Out[ui32Out++] = ui32Code;
+            ui32First = ui32Code;
+            i32Prev = ui32Code;
+            continue;
+        }
+
+        //
+        // A code not yet in the table can only be the one about to be
+        // added: the previous string and its own first index
+        //
+        ui32In = ui32Code;
+        ui32Depth = 0;
+        if(ui32Code == ui32Next)
+        {
+            pui8Stack[ui32Depth++] = ui32First;
+            ui32Code = i32Prev;
+        }
+        else if(ui32Code > ui32Next)
+        {
+            return(1);
+        }
+        while(ui32Code > ui32Clear)
+        {
+            pui8Stack[ui32Depth++] = pui8Suffix[ui32Code];
+            ui32Code = pui16Prefix[ui32Code];
+        }
+        ui32First = ui32Code;
+        pui8Stack[ui32Depth++] = ui32First;
+        while(ui32Depth && (ui32Out < ui32Count))
+        {
+            pui8Out[ui32Out++] = pui8Stack[--ui32Depth];
+        }
+
+        if(ui32Next < 4096)
+        {
+            pui16Prefix[ui32Next] = i32Prev;
+            pui8Suffix[ui32Next] = ui32First;
+            ui32Next++;
+            if((ui32Next == (1u << ui32Size)) && (ui32Size < 12))
+            {
+                ui32Size++;
+            }
+        }
+        i32Prev = ui32In;
+    }
+    return(0);
+}
+
+static int
+ConvReadGIF(tConvAnim *psAnim, const char *pcFile)
+{
+    static const uint8_t pui8Pass[4][2] = { { 0, 8 }, { 4, 8 }, { 2, 4 },
+                                            { 1, 2 } };
+    tConvGIF sGIF;
+    FILE *pFile;
+    uint8_t *pui8File, *pui8Canvas, *pui8Saved, *pui8Indices, *pui8Codes;
+    uint8_t pui8Global[768], pui8Local[768], *pui8Table;
+    uint32_t ui32Width, ui32Height, ui32Flags, ui32Global, ui32Local;
+    uint32_t ui32Left, ui32Top, ui32W, ui32H, ui32X, ui32Y, ui32Row;
+    uint32_t ui32Delay, ui32Disposal, ui32Frames, ui32Pass, idx;
+    int32_t i32Trans;
+    size_t szCodes;
+    long lSize;
+    int iType, iLabel, iRet;
+
+    pFile = fopen(pcFile, "rb");
+    if(!pFile)
+    {
+        perror(pcFile);
+        return(1);
+    }
+    fseek(pFile, 0, SEEK_END);
+    lSize = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    pui8File = malloc(lSize > 0 ? lSize : 1);
+    if(fread(pui8File, 1, lSize, pFile) != (size_t)lSize)
+    {
+        lSize = 0;
+    }
+    fclose(pFile);
+
+    sGIF.pui8Data = pui8File;
+    sGIF.szSize = lSize;
+    sGIF.szPos = 6;
+    if((lSize < 13) || (memcmp(pui8File, "GIF87a", 6) &&
+                        memcmp(pui8File, "GIF89a", 6)))
+    {
+        fprintf(stderr, "%s: not a GIF\n", pcFile);
+        free(pui8File);
+        return(1);
+    }
+    ui32Width = ConvGIFWord(&sGIF);
+    ui32Height = ConvGIFWord(&sGIF);
+    ui32Flags = ConvGIFByte(&sGIF);
+    ConvGIFWord(&sGIF);
+    ui32Global = 0;
+    if(ui32Flags & 0x80)
+    {
+        ui32Global = 2 << (ui32Flags & 7);
+        for(idx = 0; idx < ui32Global * 3; idx++)
+        {
+            pui8Global[idx] = ConvGIFByte(&sGIF);
+        }
+    }
+    if((ui32Width < 8) || (ui32Height < 8))
+    {
+        fprintf(stderr, "%s: %ux%u is smaller than the display\n", pcFile,
+                ui32Width, ui32Height);
+        free(pui8File);
+        return(1);
+    }
+
+    pui8Canvas = calloc(ui32Width * ui32Height, 3);
+    pui8Saved = malloc(ui32Width * ui32Height * 3);
+    pui8Indices = malloc(ui32Width * ui32Height);
+    ui32Delay = 0;
+    ui32Disposal = 0;
+    i32Trans = -1;
+    ui32Frames = 0;
+    iRet = 1;
+
+    while((iType = ConvGIFByte(&sGIF)) != -1)
+    {
+        if(iType == 0x3B)
+        {
+            iRet = 0;
+            break;
+        }
+        if(iType == 0x21)
+        {
+            //
+            // Extensions: only the graphic control extension matters
+            //
+            iLabel = ConvGIFByte(&sGIF);
+            pui8Codes = ConvGIFBlocks(&sGIF, &szCodes);
+            if(!pui8Codes)
+            {
+                break;
+            }
+            if((iLabel == 0xF9) && (szCodes >= 4))
+            {
+                ui32Disposal = (pui8Codes[0] >> 2) & 7;
+                ui32Delay = pui8Codes[1] | (pui8Codes[2] << 8);
+                i32Trans = (pui8Codes[0] & 1) ? pui8Codes[3] : -1;
+            }
+            free(pui8Codes);
+            continue;
+        }
+        if(iType != 0x2C)
+        {
+            break;
+        }
+
+        ui32Left = ConvGIFWord(&sGIF);
+        ui32Top = ConvGIFWord(&sGIF);
+        ui32W = ConvGIFWord(&sGIF);
+        ui32H = ConvGIFWord(&sGIF);
+        ui32Flags = ConvGIFByte(&sGIF);
+        pui8Table = pui8Global;
+        ui32Local = ui32Global;
+        if(ui32Flags & 0x80)
+        {
+            ui32Local = 2 << (ui32Flags & 7);
+            for(idx = 0; idx < ui32Local * 3; idx++)
+            {
+                pui8Local[idx] = ConvGIFByte(&sGIF);
+            }
+            pui8Table = pui8Local;
+        }
+        idx = ConvGIFByte(&sGIF);
+        pui8Codes = ConvGIFBlocks(&sGIF, &szCodes);
+        if(!pui8Codes || (ui32W * ui32H > ui32Width * ui32Height) ||
+           ConvGIFDecode(pui8Codes, szCodes, idx, pui8Indices, ui32W * ui32H))
+        {
+            free(pui8Codes);
+            break;
+        }
+        free(pui8Codes);
+
+        if(ui32Disposal == 3)
+        {
+            memcpy(pui8Saved, pui8Canvas, ui32Width * ui32Height * 3);
+        }
+
+        //
+        // Interlaced images send every 8th row from 0, every 8th from 4,
+        // every 4th from 2 then every 2nd from 1
+        //
+        ui32Pass = 0;
+        ui32Row = 0;
+        for(ui32Y = 0; ui32Y < ui32H; ui32Y++)
+        {
+            if(ui32Flags & 0x40)
+            {
+                while(ui32Row >= ui32H)
+                {
+                    ui32Pass++;
+                    ui32Row = pui8Pass[ui32Pass][0];
+                }
+            }
+            else
+            {
+                ui32Row = ui32Y;
+            }
+            for(ui32X = 0; ui32X < ui32W; ui32X++)
+            {
+                idx = pui8Indices[ui32Y * ui32W + ui32X];
+                if(((int32_t)idx == i32Trans) || (idx >= ui32Local) ||
+                   (ui32Top + ui32Row >= ui32Height) ||
+                   (ui32Left + ui32X >= ui32Width))
+                {
+                    continue;
+                }
+                memcpy(&pui8Canvas[((ui32Top + ui32Row) * ui32Width +
+                                    ui32Left + ui32X) * 3],
+                       &pui8Table[idx * 3], 3);
+            }
+            if(ui32Flags & 0x40)
+            {
+                ui32Row += pui8Pass[ui32Pass][1];
+            }
+        }
+
+        ConvAddImage(psAnim, pui8Canvas, ui32Width, ui32Height,
+                     (ui32Delay < 2) ? 100 : ui32Delay * 10);
+        ui32Frames++;
+
+        if(ui32Disposal == 2)
+        {
+            for(ui32Y = ui32Top; (ui32Y < ui32Top + ui32H) &&
+                                 (ui32Y < ui32Height); ui32Y++)
+            {
+                for(ui32X = ui32Left; (ui32X < ui32Left + ui32W) &&
+                                      (ui32X < ui32Width); ui32X++)
+                {
+                    memset(&pui8Canvas[(ui32Y * ui32Width + ui32X) * 3], 0,
+                           3);
+                }
+            }
+        }
+        else if(ui32Disposal == 3)
+        {
+            memcpy(pui8Canvas, pui8Saved, ui32Width * ui32Height * 3);
+        }
+        ui32Delay = 0;
+        ui32Disposal = 0;
+        i32Trans = -1;
+    }
+
+    free(pui8Canvas);
+    free(pui8Saved);
+    free(pui8Indices);
+    free(pui8File);
+    if(iRet || !ui32Frames)
+    {
+        fprintf(stderr, "%s: bad or truncated GIF after %u frames\n", pcFile,
+                ui32Frames);
+        return(1);
+    }
+    fprintf(stderr, "%s: %u frames of %ux%u\n", pcFile, ui32Frames,
+            ui32Width, ui32Height);
+    return(0);
+}
+
+//*****************************************************************************
+//
+// PNG reader
+//
+//*****************************************************************************
+static int
+ConvReadPNG(tConvAnim *psAnim, const char *pcFile, uint32_t ui32Ms)
+{
+#ifdef ANIMCONV_PNG
+    png_image sImage;
+    uint8_t *pui8Pixels;
+
+    memset(&sImage, 0, sizeof(sImage));
+    sImage.version = PNG_IMAGE_VERSION;
+    if(!png_image_begin_read_from_file(&sImage, pcFile))
+    {
+        fprintf(stderr, "%s: %s\n", pcFile, sImage.message);
+        return(1);
+    }
+    sImage.format = PNG_FORMAT_RGB;
+    pui8Pixels = malloc(PNG_IMAGE_SIZE(sImage));
+    if(!pui8Pixels ||
+       !png_image_finish_read(&sImage, 0, pui8Pixels, 0, 0))
+    {
+        fprintf(stderr, "%s: %s\n", pcFile, sImage.message);
+        free(pui8Pixels);
+        return(1);
+    }
+    if((sImage.width < 8) || (sImage.height < 8))
+    {
+        fprintf(stderr, "%s: %ux%u is smaller than the display\n", pcFile,
+                sImage.width, sImage.height);
+        free(pui8Pixels);
+        return(1);
+    }
+    ConvAddImage(psAnim, pui8Pixels, sImage.width, sImage.height, ui32Ms);
+    free(pui8Pixels);
+    return(0);
+#else
+    fprintf(stderr, "%s: animconv was built without libpng\n", pcFile);
+    return(1);
+#endif
+}
+
+//*****************************************************************************
+//
+// Palette. Black is entry 0, the color of a cleared frame; the other
+// colors are split by median cut into at most PALETTE_ENTRIES - 1 boxes,
+// each weighted by its pixels, and every pixel takes the nearest entry.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Color;                 // 0xBBGGRR
+    uint32_t ui32Count;
+}
+tConvColor;
+
+static uint32_t g_ui32SortShift;
+
+static int
+ConvColorCompare(const void *pvA, const void *pvB)
+{
+    uint32_t ui32A, ui32B;
+
+    ui32A = ((const tConvColor *)pvA)->ui32Color;
+    ui32B = ((const tConvColor *)pvB)->ui32Color;
+    ui32A = (((ui32A >> g_ui32SortShift) & 0xFF) << 24) | ui32A;
+    ui32B = (((ui32B >> g_ui32SortShift) & 0xFF) << 24) | ui32B;
+    return((ui32A > ui32B) - (ui32A < ui32B));
+}
+
+static uint32_t
+ConvColorOf(const uint8_t *pui8RGB)
+{
+    return(pui8RGB[0] | (pui8RGB[1] << 8) | (pui8RGB[2] << 16));
+}
+
+static uint32_t
+ConvNearest(const tConvAnim *psAnim, uint32_t ui32Color)
+{
+    uint32_t idx, ui32Best, ui32Channel;
+    int32_t i32Diff;
+    uint64_t ui64Dist, ui64Best;
+
+    ui32Best = 0;
+    ui64Best = ~0ULL;
+    for(idx = 0; idx < psAnim->ui32Colors; idx++)
+    {
+        ui64Dist = 0;
+        for(ui32Channel = 0; ui32Channel < 24; ui32Channel += 8)
+        {
+            i32Diff = (int32_t)((ui32Color >> ui32Channel) & 0xFF) -
+                      (int32_t)((psAnim->pui32Palette[idx] >> ui32Channel) &
+                                0xFF);
+            ui64Dist += i32Diff * i32Diff;
+        }
+        if(ui64Dist < ui64Best)
+        {
+            ui64Best = ui64Dist;
+            ui32Best = idx;
+        }
+    }
+    return(ui32Best);
+}
+
+static void
+ConvPalette(tConvAnim *psAnim)
+{
+    tConvColor *psColors;
+    uint32_t pui32Start[PALETTE_ENTRIES], pui32End[PALETTE_ENTRIES];
+    uint32_t ui32NumColors, ui32Boxes, ui32Box, ui32Split, ui32Channel;
+    uint32_t ui32Range, ui32BestRange, ui32Min, ui32Max, ui32Value;
+    uint32_t ui32Half, ui32Count, ui32Image, ui32Row, ui32Col, idx, ch;
+    uint64_t pui64Sum[3], ui64Weight;
+
+    //
+    // Count each color other than black
+    //
+    psColors = malloc(psAnim->ui32NumImages * 64 * sizeof(tConvColor));
+    ui32NumColors = 0;
+    for(ui32Image = 0; ui32Image < psAnim->ui32NumImages; ui32Image++)
+    {
+        for(ui32Row = 0; ui32Row < 8; ui32Row++)
+        {
+            for(ui32Col = 0; ui32Col < 8; ui32Col++)
+            {
+                ui32Value = ConvColorOf(
+                    psAnim->psImages[ui32Image].pppui8RGB[ui32Row][ui32Col]);
+                if(ui32Value)
+                {
+                    psColors[ui32NumColors].ui32Color = ui32Value;
+                    psColors[ui32NumColors++].ui32Count = 1;
+                }
+            }
+        }
+    }
+    g_ui32SortShift = 0;
+    qsort(psColors, ui32NumColors, sizeof(tConvColor), ConvColorCompare);
+    for(idx = 0, ui32Count = 0; idx < ui32NumColors; idx++)
+    {
+        if(ui32Count &&
+           (psColors[ui32Count - 1].ui32Color == psColors[idx].ui32Color))
+        {
+            psColors[ui32Count - 1].ui32Count++;
+        }
+        else
+        {
+            psColors[ui32Count++] = psColors[idx];
+        }
+    }
+    ui32NumColors = ui32Count;
+
+    //
+    // Split the box with the widest channel at its weighted median until
+    // there are enough boxes or none can be split
+    //
+    ui32Boxes = 0;
+    if(ui32NumColors)
+    {
+        pui32Start[0] = 0;
+        pui32End[0] = ui32NumColors;
+        ui32Boxes = 1;
+    }
+    while(ui32Boxes < PALETTE_ENTRIES - 1)
+    {
+        ui32BestRange = 0;
+        ui32Split = 0;
+        ui32Channel = 0;
+        for(ui32Box = 0; ui32Box < ui32Boxes; ui32Box++)
+        {
+            for(ch = 0; ch < 24; ch += 8)
+            {
+                ui32Min = 0xFF;
+                ui32Max = 0;
+                for(idx = pui32Start[ui32Box]; idx < pui32End[ui32Box]; idx++)
+                {
+                    ui32Value = (psColors[idx].ui32Color >> ch) & 0xFF;
+                    ui32Min = (ui32Value < ui32Min) ? ui32Value : ui32Min;
+                    ui32Max = (ui32Value > ui32Max) ? ui32Value : ui32Max;
+                }
+                ui32Range = (ui32Max >= ui32Min) ? ui32Max - ui32Min + 1 : 0;
+                if(ui32Range > ui32BestRange)
+                {
+                    ui32BestRange = ui32Range;
+                    ui32Split = ui32Box;
+                    ui32Channel = ch;
+                }
+            }
+        }
+        if(ui32BestRange < 2)
+        {
+            break;
+        }
+
+        g_ui32SortShift = ui32Channel;
+        qsort(&psColors[pui32Start[ui32Split]],
+              pui32End[ui32Split] - pui32Start[ui32Split], sizeof(tConvColor),
+              ConvColorCompare);
+        for(idx = pui32Start[ui32Split], ui64Weight = 0;
+            idx < pui32End[ui32Split]; idx++)
+        {
+            ui64Weight += psColors[idx].ui32Count;
+        }
+        ui32Half = 0;
+        for(idx = pui32Start[ui32Split]; idx < pui32End[ui32Split] - 1; idx++)
+        {
+            ui32Half += psColors[idx].ui32Count;
+            if(2 * ui32Half >= ui64Weight)
+            {
+                break;
+            }
+        }
+        pui32Start[ui32Boxes] = idx + 1;
+        pui32End[ui32Boxes] = pui32End[ui32Split];
+        pui32End[ui32Split] = idx + 1;
+        ui32Boxes++;
+    }
+
+    psAnim->pui32Palette[0] = 0;
+    for(ui32Box = 0; ui32Box < ui32Boxes; ui32Box++)
+    {
+        memset(pui64Sum, 0, sizeof(pui64Sum));
+        ui64Weight = 0;
+        for(idx = pui32Start[ui32Box]; idx < pui32End[ui32Box]; idx++)
+        {
+            for(ch = 0; ch < 3; ch++)
+            {
+                pui64Sum[ch] += ((psColors[idx].ui32Color >> (8 * ch)) &
+                                 0xFF) * (uint64_t)psColors[idx].ui32Count;
+            }
+            ui64Weight += psColors[idx].ui32Count;
+        }
+        psAnim->pui32Palette[ui32Box + 1] = 0;
+        for(ch = 0; ch < 3; ch++)
+        {
+            psAnim->pui32Palette[ui32Box + 1] |=
+                ((pui64Sum[ch] + ui64Weight / 2) / ui64Weight) << (8 * ch);
+        }
+    }
+    psAnim->ui32Colors = ui32Boxes + 1;
+    for(idx = psAnim->ui32Colors; idx < PALETTE_ENTRIES; idx++)
+    {
+        psAnim->pui32Palette[idx] = 0;
+    }
+    free(psColors);
+
+    psAnim->psFrames = calloc(psAnim->ui32NumImages, sizeof(tPaletteFrame));
+    for(ui32Image = 0; ui32Image < psAnim->ui32NumImages; ui32Image++)
+    {
+        for(ui32Row = 0; ui32Row < 8; ui32Row++)
+        {
+            for(ui32Col = 0; ui32Col < 8; ui32Col++)
+            {
+                ui32Value = ConvColorOf(
+                    psAnim->psImages[ui32Image].pppui8RGB[ui32Row][ui32Col]);
+                PaletteFrameSet(&psAnim->psFrames[ui32Image], ui32Row,
+                                ui32Col, ui32Value ?
+                                ConvNearest(psAnim, ui32Value) : 0);
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Frame coding
+//
+//*****************************************************************************
+static uint32_t
+ConvHold(uint32_t ui32Ms)
+{
+    uint32_t ui32Hold;
+
+    ui32Hold = (ui32Ms * 1000 + ANIM_FRAME_US / 2) / ANIM_FRAME_US;
+    return(ui32Hold ? ui32Hold : 1);
+}
+
+//
+// Code a frame against the one before and a hold of at most ANIM_MAX_HOLD
+//
+static void
+ConvEncodeFrame(tConvAnim *psAnim, const tPaletteFrame *psFrom,
+                const tPaletteFrame *psTo, uint32_t ui32Hold)
+{
+    uint8_t *pui8Out;
+    uint32_t ui32Row, ui32Col, ui32Diff, ui32Nibble, ui32Entry, ui32Pixels;
+
+    psAnim->pui32Offsets[psAnim->ui32Frames++] = psAnim->ui32Bytes;
+    pui8Out = psAnim->pui8Data + psAnim->ui32Bytes;
+    *pui8Out++ = ui32Hold;
+    *pui8Out = 0;
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        if(psFrom->pui32Row[ui32Row] != psTo->pui32Row[ui32Row])
+        {
+            *pui8Out |= 1 << ui32Row;
+        }
+    }
+    pui8Out++;
+
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        ui32Diff = psFrom->pui32Row[ui32Row] ^ psTo->pui32Row[ui32Row];
+        if(!ui32Diff)
+        {
+            continue;
+        }
+
+        //
+        // Seven changed pixels take as many bytes as the whole row, which
+        // decodes faster
+        //
+        *pui8Out = 0;
+        for(ui32Col = 0, ui32Pixels = 0; ui32Col < 8; ui32Col++)
+        {
+            if((ui32Diff >> (4 * ui32Col)) & 0xF)
+            {
+                *pui8Out |= 1 << ui32Col;
+                ui32Pixels++;
+            }
+        }
+        if(ui32Pixels >= 7)
+        {
+            *pui8Out = 0xFF;
+            ui32Diff = 0xFFFFFFFF;
+        }
+        pui8Out++;
+        for(ui32Col = 0, ui32Nibble = 0; ui32Col < 8; ui32Col++)
+        {
+            if(!((ui32Diff >> (4 * ui32Col)) & 0xF))
+            {
+                continue;
+            }
+            ui32Entry = PALETTE_PIXEL(psTo, ui32Row, ui32Col);
+            if(ui32Nibble & 1)
+            {
+                pui8Out[ui32Nibble >> 1] |= ui32Entry << 4;
+            }
+            else
+            {
+                pui8Out[ui32Nibble >> 1] = ui32Entry;
+            }
+            ui32Nibble++;
+        }
+        pui8Out += (ui32Nibble + 1) >> 1;
+    }
+    psAnim->ui32Bytes = pui8Out - psAnim->pui8Data;
+}
+
+//
+// Code a frame, splitting a long hold over empty frames
+//
+static void
+ConvEncodeHeld(tConvAnim *psAnim, const tPaletteFrame *psFrom,
+               const tPaletteFrame *psTo, uint32_t ui32Hold)
+{
+    uint32_t ui32Part;
+
+    ui32Part = (ui32Hold > ANIM_MAX_HOLD) ? ANIM_MAX_HOLD : ui32Hold;
+    ConvEncodeFrame(psAnim, psFrom, psTo, ui32Part);
+    for(ui32Hold -= ui32Part; ui32Hold; ui32Hold -= ui32Part)
+    {
+        ui32Part = (ui32Hold > ANIM_MAX_HOLD) ? ANIM_MAX_HOLD : ui32Hold;
+        ConvEncodeFrame(psAnim, psTo, psTo, ui32Part);
+    }
+}
+
+static void
+ConvEncode(tConvAnim *psAnim)
+{
+    static const tPaletteFrame sBlack;
+    const tPaletteFrame *psPrev;
+    uint32_t ui32Image, ui32Next, ui32Hold, ui32Max;
+
+    //
+    // Enough for every frame and hold split at its longest, and the loop
+    //
+    ui32Max = 2;
+    for(ui32Image = 0; ui32Image < psAnim->ui32NumImages; ui32Image++)
+    {
+        ui32Max += 1 + ConvHold(psAnim->psImages[ui32Image].ui32Ms) /
+                       ANIM_MAX_HOLD;
+    }
+    psAnim->pui8Data = malloc(ui32Max * ANIM_MAX_FRAME_BYTES);
+    psAnim->pui32Offsets = malloc((ui32Max + 1) * sizeof(uint32_t));
+
+    psPrev = &sBlack;
+    for(ui32Image = 0; ui32Image < psAnim->ui32NumImages; ui32Image = ui32Next)
+    {
+        //
+        // Repeats of a frame only add to its hold
+        //
+        ui32Hold = 0;
+        for(ui32Next = ui32Image; (ui32Next < psAnim->ui32NumImages) &&
+            !memcmp(&psAnim->psFrames[ui32Next], &psAnim->psFrames[ui32Image],
+                    sizeof(tPaletteFrame)); ui32Next++)
+        {
+            ui32Hold += ConvHold(psAnim->psImages[ui32Next].ui32Ms);
+        }
+        ConvEncodeHeld(psAnim, psPrev, &psAnim->psFrames[ui32Image], ui32Hold);
+        psPrev = &psAnim->psFrames[ui32Image];
+    }
+
+    //
+    // Back to the first frame, with the first part of its hold; the loop
+    // goes on from the second coded frame, which may be the rest of it
+    //
+    psAnim->ui32Loop = (psAnim->ui32Frames > 1) ? psAnim->pui32Offsets[1] :
+                                                  psAnim->ui32Bytes;
+    ui32Hold = psAnim->pui8Data[0];
+    ConvEncodeFrame(psAnim, psPrev, &psAnim->psFrames[0], ui32Hold);
+    psAnim->ui32Frames--;
+    psAnim->pui32Offsets[psAnim->ui32Frames + 1] = psAnim->ui32Bytes;
+    if(psAnim->ui32Bytes > 0xFFFF)
+    {
+        fprintf(stderr, "animconv: %s is %u bytes, more than 65535\n",
+                psAnim->pcName, psAnim->ui32Bytes);
+        exit(1);
+    }
+}
+
+//*****************************************************************************
+//
+// Play the animation through the firmware player for two loops and check
+// every display frame against the images.
+//
+//*****************************************************************************
+static void
+ConvVerify(const tConvAnim *psAnim, const tAnim *psCoded)
+{
+    tAnimPlayer sPlayer;
+    tPaletteFrame sFrame;
+    tPalette sPalette;
+    uint32_t ui32Image, ui32Shown, ui32Hold, ui32Loop;
+
+    AnimStart(&sPlayer, psCoded, &sFrame, &sPalette);
+    for(ui32Loop = 0; ui32Loop < 2; ui32Loop++)
+    {
+        for(ui32Image = 0; ui32Image < psAnim->ui32NumImages; ui32Image++)
+        {
+            ui32Hold = ConvHold(psAnim->psImages[ui32Image].ui32Ms);
+            for(ui32Shown = 0; ui32Shown < ui32Hold; ui32Shown++)
+            {
+                if(ui32Loop || ui32Image || ui32Shown)
+                {
+                    AnimFrame(&sPlayer, &sFrame);
+                }
+                if(memcmp(&sFrame, &psAnim->psFrames[ui32Image],
+                          sizeof(sFrame)))
+                {
+                    fprintf(stderr, "animconv: %s frame %u decodes wrong\n",
+                            psAnim->pcName, ui32Image);
+                    exit(1);
+                }
+            }
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Decode timing
+//
+//*****************************************************************************
+static const uint8_t *g_pui8BenchFrame;
+static tPaletteFrame g_sBenchFrame;
+
+static void
+ConvBenchDecode(uint32_t ui32Iter)
+{
+    AnimDecode(g_pui8BenchFrame, &g_sBenchFrame);
+}
+
+//
+// Mean and most M4 cycles to decode the coded frames, or negative without
+// ptrace
+//
+static double
+ConvDecodeCycles(const uint8_t *pui8Data, const uint32_t *pui32Offsets,
+                 uint32_t ui32Frames, double *pdMax)
+{
+    uint32_t idx;
+    double dCycles, dSum;
+
+    dSum = 0;
+    *pdMax = 0;
+    for(idx = 0; idx < ui32Frames; idx++)
+    {
+        g_pui8BenchFrame = pui8Data + pui32Offsets[idx];
+        dCycles = BenchM4Cycles(ConvBenchDecode, NULL);
+        if(dCycles < 0)
+        {
+            return(dCycles);
+        }
+        dSum += dCycles;
+        *pdMax = (dCycles > *pdMax) ? dCycles : *pdMax;
+    }
+    return(dSum / ui32Frames);
+}
+
+//
+// The slowest frame there can be: seven pixels changed in every row, each
+// gathered one at a time
+//
+static double
+ConvWorstCycles(void)
+{
+    uint8_t pui8Worst[ANIM_MAX_FRAME_BYTES];
+    uint32_t ui32Row, ui32Offset;
+    double dMax;
+
+    pui8Worst[0] = 1;
+    pui8Worst[1] = 0xFF;
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        pui8Worst[2 + 5 * ui32Row] = 0x7F;
+        memset(&pui8Worst[3 + 5 * ui32Row], 0xA5, 4);
+    }
+    ui32Offset = 0;
+    return(ConvDecodeCycles(pui8Worst, &ui32Offset, 1, &dMax));
+}
+
+//*****************************************************************************
+//
+// C source output
+//
+//*****************************************************************************
+static void
+ConvWriteAnim(FILE *pFile, const tConvAnim *psAnim)
+{
+    uint32_t ui32Frame, idx;
+
+    fprintf(pFile, "\n//\n// %s: %u frames in %u ms, %u colors\n//\n",
+            psAnim->pcName, psAnim->ui32NumImages, psAnim->ui32Ms,
+            psAnim->ui32Colors);
+    fprintf(pFile, "static const uint8_t g_pui8Anim%sData[] = {\n",
+            psAnim->pcName);
+    for(ui32Frame = 0; ui32Frame <= psAnim->ui32Frames; ui32Frame++)
+    {
+        for(idx = psAnim->pui32Offsets[ui32Frame];
+            idx < psAnim->pui32Offsets[ui32Frame + 1]; idx++)
+        {
+            fprintf(pFile, "%s0x%02X,",
+                    ((idx - psAnim->pui32Offsets[ui32Frame]) % 10) ? " " :
+                    (idx == psAnim->pui32Offsets[ui32Frame]) ? "  " : "\n  ",
+                    psAnim->pui8Data[idx]);
+        }
+        if(ui32Frame == psAnim->ui32Frames)
+        {
+            fprintf(pFile, "   // back to frame 0\n");
+        }
+        else
+        {
+            fprintf(pFile, "   // frame %u\n", ui32Frame);
+        }
+    }
+    fprintf(pFile, "};\n");
+
+    fprintf(pFile, "\nconst tAnim g_sAnim%s = {\n"
+            "  g_pui8Anim%sData, %u, %u, %u, %u,\n  {", psAnim->pcName,
+            psAnim->pcName, psAnim->ui32Bytes, psAnim->ui32Loop,
+            psAnim->ui32Frames, psAnim->ui32Colors);
+    for(idx = 0; idx < PALETTE_ENTRIES; idx++)
+    {
+        fprintf(pFile, "%s0x%06X%s", (idx % 4) ? " " : "\n    ",
+                psAnim->pui32Palette[idx],
+                (idx < PALETTE_ENTRIES - 1) ? "," : "");
+    }
+    fprintf(pFile, "\n  }\n};\n");
+}
+
+static void
+ConvWrite(FILE *pFile, const char *pcCommand)
+{
+    uint32_t idx;
+
+    fprintf(pFile,
+"//*****************************************************************************\n"
+"//\n"
+"// anim_samples.c - Sample animations.\n"
+"//\n"
+"// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.\n"
+"//\n"
+"// This is part of revision 1.0 of the Idiotbox Firmware Package.\n"
+"//\n"
+"//*****************************************************************************\n"
+"\n"
+"//*****************************************************************************\n"
+"//\n"
+"// Generated by host/animconv, do not edit:\n"
+"//   %s\n"
+"//\n"
+"//*****************************************************************************\n"
+"\n"
+"#include <stdint.h>\n"
+"#include \"anim.h\"\n", pcCommand);
+
+    for(idx = 0; idx < g_ui32ConvAnims; idx++)
+    {
+        ConvWriteAnim(pFile, &g_psConvAnims[idx]);
+    }
+
+    fprintf(pFile, "\nconst tAnim *const g_ppsAnims[] = {\n");
+    for(idx = 0; idx < g_ui32ConvAnims; idx++)
+    {
+        fprintf(pFile, "  &g_sAnim%s,\n", g_psConvAnims[idx].pcName);
+    }
+    fprintf(pFile, "};\n\nconst uint32_t g_ui32NumAnims = %u;\n",
+            g_ui32ConvAnims);
+}
+
+//*****************************************************************************
+//
+// Report an animation's size and decode time.
+//
+//*****************************************************************************
+static void
+ConvReport(const tConvAnim *psAnim)
+{
+    uint32_t ui32Flash;
+    double dMean, dMax;
+
+    ui32Flash = psAnim->ui32Bytes + CONV_ANIM_BYTES;
+    fprintf(stderr, "%s: %u frames coded as %u, %u colors, %u bytes of "
+            "flash; %.1f:1 against RGB frames, %.1f:1 against palette "
+            "frames\n", psAnim->pcName, psAnim->ui32NumImages,
+            psAnim->ui32Frames, psAnim->ui32Colors, ui32Flash,
+            (double)psAnim->ui32NumImages * 192 / ui32Flash,
+            (double)(psAnim->ui32NumImages * 32 + PALETTE_ENTRIES * 3) /
+            ui32Flash);
+    dMean = ConvDecodeCycles(psAnim->pui8Data, psAnim->pui32Offsets,
+                             psAnim->ui32Frames + 1, &dMax);
+    if(dMean >= 0)
+    {
+        fprintf(stderr, "%s: decode %.0f M4 cycles a frame on average, %.0f "
+                "at most\n", psAnim->pcName, dMean, dMax);
+    }
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+    tConvAnim *psAnim = 0;
+    tAnim sCoded;
+    uint32_t ui32Ms = 100, ui32Raw, ui32Flash, idx;
+    char pcCommand[1024];
+    const char *pcOut = 0, *pcExt;
+    double dWorst;
+    FILE *pFile;
+    int iOpt, iLen;
+
+    //
+    // Record the command line, without directories, in the output
+    //
+    iLen = snprintf(pcCommand, sizeof(pcCommand), "animconv");
+    for(iOpt = 1; (iOpt < argc) && (iLen < (int)sizeof(pcCommand)); iOpt++)
+    {
+        pcExt = strrchr(argv[iOpt], '/');
+        iLen += snprintf(pcCommand + iLen, sizeof(pcCommand) - iLen, " %s",
+                         pcExt ? pcExt + 1 : argv[iOpt]);
+    }
+
+    //
+    // Options and inputs may be mixed, so options are not moved ahead of
+    // the inputs; -n and -d apply to later inputs.
+    //
+    while(optind < argc)
+    {
+        iOpt = getopt(argc, argv, "+o:n:d:");
+        if(iOpt == -1)
+        {
+            if(!psAnim)
+            {
+                fprintf(stderr, "animconv: %s before any -n\n", argv[optind]);
+                return(2);
+            }
+            pcExt = strrchr(argv[optind], '.');
+            if(pcExt && (strcmp(pcExt, ".png") == 0))
+            {
+                if(ConvReadPNG(psAnim, argv[optind], ui32Ms))
+                {
+                    return(1);
+                }
+            }
+            else if(ConvReadGIF(psAnim, argv[optind]))
+            {
+                return(1);
+            }
+            optind++;
+            continue;
+        }
+        switch(iOpt)
+        {
+            case 'o': pcOut = optarg; break;
+            case 'd': ui32Ms = strtoul(optarg, 0, 0); break;
+            case 'n':
+                if(g_ui32ConvAnims == CONV_MAX_ANIMS)
+                {
+                    fprintf(stderr, "animconv: more than %d animations\n",
+                            CONV_MAX_ANIMS);
+                    return(1);
+                }
+                psAnim = &g_psConvAnims[g_ui32ConvAnims++];
+                snprintf(psAnim->pcName, sizeof(psAnim->pcName), "%s",
+                         optarg);
+                psAnim->psImages = malloc(CONV_MAX_IMAGES *
+                                          sizeof(tConvImage));
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-o out.c] -n name [-d ms] "
+                        "anim.gif|frame.png ... [-n name ...]\n", argv[0]);
+                return(2);
+        }
+    }
+    if(g_ui32ConvAnims == 0)
+    {
+        fprintf(stderr, "animconv: no animations\n");
+        return(1);
+    }
+
+    ui32Raw = 0;
+    ui32Flash = 0;
+    for(idx = 0; idx < g_ui32ConvAnims; idx++)
+    {
+        psAnim = &g_psConvAnims[idx];
+        if(!psAnim->ui32NumImages)
+        {
+            fprintf(stderr, "animconv: %s has no frames\n", psAnim->pcName);
+            return(1);
+        }
+        ConvPalette(psAnim);
+        ConvEncode(psAnim);
+
+        sCoded.pui8Data = psAnim->pui8Data;
+        sCoded.ui16Bytes = psAnim->ui32Bytes;
+        sCoded.ui16Loop = psAnim->ui32Loop;
+        sCoded.ui16Frames = psAnim->ui32Frames;
+        sCoded.ui16Colors = psAnim->ui32Colors;
+        memcpy(sCoded.pui32Palette, psAnim->pui32Palette,
+               sizeof(sCoded.pui32Palette));
+        ConvVerify(psAnim, &sCoded);
+        ConvReport(psAnim);
+        ui32Raw += psAnim->ui32NumImages * 192;
+        ui32Flash += psAnim->ui32Bytes + CONV_ANIM_BYTES;
+    }
+
+    pFile = pcOut ? fopen(pcOut, "w") : stdout;
+    if(!pFile)
+    {
+        perror(pcOut);
+        return(1);
+    }
+    ConvWrite(pFile, pcCommand);
+    if(pcOut)
+    {
+        fclose(pFile);
+    }
+
+    fprintf(stderr, "%u animations: %u bytes of flash, %.1f:1 against RGB "
+            "frames", g_ui32ConvAnims, ui32Flash, (double)ui32Raw / ui32Flash);
+    dWorst = ConvWorstCycles();
+    if(dWorst >= 0)
+    {
+        fprintf(stderr, "; any frame decodes in %.0f M4 cycles at most",
+                dWorst);
+    }
+    fprintf(stderr, "\n");
+    return(0);
+}
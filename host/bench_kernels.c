@@ -0,0 +1,1227 @@
+//*****************************************************************************
+//
+// bench_kernels.c - Host microbenchmark for the firmware kernels.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// This program links the firmware sources against the stand-in peripherals in
+// hoststubs.c and times every kernel the main loop and the PWM interrupt call.
+// For each kernel it reports:
+// - ns per call on the host (best of BENCH_REPS runs)
+// - throughput in kernel items (pixels, samples, scans) per second
+// - host instructions per call, counted exactly by single-stepping a child
+//   process with ptrace (see benchutil.c)
+// - estimated Cortex-M4 cycles per call: host instructions times
+//   BENCH_M4_CPI_X4 / 4, plus the peripheral cycles charged by the stubs
+//
+// Cycle estimates are deterministic for a given compiler, so they are what
+// the baseline file gates on. Host ns are reported but only gated with -n.
+//
+// Updating the baseline rewrites only the kernels whose cycle estimate
+// moved by more than BENCH_UPDATE_PERCENT, and appends new kernels at the
+// end, so that the baseline's history shows which kernels a change moved
+// rather than the noise in every host ns figure.
+//
+// Usage: bench_kernels [-b baseline] [-u] [-t percent] [-n]
+//   -b  baseline file to compare against (default bench_baseline.txt)
+//   -u  update the baseline file with the current results instead of
+//       comparing
+//   -t  allowed regression in percent (default 10)
+//   -n  also gate host ns per call, with 4 times the threshold
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "hostsim.h"
+#include "benchutil.h"
+#include "composite.h"
+#include "font.h"
+#include "melody.h"
+#include "spectrum.h"
+#include "power.h"
+#include "bitboard.h"
+#include "stream.h"
+#include "transition.h"
+#include "scan.h"
+#include "palette.h"
+#include "envelope.h"
+#include "draw.h"
+#include "fxmath.h"
+#include "effect.h"
+#include "gspack.h"
+#include "anim.h"
+#include "console.h"
+#include "telemetry.h"
+#include "inc/hw_memmap.h"
+
+//
+// Most kernels the baseline file may list
+//
+#define BENCH_MAX_KERNELS   64
+
+//
+// Change in cycles, in percent, below which -u leaves a kernel's line as it
+// is
+//
+#define BENCH_UPDATE_PERCENT 1.0
+
+//*****************************************************************************
+//
+// Firmware entry points under test
+//
+//*****************************************************************************
+extern const char font8x8_basic[128-32][8];
+extern volatile uint16_t g_gsValues[2*32];
+extern volatile uint16_t g_pwmDacValues[2*32];
+extern volatile uint8_t g_count16kHz;
+extern volatile uint8_t g_ledRow[2];
+
+extern int32_t SineApprox(uint16_t phase, uint16_t scale);
+extern void RenderCharacter(char charAddr, const char fontTable[][8],
+                            uint8_t row, uint32_t color, uint16_t* gsValues);
+extern void RenderPixel(uint32_t pixelIdx, uint32_t row, uint32_t color,
+                        uint16_t* gsValues);
+extern void RenderDomino(uint32_t pattIdx, uint16_t* gsValues);
+extern uint32_t KeybdRead(void);
+extern void FillSineHalf(uint16_t* dacValues, uint16_t* sinePhase,
+                         uint16_t sineFreq, tEnvelope* envelope);
+extern void ClearOutputHalf(uint16_t* gsValues, uint16_t* dacValues);
+extern void PWMIntHandler(void);
+extern void RenderRGBRow(uint16_t rgbValues[8][3], uint16_t* gsValues);
+extern void RenderBitboardRow(tBitboard board, uint32_t row, uint32_t color,
+                              uint16_t* gsValues);
+extern void RenderPaletteRow(const tPaletteFrame* frame,
+                             const tPalette* palette, uint32_t row,
+                             uint16_t* gsValues);
+
+//*****************************************************************************
+//
+// Kernel wrappers. Each performs one call with inputs derived from the
+// iteration number so that the compiler cannot hoist the work.
+//
+//*****************************************************************************
+static volatile int32_t g_i32Sink;
+static uint16_t g_ui16Phase;
+
+static void
+BenchRenderCharacter(uint32_t ui32Iter)
+{
+    RenderCharacter('A' - ' ' + (ui32Iter % 26), font8x8_basic, ui32Iter & 7,
+                    0x2480F0, (uint16_t*)g_gsValues);
+}
+
+static void
+BenchRenderPixel(uint32_t ui32Iter)
+{
+    RenderPixel(ui32Iter & 0x3F, (ui32Iter >> 6) & 7, 0x00FF00,
+                (uint16_t*)g_gsValues);
+}
+
+static void
+BenchRenderDomino(uint32_t ui32Iter)
+{
+    RenderDomino(ui32Iter % 48, (uint16_t*)g_gsValues);
+}
+
+static void
+BenchSineApprox(uint32_t ui32Iter)
+{
+    g_i32Sink = SineApprox(ui32Iter * 1783, 1125);
+}
+
+static void
+BenchKeybdRead(uint32_t ui32Iter)
+{
+    g_i32Sink = KeybdRead();
+}
+
+//
+// A held tone, its envelope at the sustain level
+//
+static tEnvelope g_sBenchEnvelope;
+
+static void
+BenchEnvelopeSetup(void)
+{
+    static const tEnvelopeShape sShape = { 80, 800, 224, 800 };
+    int32_t i32Step;
+
+    EnvelopeInit(&g_sBenchEnvelope, &sShape);
+    EnvelopeGate(&g_sBenchEnvelope, true);
+    EnvelopeRamp(&g_sBenchEnvelope, 1000, 1125, &i32Step);
+}
+
+static void
+BenchFillSineHalf(uint32_t ui32Iter)
+{
+    FillSineHalf((uint16_t*)&g_pwmDacValues[ui32Iter & 0x20], &g_ui16Phase,
+                 2119, &g_sBenchEnvelope);
+}
+
+static void
+BenchClearOutputHalf(uint32_t ui32Iter)
+{
+    ClearOutputHalf((uint16_t*)&g_gsValues[ui32Iter & 0x20],
+                    (uint16_t*)&g_pwmDacValues[ui32Iter & 0x20]);
+}
+
+static void
+BenchPWMIntHandler(uint32_t ui32Iter)
+{
+    PWMIntHandler();
+}
+
+//*****************************************************************************
+//
+// Naive per-channel composite, the reference CompositeRow is checked and
+// timed against. It walks the 24 channels one at a time with a multiply,
+// a clamp and a coverage test each.
+//
+//*****************************************************************************
+static void
+CompositeRowRef(const tLayer *psLayers, uint32_t numLayers, uint32_t row,
+                uint16_t rgbValues[8][3])
+{
+    int32_t pi32Acc[24];
+    const uint16_t *pui16Src;
+    uint32_t ui32Chan, ui32Layer, ui32Op;
+    int32_t i32Value;
+
+    for(ui32Chan = 0; ui32Chan < 24; ui32Chan++)
+    {
+        pi32Acc[ui32Chan] = 0;
+    }
+    for(ui32Layer = 0; ui32Layer < numLayers; ui32Layer++)
+    {
+        if(!psLayers[ui32Layer].ui8Enabled)
+        {
+            continue;
+        }
+        pui16Src = (const uint16_t *)psLayers[ui32Layer].pui32Pix[row];
+        ui32Op = psLayers[ui32Layer].ui16Opacity;
+        for(ui32Chan = 0; ui32Chan < 24; ui32Chan++)
+        {
+            if(psLayers[ui32Layer].ui8Mode == LAYER_BLEND_ADD)
+            {
+                i32Value = pi32Acc[ui32Chan] +
+                           ((pui16Src[ui32Chan] * ui32Op) >> 8);
+                pi32Acc[ui32Chan] = (i32Value > 32767) ? 32767 : i32Value;
+            }
+            else if(psLayers[ui32Layer].pui8Mask[row] & (1 << (ui32Chan / 3)))
+            {
+                pi32Acc[ui32Chan] = (pui16Src[ui32Chan] * ui32Op +
+                                     pi32Acc[ui32Chan] *
+                                     (LAYER_OPAQUE - ui32Op)) >> 8;
+            }
+        }
+    }
+    for(ui32Chan = 0; ui32Chan < 24; ui32Chan++)
+    {
+        rgbValues[ui32Chan / 3][ui32Chan % 3] =
+            pi32Acc[ui32Chan] >> LAYER_SHIFT;
+    }
+}
+
+//
+// Background, sprite and text layers like the firmware's layered pattern
+//
+static tLayer g_psBenchLayers[3];
+static uint16_t g_pui16BenchRGB[8][3];
+
+static void
+BenchLayerSetup(void)
+{
+    uint32_t ui32Row, ui32Col;
+
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        for(ui32Col = 0; ui32Col < 8; ui32Col++)
+        {
+            LayerSetPixel(&g_psBenchLayers[0], ui32Row, ui32Col,
+                          0x2480F0 + ui32Row * 0x10101 + ui32Col * 0x3);
+        }
+    }
+    g_psBenchLayers[0].ui8Mode = LAYER_BLEND_ADD;
+    g_psBenchLayers[0].ui16Opacity = 160;
+    g_psBenchLayers[0].ui8Enabled = 1;
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        LayerSetPixel(&g_psBenchLayers[1], ui32Row, ui32Row, 0xFFFFFF);
+    }
+    g_psBenchLayers[1].ui8Mode = LAYER_BLEND_ADD;
+    g_psBenchLayers[1].ui16Opacity = LAYER_OPAQUE;
+    g_psBenchLayers[1].ui8Enabled = 1;
+    LayerDrawBitmap(&g_psBenchLayers[2], font8x8_basic['A' - ' '], 0xFF0000);
+    g_psBenchLayers[2].ui8Mode = LAYER_BLEND_ALPHA;
+    g_psBenchLayers[2].ui16Opacity = 192;
+    g_psBenchLayers[2].ui8Enabled = 1;
+}
+
+//
+// Returns the number of rows where CompositeRow and the reference differ
+//
+static uint32_t
+BenchLayerCheck(void)
+{
+    uint16_t pui16Ref[8][3];
+    uint32_t ui32Row, ui32Bad;
+
+    ui32Bad = 0;
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        CompositeRow(g_psBenchLayers, 3, ui32Row, g_pui16BenchRGB);
+        CompositeRowRef(g_psBenchLayers, 3, ui32Row, pui16Ref);
+        if(memcmp(g_pui16BenchRGB, pui16Ref, sizeof(pui16Ref)) != 0)
+        {
+            ui32Bad++;
+        }
+    }
+    return(ui32Bad);
+}
+
+static void
+BenchCompositeRow(uint32_t ui32Iter)
+{
+    CompositeRow(g_psBenchLayers, 3, ui32Iter & 7, g_pui16BenchRGB);
+}
+
+static void
+BenchCompositeRowRef(uint32_t ui32Iter)
+{
+    CompositeRowRef(g_psBenchLayers, 3, ui32Iter & 7, g_pui16BenchRGB);
+}
+
+static void
+BenchRenderRGBRow(uint32_t ui32Iter)
+{
+    RenderRGBRow(g_pui16BenchRGB, (uint16_t*)&g_gsValues[ui32Iter & 0x20]);
+}
+
+//
+// Font engine: a cache hit, a miss (cycling through 64 codes, which the
+// 16-entry cache cannot hold) and one frame of scrolling text
+//
+static tFontScroll g_sBenchScroll;
+static char g_pcBenchWindow[1][8];
+
+static void
+BenchFontGlyphHit(uint32_t ui32Iter)
+{
+    g_i32Sink = FontGlyphGet(&g_sFontIdiotBox, 'A' + (ui32Iter & 1))->
+                pui8Rows[ui32Iter & 7];
+}
+
+static void
+BenchFontGlyphMiss(uint32_t ui32Iter)
+{
+    g_i32Sink = FontGlyphGet(&g_sFontIdiotBox, ' ' + (ui32Iter & 0x3F))->
+                pui8Rows[ui32Iter & 7];
+}
+
+static void
+BenchFontScroll(uint32_t ui32Iter)
+{
+    FontScrollStep(&g_sBenchScroll);
+    FontScrollRender(&g_sBenchScroll, g_pcBenchWindow[0]);
+}
+
+static void
+BenchRenderScrollRow(uint32_t ui32Iter)
+{
+    RenderCharacter(0, g_pcBenchWindow, ui32Iter & 7, 0x2480F0,
+                    (uint16_t*)g_gsValues);
+}
+
+//
+// Melody sequencer: a song of 16ths at the fastest tempo and one of whole
+// notes at a slow tempo. The cost per half should not depend on which.
+//
+static const uint8_t g_pui8BenchDense[] = {
+    MELODY_TEMPO, 255,
+    NOTE(C, 5), DUR_16, NOTE(E, 5), DUR_16, NOTE(G, 5), DUR_16,
+    NOTE(C, 6), DUR_16, MELODY_END, 0
+};
+static const uint8_t g_pui8BenchSparse[] = {
+    MELODY_TEMPO, 40,
+    NOTE(C, 5), DUR_1, MELODY_END, 0
+};
+
+static void
+BenchMelodyFillDense(uint32_t ui32Iter)
+{
+    if(!MelodyPlaying())
+    {
+        MelodyStart(g_pui8BenchDense);
+    }
+    MelodyFill((uint16_t*)&g_pwmDacValues[ui32Iter & 0x20], 32, 1250, 1125);
+}
+
+static void
+BenchMelodyFillSparse(uint32_t ui32Iter)
+{
+    if(!MelodyPlaying())
+    {
+        MelodyStart(g_pui8BenchSparse);
+    }
+    MelodyFill((uint16_t*)&g_pwmDacValues[ui32Iter & 0x20], 32, 1250, 1125);
+}
+
+//
+// Spectrum analyser: one row's slice of 32 samples, a whole analysis frame
+// of 256 samples, and drawing a row. The input is a 1kHz tone with 2 kHz
+// and 4 kHz harmonics at 12 bits.
+//
+static tSpectrum g_sBenchSpectrum;
+static uint16_t g_pui16BenchAudio[SPECTRUM_FRAME];
+
+static void
+BenchSpectrumSetup(void)
+{
+    uint32_t idx;
+
+    for(idx = 0; idx < SPECTRUM_FRAME; idx++)
+    {
+        g_pui16BenchAudio[idx] = 2048 + SineApprox(idx * 4096, 1200) +
+                                 SineApprox(idx * 8192, 400) +
+                                 SineApprox(idx * 16384, 200);
+    }
+    SpectrumInit(&g_sBenchSpectrum);
+}
+
+static void
+BenchSpectrumSlice(uint32_t ui32Iter)
+{
+    SpectrumFeed(&g_sBenchSpectrum, &g_pui16BenchAudio[(ui32Iter & 7) * 32],
+                 32, 2048);
+}
+
+static void
+BenchSpectrumFrame(uint32_t ui32Iter)
+{
+    SpectrumFeed(&g_sBenchSpectrum, g_pui16BenchAudio, SPECTRUM_FRAME, 2048);
+}
+
+static void
+BenchSpectrumRow(uint32_t ui32Iter)
+{
+    SpectrumRow(&g_sBenchSpectrum, ui32Iter & 7, g_pui16BenchRGB);
+}
+
+//
+// Current limiter: accounting for one rendered row, and the once a frame
+// estimate and brightness update
+//
+static tPowerLimiter g_sBenchPower;
+
+static void
+BenchPowerRow(uint32_t ui32Iter)
+{
+    PowerRow(&g_sBenchPower, ui32Iter & 7,
+             (uint16_t*)&g_gsValues[ui32Iter & 0x20]);
+}
+
+static void
+BenchPowerFrame(uint32_t ui32Iter)
+{
+    PowerFrame(&g_sBenchPower);
+}
+
+//
+// A row of grayscale values scaled and packed into 16-bit SSI frames, as
+// TaskRow does when built with GS_PACKED
+//
+static uint16_t g_pui16BenchPacked[GSPACK_ROW_WORDS];
+
+static void
+BenchGsPack(uint32_t ui32Iter)
+{
+    GsPack((const uint16_t*)&g_gsValues[ui32Iter & 0x20], 32,
+           POWER_SCALE_FULL - (ui32Iter & 0xFF), g_pui16BenchPacked);
+}
+
+//
+// Bitboard layer: a row of a glyph board expanded to the channels, to set
+// against RenderCharacter, and a Life generation and a rotation of the
+// whole board
+//
+static tBitboard g_bbBench = 0x1818243C42420000ull;
+
+static void
+BenchRenderBitboardRow(uint32_t ui32Iter)
+{
+    RenderBitboardRow(g_bbBench ^ ui32Iter, ui32Iter & 7, 0x2480F0,
+                      (uint16_t*)g_gsValues);
+}
+
+static void
+BenchBitboardLifeStep(uint32_t ui32Iter)
+{
+    g_bbBench = BitboardLifeStep(g_bbBench ^ ui32Iter);
+}
+
+static void
+BenchBitboardRotate90(uint32_t ui32Iter)
+{
+    g_bbBench = BitboardRotate90(g_bbBench ^ ui32Iter);
+}
+
+//
+// Frame stream: a row's worth of a full line, 200 bytes, received and
+// decoded. The line is a keyframe and then one-row deltas, a ball moving
+// over a still picture, wrapping the sequence number without a gap.
+//
+#define BENCH_STREAM_FRAMES 256
+#define BENCH_STREAM_CHUNK  (STREAM_BAUD / 10 / 500)
+
+static uint8_t g_pui8BenchLine[STREAM_OVERHEAD + STREAM_FRAME_BYTES +
+                               (BENCH_STREAM_FRAMES - 1) *
+                               (STREAM_OVERHEAD + 1 + STREAM_ROW_BYTES)];
+static uint32_t g_ui32BenchLineLen;
+static uint32_t g_ui32BenchLinePos;
+
+static void
+BenchStreamSetup(void)
+{
+    uint32_t ui32Frame, ui32Start, ui32Sum1, ui32Sum2, idx;
+    uint8_t *pui8Out;
+
+    StreamInit();
+    pui8Out = g_pui8BenchLine;
+    for(ui32Frame = 0; ui32Frame < BENCH_STREAM_FRAMES; ui32Frame++)
+    {
+        ui32Start = pui8Out - g_pui8BenchLine;
+        *pui8Out++ = STREAM_SYNC0;
+        *pui8Out++ = STREAM_SYNC1;
+        if(ui32Frame == 0)
+        {
+            *pui8Out++ = STREAM_KEYFRAME;
+            *pui8Out++ = ui32Frame;
+            for(idx = 0; idx < STREAM_FRAME_BYTES; idx++)
+            {
+                *pui8Out++ = idx * 37;
+            }
+        }
+        else
+        {
+            *pui8Out++ = STREAM_DELTA;
+            *pui8Out++ = ui32Frame;
+            *pui8Out++ = 1 << (ui32Frame & 7);
+            for(idx = 0; idx < STREAM_ROW_BYTES; idx++)
+            {
+                *pui8Out++ = (idx / 3 == (ui32Frame / 8) % 8) ? 0xFF : idx;
+            }
+        }
+
+        //
+        // Fletcher-16 of everything after the sync bytes, as in stream.c
+        //
+        ui32Sum1 = ui32Sum2 = 0;
+        for(idx = ui32Start + 2; idx < pui8Out - g_pui8BenchLine; idx++)
+        {
+            ui32Sum1 = (ui32Sum1 + g_pui8BenchLine[idx]) % 255;
+            ui32Sum2 = (ui32Sum2 + ui32Sum1) % 255;
+        }
+        *pui8Out++ = ui32Sum1;
+        *pui8Out++ = ui32Sum2;
+    }
+    g_ui32BenchLineLen = pui8Out - g_pui8BenchLine;
+}
+
+static void
+BenchStreamReceive(uint32_t ui32Iter)
+{
+    uint32_t ui32Count;
+
+    ui32Count = g_ui32BenchLineLen - g_ui32BenchLinePos;
+    if(ui32Count > BENCH_STREAM_CHUNK)
+    {
+        ui32Count = BENCH_STREAM_CHUNK;
+    }
+    if(HostUartReceive(UART0_BASE, &g_pui8BenchLine[g_ui32BenchLinePos],
+                       ui32Count))
+    {
+        StreamIntHandler();
+    }
+    g_ui32BenchLinePos = (g_ui32BenchLinePos + ui32Count) % g_ui32BenchLineLen;
+    StreamReceive();
+}
+
+//
+// Transitions: a row blended halfway through each type, from a frame of
+// every output lit to one of every other output lit, so half the outputs
+// differ
+//
+static tTransition g_psBenchTransition[TRANSITION_NUM_TYPES];
+
+static void
+BenchTransitionSetup(void)
+{
+    tTransition *psTransition;
+    uint32_t ui32Type, ui32Row, idx;
+
+    for(ui32Type = 0; ui32Type < TRANSITION_NUM_TYPES; ui32Type++)
+    {
+        psTransition = &g_psBenchTransition[ui32Type];
+        TransitionInit(psTransition);
+        for(idx = 0; idx < 32; idx++)
+        {
+            psTransition->pui8ChannelColumn[idx] = idx & 7;
+            for(ui32Row = 0; ui32Row < 8; ui32Row++)
+            {
+                psTransition->ppui16Shown[ui32Row][idx] = 0xFF0;
+            }
+        }
+        TransitionStart(psTransition, ui32Type, 2);
+        TransitionFrame(psTransition);
+    }
+}
+
+static void
+BenchTransitionRow(uint32_t ui32Iter, uint32_t ui32Type)
+{
+    uint16_t *pui16GS;
+    uint32_t idx;
+
+    pui16GS = (uint16_t*)g_gsValues;
+    for(idx = 0; idx < 32; idx++)
+    {
+        pui16GS[idx] = (idx & 1) ? 0xFF0 : 0;
+    }
+    TransitionRow(&g_psBenchTransition[ui32Type], ui32Iter & 7, pui16GS);
+}
+
+static void
+BenchTransitionFade(uint32_t ui32Iter)
+{
+    BenchTransitionRow(ui32Iter, TRANSITION_CROSSFADE);
+}
+
+static void
+BenchTransitionWipe(uint32_t ui32Iter)
+{
+    BenchTransitionRow(ui32Iter, TRANSITION_WIPE);
+}
+
+static void
+BenchTransitionDissolve(uint32_t ui32Iter)
+{
+    BenchTransitionRow(ui32Iter, TRANSITION_DISSOLVE);
+}
+
+//
+// Row scan: a lit row scaled for the 7 slots a lone lit row gets
+//
+static tRowScan g_sBenchScan;
+
+static void
+BenchScanRow(uint32_t ui32Iter)
+{
+    uint16_t *pui16GS;
+    uint32_t idx;
+
+    pui16GS = (uint16_t*)g_gsValues;
+    for(idx = 0; idx < 32; idx++)
+    {
+        pui16GS[idx] = (idx & 1) ? 0xFF0 : 0;
+    }
+    ScanRow(&g_sBenchScan, ui32Iter & 7, pui16GS);
+}
+
+//
+// Palette frames: a row of 8 different entries looked up and copied to the
+// channels, to set against RenderRGBRow, and a rotation of 15 entries
+//
+static tPaletteFrame g_sBenchPaletteFrame;
+static tPalette g_sBenchPalette;
+
+static void
+BenchPaletteSetup(void)
+{
+    uint32_t ui32Row, idx;
+
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        g_sBenchPaletteFrame.pui32Row[ui32Row] = 0x76543210 << ui32Row;
+    }
+    for(idx = 0; idx < PALETTE_ENTRIES; idx++)
+    {
+        PaletteSetColor(&g_sBenchPalette, idx, 0x2480F0 * idx);
+    }
+}
+
+static void
+BenchRenderPaletteRow(uint32_t ui32Iter)
+{
+    RenderPaletteRow(&g_sBenchPaletteFrame, &g_sBenchPalette, ui32Iter & 7,
+                     (uint16_t*)g_gsValues);
+}
+
+static void
+BenchPaletteRotate(uint32_t ui32Iter)
+{
+    PaletteRotate(&g_sBenchPalette, 1, PALETTE_ENTRIES - 1);
+}
+
+//
+// Drawing primitives, each over the whole 8x8 frame: a clipped diagonal,
+// the frame's border and interior, a circle reaching its edges, a glyph,
+// and a flood of the whole frame, against the per-pixel LayerDrawBitmap
+//
+static tLayer g_sBenchDrawLayer;
+
+static void
+BenchDrawLine(uint32_t ui32Iter)
+{
+    DrawLine(&g_sBenchDrawLayer, -2, -1, 9, 8, 0x2480F0);
+}
+
+static void
+BenchDrawRect(uint32_t ui32Iter)
+{
+    DrawRect(&g_sBenchDrawLayer, 0, 0, 7, 7, 0x2480F0);
+}
+
+static void
+BenchDrawFillRect(uint32_t ui32Iter)
+{
+    DrawFillRect(&g_sBenchDrawLayer, 0, 0, 7, 7, 0x2480F0);
+}
+
+static void
+BenchDrawCircle(uint32_t ui32Iter)
+{
+    DrawCircle(&g_sBenchDrawLayer, 3, 4, 3, 0x2480F0);
+}
+
+static void
+BenchDrawBlit(uint32_t ui32Iter)
+{
+    DrawBlit(&g_sBenchDrawLayer, 0, 0, font8x8_basic['A' - ' '], 0x2480F0);
+}
+
+static void
+BenchLayerDrawBitmap(uint32_t ui32Iter)
+{
+    LayerDrawBitmap(&g_sBenchDrawLayer, font8x8_basic['A' - ' '], 0x2480F0);
+}
+
+static void
+BenchDrawFloodFill(uint32_t ui32Iter)
+{
+    DrawFloodFill(&g_sBenchDrawLayer, 3, 4, 0x2480F0);
+}
+
+//
+// Procedural effects, one state per effect, each a row at a time and a
+// step at a time, and the HSV kernel they share
+//
+static tEffect g_psBenchEffect[EFFECT_NUM_TYPES];
+
+static void
+BenchEffectSetup(void)
+{
+    uint32_t ui32Type, ui32Step;
+
+    for(ui32Type = 0; ui32Type < EFFECT_NUM_TYPES; ui32Type++)
+    {
+        EffectInit(&g_psBenchEffect[ui32Type], ui32Type, 12345);
+        for(ui32Step = 0; ui32Step < 16; ui32Step++)
+        {
+            EffectStep(&g_psBenchEffect[ui32Type]);
+        }
+    }
+}
+
+static void
+BenchFxHsvToRgb(uint32_t ui32Iter)
+{
+    FxHsvToRgb(ui32Iter * 2731, FX_SAT_FULL, FX_VAL_FULL,
+               g_pui16BenchRGB[ui32Iter & 7]);
+}
+
+static void
+BenchEffectRow(uint32_t ui32Type, uint32_t ui32Iter)
+{
+    EffectRow(&g_psBenchEffect[ui32Type], ui32Iter & 7, g_pui16BenchRGB);
+}
+
+static void
+BenchPlasmaRow(uint32_t ui32Iter)
+{
+    BenchEffectRow(EFFECT_PLASMA, ui32Iter);
+}
+
+static void
+BenchFireRow(uint32_t ui32Iter)
+{
+    BenchEffectRow(EFFECT_FIRE, ui32Iter);
+}
+
+static void
+BenchRainbowRow(uint32_t ui32Iter)
+{
+    BenchEffectRow(EFFECT_RAINBOW, ui32Iter);
+}
+
+static void
+BenchSparkleRow(uint32_t ui32Iter)
+{
+    BenchEffectRow(EFFECT_SPARKLE, ui32Iter);
+}
+
+static void
+BenchPlasmaStep(uint32_t ui32Iter)
+{
+    EffectStep(&g_psBenchEffect[EFFECT_PLASMA]);
+}
+
+static void
+BenchFireStep(uint32_t ui32Iter)
+{
+    EffectStep(&g_psBenchEffect[EFFECT_FIRE]);
+}
+
+static void
+BenchRainbowStep(uint32_t ui32Iter)
+{
+    EffectStep(&g_psBenchEffect[EFFECT_RAINBOW]);
+}
+
+static void
+BenchSparkleStep(uint32_t ui32Iter)
+{
+    EffectStep(&g_psBenchEffect[EFFECT_SPARKLE]);
+}
+
+//
+// Animation: the slowest frame there can be, seven pixels changed in every
+// row, and 16 display frames of a sample animation from its start, each
+// decoding a frame when its hold runs out
+//
+static uint8_t g_pui8BenchAnimWorst[ANIM_MAX_FRAME_BYTES];
+static tAnimPlayer g_sBenchAnimStart, g_sBenchAnimPlayer;
+static tPaletteFrame g_sBenchAnimFirst, g_sBenchAnimFrame;
+static tPalette g_sBenchAnimPalette;
+
+static void
+BenchAnimSetup(void)
+{
+    uint32_t ui32Row;
+
+    g_pui8BenchAnimWorst[0] = 1;
+    g_pui8BenchAnimWorst[1] = 0xFF;
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        g_pui8BenchAnimWorst[2 + 5 * ui32Row] = 0x7F;
+        memset(&g_pui8BenchAnimWorst[3 + 5 * ui32Row], 0xA5, 4);
+    }
+    AnimStart(&g_sBenchAnimStart, g_ppsAnims[g_ui32NumAnims - 1],
+              &g_sBenchAnimFirst, &g_sBenchAnimPalette);
+}
+
+static void
+BenchAnimDecode(uint32_t ui32Iter)
+{
+    AnimDecode(g_pui8BenchAnimWorst, &g_sBenchAnimFrame);
+}
+
+static void
+BenchAnimFrames(uint32_t ui32Iter)
+{
+    uint32_t idx;
+
+    g_sBenchAnimPlayer = g_sBenchAnimStart;
+    g_sBenchAnimFrame = g_sBenchAnimFirst;
+    for(idx = 0; idx < 16; idx++)
+    {
+        AnimFrame(&g_sBenchAnimPlayer, &g_sBenchAnimFrame);
+    }
+}
+
+//
+// Telemetry: framing a status record, and the whole of a frame's telemetry
+// with a record due every frame, queueing it and sending it to the UART
+//
+static tSchedTask g_sBenchRender, g_sBenchRefill;
+static tTelemetryStatus g_sBenchStatus;
+static uint8_t g_pui8BenchTelemetry[TELEMETRY_LINE_BYTES];
+
+static void
+BenchTelemetrySetup(void)
+{
+    uint32_t idx;
+
+    TelemetryInit(&g_sBenchRender, &g_sBenchRefill);
+    TelemetrySetPeriod(1);
+    for(idx = 0; idx < TELEMETRY_KEYS; idx++)
+    {
+        TelemetryKey(idx * 5, idx & 1);
+    }
+    memset(&g_sBenchStatus, 0xA5, sizeof(g_sBenchStatus));
+}
+
+static void
+BenchTelemetryEncode(uint32_t ui32Iter)
+{
+    TelemetryEncode(&g_sBenchStatus, ui32Iter, g_pui8BenchTelemetry);
+}
+
+static void
+BenchTelemetryFrame(uint32_t ui32Iter)
+{
+    g_sBenchRender.ui32Runs += 8;
+    g_sBenchRender.ui32TotalCycles += 8 * 4000;
+    g_sBenchRefill.ui32Runs += 8;
+    g_sBenchRefill.ui32TotalCycles += 8 * 9000;
+    TelemetryFrame(3, ui32Iter & 0xF, ui32Iter & 0x1F,
+                   TELEMETRY_FLAG_KEY | TELEMETRY_FLAG_SONG);
+    ConsoleFlush();
+}
+
+//
+// Keypad stand-in: a key is held in every scanned row
+//
+static int32_t
+BenchGpioInput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    return(0x02);
+}
+
+typedef struct
+{
+    const char *pcName;
+    tBenchFn pfnRun;
+    uint32_t ui32Items;
+    const char *pcUnit;
+}
+tBenchKernel;
+
+static const tBenchKernel g_psKernels[] =
+{
+    { "RenderCharacter", BenchRenderCharacter, 8,  "pixel"  },
+    { "RenderPixel",     BenchRenderPixel,     8,  "pixel"  },
+    { "RenderDomino",    BenchRenderDomino,    1,  "column" },
+    { "SineApprox",      BenchSineApprox,      1,  "sample" },
+    { "KeybdRead",       BenchKeybdRead,       1,  "scan"   },
+    { "FillSineHalf",    BenchFillSineHalf,    32, "sample" },
+    { "ClearOutputHalf", BenchClearOutputHalf, 32, "word"   },
+    { "PWMIntHandler",   BenchPWMIntHandler,   1,  "irq"    },
+    { "CompositeRow",    BenchCompositeRow,    24, "channel" },
+    { "CompositeRowRef", BenchCompositeRowRef, 24, "channel" },
+    { "RenderRGBRow",    BenchRenderRGBRow,    24, "channel" },
+    { "FontGlyphHit",    BenchFontGlyphHit,    1,  "glyph"  },
+    { "FontGlyphMiss",   BenchFontGlyphMiss,   1,  "glyph"  },
+    { "FontScroll",      BenchFontScroll,      1,  "frame"  },
+    { "RenderScrollRow", BenchRenderScrollRow, 8,  "pixel"  },
+    { "MelodyFillDense", BenchMelodyFillDense, 32, "sample" },
+    { "MelodyFillSparse", BenchMelodyFillSparse, 32, "sample" },
+    { "SpectrumSlice",   BenchSpectrumSlice,   32, "sample" },
+    { "SpectrumFrame",   BenchSpectrumFrame,   256, "sample" },
+    { "SpectrumRow",     BenchSpectrumRow,     8,  "pixel"  },
+    { "PowerRow",        BenchPowerRow,        32, "channel" },
+    { "PowerFrame",      BenchPowerFrame,      1,  "frame"  },
+    { "GsPack",          BenchGsPack,          32, "channel" },
+    { "RenderBitboardRow", BenchRenderBitboardRow, 8, "pixel" },
+    { "BitboardLifeStep", BenchBitboardLifeStep, 64, "cell"   },
+    { "BitboardRotate90", BenchBitboardRotate90, 64, "cell"   },
+    { "StreamReceive",   BenchStreamReceive,   BENCH_STREAM_CHUNK, "byte" },
+    { "TransitionFade",  BenchTransitionFade,  32, "channel" },
+    { "TransitionWipe",  BenchTransitionWipe,  32, "channel" },
+    { "TransitionDissolve", BenchTransitionDissolve, 32, "channel" },
+    { "ScanRow",         BenchScanRow,         32, "channel" },
+    { "RenderPaletteRow", BenchRenderPaletteRow, 8, "pixel" },
+    { "PaletteRotate",   BenchPaletteRotate,   15, "entry" },
+    { "DrawLine",        BenchDrawLine,        8,  "pixel"  },
+    { "DrawRect",        BenchDrawRect,        28, "pixel"  },
+    { "DrawFillRect",    BenchDrawFillRect,    64, "pixel"  },
+    { "DrawCircle",      BenchDrawCircle,      16, "pixel"  },
+    { "DrawBlit",        BenchDrawBlit,        8,  "row"    },
+    { "LayerDrawBitmap", BenchLayerDrawBitmap, 8,  "row"    },
+    { "DrawFloodFill",   BenchDrawFloodFill,   64, "pixel"  },
+    { "FxHsvToRgb",      BenchFxHsvToRgb,      1,  "pixel"  },
+    { "PlasmaRow",       BenchPlasmaRow,       8,  "pixel"  },
+    { "FireRow",         BenchFireRow,         8,  "pixel"  },
+    { "RainbowRow",      BenchRainbowRow,      8,  "pixel"  },
+    { "SparkleRow",      BenchSparkleRow,      8,  "pixel"  },
+    { "PlasmaStep",      BenchPlasmaStep,      1,  "frame"  },
+    { "FireStep",        BenchFireStep,        64, "cell"   },
+    { "RainbowStep",     BenchRainbowStep,     1,  "frame"  },
+    { "SparkleStep",     BenchSparkleStep,     64, "cell"   },
+    { "AnimDecode",      BenchAnimDecode,      56, "pixel"  },
+    { "AnimFrames",      BenchAnimFrames,      16, "frame"  },
+    { "TelemetryEncode", BenchTelemetryEncode, TELEMETRY_STATUS_BYTES, "byte" },
+    { "TelemetryFrame",  BenchTelemetryFrame,  1,  "record" },
+};
+
+#define NUM_KERNELS (sizeof(g_psKernels) / sizeof(g_psKernels[0]))
+
+typedef struct
+{
+    char pcName[32];
+    double dInsns;
+    double dCycles;
+    double dNs;
+}
+tBenchResult;
+
+//*****************************************************************************
+//
+// Baseline file handling. One line per kernel: name, insns, cycles, ns.
+//
+//*****************************************************************************
+static uint32_t
+BenchLoadBaseline(const char *pcFile, tBenchResult *psBase)
+{
+    FILE *pFile;
+    char pcLine[128];
+    uint32_t ui32Count;
+
+    pFile = fopen(pcFile, "r");
+    if(!pFile)
+    {
+        return(0);
+    }
+    ui32Count = 0;
+    while(fgets(pcLine, sizeof(pcLine), pFile) &&
+          (ui32Count < BENCH_MAX_KERNELS))
+    {
+        if((pcLine[0] == '#') || (pcLine[0] == '\n'))
+        {
+            continue;
+        }
+        if(sscanf(pcLine, "%31s %lf %lf %lf", psBase[ui32Count].pcName,
+                  &psBase[ui32Count].dInsns, &psBase[ui32Count].dCycles,
+                  &psBase[ui32Count].dNs) == 4)
+        {
+            ui32Count++;
+        }
+    }
+    fclose(pFile);
+    return(ui32Count);
+}
+
+static int32_t
+BenchFind(const tBenchResult *psList, uint32_t ui32Count, const char *pcName)
+{
+    uint32_t idx;
+
+    for(idx = 0; idx < ui32Count; idx++)
+    {
+        if(strcmp(psList[idx].pcName, pcName) == 0)
+        {
+            return(idx);
+        }
+    }
+    return(-1);
+}
+
+static int
+BenchSaveBaseline(const char *pcFile, const tBenchResult *psResult,
+                  uint32_t ui32Count)
+{
+    FILE *pFile;
+    uint32_t idx;
+
+    pFile = fopen(pcFile, "w");
+    if(!pFile)
+    {
+        perror(pcFile);
+        return(1);
+    }
+    fprintf(pFile, "# bench_kernels baseline: kernel insns m4_cycles ns\n");
+    for(idx = 0; idx < ui32Count; idx++)
+    {
+        fprintf(pFile, "%-20s %10.1f %10.1f %10.2f\n", psResult[idx].pcName,
+                psResult[idx].dInsns, psResult[idx].dCycles,
+                psResult[idx].dNs);
+    }
+    fclose(pFile);
+    return(0);
+}
+
+//*****************************************************************************
+//
+// BenchUpdateBaseline
+// Merge the results into the baseline: kernels kept in its order, those
+// whose cycles moved past BENCH_UPDATE_PERCENT rewritten, kernels no longer
+// benchmarked dropped and new ones appended.
+//
+//*****************************************************************************
+static int
+BenchUpdateBaseline(const char *pcFile, const tBenchResult *psResult,
+                    uint32_t ui32Count)
+{
+    static tBenchResult psBase[BENCH_MAX_KERNELS];
+    static tBenchResult psMerged[BENCH_MAX_KERNELS];
+    const tBenchResult *psOld;
+    uint32_t ui32NumBase, ui32NumMerged, ui32Changed, idx;
+    int32_t i32Found;
+    double dDelta;
+
+    ui32NumBase = BenchLoadBaseline(pcFile, psBase);
+    ui32NumMerged = 0;
+    ui32Changed = 0;
+    for(idx = 0; idx < ui32NumBase; idx++)
+    {
+        i32Found = BenchFind(psResult, ui32Count, psBase[idx].pcName);
+        if(i32Found < 0)
+        {
+            printf("%-18s dropped from the baseline\n", psBase[idx].pcName);
+            ui32Changed++;
+            continue;
+        }
+        psOld = &psBase[idx];
+        dDelta = psResult[i32Found].dCycles - psOld->dCycles;
+        if((dDelta < 0 ? -dDelta : dDelta) * 100.0 >
+           psOld->dCycles * BENCH_UPDATE_PERCENT)
+        {
+            printf("%-18s %.1f -> %.1f m4 cycles\n", psOld->pcName,
+                   psOld->dCycles, psResult[i32Found].dCycles);
+            psOld = &psResult[i32Found];
+            ui32Changed++;
+        }
+        psMerged[ui32NumMerged++] = *psOld;
+    }
+    for(idx = 0; idx < ui32Count; idx++)
+    {
+        if(BenchFind(psBase, ui32NumBase, psResult[idx].pcName) < 0)
+        {
+            printf("%-18s added to the baseline\n", psResult[idx].pcName);
+            psMerged[ui32NumMerged++] = psResult[idx];
+            ui32Changed++;
+        }
+    }
+    printf("%u of %u kernels changed in %s\n", ui32Changed, ui32NumMerged,
+           pcFile);
+    return(BenchSaveBaseline(pcFile, psMerged, ui32NumMerged));
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+    static tBenchResult psResult[BENCH_MAX_KERNELS];
+    static tBenchResult psBase[BENCH_MAX_KERNELS];
+    const char *pcBaseline = "bench_baseline.txt";
+    bool bUpdate = false, bGateNs = false;
+    double dThreshold = 10.0, dLimit;
+    uint32_t idx, ui32Base, ui32NumBase;
+    int32_t i32Base;
+    int iOpt, iFailed;
+
+    while((iOpt = getopt(argc, argv, "b:ut:n")) != -1)
+    {
+        switch(iOpt)
+        {
+            case 'b': pcBaseline = optarg; break;
+            case 'u': bUpdate = true; break;
+            case 't': dThreshold = atof(optarg); break;
+            case 'n': bGateNs = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-b baseline] [-u] [-t percent] "
+                        "[-n]\n", argv[0]);
+                return(2);
+        }
+    }
+
+    HostReset();
+    g_pfnHostGpioInput = BenchGpioInput;
+
+    BenchLayerSetup();
+    BenchSpectrumSetup();
+    BenchStreamSetup();
+    BenchTransitionSetup();
+    ScanInit(&g_sBenchScan, true);
+    BenchPaletteSetup();
+    BenchEnvelopeSetup();
+    BenchEffectSetup();
+    BenchAnimSetup();
+    BenchTelemetrySetup();
+    g_sBenchScan.ui32Scale = SCAN_SCALE_FULL / 7;
+    PowerInit(&g_sBenchPower, 8, POWER_PEAK_BUDGET_MA,
+              POWER_AVERAGE_BUDGET_MA);
+    FontScrollInit(&g_sBenchScroll, &g_sFontIdiotBox,
+                   "IdiotBox \xE2\x99\xA5 Gr\xC3\xBC\xC3\x9F""e", 4);
+    if(BenchLayerCheck() != 0)
+    {
+        printf("CompositeRow: %u rows differ from the per-channel "
+               "reference\n", BenchLayerCheck());
+        return(1);
+    }
+
+    printf("%-18s %10s %14s %10s %10s\n", "kernel", "ns/call", "items/s",
+           "insns", "m4 cycles");
+    for(idx = 0; idx < NUM_KERNELS; idx++)
+    {
+        tBenchResult *psRes = &psResult[idx];
+        double dItems;
+
+        strncpy(psRes->pcName, g_psKernels[idx].pcName,
+                sizeof(psRes->pcName) - 1);
+        psRes->dNs = BenchTime(g_psKernels[idx].pfnRun);
+        psRes->dCycles = BenchM4Cycles(g_psKernels[idx].pfnRun,
+                                       &psRes->dInsns);
+        dItems = 1e9 / psRes->dNs * g_psKernels[idx].ui32Items;
+        printf("%-18s %10.2f %10.3gM %-3s %10.1f %10.1f\n", psRes->pcName,
+               psRes->dNs, dItems / 1e6, g_psKernels[idx].pcUnit,
+               psRes->dInsns, psRes->dCycles);
+    }
+
+    if(bUpdate)
+    {
+        return(BenchUpdateBaseline(pcBaseline, psResult, NUM_KERNELS));
+    }
+
+    //
+    // Compare against the stored baseline.
+    //
+    ui32NumBase = BenchLoadBaseline(pcBaseline, psBase);
+    if(ui32NumBase == 0)
+    {
+        printf("no baseline in %s; run with -u to create one\n", pcBaseline);
+        return(0);
+    }
+    iFailed = 0;
+    for(idx = 0; idx < NUM_KERNELS; idx++)
+    {
+        i32Base = BenchFind(psBase, ui32NumBase, psResult[idx].pcName);
+        if(i32Base < 0)
+        {
+            printf("%-18s NEW (not in baseline)\n", psResult[idx].pcName);
+            continue;
+        }
+        ui32Base = i32Base;
+        dLimit = psBase[ui32Base].dCycles * (1.0 + dThreshold / 100.0);
+        if((psResult[idx].dCycles >= 0) && (psResult[idx].dCycles > dLimit))
+        {
+            printf("%-18s REGRESSED %.1f -> %.1f m4 cycles\n",
+                   psResult[idx].pcName, psBase[ui32Base].dCycles,
+                   psResult[idx].dCycles);
+            iFailed++;
+        }
+        dLimit = psBase[ui32Base].dNs * (1.0 + 4 * dThreshold / 100.0);
+        if(bGateNs && (psResult[idx].dNs > dLimit))
+        {
+            printf("%-18s REGRESSED %.2f -> %.2f ns\n", psResult[idx].pcName,
+                   psBase[ui32Base].dNs, psResult[idx].dNs);
+            iFailed++;
+        }
+    }
+    printf("%s: %d regression(s) against %s\n", iFailed ? "FAIL" : "PASS",
+           iFailed, pcBaseline);
+    return(iFailed ? 1 : 0);
+}
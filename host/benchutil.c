@@ -0,0 +1,177 @@
+//*****************************************************************************
+//
+// benchutil.c - Timing and instruction counting shared by the host tools.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Host timing is noisy, so BenchTime reports the best of several runs.
+// Instruction counts are exact: a forked child stops itself around the calls
+// and the parent single-steps it with ptrace. The Cortex-M4 estimate scales
+// those by BENCH_M4_CPI_X4 and adds the cycles charged by hoststubs.c.
+//
+//*****************************************************************************
+
+#include <signal.h>
+#include <stddef.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ptrace.h>
+#include <sys/wait.h>
+#include "hostsim.h"
+#include "benchutil.h"
+
+static void
+BenchNothing(uint32_t ui32Iter)
+{
+}
+
+//*****************************************************************************
+//
+// Time one kernel, returning the best ns per call of BENCH_REPS runs.
+//
+//*****************************************************************************
+double
+BenchTime(tBenchFn pfnRun)
+{
+    struct timespec sStart, sEnd;
+    double dBest, dNs;
+    uint32_t ui32Rep, ui32Iter;
+
+    dBest = 1e30;
+    for(ui32Rep = 0; ui32Rep < BENCH_REPS; ui32Rep++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &sStart);
+        for(ui32Iter = 0; ui32Iter < BENCH_CALLS; ui32Iter++)
+        {
+            pfnRun(ui32Iter);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &sEnd);
+        dNs = ((sEnd.tv_sec - sStart.tv_sec) * 1e9 +
+               (sEnd.tv_nsec - sStart.tv_nsec)) / BENCH_CALLS;
+        if(dNs < dBest)
+        {
+            dBest = dNs;
+        }
+    }
+    return(dBest);
+}
+
+//*****************************************************************************
+//
+// Count host instructions for BENCH_STEP_CALLS calls of a kernel, returning
+// the raw count per call including the stepping overhead, or a negative
+// value if ptrace is not available.
+//
+//*****************************************************************************
+static double
+BenchStep(tBenchFn pfnRun)
+{
+    pid_t pid;
+    int iStatus;
+    uint32_t ui32Iter;
+    uint64_t ui64Steps;
+
+    pid = fork();
+    if(pid == 0)
+    {
+        ptrace(PTRACE_TRACEME, 0, 0, 0);
+        raise(SIGSTOP);
+        for(ui32Iter = 0; ui32Iter < BENCH_STEP_CALLS; ui32Iter++)
+        {
+            pfnRun(ui32Iter);
+        }
+        raise(SIGSTOP);
+        _exit(0);
+    }
+    if(pid < 0)
+    {
+        return(-1.0);
+    }
+
+    //
+    // Wait for the first stop, then step until the second.
+    //
+    waitpid(pid, &iStatus, 0);
+    ui64Steps = 0;
+    while(1)
+    {
+        if(ptrace(PTRACE_SINGLESTEP, pid, 0, 0) < 0)
+        {
+            kill(pid, SIGKILL);
+            waitpid(pid, &iStatus, 0);
+            return(-1.0);
+        }
+        waitpid(pid, &iStatus, 0);
+        if(WIFEXITED(iStatus) ||
+           (WIFSTOPPED(iStatus) && (WSTOPSIG(iStatus) == SIGSTOP)))
+        {
+            break;
+        }
+        ui64Steps++;
+    }
+    kill(pid, SIGKILL);
+    waitpid(pid, &iStatus, 0);
+    return((double)ui64Steps / BENCH_STEP_CALLS);
+}
+
+//*****************************************************************************
+//
+// Host instructions per call, with the loop and raise() overhead calibrated
+// away. Negative if ptrace is not available.
+//
+//*****************************************************************************
+double
+BenchCountInsns(tBenchFn pfnRun)
+{
+    static double dCalib = -2.0;
+    double dInsns;
+
+    if(dCalib < -1.5)
+    {
+        dCalib = BenchStep(BenchNothing);
+    }
+    dInsns = BenchStep(pfnRun);
+    if((dInsns < 0) || (dCalib < 0))
+    {
+        return(-1.0);
+    }
+    return(dInsns - dCalib);
+}
+
+//*****************************************************************************
+//
+// Estimated Cortex-M4 cycles per call. The host instruction count is
+// returned through pdInsns when it is not NULL. Negative if ptrace is not
+// available.
+//
+//*****************************************************************************
+double
+BenchM4Cycles(tBenchFn pfnRun, double *pdInsns)
+{
+    double dInsns;
+    uint32_t ui32Iter;
+
+    dInsns = BenchCountInsns(pfnRun);
+    if(pdInsns)
+    {
+        *pdInsns = dInsns;
+    }
+    if(dInsns < 0)
+    {
+        return(-1.0);
+    }
+
+    g_ui64HostPeriphCycles = 0;
+    for(ui32Iter = 0; ui32Iter < BENCH_STEP_CALLS; ui32Iter++)
+    {
+        pfnRun(ui32Iter);
+    }
+    return(dInsns * BENCH_M4_CPI_X4 / 4 +
+           (double)g_ui64HostPeriphCycles / BENCH_STEP_CALLS);
+}
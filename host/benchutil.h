@@ -0,0 +1,41 @@
+//*****************************************************************************
+//
+// benchutil.h - Timing and instruction counting shared by the host tools.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __BENCHUTIL_H__
+#define __BENCHUTIL_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Benchmark parameters
+//
+//*****************************************************************************
+#define BENCH_CALLS         20000
+#define BENCH_REPS          7
+#define BENCH_STEP_CALLS    16
+
+//
+// Cortex-M4 cycles per host instruction, times 4. Thumb-2 and x86-64 need a
+// similar number of instructions for this integer code; the M4 averages
+// about 1.25 cycles per instruction once loads and taken branches count.
+//
+#define BENCH_M4_CPI_X4     5
+
+//
+// One call of a kernel under test, with inputs derived from the iteration
+//
+typedef void (*tBenchFn)(uint32_t ui32Iter);
+
+extern double BenchTime(tBenchFn pfnRun);
+extern double BenchCountInsns(tBenchFn pfnRun);
+extern double BenchM4Cycles(tBenchFn pfnRun, double *pdInsns);
+
+#endif // __BENCHUTIL_H__
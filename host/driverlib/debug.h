@@ -0,0 +1,19 @@
+//*****************************************************************************
+//
+// debug.h - Host stand-in for the TivaWare debug API.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __DEBUG_H__
+#define __DEBUG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define ASSERT(expr)
+
+#endif // __DEBUG_H__
@@ -0,0 +1,19 @@
+//*****************************************************************************
+//
+// fpu.h - Host stand-in for the TivaWare FPU API.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __FPU_H__
+#define __FPU_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+extern void FPULazyStackingEnable(void);
+
+#endif // __FPU_H__
@@ -0,0 +1,28 @@
+//*****************************************************************************
+//
+// pin_map.h - Host stand-in for the TivaWare pin map API.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __PIN_MAP_H__
+#define __PIN_MAP_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define GPIO_PA0_U0RX           0x00000001
+#define GPIO_PA1_U0TX           0x00000401
+#define GPIO_PA2_SSI0CLK        0x00000802
+#define GPIO_PA5_SSI0TX         0x00001402
+#define GPIO_PB4_T1CCP0         0x00011007
+#define GPIO_PD0_SSI1CLK        0x00030002
+#define GPIO_PD2_WT3CCP0        0x00030807
+#define GPIO_PD3_SSI1TX         0x00030C02
+#define GPIO_PF0_T0CCP0         0x00050007
+#define GPIO_PF1_T0CCP1         0x00050407
+
+#endif // __PIN_MAP_H__
@@ -0,0 +1,73 @@
+//*****************************************************************************
+//
+// rom.h - Host stand-in for the TivaWare ROM API.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __ROM_H__
+#define __ROM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+//
+// The host has no ROM. Map every ROM_ call used by the firmware onto the
+// stand-in driverlib functions.
+//
+//*****************************************************************************
+#define ROM_ADCProcessorTrigger         ADCProcessorTrigger
+#define ROM_ADCSequenceConfigure        ADCSequenceConfigure
+#define ROM_ADCSequenceDataGet          ADCSequenceDataGet
+#define ROM_ADCSequenceEnable           ADCSequenceEnable
+#define ROM_ADCSequenceStepConfigure    ADCSequenceStepConfigure
+#define ROM_FPULazyStackingEnable       FPULazyStackingEnable
+#define ROM_GPIOPinTypeADC              GPIOPinTypeADC
+#define ROM_GPIOPinConfigure            GPIOPinConfigure
+#define ROM_GPIOPinRead                 GPIOPinRead
+#define ROM_GPIOPinTypeGPIOInput        GPIOPinTypeGPIOInput
+#define ROM_GPIOPinTypeGPIOOutput       GPIOPinTypeGPIOOutput
+#define ROM_GPIOPinTypeSSI              GPIOPinTypeSSI
+#define ROM_GPIOPinTypeTimer            GPIOPinTypeTimer
+#define ROM_GPIOPinTypeUART             GPIOPinTypeUART
+#define ROM_GPIOPinWrite                GPIOPinWrite
+#define ROM_IntMasterDisable            IntMasterDisable
+#define ROM_IntMasterEnable             IntMasterEnable
+#define ROM_SSIBusy                     SSIBusy
+#define ROM_SSIConfigSetExpClk          SSIConfigSetExpClk
+#define ROM_SSIDataPut                  SSIDataPut
+#define ROM_SSIDisable                  SSIDisable
+#define ROM_SSIEnable                   SSIEnable
+#define ROM_SysCtlClockSet              SysCtlClockSet
+#define ROM_SysCtlPeripheralEnable      SysCtlPeripheralEnable
+#define ROM_SysTickDisable              SysTickDisable
+#define ROM_SysTickEnable               SysTickEnable
+#define ROM_SysTickIntEnable            SysTickIntEnable
+#define ROM_SysTickPeriodSet            SysTickPeriodSet
+#define ROM_TimerConfigure              TimerConfigure
+#define ROM_TimerDisable                TimerDisable
+#define ROM_TimerEnable                 TimerEnable
+#define ROM_TimerIntClear               TimerIntClear
+#define ROM_TimerIntDisable             TimerIntDisable
+#define ROM_TimerIntEnable              TimerIntEnable
+#define ROM_TimerLoadSet                TimerLoadSet
+#define ROM_TimerPrescaleSet            TimerPrescaleSet
+#define ROM_UARTCharPutNonBlocking      UARTCharPutNonBlocking
+#define ROM_UARTDMAEnable               UARTDMAEnable
+#define ROM_UARTFIFOLevelSet            UARTFIFOLevelSet
+#define ROM_UARTIntClear                UARTIntClear
+#define ROM_UARTIntStatus               UARTIntStatus
+#define ROM_uDMAChannelAttributeDisable uDMAChannelAttributeDisable
+#define ROM_uDMAChannelControlSet       uDMAChannelControlSet
+#define ROM_uDMAChannelEnable           uDMAChannelEnable
+#define ROM_uDMAChannelModeGet          uDMAChannelModeGet
+#define ROM_uDMAChannelSizeGet          uDMAChannelSizeGet
+#define ROM_uDMAChannelTransferSet      uDMAChannelTransferSet
+#define ROM_uDMAControlBaseSet          uDMAControlBaseSet
+#define ROM_uDMAEnable                  uDMAEnable
+
+#endif // __ROM_H__
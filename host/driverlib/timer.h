@@ -0,0 +1,45 @@
+//*****************************************************************************
+//
+// timer.h - Host stand-in for the TivaWare timer API.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __TIMER_H__
+#define __TIMER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define TIMER_CFG_SPLIT_PAIR    0x04000000
+#define TIMER_CFG_A_PWM         0x0000000A
+#define TIMER_CFG_B_PWM         0x00000A00
+
+#define TIMER_A                 0x000000ff
+#define TIMER_B                 0x0000ff00
+#define TIMER_BOTH              0x0000ffff
+
+#define TIMER_CAPA_EVENT        0x00000004
+#define TIMER_EVENT_NEG_EDGE    0x00000001
+
+extern void TimerEnable(uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerDisable(uint32_t ui32Base, uint32_t ui32Timer);
+extern void TimerConfigure(uint32_t ui32Base, uint32_t ui32Config);
+extern void TimerControlEvent(uint32_t ui32Base, uint32_t ui32Timer,
+                              uint32_t ui32Event);
+extern void TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer,
+                         uint32_t ui32Value);
+extern void TimerPrescaleSet(uint32_t ui32Base, uint32_t ui32Timer,
+                             uint32_t ui32Value);
+extern void TimerMatchSet(uint32_t ui32Base, uint32_t ui32Timer,
+                          uint32_t ui32Value);
+extern void TimerPrescaleMatchSet(uint32_t ui32Base, uint32_t ui32Timer,
+                                  uint32_t ui32Value);
+extern void TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void TimerIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern void TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags);
+
+#endif // __TIMER_H__
@@ -0,0 +1,33 @@
+//*****************************************************************************
+//
+// uart.h - Host stand-in for the TivaWare UART API.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __UART_H__
+#define __UART_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define UART_CLOCK_SYSTEM       0x00000000
+#define UART_CLOCK_PIOSC        0x00000005
+
+#define UART_FIFO_TX4_8         0x00000002
+#define UART_FIFO_RX4_8         0x00000010
+
+#define UART_DMA_RX             0x00000001
+
+extern void UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source);
+extern bool UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData);
+extern void UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel,
+                             uint32_t ui32RxLevel);
+extern void UARTDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags);
+extern uint32_t UARTIntStatus(uint32_t ui32Base, bool bMasked);
+extern void UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags);
+
+#endif // __UART_H__
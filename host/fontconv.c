@@ -0,0 +1,675 @@
+//*****************************************************************************
+//
+// fontconv.c - Convert BDF and PNG fonts to compressed firmware font tables.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// This program reads one or more fonts and writes a C source file holding a
+// tFont for the firmware font engine (see test_tlc5941/font.h). Glyphs are
+// placed in an 8 row cell, trimmed to their inked columns (at most 8) and
+// stored either bit-packed or run-length coded, whichever is smaller.
+// Consecutive code points are grouped into glyph sets. Later inputs replace
+// glyphs of earlier ones with the same code.
+//
+// Inputs:
+// - BDF: every glyph with an ENCODING. Rows are placed so that the font
+//   ascent is the top of the cell.
+// - PNG (when built with libpng): a sheet of 8x8 cells read left to right,
+//   top to bottom, the first cell being the code given with -c. Light pixels
+//   are lit, or dark pixels with -i.
+//
+// Usage: fontconv [-n name] [-s spacing] [-m missing] [-w space] [-o out.c]
+//                 [-c first] [-i] font.bdf|sheet.png ...
+//   -n  font name, the table is g_sFont<name> (default IdiotBox)
+//   -s  blank columns after each glyph (default 1)
+//   -m  code drawn for characters not in the font (default '?')
+//   -w  width of glyphs without ink, such as space (default 3)
+//   -o  output file (default stdout)
+//   -c  code of the first cell of the following PNG sheets (default 32)
+//   -i  following PNG sheets are dark glyphs on a light background
+//
+//*****************************************************************************
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef FONTCONV_PNG
+#include <png.h>
+#endif
+#include "font.h"
+
+#define CONV_MAX_GLYPHS     1024
+#define CONV_MAX_LINE       256
+#define CONV_CELL_COLUMNS   16
+
+typedef struct
+{
+    uint32_t ui32Code;
+    uint32_t ui32Width;
+    uint16_t pui16Rows[FONT_HEIGHT];    // up to 16 columns before trimming
+    uint8_t pui8Data[16];
+    uint32_t ui32Bytes;
+    uint8_t ui8Header;
+    bool bMissing;
+}
+tConvGlyph;
+
+static tConvGlyph g_psGlyphs[CONV_MAX_GLYPHS];
+static uint32_t g_ui32NumGlyphs;
+static uint32_t g_ui32SpaceWidth = 3;
+
+//*****************************************************************************
+//
+// Add a glyph, replacing one with the same code. The rows may be up to 16
+// columns wide; they are trimmed here.
+//
+//*****************************************************************************
+static void
+ConvAddGlyph(uint32_t ui32Code, const uint16_t pui16Rows[FONT_HEIGHT],
+             uint32_t ui32BlankWidth)
+{
+    tConvGlyph *psGlyph;
+    uint16_t ui16Ink;
+    uint32_t idx, ui32First, ui32Last;
+
+    for(idx = 0; idx < g_ui32NumGlyphs; idx++)
+    {
+        if(g_psGlyphs[idx].ui32Code == ui32Code)
+        {
+            break;
+        }
+    }
+    if(idx == CONV_MAX_GLYPHS)
+    {
+        fprintf(stderr, "fontconv: more than %d glyphs\n", CONV_MAX_GLYPHS);
+        exit(1);
+    }
+    if(idx == g_ui32NumGlyphs)
+    {
+        g_ui32NumGlyphs++;
+    }
+    psGlyph = &g_psGlyphs[idx];
+    psGlyph->ui32Code = ui32Code;
+
+    ui16Ink = 0;
+    for(idx = 0; idx < FONT_HEIGHT; idx++)
+    {
+        ui16Ink |= pui16Rows[idx];
+    }
+    if(!ui16Ink)
+    {
+        psGlyph->ui32Width = ui32BlankWidth ? ui32BlankWidth : g_ui32SpaceWidth;
+        if(psGlyph->ui32Width > 8)
+        {
+            psGlyph->ui32Width = 8;
+        }
+        memset(psGlyph->pui16Rows, 0, sizeof(psGlyph->pui16Rows));
+        return;
+    }
+    for(ui32First = 0; !(ui16Ink & (1 << ui32First)); ui32First++)
+    {
+    }
+    for(ui32Last = 15; !(ui16Ink & (1 << ui32Last)); ui32Last--)
+    {
+    }
+    if(ui32Last - ui32First >= 8)
+    {
+        fprintf(stderr, "fontconv: U+%04X is %u columns wide, clipped to 8\n",
+                ui32Code, ui32Last - ui32First + 1);
+        ui32Last = ui32First + 7;
+    }
+    psGlyph->ui32Width = ui32Last - ui32First + 1;
+    for(idx = 0; idx < FONT_HEIGHT; idx++)
+    {
+        psGlyph->pui16Rows[idx] = (pui16Rows[idx] >> ui32First) &
+                                  ((1 << psGlyph->ui32Width) - 1);
+    }
+}
+
+//*****************************************************************************
+//
+// BDF reader
+//
+//*****************************************************************************
+static int
+ConvReadBDF(const char *pcFile)
+{
+    FILE *pFile;
+    char pcLine[CONV_MAX_LINE];
+    uint16_t pui16Rows[FONT_HEIGHT];
+    int32_t i32Code = -1, i32Ascent = FONT_HEIGHT - 1, i32Row = -1;
+    int32_t i32W = 0, i32H = 0, i32X = 0, i32Y = 0, i32DWidth = 0, i32Top;
+    uint32_t ui32Bits, ui32Col, ui32Count = 0;
+
+    pFile = fopen(pcFile, "r");
+    if(!pFile)
+    {
+        perror(pcFile);
+        return(1);
+    }
+    while(fgets(pcLine, sizeof(pcLine), pFile))
+    {
+        if(sscanf(pcLine, "FONT_ASCENT %d", &i32Ascent) == 1)
+        {
+            continue;
+        }
+        if(sscanf(pcLine, "ENCODING %d", &i32Code) == 1)
+        {
+            continue;
+        }
+        if(sscanf(pcLine, "DWIDTH %d", &i32DWidth) == 1)
+        {
+            continue;
+        }
+        if(sscanf(pcLine, "BBX %d %d %d %d", &i32W, &i32H, &i32X, &i32Y) == 4)
+        {
+            continue;
+        }
+        if(strncmp(pcLine, "BITMAP", 6) == 0)
+        {
+            memset(pui16Rows, 0, sizeof(pui16Rows));
+            i32Row = 0;
+            continue;
+        }
+        if(strncmp(pcLine, "ENDCHAR", 7) == 0)
+        {
+            if((i32Code >= 0) && (i32Code <= 0xFFFF))
+            {
+                ConvAddGlyph(i32Code, pui16Rows,
+                             (i32DWidth > 1) ? i32DWidth - 1 : 0);
+                ui32Count++;
+            }
+            i32Code = -1;
+            i32Row = -1;
+            continue;
+        }
+        if(i32Row < 0)
+        {
+            continue;
+        }
+
+        //
+        // One bitmap row, most significant bit leftmost
+        //
+        ui32Bits = strtoul(pcLine, 0, 16);
+        i32Top = i32Ascent - (i32Y + i32H) + i32Row;
+        i32Row++;
+        if((i32Top < 0) || (i32Top >= FONT_HEIGHT))
+        {
+            continue;
+        }
+        for(ui32Col = 0; (int32_t)ui32Col < i32W; ui32Col++)
+        {
+            if((ui32Bits >> (((i32W + 7) & ~7) - 1 - ui32Col)) & 1)
+            {
+                if((i32X + (int32_t)ui32Col >= 0) &&
+                   (i32X + (int32_t)ui32Col < 16))
+                {
+                    pui16Rows[i32Top] |= 1 << (i32X + ui32Col);
+                }
+            }
+        }
+    }
+    fclose(pFile);
+    fprintf(stderr, "%s: %u glyphs\n", pcFile, ui32Count);
+    return(0);
+}
+
+//*****************************************************************************
+//
+// PNG reader
+//
+//*****************************************************************************
+static int
+ConvReadPNG(const char *pcFile, uint32_t ui32First, bool bInvert)
+{
+#ifdef FONTCONV_PNG
+    png_image sImage;
+    uint8_t *pui8Pixels;
+    uint16_t pui16Rows[FONT_HEIGHT];
+    uint32_t ui32Cols, ui32Cells, ui32Cell, ui32Row, ui32Col;
+    uint8_t ui8Pixel;
+
+    memset(&sImage, 0, sizeof(sImage));
+    sImage.version = PNG_IMAGE_VERSION;
+    if(!png_image_begin_read_from_file(&sImage, pcFile))
+    {
+        fprintf(stderr, "%s: %s\n", pcFile, sImage.message);
+        return(1);
+    }
+    sImage.format = PNG_FORMAT_GRAY;
+    pui8Pixels = malloc(PNG_IMAGE_SIZE(sImage));
+    if(!pui8Pixels ||
+       !png_image_finish_read(&sImage, 0, pui8Pixels, 0, 0))
+    {
+        fprintf(stderr, "%s: %s\n", pcFile, sImage.message);
+        free(pui8Pixels);
+        return(1);
+    }
+
+    ui32Cols = sImage.width / 8;
+    ui32Cells = ui32Cols * (sImage.height / FONT_HEIGHT);
+    for(ui32Cell = 0; ui32Cell < ui32Cells; ui32Cell++)
+    {
+        for(ui32Row = 0; ui32Row < FONT_HEIGHT; ui32Row++)
+        {
+            pui16Rows[ui32Row] = 0;
+            for(ui32Col = 0; ui32Col < 8; ui32Col++)
+            {
+                ui8Pixel = pui8Pixels[((ui32Cell / ui32Cols) * FONT_HEIGHT +
+                                       ui32Row) * sImage.width +
+                                      (ui32Cell % ui32Cols) * 8 + ui32Col];
+                if((ui8Pixel >= 128) != bInvert)
+                {
+                    pui16Rows[ui32Row] |= 1 << ui32Col;
+                }
+            }
+        }
+        ConvAddGlyph(ui32First + ui32Cell, pui16Rows, 0);
+    }
+    free(pui8Pixels);
+    fprintf(stderr, "%s: %u glyphs from U+%04X\n", pcFile, ui32Cells,
+            ui32First);
+    return(0);
+#else
+    fprintf(stderr, "%s: fontconv was built without libpng\n", pcFile);
+    return(1);
+#endif
+}
+
+//*****************************************************************************
+//
+// Glyph encoding
+//
+//*****************************************************************************
+static void
+ConvEncode(tConvGlyph *psGlyph)
+{
+    uint8_t pui8Packed[8], pui8Runs[64];
+    uint32_t ui32Pixels, ui32Pixel, ui32Last, ui32Run, ui32NumRuns;
+    uint32_t ui32Packed, idx;
+    bool bLit, bPixel;
+
+    //
+    // Bit-packed, LSB first
+    //
+    ui32Pixels = FONT_HEIGHT * psGlyph->ui32Width;
+    memset(pui8Packed, 0, sizeof(pui8Packed));
+    ui32Last = 0;
+    for(ui32Pixel = 0; ui32Pixel < ui32Pixels; ui32Pixel++)
+    {
+        if((psGlyph->pui16Rows[ui32Pixel / psGlyph->ui32Width] >>
+            (ui32Pixel % psGlyph->ui32Width)) & 1)
+        {
+            pui8Packed[ui32Pixel / 8] |= 1 << (ui32Pixel % 8);
+            ui32Last = ui32Pixel + 1;
+        }
+    }
+    ui32Packed = (ui32Last + 7) / 8;
+
+    //
+    // Run lengths up to the last lit pixel
+    //
+    ui32NumRuns = 0;
+    bLit = false;
+    ui32Run = 0;
+    for(ui32Pixel = 0; ui32Pixel <= ui32Last; ui32Pixel++)
+    {
+        bPixel = (ui32Pixel < ui32Last) &&
+                 ((pui8Packed[ui32Pixel / 8] >> (ui32Pixel % 8)) & 1);
+        if((ui32Pixel < ui32Last) && (bPixel == bLit))
+        {
+            ui32Run++;
+            continue;
+        }
+        while(ui32Run >= 15)
+        {
+            pui8Runs[ui32NumRuns++] = 15;
+            ui32Run -= 15;
+        }
+        pui8Runs[ui32NumRuns++] = ui32Run;
+        bLit = !bLit;
+        ui32Run = 1;
+    }
+    if(ui32Last == 0)
+    {
+        ui32NumRuns = 0;
+    }
+
+    psGlyph->ui8Header = psGlyph->ui32Width - 1;
+    if(psGlyph->bMissing)
+    {
+        psGlyph->ui32Bytes = 0;
+        psGlyph->ui8Header = FONT_GLYPH_RLE;
+        return;
+    }
+    if((ui32NumRuns + 1) / 2 < ui32Packed)
+    {
+        psGlyph->ui32Bytes = (ui32NumRuns + 1) / 2;
+        memset(psGlyph->pui8Data, 0, sizeof(psGlyph->pui8Data));
+        for(idx = 0; idx < ui32NumRuns; idx++)
+        {
+            psGlyph->pui8Data[idx / 2] |= pui8Runs[idx] << (4 * (idx & 1));
+        }
+        psGlyph->ui8Header |= FONT_GLYPH_RLE;
+    }
+    else
+    {
+        psGlyph->ui32Bytes = ui32Packed;
+        memcpy(psGlyph->pui8Data, pui8Packed, ui32Packed);
+    }
+    psGlyph->ui8Header |= psGlyph->ui32Bytes << 4;
+}
+
+//
+// Check the encoding with the firmware decoder
+//
+static void
+ConvVerify(const tConvGlyph *psGlyph)
+{
+    uint8_t pui8Glyph[17], pui8Rows[FONT_HEIGHT];
+    uint32_t idx;
+
+    pui8Glyph[0] = psGlyph->ui8Header;
+    memcpy(pui8Glyph + 1, psGlyph->pui8Data, psGlyph->ui32Bytes);
+    FontGlyphDecode(pui8Glyph, pui8Rows);
+    for(idx = 0; idx < FONT_HEIGHT; idx++)
+    {
+        if(pui8Rows[idx] != psGlyph->pui16Rows[idx])
+        {
+            fprintf(stderr, "fontconv: U+%04X does not decode\n",
+                    psGlyph->ui32Code);
+            exit(1);
+        }
+    }
+}
+
+//
+// Mark short runs of missing codes inside the font rather than start a new
+// glyph set, which costs a tFontSet and an index entry
+//
+#define CONV_MAX_GAP        12
+
+static void
+ConvFillGaps(void)
+{
+    uint32_t idx, ui32Gap, ui32Code;
+
+    for(idx = 1; idx < g_ui32NumGlyphs; idx++)
+    {
+        ui32Gap = g_psGlyphs[idx].ui32Code - g_psGlyphs[idx - 1].ui32Code - 1;
+        if((ui32Gap == 0) || (ui32Gap > CONV_MAX_GAP) ||
+           (g_ui32NumGlyphs + ui32Gap > CONV_MAX_GLYPHS))
+        {
+            continue;
+        }
+        memmove(&g_psGlyphs[idx + ui32Gap], &g_psGlyphs[idx],
+                (g_ui32NumGlyphs - idx) * sizeof(g_psGlyphs[0]));
+        ui32Code = g_psGlyphs[idx - 1].ui32Code;
+        for(; ui32Gap; ui32Gap--, idx++, g_ui32NumGlyphs++)
+        {
+            memset(&g_psGlyphs[idx], 0, sizeof(g_psGlyphs[0]));
+            g_psGlyphs[idx].ui32Code = ++ui32Code;
+            g_psGlyphs[idx].bMissing = true;
+        }
+    }
+}
+
+static int
+ConvCompare(const void *pvA, const void *pvB)
+{
+    return((int)((const tConvGlyph *)pvA)->ui32Code -
+           (int)((const tConvGlyph *)pvB)->ui32Code);
+}
+
+//*****************************************************************************
+//
+// C source output
+//
+//*****************************************************************************
+static void
+ConvGlyphComment(FILE *pFile, uint32_t ui32Code)
+{
+    if((ui32Code >= 0x20) && (ui32Code < 0x7F))
+    {
+        fprintf(pFile, "// U+%04X (%c)\n", ui32Code, ui32Code);
+    }
+    else if(ui32Code < 0x800)
+    {
+        fprintf(pFile, "// U+%04X (%c%c)\n", ui32Code, 0xC0 | (ui32Code >> 6),
+                0x80 | (ui32Code & 0x3F));
+    }
+    else
+    {
+        fprintf(pFile, "// U+%04X (%c%c%c)\n", ui32Code,
+                0xE0 | (ui32Code >> 12), 0x80 | ((ui32Code >> 6) & 0x3F),
+                0x80 | (ui32Code & 0x3F));
+    }
+}
+
+static void
+ConvWrite(FILE *pFile, const char *pcName, uint32_t ui32Spacing,
+          uint32_t ui32Missing, const char *pcCommand)
+{
+    uint32_t ui32Set, ui32NumSets, ui32Start, ui32End, ui32Offset;
+    uint32_t idx, ui32Byte, ui32Total;
+    char pcFile[64];
+
+    for(idx = 0; pcName[idx] && (idx < sizeof(pcFile) - 1); idx++)
+    {
+        pcFile[idx] = tolower((unsigned char)pcName[idx]);
+    }
+    pcFile[idx] = 0;
+
+    fprintf(pFile,
+"//*****************************************************************************\n"
+"//\n"
+"// font_%s.c - Compressed %s font tables.\n"
+"//\n"
+"// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.\n"
+"//\n"
+"// This is part of revision 1.0 of the Idiotbox Firmware Package.\n"
+"//\n"
+"//*****************************************************************************\n"
+"\n"
+"//*****************************************************************************\n"
+"//\n"
+"// Generated by host/fontconv, do not edit:\n"
+"//   %s\n"
+"//\n"
+"//*****************************************************************************\n"
+"\n"
+"#include <stdint.h>\n"
+"#include \"font.h\"\n", pcFile, pcName, pcCommand);
+
+    ui32NumSets = 0;
+    ui32Total = 0;
+    for(ui32Start = 0; ui32Start < g_ui32NumGlyphs; ui32Start = ui32End)
+    {
+        for(ui32End = ui32Start + 1;
+            (ui32End < g_ui32NumGlyphs) &&
+            (g_psGlyphs[ui32End].ui32Code == g_psGlyphs[ui32End - 1].ui32Code + 1);
+            ui32End++)
+        {
+        }
+
+        fprintf(pFile, "\n//\n// U+%04X - U+%04X\n//\n", g_psGlyphs[ui32Start].ui32Code,
+                g_psGlyphs[ui32End - 1].ui32Code);
+        fprintf(pFile, "static const uint8_t g_pui8Font%sData%u[] = {\n",
+                pcName, ui32NumSets);
+        for(idx = ui32Start; idx < ui32End; idx++)
+        {
+            fprintf(pFile, "  0x%02X,", g_psGlyphs[idx].ui8Header);
+            for(ui32Byte = 0; ui32Byte < g_psGlyphs[idx].ui32Bytes; ui32Byte++)
+            {
+                fprintf(pFile, " 0x%02X,", g_psGlyphs[idx].pui8Data[ui32Byte]);
+            }
+            fprintf(pFile, "%*s", 6 * (8 - g_psGlyphs[idx].ui32Bytes) + 3, "");
+            if(g_psGlyphs[idx].bMissing)
+            {
+                fprintf(pFile, "// U+%04X missing\n", g_psGlyphs[idx].ui32Code);
+            }
+            else
+            {
+                ConvGlyphComment(pFile, g_psGlyphs[idx].ui32Code);
+            }
+            ui32Total += 1 + g_psGlyphs[idx].ui32Bytes;
+        }
+        fprintf(pFile, "};\n");
+
+        fprintf(pFile, "static const uint16_t g_pui16Font%sIndex%u[] = {\n ",
+                pcName, ui32NumSets);
+        ui32Offset = 0;
+        for(idx = ui32Start; idx < ui32End; idx++)
+        {
+            if((idx - ui32Start) % FONT_INDEX_STEP == 0)
+            {
+                fprintf(pFile, " %u,", ui32Offset);
+                ui32Total += 2;
+            }
+            ui32Offset += 1 + g_psGlyphs[idx].ui32Bytes;
+        }
+        fprintf(pFile, "\n};\n");
+        ui32NumSets++;
+    }
+
+    fprintf(pFile, "\nstatic const tFontSet g_psFont%sSets[%u] = {\n", pcName,
+            ui32NumSets);
+    ui32Set = 0;
+    for(ui32Start = 0; ui32Start < g_ui32NumGlyphs; ui32Start = ui32End)
+    {
+        for(ui32End = ui32Start + 1;
+            (ui32End < g_ui32NumGlyphs) &&
+            (g_psGlyphs[ui32End].ui32Code == g_psGlyphs[ui32End - 1].ui32Code + 1);
+            ui32End++)
+        {
+        }
+        fprintf(pFile, "  { 0x%04X, %u, g_pui16Font%sIndex%u, g_pui8Font%sData%u },\n",
+                g_psGlyphs[ui32Start].ui32Code, ui32End - ui32Start, pcName,
+                ui32Set, pcName, ui32Set);
+        ui32Set++;
+    }
+    fprintf(pFile, "};\n");
+    //
+    // A tFontSet is 12 bytes on the Cortex-M4
+    //
+    ui32Total += ui32NumSets * 12;
+    for(idx = 0, ui32Byte = 0; idx < g_ui32NumGlyphs; idx++)
+    {
+        ui32Byte += g_psGlyphs[idx].bMissing ? 0 : 1;
+    }
+
+    fprintf(pFile, "\nconst tFont g_sFont%s = {\n"
+            "  g_psFont%sSets, %u, %u, 0x%04X\n};\n", pcName, pcName,
+            ui32NumSets, ui32Spacing, ui32Missing);
+
+    fprintf(stderr, "%u glyphs in %u sets: %u bytes of flash, %.2f per "
+            "glyph (8x8 table: 8)\n", ui32Byte, ui32NumSets, ui32Total,
+            (double)ui32Total / ui32Byte);
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+    const char *pcName = "IdiotBox", *pcOut = 0, *pcExt;
+    uint32_t ui32Spacing = 1, ui32Missing = '?', ui32First = ' ', idx;
+    char pcCommand[512];
+    bool bInvert = false;
+    FILE *pFile;
+    int iOpt, iLen;
+
+    //
+    // Record the command line, without directories, in the output
+    //
+    iLen = snprintf(pcCommand, sizeof(pcCommand), "fontconv");
+    for(iOpt = 1; (iOpt < argc) && (iLen < (int)sizeof(pcCommand)); iOpt++)
+    {
+        pcExt = strrchr(argv[iOpt], '/');
+        iLen += snprintf(pcCommand + iLen, sizeof(pcCommand) - iLen, " %s",
+                         pcExt ? pcExt + 1 : argv[iOpt]);
+    }
+
+    //
+    // Options and inputs may be mixed; -c and -i apply to later PNG sheets.
+    //
+    while(optind < argc)
+    {
+        iOpt = getopt(argc, argv, "n:s:m:w:o:c:i");
+        if(iOpt == -1)
+        {
+            pcExt = strrchr(argv[optind], '.');
+            if(pcExt && (strcmp(pcExt, ".png") == 0))
+            {
+                if(ConvReadPNG(argv[optind], ui32First, bInvert))
+                {
+                    return(1);
+                }
+            }
+            else if(ConvReadBDF(argv[optind]))
+            {
+                return(1);
+            }
+            optind++;
+            continue;
+        }
+        switch(iOpt)
+        {
+            case 'n': pcName = optarg; break;
+            case 's': ui32Spacing = strtoul(optarg, 0, 0); break;
+            case 'm': ui32Missing = strtoul(optarg, 0, 0); break;
+            case 'w': g_ui32SpaceWidth = strtoul(optarg, 0, 0); break;
+            case 'o': pcOut = optarg; break;
+            case 'c': ui32First = strtoul(optarg, 0, 0); break;
+            case 'i': bInvert = true; break;
+            default:
+                fprintf(stderr, "usage: %s [-n name] [-s spacing] "
+                        "[-m missing] [-w space] [-o out.c] [-c first] [-i] "
+                        "font.bdf|sheet.png ...\n", argv[0]);
+                return(2);
+        }
+    }
+    if(g_ui32NumGlyphs == 0)
+    {
+        fprintf(stderr, "fontconv: no glyphs\n");
+        return(1);
+    }
+
+    qsort(g_psGlyphs, g_ui32NumGlyphs, sizeof(g_psGlyphs[0]), ConvCompare);
+    ConvFillGaps();
+    for(idx = 0; idx < g_ui32NumGlyphs; idx++)
+    {
+        ConvEncode(&g_psGlyphs[idx]);
+        if(!g_psGlyphs[idx].bMissing)
+        {
+            ConvVerify(&g_psGlyphs[idx]);
+        }
+    }
+
+    pFile = pcOut ? fopen(pcOut, "w") : stdout;
+    if(!pFile)
+    {
+        perror(pcOut);
+        return(1);
+    }
+    ConvWrite(pFile, pcName, ui32Spacing, ui32Missing, pcCommand);
+    if(pcOut)
+    {
+        fclose(pFile);
+    }
+    return(0);
+}
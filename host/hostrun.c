@@ -0,0 +1,471 @@
+//*****************************************************************************
+//
+// hostrun.c - Run the whole firmware on the host against a scripted keypad.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// ConfigureBoard runs once, then every 16kHz sample PWMIntHandler is called
+// and the main loop's RunTasks is called until only idle work is left, so
+// the tasks released by a new grayscale cycle all run before the next
+// sample. On the target they may take several samples. While the display is
+// parked the PWM DAC timer's interrupt is masked and PWMIntHandler is not
+// called; SysTick is counted down by a sample's cycles instead, calling
+// SysTickIntHandler each time it wraps. The firmware is built with
+// TRACE_ENABLE and the trace is written to a file for trace_replay.
+//
+// It is also built with SPECTRUM_ADC. The audio input is read from a file
+// of raw 16-bit little-endian mono samples at 16kHz, or, without one, is
+// the PWM DAC output looped back, as if the speaker played into the input.
+//
+// The firmware is built with LATENCY_ENABLE as well. Each scripted press is
+// timestamped when the key goes down, and the latency report is printed at
+// the end of the run.
+//
+// The DWT cycle counter is set from the sample tick, 2500 cycles a sample,
+// so boot takes no time and the boot report's time to the first frame is
+// that of the row pipeline alone. hostrun fails if that misses its target.
+//
+// With -u, UART0 receives from a serial line, usually the pseudo-terminal
+// of stream_send -p. The line carries STREAM_BAUD, 6.25 bytes a sample, and
+// hostrun waits on the sender for them, so the line is always full. The run
+// lasts until a stream has been shown and has ended, or the line has closed
+// with none showing, and fails if any frame was lost or damaged.
+//
+// With -e, telemetry records are sent from boot, as if a PC had asked for
+// them, among the console text on stdout for telemetry_decode.
+//
+// Usage: hostrun [-r rows] [-k tick:key] ... [-t trace.bin] [-a audio.raw]
+//                [-u line] [-e frames]
+//   -r  number of 2ms LED rows to run (default 400; ignored with -u)
+//   -k  from sample tick on, hold keypad key 0-15, or release it with '-'
+//   -t  write the event trace to this file
+//   -a  read the audio input from this file; silence after its end
+//   -u  receive frames on UART0 from this serial line
+//   -e  send a telemetry record every this many display frames
+//
+//*****************************************************************************
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/timer.h"
+#include "hostsim.h"
+#include "trace.h"
+#include "latency.h"
+#include "sched.h"
+#include "console.h"
+#include "boottime.h"
+#include "dwt.h"
+#include "stream.h"
+#include "telemetry.h"
+
+#define HOSTRUN_MAX_KEYS    64
+
+//
+// PWM DAC timer and period, for the audio loopback
+//
+#define HOSTRUN_PWM_BASE    TIMER1_BASE
+#define HOSTRUN_PWM_PERIOD  2500
+
+//
+// 40MHz CPU cycles per 16kHz sample
+//
+#define HOSTRUN_SAMPLE_CYCLES (HOST_SYSCLK_HZ / 16000)
+
+//
+// Seconds to wait for the serial line to appear, for a sender started
+// alongside
+//
+#define HOSTRUN_LINE_WAIT   5
+
+//*****************************************************************************
+//
+// Firmware entry points
+//
+//*****************************************************************************
+extern volatile uint32_t g_NewGSCycle;
+extern void ConfigureBoard(void);
+extern bool RunTasks(void);
+extern void PWMIntHandler(void);
+extern void SysTickIntHandler(void);
+
+//*****************************************************************************
+//
+// Keypad script
+//
+//*****************************************************************************
+static struct
+{
+    uint32_t ui32Tick;
+    int32_t i32Key;
+}
+g_psKeys[HOSTRUN_MAX_KEYS];
+static uint32_t g_ui32NumKeys;
+static int32_t g_i32HeldKey = -1;
+
+//
+// Keypad stand-in. A held key connects keypad row (key >> 2), driven on
+// port E, to column input (key & 3) on port B.
+//
+static int32_t
+HostRunGpioInput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    if((ui32Port == GPIO_PORTB_BASE) && (g_i32HeldKey >= 0) &&
+       (HostGpioGet(GPIO_PORTE_BASE) & (1 << (g_i32HeldKey >> 2))))
+    {
+        return(1 << (g_i32HeldKey & 3));
+    }
+    return(0);
+}
+
+//
+// Audio input stand-in: the next sample of the audio file, scaled to 12
+// bits, or the PWM DAC duty cycle.
+//
+static FILE *g_pAudioFile;
+
+static uint32_t
+HostRunAdcInput(uint32_t ui32Base)
+{
+    int16_t i16Sample;
+
+    if(g_pAudioFile)
+    {
+        if(fread(&i16Sample, sizeof(i16Sample), 1, g_pAudioFile) != 1)
+        {
+            return(HOST_ADC_MIDSCALE);
+        }
+        return((uint32_t)((i16Sample >> 4) + HOST_ADC_MIDSCALE));
+    }
+    return(HostTimerMatchGet(HOSTRUN_PWM_BASE, TIMER_A) * 4096 /
+           HOSTRUN_PWM_PERIOD);
+}
+
+static void
+HostRunUsage(const char *pcName)
+{
+    fprintf(stderr, "usage: %s [-r rows] [-k tick:key] ... [-t trace.bin] "
+            "[-a audio.raw] [-u line] [-e frames]\n", pcName);
+    exit(2);
+}
+
+//*****************************************************************************
+//
+// Serial line into UART0. Each sample earns the line STREAM_BAUD / 10 / 16000
+// bytes, in hundredths of a byte a sample, which are read from the line,
+// waiting for the sender, and handed to the uDMA stand-in.
+//
+//*****************************************************************************
+static int g_iLine = -1;
+static bool g_bLineClosed;
+static bool g_bStreamShown;
+static uint32_t g_ui32LineCredit;
+
+static void
+HostRunLineOpen(const char *pcLine)
+{
+    struct termios sTerm;
+    uint32_t ui32Wait;
+
+    for(ui32Wait = 0; ui32Wait < HOSTRUN_LINE_WAIT * 20; ui32Wait++)
+    {
+        g_iLine = open(pcLine, O_RDONLY | O_NOCTTY);
+        if((g_iLine >= 0) || (errno != ENOENT))
+        {
+            break;
+        }
+        usleep(50000);
+    }
+    if(g_iLine < 0)
+    {
+        perror(pcLine);
+        exit(1);
+    }
+
+    //
+    // Raw 8-bit bytes; a pseudo-terminal takes no rate
+    //
+    if(tcgetattr(g_iLine, &sTerm) == 0)
+    {
+        cfmakeraw(&sTerm);
+        cfsetspeed(&sTerm, B1000000);
+        tcsetattr(g_iLine, TCSANOW, &sTerm);
+    }
+}
+
+static void
+HostRunLineTick(void)
+{
+    uint8_t pui8Data[16];
+    uint32_t ui32Count, ui32Read;
+    ssize_t iRead;
+
+    g_ui32LineCredit += STREAM_BAUD / 10 / 100;
+    ui32Count = g_ui32LineCredit / (TRACE_TICK_HZ / 100);
+    g_ui32LineCredit -= ui32Count * (TRACE_TICK_HZ / 100);
+
+    for(ui32Read = 0; !g_bLineClosed && (ui32Read < ui32Count); )
+    {
+        iRead = read(g_iLine, pui8Data + ui32Read, ui32Count - ui32Read);
+        if(iRead > 0)
+        {
+            ui32Read += iRead;
+        }
+        else if((iRead == 0) || (errno != EINTR))
+        {
+            //
+            // End of file, or EIO from a pseudo-terminal whose sender
+            // has gone
+            //
+            g_bLineClosed = true;
+        }
+    }
+    if(ui32Read && HostUartReceive(UART0_BASE, pui8Data, ui32Read))
+    {
+        StreamIntHandler();
+    }
+}
+
+static bool
+HostRunLineDone(void)
+{
+    if(StreamActive())
+    {
+        g_bStreamShown = true;
+        return(false);
+    }
+    return(g_bStreamShown || g_bLineClosed);
+}
+
+//*****************************************************************************
+//
+// Trace file output. The header is rewritten with the final count at close.
+//
+//*****************************************************************************
+static FILE *g_pTraceFile;
+static tTraceHeader g_sTraceHeader;
+
+static void
+HostRunTraceDrain(void)
+{
+    tTraceRecord psRecords[64];
+    uint32_t ui32Count;
+
+    while((ui32Count = TraceRead(psRecords, 64)) != 0)
+    {
+        if(g_pTraceFile)
+        {
+            fwrite(psRecords, sizeof(tTraceRecord), ui32Count, g_pTraceFile);
+        }
+        g_sTraceHeader.ui32Count += ui32Count;
+    }
+}
+
+static void
+HostRunTraceWriteHeader(void)
+{
+    g_sTraceHeader.ui32Magic = TRACE_MAGIC;
+    g_sTraceHeader.ui16Version = TRACE_VERSION;
+    g_sTraceHeader.ui16RecordSize = sizeof(tTraceRecord);
+    g_sTraceHeader.ui32TickHz = TRACE_TICK_HZ;
+    g_sTraceHeader.ui32Capacity = g_sTraceHeader.ui32Count;
+    g_sTraceHeader.ui32Head = 0;
+    fseek(g_pTraceFile, 0, SEEK_SET);
+    fwrite(&g_sTraceHeader, sizeof(g_sTraceHeader), 1, g_pTraceFile);
+}
+
+//
+// Whether PWMIntHandler runs: a parked display masks the PWM DAC timer's
+// interrupt, leaving the timer running at the midpoint
+//
+static bool
+HostRunPwmInt(void)
+{
+    return(HostTimerEnabled(HOSTRUN_PWM_BASE, TIMER_A) &&
+           HostTimerIntEnabled(HOSTRUN_PWM_BASE, TIMER_CAPA_EVENT));
+}
+
+//
+// Timestamp a scripted press. The latency counter keeps step with the
+// sample tick, one ahead once the sample's interrupt has run, but while the
+// display is parked SysTick moves it only a row at a time, so the press is
+// stamped with the sample it fell in.
+//
+static void
+HostRunLatencyPress(uint32_t ui32Tick)
+{
+    uint32_t ui32Saved;
+
+    if(HostRunPwmInt())
+    {
+        LatencyPress();
+        return;
+    }
+    ui32Saved = g_ui32LatencyTick;
+    g_ui32LatencyTick = ui32Tick;
+    LatencyPress();
+    g_ui32LatencyTick = ui32Saved;
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+    uint32_t ui32Rows = 400, ui32Tick, ui32NextKey, ui32Telemetry = 0;
+    const char *pcTrace = NULL, *pcLine = NULL;
+    const tStreamStats *psStream;
+    char *pcSep;
+    int iOpt;
+
+    while((iOpt = getopt(argc, argv, "r:k:t:a:u:e:")) != -1)
+    {
+        switch(iOpt)
+        {
+            case 'r':
+                ui32Rows = strtoul(optarg, NULL, 0);
+                break;
+            case 'k':
+                pcSep = strchr(optarg, ':');
+                if(!pcSep || (g_ui32NumKeys == HOSTRUN_MAX_KEYS))
+                {
+                    HostRunUsage(argv[0]);
+                }
+                g_psKeys[g_ui32NumKeys].ui32Tick = strtoul(optarg, NULL, 0);
+                g_psKeys[g_ui32NumKeys].i32Key =
+                    (pcSep[1] == '-') ? -1 : (atoi(pcSep + 1) & 0xF);
+                g_ui32NumKeys++;
+                break;
+            case 't':
+                pcTrace = optarg;
+                break;
+            case 'a':
+                g_pAudioFile = fopen(optarg, "rb");
+                if(!g_pAudioFile)
+                {
+                    perror(optarg);
+                    return(1);
+                }
+                break;
+            case 'u':
+                pcLine = optarg;
+                break;
+            case 'e':
+                ui32Telemetry = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                HostRunUsage(argv[0]);
+        }
+    }
+
+    if(pcTrace)
+    {
+        g_pTraceFile = fopen(pcTrace, "wb");
+        if(!g_pTraceFile)
+        {
+            perror(pcTrace);
+            return(1);
+        }
+        HostRunTraceWriteHeader();
+    }
+
+    if(pcLine)
+    {
+        HostRunLineOpen(pcLine);
+    }
+
+    HostReset();
+    g_pfnHostGpioInput = HostRunGpioInput;
+    g_pfnHostAdcInput = HostRunAdcInput;
+    g_bHostConsole = true;
+
+    ConfigureBoard();
+    TelemetrySetPeriod(ui32Telemetry);
+    IntMasterEnable();
+
+    ui32NextKey = 0;
+    for(ui32Tick = 0;
+        pcLine ? !HostRunLineDone() : (ui32Tick < ui32Rows * 32);
+        ui32Tick++)
+    {
+        while((ui32NextKey < g_ui32NumKeys) &&
+              (g_psKeys[ui32NextKey].ui32Tick <= ui32Tick))
+        {
+            if((g_psKeys[ui32NextKey].i32Key >= 0) &&
+               (g_psKeys[ui32NextKey].i32Key != g_i32HeldKey))
+            {
+                HostRunLatencyPress(ui32Tick);
+            }
+            g_i32HeldKey = g_psKeys[ui32NextKey++].i32Key;
+        }
+
+        if(pcLine)
+        {
+            HostRunLineTick();
+        }
+
+        DWTCycles() = ui32Tick * HOSTRUN_SAMPLE_CYCLES;
+        if(HostRunPwmInt())
+        {
+            PWMIntHandler();
+        }
+        if(HostSysTickElapsed(HOSTRUN_SAMPLE_CYCLES))
+        {
+            SysTickIntHandler();
+        }
+        while(RunTasks())
+        {
+        }
+        HostRunTraceDrain();
+    }
+    LatencyReport();
+    ConsoleFlush();
+    SchedReport();
+    ConsoleFlush();
+
+    if(g_pTraceFile)
+    {
+        HostRunTraceWriteHeader();
+        fclose(g_pTraceFile);
+        printf("%u trace records written to %s\n",
+               g_sTraceHeader.ui32Count, pcTrace);
+    }
+
+    if(BootTimeFirstFrameUs() > BOOT_FIRST_FRAME_TARGET_US)
+    {
+        fprintf(stderr, "first frame after %u us, target %u us\n",
+                BootTimeFirstFrameUs(), BOOT_FIRST_FRAME_TARGET_US);
+        return(1);
+    }
+
+    if(pcLine)
+    {
+        close(g_iLine);
+        psStream = StreamStats();
+        if(psStream->ui32Dropped || psStream->ui32Errors ||
+           psStream->ui32Overruns || g_ui32HostUartOverruns)
+        {
+            fprintf(stderr, "stream lost %u frames, %u damaged, %u ring and "
+                    "%u FIFO overruns\n", psStream->ui32Dropped,
+                    psStream->ui32Errors, psStream->ui32Overruns,
+                    g_ui32HostUartOverruns);
+            return(1);
+        }
+    }
+    return(0);
+}
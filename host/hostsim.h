@@ -0,0 +1,70 @@
+//*****************************************************************************
+//
+// hostsim.h - Control interface for the host build stand-in peripherals.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __HOSTSIM_H__
+#define __HOSTSIM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+//
+// Cortex-M4 cost model charges for stand-in peripheral calls, in CPU cycles
+// at 40MHz. A ROM driverlib call costs a BL/BX pair plus argument setup; an
+// APB register access adds one wait state over a plain store.
+//
+//*****************************************************************************
+#define HOST_CYCLES_CALL        6
+#define HOST_CYCLES_APB         2
+#define HOST_SYSCLK_HZ          40000000
+
+//
+// 12-bit ADC reading for a silent input
+//
+#define HOST_ADC_MIDSCALE       2048
+
+//
+// Cycles charged so far by the stand-in peripherals
+//
+extern uint64_t g_ui64HostPeriphCycles;
+
+//
+// Optional hook returning the input level of GPIO pins. When NULL the
+// latched output value is returned.
+//
+extern int32_t (*g_pfnHostGpioInput)(uint32_t ui32Port, uint8_t ui8Pins);
+
+//
+// Optional hook returning the 12-bit ADC input converted by each trigger.
+// When NULL the input is silent, HOST_ADC_MIDSCALE.
+//
+extern uint32_t (*g_pfnHostAdcInput)(uint32_t ui32Base);
+
+//
+// Echo UART output to stdout when true
+//
+extern bool g_bHostConsole;
+
+//
+// Bytes received by a UART with nowhere to go: its receive uDMA channel was
+// not enabled or had stopped
+//
+extern uint32_t g_ui32HostUartOverruns;
+
+extern void HostReset(void);
+extern uint32_t HostUartReceive(uint32_t ui32Base, const uint8_t *pui8Data,
+                                uint32_t ui32Count);
+extern uint8_t HostGpioGet(uint32_t ui32Port);
+extern uint32_t HostTimerMatchGet(uint32_t ui32Base, uint32_t ui32Timer);
+extern bool HostTimerEnabled(uint32_t ui32Base, uint32_t ui32Timer);
+extern bool HostTimerIntEnabled(uint32_t ui32Base, uint32_t ui32IntFlags);
+extern bool HostSysTickElapsed(uint32_t ui32Cycles);
+
+#endif // __HOSTSIM_H__
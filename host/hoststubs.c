@@ -0,0 +1,831 @@
+//*****************************************************************************
+//
+// hoststubs.c - Stand-in TivaWare peripherals for the Linux host build.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// These functions replace driverlib and uartstdio so the firmware sources
+// compile and run unchanged on Linux. Each call latches the value the real
+// peripheral would hold and charges an estimated Cortex-M4 cycle cost to
+// g_ui64HostPeriphCycles. Nothing here models timing; the harness decides
+// when interrupt handlers run.
+//
+//*****************************************************************************
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "inc/hw_memmap.h"
+#include "inc/hw_ssi.h"
+#include "inc/hw_types.h"
+#include "driverlib/adc.h"
+#include "driverlib/fpu.h"
+#include "driverlib/gpio.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/ssi.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
+#include "driverlib/timer.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "utils/uartstdio.h"
+#include "utils/ustdlib.h"
+#include "hostsim.h"
+
+//*****************************************************************************
+//
+// Simulated state
+//
+//*****************************************************************************
+
+uint64_t g_ui64HostPeriphCycles;
+int32_t (*g_pfnHostGpioInput)(uint32_t ui32Port, uint8_t ui8Pins);
+uint32_t (*g_pfnHostAdcInput)(uint32_t ui32Base);
+bool g_bHostConsole;
+static bool g_bHostIntMasked;
+
+#define HOST_NUM_REGS 32
+static struct
+{
+    uint32_t ui32Addr;
+    volatile uint32_t ui32Value;
+} g_sHostRegs[HOST_NUM_REGS];
+
+#define HOST_NUM_PORTS 6
+static uint8_t g_ui8GpioOut[HOST_NUM_PORTS];
+
+//
+// Last ADC conversion result
+//
+static uint32_t g_ui32HostAdcSample;
+
+#define HOST_NUM_TIMERS 4
+static struct
+{
+    uint32_t ui32Base;
+    uint32_t ui32MatchA, ui32MatchB;
+    uint32_t ui32IntFlags;
+    bool bEnabledA, bEnabledB;
+} g_sHostTimers[HOST_NUM_TIMERS];
+
+//
+// SysTick: whether it counts and interrupts, its period and the cycles left
+// to its next interrupt
+//
+static struct
+{
+    bool bEnabled, bIntEnabled;
+    uint32_t ui32Period, ui32Current;
+} g_sHostSysTick;
+
+//
+// uDMA channels: the primary and alternate transfer of each, the one in use
+// and whether the channel is enabled. The control table in target memory is
+// not used.
+//
+#define HOST_NUM_DMA 32
+typedef struct
+{
+    uint32_t ui32Mode;
+    uint8_t *pui8Dst;
+    uint32_t ui32Size;
+} tHostDmaXfer;
+
+static struct
+{
+    tHostDmaXfer psXfer[2];
+    uint32_t ui32Active;
+    bool bEnabled;
+} g_sHostDma[HOST_NUM_DMA];
+
+//
+// UART0 receives through uDMA when enabled by UARTDMAEnable
+//
+static bool g_bHostUartDmaRx;
+uint32_t g_ui32HostUartOverruns;
+
+//*****************************************************************************
+//
+// Helpers
+//
+//*****************************************************************************
+static uint32_t
+HostPortIndex(uint32_t ui32Port)
+{
+    switch(ui32Port)
+    {
+        case GPIO_PORTA_BASE: return(0);
+        case GPIO_PORTB_BASE: return(1);
+        case GPIO_PORTC_BASE: return(2);
+        case GPIO_PORTD_BASE: return(3);
+        case GPIO_PORTE_BASE: return(4);
+        default:              return(5);
+    }
+}
+
+static uint32_t
+HostTimerIndex(uint32_t ui32Base)
+{
+    uint32_t idx;
+
+    for(idx = 0; idx < HOST_NUM_TIMERS; idx++)
+    {
+        if((g_sHostTimers[idx].ui32Base == ui32Base) ||
+           (g_sHostTimers[idx].ui32Base == 0))
+        {
+            g_sHostTimers[idx].ui32Base = ui32Base;
+            return(idx);
+        }
+    }
+    return(HOST_NUM_TIMERS - 1);
+}
+
+//
+// Transfer for a channel number ORed with UDMA_PRI_SELECT or UDMA_ALT_SELECT
+//
+static tHostDmaXfer *
+HostDmaXfer(uint32_t ui32ChannelStructIndex)
+{
+    return(&g_sHostDma[ui32ChannelStructIndex & 0x1F].psXfer[
+        (ui32ChannelStructIndex & UDMA_ALT_SELECT) ? 1 : 0]);
+}
+
+volatile uint32_t *
+HostRegister(uint32_t ui32Addr)
+{
+    uint32_t idx;
+
+    for(idx = 0; idx < HOST_NUM_REGS; idx++)
+    {
+        if((g_sHostRegs[idx].ui32Addr == ui32Addr) ||
+           (g_sHostRegs[idx].ui32Addr == 0))
+        {
+            g_sHostRegs[idx].ui32Addr = ui32Addr;
+            return(&g_sHostRegs[idx].ui32Value);
+        }
+    }
+    return(&g_sHostRegs[HOST_NUM_REGS - 1].ui32Value);
+}
+
+void
+HostReset(void)
+{
+    memset((void *)g_sHostRegs, 0, sizeof(g_sHostRegs));
+    memset(g_ui8GpioOut, 0, sizeof(g_ui8GpioOut));
+    memset(g_sHostTimers, 0, sizeof(g_sHostTimers));
+    memset(&g_sHostSysTick, 0, sizeof(g_sHostSysTick));
+    memset(g_sHostDma, 0, sizeof(g_sHostDma));
+    g_bHostUartDmaRx = false;
+    g_ui32HostUartOverruns = 0;
+    g_ui32HostAdcSample = HOST_ADC_MIDSCALE;
+    g_ui64HostPeriphCycles = 0;
+}
+
+//
+// Bytes arriving at UART0, moved by its receive uDMA channel as the real
+// one would be, switching between primary and alternate transfers in
+// ping-pong mode. Returns the number of transfers completed; the harness
+// runs the UART interrupt handler when that is not 0.
+//
+uint32_t
+HostUartReceive(uint32_t ui32Base, const uint8_t *pui8Data, uint32_t ui32Count)
+{
+    uint32_t ui32Run, ui32Done, ui32Channel;
+    tHostDmaXfer *psXfer;
+
+    //
+    // Bytes are moved in runs to the end of the current transfer, as the
+    // bus does it without the CPU
+    //
+    ui32Channel = UDMA_CHANNEL_UART0RX;
+    ui32Done = 0;
+    while(ui32Count)
+    {
+        psXfer = &g_sHostDma[ui32Channel].psXfer[
+            g_sHostDma[ui32Channel].ui32Active];
+        if((ui32Base != UART0_BASE) || !g_bHostUartDmaRx ||
+           !g_sHostDma[ui32Channel].bEnabled ||
+           (psXfer->ui32Mode == UDMA_MODE_STOP))
+        {
+            g_ui32HostUartOverruns += ui32Count;
+            break;
+        }
+        ui32Run = (ui32Count < psXfer->ui32Size) ? ui32Count :
+                                                   psXfer->ui32Size;
+        memcpy(psXfer->pui8Dst, pui8Data, ui32Run);
+        psXfer->pui8Dst += ui32Run;
+        psXfer->ui32Size -= ui32Run;
+        pui8Data += ui32Run;
+        ui32Count -= ui32Run;
+        if(psXfer->ui32Size == 0)
+        {
+            //
+            // A ping-pong channel carries on with the other transfer if it
+            // is set up, and otherwise stops
+            //
+            ui32Done++;
+            if(psXfer->ui32Mode == UDMA_MODE_PINGPONG)
+            {
+                g_sHostDma[ui32Channel].ui32Active ^= 1;
+            }
+            psXfer->ui32Mode = UDMA_MODE_STOP;
+            if(g_sHostDma[ui32Channel].psXfer[
+                   g_sHostDma[ui32Channel].ui32Active].ui32Mode ==
+               UDMA_MODE_STOP)
+            {
+                g_sHostDma[ui32Channel].bEnabled = false;
+            }
+        }
+    }
+    return(ui32Done);
+}
+
+uint8_t
+HostGpioGet(uint32_t ui32Port)
+{
+    return(g_ui8GpioOut[HostPortIndex(ui32Port)]);
+}
+
+uint32_t
+HostTimerMatchGet(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    uint32_t idx = HostTimerIndex(ui32Base);
+
+    return((ui32Timer == TIMER_B) ? g_sHostTimers[idx].ui32MatchB :
+                                    g_sHostTimers[idx].ui32MatchA);
+}
+
+bool
+HostTimerEnabled(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    uint32_t idx = HostTimerIndex(ui32Base);
+
+    return((ui32Timer == TIMER_B) ? g_sHostTimers[idx].bEnabledB :
+                                    g_sHostTimers[idx].bEnabledA);
+}
+
+bool
+HostTimerIntEnabled(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    return((g_sHostTimers[HostTimerIndex(ui32Base)].ui32IntFlags &
+            ui32IntFlags) != 0);
+}
+
+//*****************************************************************************
+//
+// GPIO
+//
+//*****************************************************************************
+void
+GPIOPinWrite(uint32_t ui32Port, uint8_t ui8Pins, uint8_t ui8Val)
+{
+    uint8_t *pui8Out = &g_ui8GpioOut[HostPortIndex(ui32Port)];
+
+    *pui8Out = (*pui8Out & ~ui8Pins) | (ui8Val & ui8Pins);
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+int32_t
+GPIOPinRead(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+    if(g_pfnHostGpioInput)
+    {
+        return(g_pfnHostGpioInput(ui32Port, ui8Pins) & ui8Pins);
+    }
+    return(g_ui8GpioOut[HostPortIndex(ui32Port)] & ui8Pins);
+}
+
+void
+GPIODirModeSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32PinIO)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+GPIOPadConfigSet(uint32_t ui32Port, uint8_t ui8Pins, uint32_t ui32Strength,
+                 uint32_t ui32PadType)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4 * HOST_CYCLES_APB;
+}
+
+void
+GPIOPinConfigure(uint32_t ui32PinConfig)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+GPIOPinTypeADC(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4 * HOST_CYCLES_APB;
+}
+
+void
+GPIOPinTypeGPIOInput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4 * HOST_CYCLES_APB;
+}
+
+void
+GPIOPinTypeGPIOOutput(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4 * HOST_CYCLES_APB;
+}
+
+void
+GPIOPinTypeSSI(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4 * HOST_CYCLES_APB;
+}
+
+void
+GPIOPinTypeTimer(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4 * HOST_CYCLES_APB;
+}
+
+void
+GPIOPinTypeUART(uint32_t ui32Port, uint8_t ui8Pins)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4 * HOST_CYCLES_APB;
+}
+
+//*****************************************************************************
+//
+// Timers
+//
+//*****************************************************************************
+void
+TimerEnable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    uint32_t idx = HostTimerIndex(ui32Base);
+
+    g_sHostTimers[idx].bEnabledA |= (ui32Timer & TIMER_A) != 0;
+    g_sHostTimers[idx].bEnabledB |= (ui32Timer & TIMER_B) != 0;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+TimerDisable(uint32_t ui32Base, uint32_t ui32Timer)
+{
+    uint32_t idx = HostTimerIndex(ui32Base);
+
+    if(ui32Timer & TIMER_A)
+    {
+        g_sHostTimers[idx].bEnabledA = false;
+    }
+    if(ui32Timer & TIMER_B)
+    {
+        g_sHostTimers[idx].bEnabledB = false;
+    }
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+TimerMatchSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    uint32_t idx = HostTimerIndex(ui32Base);
+
+    if(ui32Timer & TIMER_A)
+    {
+        g_sHostTimers[idx].ui32MatchA = ui32Value;
+    }
+    if(ui32Timer & TIMER_B)
+    {
+        g_sHostTimers[idx].ui32MatchB = ui32Value;
+    }
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+TimerConfigure(uint32_t ui32Base, uint32_t ui32Config)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 3 * HOST_CYCLES_APB;
+}
+
+void
+TimerControlEvent(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Event)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+TimerLoadSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+TimerPrescaleSet(uint32_t ui32Base, uint32_t ui32Timer, uint32_t ui32Value)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+TimerPrescaleMatchSet(uint32_t ui32Base, uint32_t ui32Timer,
+                      uint32_t ui32Value)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+TimerIntEnable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_sHostTimers[HostTimerIndex(ui32Base)].ui32IntFlags |= ui32IntFlags;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+TimerIntDisable(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_sHostTimers[HostTimerIndex(ui32Base)].ui32IntFlags &= ~ui32IntFlags;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+TimerIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+//*****************************************************************************
+//
+// SysTick. Enabling it starts a full period, as if the current value had
+// been cleared first; HostSysTickElapsed runs it.
+//
+//*****************************************************************************
+void
+SysTickEnable(void)
+{
+    g_sHostSysTick.bEnabled = true;
+    g_sHostSysTick.ui32Current = g_sHostSysTick.ui32Period;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+SysTickDisable(void)
+{
+    g_sHostSysTick.bEnabled = false;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+SysTickIntEnable(void)
+{
+    g_sHostSysTick.bIntEnabled = true;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+SysTickIntDisable(void)
+{
+    g_sHostSysTick.bIntEnabled = false;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+SysTickPeriodSet(uint32_t ui32Period)
+{
+    g_sHostSysTick.ui32Period = ui32Period;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+//
+// Count SysTick down by ui32Cycles and return true if it reached zero with
+// its interrupt enabled, reloading it
+//
+bool
+HostSysTickElapsed(uint32_t ui32Cycles)
+{
+    if(!g_sHostSysTick.bEnabled || !g_sHostSysTick.ui32Period)
+    {
+        return(false);
+    }
+    if(g_sHostSysTick.ui32Current > ui32Cycles)
+    {
+        g_sHostSysTick.ui32Current -= ui32Cycles;
+        return(false);
+    }
+    g_sHostSysTick.ui32Current += g_sHostSysTick.ui32Period - ui32Cycles;
+    return(g_sHostSysTick.bIntEnabled);
+}
+
+//*****************************************************************************
+//
+// SSI
+//
+//*****************************************************************************
+void
+SSIConfigSetExpClk(uint32_t ui32Base, uint32_t ui32SSIClk,
+                   uint32_t ui32Protocol, uint32_t ui32Mode,
+                   uint32_t ui32BitRate, uint32_t ui32DataWidth)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 3 * HOST_CYCLES_APB;
+}
+
+void
+SSIEnable(uint32_t ui32Base)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+SSIDisable(uint32_t ui32Base)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+SSIDataPut(uint32_t ui32Base, uint32_t ui32Data)
+{
+    HWREG(ui32Base + SSI_O_DR) = ui32Data;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 2 * HOST_CYCLES_APB;
+}
+
+bool
+SSIBusy(uint32_t ui32Base)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+    return(false);
+}
+
+//*****************************************************************************
+//
+// ADC. A processor trigger converts the input at once.
+//
+//*****************************************************************************
+void
+ADCSequenceConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                     uint32_t ui32Trigger, uint32_t ui32Priority)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 3 * HOST_CYCLES_APB;
+}
+
+void
+ADCSequenceStepConfigure(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                         uint32_t ui32Step, uint32_t ui32Config)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4 * HOST_CYCLES_APB;
+}
+
+void
+ADCSequenceEnable(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+ADCProcessorTrigger(uint32_t ui32Base, uint32_t ui32SequenceNum)
+{
+    g_ui32HostAdcSample = g_pfnHostAdcInput ? g_pfnHostAdcInput(ui32Base) :
+                                              HOST_ADC_MIDSCALE;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+int32_t
+ADCSequenceDataGet(uint32_t ui32Base, uint32_t ui32SequenceNum,
+                   uint32_t *pui32Buffer)
+{
+    *pui32Buffer = g_ui32HostAdcSample;
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 2 * HOST_CYCLES_APB;
+    return(1);
+}
+
+//*****************************************************************************
+//
+// System control, interrupts and FPU
+//
+//*****************************************************************************
+void
+SysCtlPeripheralEnable(uint32_t ui32Peripheral)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+SysCtlClockSet(uint32_t ui32Config)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL;
+}
+
+uint32_t
+SysCtlClockGet(void)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL;
+    return(HOST_SYSCLK_HZ);
+}
+
+void
+SysCtlDelay(uint32_t ui32Count)
+{
+    //
+    // The real loop is three cycles per count.
+    //
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 3 * ui32Count;
+}
+
+bool
+IntMasterEnable(void)
+{
+    bool bWasMasked = g_bHostIntMasked;
+
+    g_bHostIntMasked = false;
+    return(bWasMasked);
+}
+
+bool
+IntMasterDisable(void)
+{
+    bool bWasMasked = g_bHostIntMasked;
+
+    g_bHostIntMasked = true;
+    return(bWasMasked);
+}
+
+void
+IntEnable(uint32_t ui32Interrupt)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+IntDisable(uint32_t ui32Interrupt)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+FPULazyStackingEnable(void)
+{
+}
+
+//*****************************************************************************
+//
+// UART console
+//
+//*****************************************************************************
+void
+UARTClockSourceSet(uint32_t ui32Base, uint32_t ui32Source)
+{
+}
+
+void
+UARTStdioConfig(uint32_t ui32Port, uint32_t ui32Baud, uint32_t ui32SrcClock)
+{
+}
+
+//
+// The transmit FIFO never fills; every byte goes straight to stdout
+//
+bool
+UARTCharPutNonBlocking(uint32_t ui32Base, unsigned char ucData)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 2 * HOST_CYCLES_APB;
+    if(g_bHostConsole)
+    {
+        putchar(ucData);
+    }
+    return(true);
+}
+
+void
+UARTFIFOLevelSet(uint32_t ui32Base, uint32_t ui32TxLevel,
+                 uint32_t ui32RxLevel)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+UARTDMAEnable(uint32_t ui32Base, uint32_t ui32DMAFlags)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 2 * HOST_CYCLES_APB;
+    if((ui32Base == UART0_BASE) && (ui32DMAFlags & UART_DMA_RX))
+    {
+        g_bHostUartDmaRx = true;
+    }
+}
+
+uint32_t
+UARTIntStatus(uint32_t ui32Base, bool bMasked)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+    return(0);
+}
+
+void
+UARTIntClear(uint32_t ui32Base, uint32_t ui32IntFlags)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+UARTprintf(const char *pcString, ...)
+{
+    va_list vaArgP;
+
+    if(g_bHostConsole)
+    {
+        va_start(vaArgP, pcString);
+        vprintf(pcString, vaArgP);
+        va_end(vaArgP);
+    }
+}
+
+//*****************************************************************************
+//
+// uDMA
+//
+//*****************************************************************************
+void
+uDMAEnable(void)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+uDMAControlBaseSet(void *pControlTable)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+}
+
+void
+uDMAChannelAssign(uint32_t ui32Mapping)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 2 * HOST_CYCLES_APB;
+}
+
+void
+uDMAChannelAttributeDisable(uint32_t ui32ChannelNum, uint32_t ui32Attr)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4 * HOST_CYCLES_APB;
+    if(ui32Attr & UDMA_ATTR_ALTSELECT)
+    {
+        g_sHostDma[ui32ChannelNum & 0x1F].ui32Active = 0;
+    }
+}
+
+void
+uDMAChannelControlSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Control)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4;
+}
+
+//
+// The real call works out end pointers and writes the control word to the
+// table in SRAM, no APB access
+//
+void
+uDMAChannelTransferSet(uint32_t ui32ChannelStructIndex, uint32_t ui32Mode,
+                       void *pvSrcAddr, void *pvDstAddr,
+                       uint32_t ui32TransferSize)
+{
+    tHostDmaXfer *psXfer = HostDmaXfer(ui32ChannelStructIndex);
+
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 20;
+    psXfer->ui32Mode = ui32Mode;
+    psXfer->pui8Dst = pvDstAddr;
+    psXfer->ui32Size = ui32TransferSize;
+}
+
+void
+uDMAChannelEnable(uint32_t ui32ChannelNum)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + HOST_CYCLES_APB;
+    g_sHostDma[ui32ChannelNum & 0x1F].bEnabled = true;
+}
+
+uint32_t
+uDMAChannelModeGet(uint32_t ui32ChannelStructIndex)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 4;
+    return(HostDmaXfer(ui32ChannelStructIndex)->ui32Mode);
+}
+
+//
+// Transfers left, or 0 once stopped
+//
+uint32_t
+uDMAChannelSizeGet(uint32_t ui32ChannelStructIndex)
+{
+    g_ui64HostPeriphCycles += HOST_CYCLES_CALL + 6;
+    return(HostDmaXfer(ui32ChannelStructIndex)->ui32Size);
+}
+
+//*****************************************************************************
+//
+// String formatting. The C library takes every format uvsnprintf does.
+//
+//*****************************************************************************
+int
+uvsnprintf(char *pcBuf, uint32_t ui32Size, const char *pcString,
+           va_list vaArgP)
+{
+    return(vsnprintf(pcBuf, ui32Size, pcString, vaArgP));
+}
@@ -0,0 +1,18 @@
+//*****************************************************************************
+//
+// hw_ints.h - Host stand-in for the TM4C123 interrupt assignments.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __HW_INTS_H__
+#define __HW_INTS_H__
+
+#define INT_UART0               21
+#define INT_TIMER1A             37
+#define INT_WTIMER3A            116
+
+#endif // __HW_INTS_H__
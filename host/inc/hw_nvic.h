@@ -0,0 +1,17 @@
+//*****************************************************************************
+//
+// hw_nvic.h - Host stand-in for the NVIC register definitions.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __HW_NVIC_H__
+#define __HW_NVIC_H__
+
+#define NVIC_ST_CURRENT         0xE000E018
+#define NVIC_DBG_INT            0xE000EDF0
+
+#endif // __HW_NVIC_H__
@@ -0,0 +1,19 @@
+//*****************************************************************************
+//
+// hw_ssi.h - Host stand-in for the SSI register offsets.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __HW_SSI_H__
+#define __HW_SSI_H__
+
+#define SSI_O_CR0               0x00000000
+#define SSI_O_CR1               0x00000004
+#define SSI_O_DR                0x00000008
+#define SSI_O_SR                0x0000000C
+
+#endif // __HW_SSI_H__
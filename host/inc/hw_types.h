@@ -0,0 +1,31 @@
+//*****************************************************************************
+//
+// hw_types.h - Host stand-in for the TivaWare common type definitions.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __HW_TYPES_H__
+#define __HW_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//*****************************************************************************
+//
+// On the host there is no memory mapped I/O. Register accesses are routed to
+// a small table of simulated registers kept by hoststubs.c, so code such as
+// HWREG(SSI0_BASE + SSI_O_DR) = x compiles unchanged and the harness can read
+// back the last value written.
+//
+//*****************************************************************************
+extern volatile uint32_t *HostRegister(uint32_t ui32Addr);
+
+#define HWREG(x)                (*HostRegister((uint32_t)(x)))
+#define HWREGH(x)               (*(volatile uint16_t *)HostRegister((uint32_t)(x)))
+#define HWREGB(x)               (*(volatile uint8_t *)HostRegister((uint32_t)(x)))
+
+#endif // __HW_TYPES_H__
@@ -0,0 +1,16 @@
+//*****************************************************************************
+//
+// hw_uart.h - Host stand-in for the UART register offsets.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __HW_UART_H__
+#define __HW_UART_H__
+
+#define UART_O_DR               0x00000000
+
+#endif // __HW_UART_H__
@@ -0,0 +1,508 @@
+//*****************************************************************************
+//
+// map_budget.c - SRAM and flash use per symbol from a linker map file.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// This program reads the map file written by the linker and reports how much
+// SRAM and flash every input section takes, largest first, followed by the
+// total for each memory. With --gen_data_subsections (the CCS default) every
+// global variable and table gets its own input section, so the report is per
+// symbol.
+//
+// Two map formats are understood:
+// - TI ARM linker (--map_file): memories come from MEMORY CONFIGURATION and
+//   each input section is assigned to the memory holding its address.
+// - GNU ld (-Map): .text, .rodata and friends count as flash, .data and .bss
+//   count as SRAM. Used to report the host build of the firmware sources.
+//
+// The program fails when a memory is above its budget, so the build reserves
+// room for framebuffers and audio rings that have yet to be added.
+//
+// Usage: map_budget [-s sram] [-f flash] [-r stack] [-m match] [-n top]
+//                   mapfile
+//   -s  SRAM budget in bytes (default: no budget)
+//   -f  flash budget in bytes (default: no budget)
+//   -r  SRAM the map does not show, such as the C stack of an image linked
+//       without one, counted against the budget (default 0)
+//   -m  only count input sections from objects whose name contains match
+//   -n  number of largest sections listed per memory (default 12, 0 for all)
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAP_MAX_ENTRIES     4096
+#define MAP_MAX_LINE        512
+
+#define MAP_FLASH           0
+#define MAP_SRAM            1
+#define MAP_NUM_MEMORIES    2
+
+static const char *g_ppcMemoryNames[MAP_NUM_MEMORIES] = { "FLASH", "SRAM" };
+
+typedef struct
+{
+    char pcName[64];
+    char pcObject[64];
+    uint32_t ui32Size;
+    uint32_t ui32Memory;
+}
+tMapEntry;
+
+static tMapEntry g_psEntries[MAP_MAX_ENTRIES];
+static uint32_t g_ui32NumEntries;
+
+//
+// Address ranges of FLASH and SRAM from a TI map
+//
+static uint32_t g_pui32Origin[MAP_NUM_MEMORIES];
+static uint32_t g_pui32Length[MAP_NUM_MEMORIES];
+
+//*****************************************************************************
+//
+// Helpers
+//
+//*****************************************************************************
+static void
+MapCopy(char *pcDst, size_t szDst, const char *pcSrc, size_t szSrc)
+{
+    if(szSrc >= szDst)
+    {
+        szSrc = szDst - 1;
+    }
+    memcpy(pcDst, pcSrc, szSrc);
+    pcDst[szSrc] = 0;
+}
+
+static void
+MapAdd(const char *pcName, const char *pcObject, uint32_t ui32Size,
+       uint32_t ui32Memory, const char *pcMatch)
+{
+    tMapEntry *psEntry;
+
+    if((ui32Size == 0) || (g_ui32NumEntries == MAP_MAX_ENTRIES) ||
+       (pcMatch && !strstr(pcObject, pcMatch)))
+    {
+        return;
+    }
+    psEntry = &g_psEntries[g_ui32NumEntries++];
+    MapCopy(psEntry->pcName, sizeof(psEntry->pcName), pcName, strlen(pcName));
+    MapCopy(psEntry->pcObject, sizeof(psEntry->pcObject), pcObject,
+            strlen(pcObject));
+    psEntry->ui32Size = ui32Size;
+    psEntry->ui32Memory = ui32Memory;
+}
+
+static int
+MapCompare(const void *pvA, const void *pvB)
+{
+    const tMapEntry *psA = pvA, *psB = pvB;
+
+    if(psA->ui32Memory != psB->ui32Memory)
+    {
+        return((int)psA->ui32Memory - (int)psB->ui32Memory);
+    }
+    return((psA->ui32Size < psB->ui32Size) ? 1 :
+           (psA->ui32Size > psB->ui32Size) ? -1 : 0);
+}
+
+//*****************************************************************************
+//
+// TI ARM linker map. The lines of interest look like
+//
+//   SRAM                  20000000   00008000  0000076e  00007892  RW X
+//                   20000000    00000300     font8x8.obj (.data:font8x8_basic)
+//                   00000a64    000001b6     rtsv7M4.lib : fd_add_t2.obj (.text)
+//                   20000664    00000004     (.common:g_NewGSCycle)
+//
+//*****************************************************************************
+static void
+MapParseTI(FILE *pFile, const char *pcMatch)
+{
+    char pcLine[MAP_MAX_LINE], pcName[64], pcLib[64], pcObject[64];
+    char pcOutput[64];
+    char *pcOpen, *pcClose, *pcColon;
+    uint32_t ui32Addr, ui32Size, ui32Memory, ui32Origin, ui32Length;
+    bool bMemory = false, bSections = false;
+    int iPos;
+
+    pcLib[0] = 0;
+    pcOutput[0] = 0;
+    while(fgets(pcLine, sizeof(pcLine), pFile))
+    {
+        if(strncmp(pcLine, "MEMORY CONFIGURATION", 20) == 0)
+        {
+            bMemory = true;
+            continue;
+        }
+        if(strncmp(pcLine, "SECTION ALLOCATION MAP", 22) == 0)
+        {
+            bMemory = false;
+            bSections = true;
+            continue;
+        }
+        if(strncmp(pcLine, "LINKER GENERATED", 16) == 0)
+        {
+            break;
+        }
+
+        if(bMemory)
+        {
+            if(sscanf(pcLine, " %63s %x %x", pcName, &ui32Origin,
+                      &ui32Length) == 3)
+            {
+                if(strcmp(pcName, "FLASH") == 0)
+                {
+                    g_pui32Origin[MAP_FLASH] = ui32Origin;
+                    g_pui32Length[MAP_FLASH] = ui32Length;
+                }
+                else if(strcmp(pcName, "SRAM") == 0)
+                {
+                    g_pui32Origin[MAP_SRAM] = ui32Origin;
+                    g_pui32Length[MAP_SRAM] = ui32Length;
+                }
+            }
+            continue;
+        }
+
+        //
+        // Input sections are indented and start with address and length.
+        // Output section headers start in column 0.
+        //
+        if(bSections && (pcLine[0] == '.'))
+        {
+            sscanf(pcLine, "%63s", pcOutput);
+            continue;
+        }
+        if(!bSections || (pcLine[0] != ' ') ||
+           (sscanf(pcLine, " %x %x %n", &ui32Addr, &ui32Size, &iPos) != 2))
+        {
+            continue;
+        }
+
+        for(ui32Memory = 0; ui32Memory < MAP_NUM_MEMORIES; ui32Memory++)
+        {
+            if((ui32Addr >= g_pui32Origin[ui32Memory]) &&
+               (ui32Addr - g_pui32Origin[ui32Memory] <
+                g_pui32Length[ui32Memory]))
+            {
+                break;
+            }
+        }
+        if(ui32Memory == MAP_NUM_MEMORIES)
+        {
+            continue;
+        }
+
+        //
+        // "--HOLE--" is alignment padding, or the whole of .stack.
+        //
+        if(strncmp(pcLine + iPos, "--HOLE--", 8) == 0)
+        {
+            MapAdd(strcmp(pcOutput, ".stack") ? "(padding)" : "(stack)", "",
+                   ui32Size, ui32Memory, pcMatch);
+            continue;
+        }
+
+        //
+        // "lib : member (section)", ": member (section)" for the next
+        // member of the same library, or "object (section)".
+        //
+        pcOpen = strchr(pcLine + iPos, '(');
+        pcClose = pcOpen ? strrchr(pcOpen, ')') : 0;
+        if(!pcClose)
+        {
+            continue;
+        }
+        pcColon = strstr(pcLine + iPos, " : ");
+        if(pcLine[iPos] == ':')
+        {
+            pcColon = pcLine + iPos - 1;
+        }
+        else if(pcColon && (pcColon < pcOpen))
+        {
+            MapCopy(pcLib, sizeof(pcLib), pcLine + iPos,
+                    pcColon - (pcLine + iPos));
+        }
+        else
+        {
+            pcColon = 0;
+            pcLib[0] = 0;
+        }
+        if(pcColon)
+        {
+            snprintf(pcObject, sizeof(pcObject), "%s:", pcLib);
+            iPos = pcColon + 3 - pcLine;
+        }
+        else
+        {
+            pcObject[0] = 0;
+        }
+        while((pcOpen > pcLine + iPos) && (pcOpen[-1] == ' '))
+        {
+            pcOpen--;
+        }
+        MapCopy(pcObject + strlen(pcObject), sizeof(pcObject) - strlen(pcObject),
+                pcLine + iPos, pcOpen - (pcLine + iPos));
+        pcOpen = strchr(pcOpen, '(');
+
+        //
+        // ".data:font8x8_basic" names the symbol, ".data" alone does not.
+        //
+        MapCopy(pcName, sizeof(pcName), pcOpen + 1, pcClose - pcOpen - 1);
+        pcColon = strchr(pcName, ':');
+        if(pcColon && (pcColon[1] != '.'))
+        {
+            memmove(pcName, pcColon + 1, strlen(pcColon));
+        }
+        MapAdd(pcName, pcObject, ui32Size, ui32Memory, pcMatch);
+    }
+}
+
+//*****************************************************************************
+//
+// GNU ld map. Input sections follow their output section and are either on
+// one line or split when the name is long:
+//
+//  .rodata.colors
+//                 0x0000000000012340       0x10 build/fw_test_tlc5941.o
+//  .bss           0x0000000000012350        0x4 build/fw_trace.o
+//
+//*****************************************************************************
+static int32_t
+MapGnuMemory(const char *pcSection)
+{
+    static const char *ppcFlash[] = { ".text", ".rodata", ".init", ".fini" };
+    static const char *ppcSram[] = { ".data", ".bss" };
+    uint32_t idx;
+
+    for(idx = 0; idx < sizeof(ppcFlash) / sizeof(ppcFlash[0]); idx++)
+    {
+        if(strncmp(pcSection, ppcFlash[idx], strlen(ppcFlash[idx])) == 0)
+        {
+            return(MAP_FLASH);
+        }
+    }
+    for(idx = 0; idx < sizeof(ppcSram) / sizeof(ppcSram[0]); idx++)
+    {
+        if(strncmp(pcSection, ppcSram[idx], strlen(ppcSram[idx])) == 0)
+        {
+            return(MAP_SRAM);
+        }
+    }
+    return(-1);
+}
+
+static void
+MapParseGnu(FILE *pFile, const char *pcMatch)
+{
+    char pcLine[MAP_MAX_LINE], pcSection[64], pcPending[64], pcObject[256];
+    unsigned long long ui64Addr, ui64Size;
+    int32_t i32Output;
+    bool bMap = false;
+    const char *pcSym;
+
+    i32Output = -1;
+    pcPending[0] = 0;
+    while(fgets(pcLine, sizeof(pcLine), pFile))
+    {
+        if(strncmp(pcLine, "Linker script and memory map", 28) == 0)
+        {
+            bMap = true;
+            continue;
+        }
+        if(!bMap)
+        {
+            continue;
+        }
+
+        //
+        // Output section header
+        //
+        if(pcLine[0] == '.')
+        {
+            sscanf(pcLine, "%63s", pcSection);
+            i32Output = MapGnuMemory(pcSection);
+            pcPending[0] = 0;
+            continue;
+        }
+        if((pcLine[0] != ' ') || (pcLine[1] != '.'))
+        {
+            //
+            // Address and size of an input section named on the line before
+            //
+            if(pcPending[0] && (sscanf(pcLine, " 0x%llx 0x%llx %255s",
+                                       &ui64Addr, &ui64Size, pcObject) == 3))
+            {
+                strcpy(pcSection, pcPending);
+            }
+            else if(strncmp(pcLine, " COMMON ", 8) == 0 &&
+                    sscanf(pcLine, " COMMON 0x%llx 0x%llx %255s",
+                           &ui64Addr, &ui64Size, pcObject) == 3)
+            {
+                strcpy(pcSection, ".bss.(common)");
+            }
+            else
+            {
+                pcPending[0] = 0;
+                continue;
+            }
+        }
+        else if(sscanf(pcLine, " %63s 0x%llx 0x%llx %255s", pcSection,
+                       &ui64Addr, &ui64Size, pcObject) != 4)
+        {
+            sscanf(pcLine, " %63s", pcPending);
+            continue;
+        }
+        pcPending[0] = 0;
+        if(i32Output < 0)
+        {
+            continue;
+        }
+
+        //
+        // ".rodata.colors" names the symbol, ".rodata" alone does not.
+        //
+        pcSym = strchr(pcSection + 1, '.');
+        MapAdd(pcSym ? pcSym + 1 : pcSection,
+               strrchr(pcObject, '/') ? strrchr(pcObject, '/') + 1 : pcObject,
+               (uint32_t)ui64Size, i32Output, pcMatch);
+    }
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+    uint32_t pui32Budget[MAP_NUM_MEMORIES] = { 0, 0 };
+    uint32_t pui32Total[MAP_NUM_MEMORIES] = { 0, 0 };
+    uint32_t ui32Top = 12, ui32Reserved = 0, ui32Memory, ui32Shown, idx;
+    const char *pcMatch = 0;
+    char pcLine[MAP_MAX_LINE];
+    FILE *pFile;
+    bool bTI;
+    int iOpt, iFailed;
+
+    while((iOpt = getopt(argc, argv, "s:f:r:m:n:")) != -1)
+    {
+        switch(iOpt)
+        {
+            case 's': pui32Budget[MAP_SRAM] = strtoul(optarg, 0, 0); break;
+            case 'f': pui32Budget[MAP_FLASH] = strtoul(optarg, 0, 0); break;
+            case 'r': ui32Reserved = strtoul(optarg, 0, 0); break;
+            case 'm': pcMatch = optarg; break;
+            case 'n': ui32Top = strtoul(optarg, 0, 0); break;
+            default: optind = argc; break;
+        }
+    }
+    if(optind != argc - 1)
+    {
+        fprintf(stderr, "usage: %s [-s sram] [-f flash] [-r stack] "
+                "[-m match] [-n top] mapfile\n", argv[0]);
+        return(2);
+    }
+
+    pFile = fopen(argv[optind], "r");
+    if(!pFile)
+    {
+        perror(argv[optind]);
+        return(2);
+    }
+    bTI = false;
+    while(fgets(pcLine, sizeof(pcLine), pFile))
+    {
+        if(strstr(pcLine, "TI ARM Linker"))
+        {
+            bTI = true;
+            break;
+        }
+        if(strstr(pcLine, "Linker script and memory map") ||
+           strstr(pcLine, "Memory Configuration"))
+        {
+            break;
+        }
+    }
+    rewind(pFile);
+    if(bTI)
+    {
+        MapParseTI(pFile, pcMatch);
+    }
+    else
+    {
+        MapParseGnu(pFile, pcMatch);
+    }
+    fclose(pFile);
+
+    qsort(g_psEntries, g_ui32NumEntries, sizeof(g_psEntries[0]), MapCompare);
+    for(idx = 0; idx < g_ui32NumEntries; idx++)
+    {
+        pui32Total[g_psEntries[idx].ui32Memory] += g_psEntries[idx].ui32Size;
+    }
+    pui32Total[MAP_SRAM] += ui32Reserved;
+
+    printf("%s (%s map)\n", argv[optind], bTI ? "TI" : "GNU");
+    for(ui32Memory = 0; ui32Memory < MAP_NUM_MEMORIES; ui32Memory++)
+    {
+        printf("\n%-6s %8s  %-28s %s\n", g_ppcMemoryNames[ui32Memory],
+               "bytes", "section", "object");
+        ui32Shown = 0;
+        for(idx = 0; idx < g_ui32NumEntries; idx++)
+        {
+            if(g_psEntries[idx].ui32Memory != ui32Memory)
+            {
+                continue;
+            }
+            if(ui32Top && (ui32Shown == ui32Top))
+            {
+                printf("       %8s  ...\n", "");
+                break;
+            }
+            printf("       %8u  %-28s %s\n", g_psEntries[idx].ui32Size,
+                   g_psEntries[idx].pcName, g_psEntries[idx].pcObject);
+            ui32Shown++;
+        }
+    }
+
+    printf("\n");
+    if(ui32Reserved)
+    {
+        printf("SRAM   %8u bytes reserved outside the map\n", ui32Reserved);
+    }
+    iFailed = 0;
+    for(ui32Memory = 0; ui32Memory < MAP_NUM_MEMORIES; ui32Memory++)
+    {
+        printf("%-6s %8u bytes", g_ppcMemoryNames[ui32Memory],
+               pui32Total[ui32Memory]);
+        if(pui32Budget[ui32Memory])
+        {
+            printf(" of %u budget (%u free)%s",
+                   pui32Budget[ui32Memory],
+                   (pui32Total[ui32Memory] < pui32Budget[ui32Memory]) ?
+                   pui32Budget[ui32Memory] - pui32Total[ui32Memory] : 0,
+                   (pui32Total[ui32Memory] > pui32Budget[ui32Memory]) ?
+                   "  OVER BUDGET" : "");
+            if(pui32Total[ui32Memory] > pui32Budget[ui32Memory])
+            {
+                iFailed++;
+            }
+        }
+        printf("\n");
+    }
+    return(iFailed ? 1 : 0);
+}
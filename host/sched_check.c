@@ -0,0 +1,331 @@
+//*****************************************************************************
+//
+// sched_check.c - Run the firmware task table on a modelled CPU clock.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// ConfigureBoard sets up the firmware as on the board, and the task table it
+// hands to SchedInit is taken through the linker's --wrap. The tasks are
+// then replaced by stand-ins that advance the DWT cycle counter by a fixed
+// cost, each task's budget unless given with -x, and the scheduler is run
+// as the main loop runs it: a row boundary every 80000 cycles, releasing
+// the tasks due, and the next task picked only once the one running has
+// finished. The console idle task takes a random time up to the -i limit,
+// so that row boundaries fall at every point of it; the run a boundary
+// interrupts holds up every task it releases.
+//
+// A task's response is the time from the boundary that released it to the
+// end of its run. Interrupt handlers are not modelled apart: on the target
+// they take cycles from the task they interrupt, so a cost is the run time
+// the DWT shows, interrupts included.
+//
+// The row and audio tasks fill the buffer halves the hardware plays from
+// the next row boundary, so the check fails if either misses a deadline,
+// or if a task of lower priority ever starts while one of them is waiting.
+//
+// Usage: sched_check [-r rows] [-i cycles] [-x task:cycles] ...
+//   -r  number of 2ms LED rows to run (default 4000)
+//   -i  longest run of an idle task (default 20000)
+//   -x  run this task for this many cycles rather than its budget
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "hostsim.h"
+#include "dwt.h"
+#include "scan.h"
+#include "sched.h"
+
+#define SCHED_CHECK_MAX_TASKS   16
+
+//
+// 40MHz CPU cycles per 2ms row
+//
+#define SCHED_CHECK_ROW_CYCLES  (HOST_SYSCLK_HZ / 500)
+
+//*****************************************************************************
+//
+// Firmware entry points, and the scheduler's own SchedInit under --wrap
+//
+//*****************************************************************************
+extern void ConfigureBoard(void);
+extern void __real_SchedInit(tSchedTask *psTasks, uint32_t ui32NumTasks);
+
+//*****************************************************************************
+//
+// Task table and modelled clock
+//
+//*****************************************************************************
+static tSchedTask *g_psTasks;
+static uint32_t g_ui32NumTasks;
+
+//
+// Cost of each task's run, and its longest response
+//
+static uint32_t g_pui32Cost[SCHED_CHECK_MAX_TASKS];
+static uint64_t g_pui64Response[SCHED_CHECK_MAX_TASKS];
+
+//
+// Tasks whose deadlines are checked, and the runs that started while one
+// of them was waiting
+//
+static int32_t g_i32Row = -1;
+static int32_t g_i32Audio = -1;
+static uint32_t g_ui32Blocked;
+
+static uint64_t g_ui64Now;
+static uint64_t g_ui64Boundary;
+static uint32_t g_ui32IdleMax = 20000;
+static uint32_t g_ui32Random = 0x12345678;
+
+//*****************************************************************************
+//
+// __wrap_SchedInit
+// Note the firmware's task table on its way to the scheduler.
+//
+//*****************************************************************************
+void
+__wrap_SchedInit(tSchedTask *psTasks, uint32_t ui32NumTasks)
+{
+    g_psTasks = psTasks;
+    g_ui32NumTasks = ui32NumTasks;
+    __real_SchedInit(psTasks, ui32NumTasks);
+}
+
+//*****************************************************************************
+//
+// SchedCheckRun
+// Stand-in for task idx: take its cost off the clock, an idle task a random
+// part of g_ui32IdleMax, and note how long after its release it finished.
+//
+//*****************************************************************************
+static void
+SchedCheckRun(uint32_t idx)
+{
+    const tSchedTask *psTask;
+    uint32_t ui32Cost;
+
+    psTask = &g_psTasks[idx];
+    if(((int32_t)idx != g_i32Row) && ((int32_t)idx != g_i32Audio) &&
+       (g_psTasks[g_i32Row].ui8Released || g_psTasks[g_i32Audio].ui8Released))
+    {
+        g_ui32Blocked++;
+    }
+
+    if(psTask->ui8Trigger == SCHED_IDLE)
+    {
+        g_ui32Random = g_ui32Random * 1664525 + 1013904223;
+        ui32Cost = 1 + (g_ui32Random >> 8) % g_ui32IdleMax;
+    }
+    else
+    {
+        ui32Cost = g_pui32Cost[idx];
+    }
+    g_ui64Now += ui32Cost;
+    DWTCycles() = (uint32_t)g_ui64Now;
+
+    if((psTask->ui8Trigger != SCHED_IDLE) &&
+       (g_ui64Now - g_ui64Boundary > g_pui64Response[idx]))
+    {
+        g_pui64Response[idx] = g_ui64Now - g_ui64Boundary;
+    }
+}
+
+//
+// One stand-in per task, as a task takes no argument
+//
+#define SCHED_CHECK_TASK(n)                                                   \
+    static void SchedCheckTask##n(void) { SchedCheckRun(n); }
+
+SCHED_CHECK_TASK(0)  SCHED_CHECK_TASK(1)  SCHED_CHECK_TASK(2)
+SCHED_CHECK_TASK(3)  SCHED_CHECK_TASK(4)  SCHED_CHECK_TASK(5)
+SCHED_CHECK_TASK(6)  SCHED_CHECK_TASK(7)  SCHED_CHECK_TASK(8)
+SCHED_CHECK_TASK(9)  SCHED_CHECK_TASK(10) SCHED_CHECK_TASK(11)
+SCHED_CHECK_TASK(12) SCHED_CHECK_TASK(13) SCHED_CHECK_TASK(14)
+SCHED_CHECK_TASK(15)
+
+static void (* const g_ppfnStandIns[SCHED_CHECK_MAX_TASKS])(void) =
+{
+    SchedCheckTask0,  SchedCheckTask1,  SchedCheckTask2,  SchedCheckTask3,
+    SchedCheckTask4,  SchedCheckTask5,  SchedCheckTask6,  SchedCheckTask7,
+    SchedCheckTask8,  SchedCheckTask9,  SchedCheckTask10, SchedCheckTask11,
+    SchedCheckTask12, SchedCheckTask13, SchedCheckTask14, SchedCheckTask15
+};
+
+static int32_t
+SchedCheckFind(const char *pcName)
+{
+    uint32_t idx;
+
+    for(idx = 0; idx < g_ui32NumTasks; idx++)
+    {
+        if(!strcmp(g_psTasks[idx].pcName, pcName))
+        {
+            return(idx);
+        }
+    }
+    return(-1);
+}
+
+static void
+SchedCheckUsage(const char *pcName)
+{
+    fprintf(stderr, "usage: %s [-r rows] [-i cycles] [-x task:cycles] ...\n",
+            pcName);
+    exit(2);
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+    uint32_t ui32Rows = 4000, ui32Row, ui32NumCosts = 0, idx;
+    const char *ppcCosts[SCHED_CHECK_MAX_TASKS];
+    tSchedTask *psTask;
+    char pcName[32];
+    char *pcSep;
+    int32_t i32Task;
+    bool bFail;
+    int iOpt;
+
+    while((iOpt = getopt(argc, argv, "r:i:x:")) != -1)
+    {
+        switch(iOpt)
+        {
+            case 'r':
+                ui32Rows = strtoul(optarg, NULL, 0);
+                break;
+            case 'i':
+                g_ui32IdleMax = strtoul(optarg, NULL, 0);
+                break;
+            case 'x':
+                if(!strchr(optarg, ':') ||
+                   (ui32NumCosts == SCHED_CHECK_MAX_TASKS))
+                {
+                    SchedCheckUsage(argv[0]);
+                }
+                ppcCosts[ui32NumCosts++] = optarg;
+                break;
+            default:
+                SchedCheckUsage(argv[0]);
+        }
+    }
+    if(!g_ui32IdleMax)
+    {
+        SchedCheckUsage(argv[0]);
+    }
+
+    HostReset();
+    ConfigureBoard();
+    g_i32Row = SchedCheckFind("row");
+    g_i32Audio = SchedCheckFind("audio");
+    if((g_ui32NumTasks > SCHED_CHECK_MAX_TASKS) || (g_i32Row < 0) ||
+       (g_i32Audio < 0))
+    {
+        fprintf(stderr, "task table of %u tasks has no row or audio task\n",
+                g_ui32NumTasks);
+        return(1);
+    }
+
+    for(idx = 0; idx < g_ui32NumTasks; idx++)
+    {
+        g_pui32Cost[idx] = g_psTasks[idx].ui32Budget;
+        g_psTasks[idx].pfnRun = g_ppfnStandIns[idx];
+    }
+    for(idx = 0; idx < ui32NumCosts; idx++)
+    {
+        pcSep = strchr(ppcCosts[idx], ':');
+        snprintf(pcName, sizeof(pcName), "%.*s",
+                 (int)(pcSep - ppcCosts[idx]), ppcCosts[idx]);
+        i32Task = SchedCheckFind(pcName);
+        if(i32Task < 0)
+        {
+            fprintf(stderr, "no task %s\n", pcName);
+            return(1);
+        }
+        g_pui32Cost[i32Task] = strtoul(pcSep + 1, NULL, 0);
+    }
+
+    //
+    // Start afresh, the clock at the first row boundary
+    //
+    __real_SchedInit(g_psTasks, g_ui32NumTasks);
+    g_ui64Now = 0;
+    DWTCycles() = 0;
+
+    for(ui32Row = 0; ui32Row < ui32Rows; ui32Row++)
+    {
+        //
+        // The boundary is seen once the run it fell in has finished
+        //
+        g_ui64Boundary = (uint64_t)ui32Row * SCHED_CHECK_ROW_CYCLES;
+        SchedRelease((ui32Row % SCAN_SLOTS) == SCAN_SLOTS - 1);
+        while(g_ui64Now < g_ui64Boundary + SCHED_CHECK_ROW_CYCLES)
+        {
+            SchedRunNext();
+        }
+    }
+
+    printf("%u rows of %u cycles, idle runs up to %u cycles\n", ui32Rows,
+           SCHED_CHECK_ROW_CYCLES, g_ui32IdleMax);
+    printf("task      prio trigger   cost    runs missed max_response\n");
+    for(idx = 0; idx < g_ui32NumTasks; idx++)
+    {
+        psTask = &g_psTasks[idx];
+        if(psTask->ui8Trigger == SCHED_IDLE)
+        {
+            printf("%-9s %4u idle    %6u %7u      -            -\n",
+                   psTask->pcName, psTask->ui8Priority, g_ui32IdleMax,
+                   psTask->ui32Runs);
+            continue;
+        }
+        printf("%-9s %4u %-7s %6u %7u %6u %12llu\n", psTask->pcName,
+               psTask->ui8Priority,
+               (psTask->ui8Trigger == SCHED_ROW) ? "row" :
+               (psTask->ui8Trigger == SCHED_FRAME) ? "frame" : "period",
+               g_pui32Cost[idx], psTask->ui32Runs, psTask->ui32Missed,
+               (unsigned long long)g_pui64Response[idx]);
+    }
+
+    bFail = false;
+    for(idx = 0; idx < 2; idx++)
+    {
+        psTask = &g_psTasks[idx ? g_i32Audio : g_i32Row];
+        if(psTask->ui32Missed)
+        {
+            printf("%s task missed %u deadlines\n", psTask->pcName,
+                   psTask->ui32Missed);
+            bFail = true;
+        }
+    }
+    if(g_ui32Blocked)
+    {
+        printf("%u runs started with the row or audio task waiting\n",
+               g_ui32Blocked);
+        bFail = true;
+    }
+    if(bFail)
+    {
+        return(1);
+    }
+    printf("row and audio tasks met every deadline, done %llu and %llu "
+           "cycles after their release at worst\n",
+           (unsigned long long)g_pui64Response[g_i32Row],
+           (unsigned long long)g_pui64Response[g_i32Audio]);
+    return(0);
+}
@@ -0,0 +1,186 @@
+//*****************************************************************************
+//
+// sine_study.c - Accuracy and cost study of the SineApprox kernels.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The Makefile compiles test_tlc5941/sine_approx.c once per kernel with
+// SINE_APPROX_KERNEL set and SineApprox renamed, so every kernel selectable
+// in the firmware is linked here side by side. For each one this program
+// sweeps all 65536 phases at Q15 full scale against libm and reports:
+// - flash used by tables
+// - max and RMS error in LSB
+// - spurious-free dynamic range of the one-cycle sweep, from harmonics
+//   2 to STUDY_HARMONICS and DC
+// - host ns per call and estimated Cortex-M4 cycles per call
+//
+// Usage: sine_study
+//
+//*****************************************************************************
+
+#include <math.h>
+#include <stdio.h>
+#include "benchutil.h"
+
+#define STUDY_SCALE         32767
+#define STUDY_POINTS        65536
+#define STUDY_HARMONICS     64
+
+//*****************************************************************************
+//
+// Kernels under test
+//
+//*****************************************************************************
+#define SINE_KERNEL_EXTERN(name)                                              \
+    extern int32_t SineApprox_##name(uint16_t phase, uint16_t scale);          \
+    extern const uint32_t SineApproxTableBytes_##name;
+
+SINE_KERNEL_EXTERN(tab32)
+SINE_KERNEL_EXTERN(tab256)
+SINE_KERNEL_EXTERN(tab1024)
+SINE_KERNEL_EXTERN(parabolic)
+SINE_KERNEL_EXTERN(cordic)
+
+typedef int32_t (*tSineFn)(uint16_t phase, uint16_t scale);
+
+typedef struct
+{
+    const char *pcName;
+    tSineFn pfnSine;
+    const uint32_t *pui32TableBytes;
+}
+tSineKernel;
+
+static const tSineKernel g_psKernels[] =
+{
+    { "SINE_KERNEL_TAB32",     SineApprox_tab32,
+      &SineApproxTableBytes_tab32 },
+    { "SINE_KERNEL_TAB256",    SineApprox_tab256,
+      &SineApproxTableBytes_tab256 },
+    { "SINE_KERNEL_TAB1024",   SineApprox_tab1024,
+      &SineApproxTableBytes_tab1024 },
+    { "SINE_KERNEL_PARABOLIC", SineApprox_parabolic,
+      &SineApproxTableBytes_parabolic },
+    { "SINE_KERNEL_CORDIC",    SineApprox_cordic,
+      &SineApproxTableBytes_cordic },
+};
+
+#define NUM_KERNELS (sizeof(g_psKernels) / sizeof(g_psKernels[0]))
+
+//
+// Kernel being timed, and the sweep it produced
+//
+static tSineFn g_pfnSine;
+static volatile int32_t g_i32Sink;
+static double g_pdSweep[STUDY_POINTS];
+
+static int32_t
+SineLibm(uint16_t phase, uint16_t scale)
+{
+    return((int32_t)lround(scale * sin(2 * M_PI * phase / STUDY_POINTS)));
+}
+
+static void
+BenchSine(uint32_t ui32Iter)
+{
+    g_i32Sink = g_pfnSine(ui32Iter * 1783, 1125);
+}
+
+//*****************************************************************************
+//
+// Magnitude of DFT bin k of the sweep, by Goertzel.
+//
+//*****************************************************************************
+static double
+StudyBin(uint32_t k)
+{
+    double dCoeff, dS0, dS1, dS2;
+    uint32_t n;
+
+    dCoeff = 2 * cos(2 * M_PI * k / STUDY_POINTS);
+    dS1 = dS2 = 0;
+    for(n = 0; n < STUDY_POINTS; n++)
+    {
+        dS0 = g_pdSweep[n] + dCoeff * dS1 - dS2;
+        dS2 = dS1;
+        dS1 = dS0;
+    }
+    return(sqrt(dS1 * dS1 + dS2 * dS2 - dCoeff * dS1 * dS2));
+}
+
+//*****************************************************************************
+//
+// Sweep one kernel and print its row.
+//
+//*****************************************************************************
+static void
+StudyKernel(const char *pcName, tSineFn pfnSine, int32_t i32TableBytes)
+{
+    double dErr, dMaxErr, dSumSq, dFund, dSpur, dBin, dCycles;
+    uint32_t n, k;
+
+    dMaxErr = 0;
+    dSumSq = 0;
+    for(n = 0; n < STUDY_POINTS; n++)
+    {
+        g_pdSweep[n] = pfnSine(n, STUDY_SCALE);
+        dErr = g_pdSweep[n] - STUDY_SCALE * sin(2 * M_PI * n / STUDY_POINTS);
+        dSumSq += dErr * dErr;
+        if(fabs(dErr) > dMaxErr)
+        {
+            dMaxErr = fabs(dErr);
+        }
+    }
+
+    dFund = StudyBin(1);
+    dSpur = StudyBin(0) / 2;
+    for(k = 2; k <= STUDY_HARMONICS; k++)
+    {
+        dBin = StudyBin(k);
+        if(dBin > dSpur)
+        {
+            dSpur = dBin;
+        }
+    }
+
+    g_pfnSine = pfnSine;
+    dCycles = BenchM4Cycles(BenchSine, NULL);
+
+    printf("%-22s %6d %8.2f %8.3f %8.1f %8.2f %8.1f\n", pcName, i32TableBytes,
+           dMaxErr, sqrt(dSumSq / STUDY_POINTS),
+           (dSpur > 0) ? 20 * log10(dFund / dSpur) : 999.0,
+           BenchTime(BenchSine), dCycles);
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(void)
+{
+    uint32_t idx;
+
+    printf("Q15 full scale, %d phases, harmonics to %d\n", STUDY_POINTS,
+           STUDY_HARMONICS);
+    printf("%-22s %6s %8s %8s %8s %8s %8s\n", "kernel", "flash", "max err",
+           "rms err", "SFDR dB", "ns/call", "m4 cyc");
+    for(idx = 0; idx < NUM_KERNELS; idx++)
+    {
+        StudyKernel(g_psKernels[idx].pcName, g_psKernels[idx].pfnSine,
+                    *g_psKernels[idx].pui32TableBytes);
+    }
+
+    //
+    // Rounded libm sine: the best any Q15 kernel can do.
+    //
+    StudyKernel("libm (reference)", SineLibm, -1);
+    return(0);
+}
@@ -0,0 +1,383 @@
+//*****************************************************************************
+//
+// stream_send.c - Stream frames to the Idiotbox display over a serial line.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Sends frames in the protocol of test_tlc5941/stream.h: a keyframe every
+// -k frames and otherwise a delta of the rows that changed, then a release
+// frame that hands the display back to the keypad.
+//
+// With -p a pseudo-terminal stands in for the serial line and its slave is
+// linked at LINK for hostrun -u. The pseudo-terminal discards what is still
+// unread when the sending side closes, so stream_send then waits for the
+// reader to take everything before it exits.
+//
+// Usage: stream_send [-n frames] [-f fps] [-k interval] [-i frames.rgb]
+//                    [-b baud] DEVICE | -p LINK
+//   -n  frames to send before the release (default 600)
+//   -f  frames per second, 0 to send as fast as the line takes them
+//       (default 0)
+//   -k  send a keyframe every this many frames (default 32)
+//   -i  read the frames from this file of 192-byte RGB frames, row 0
+//       first, over and over; without it a test animation is sent
+//   -b  line rate of DEVICE (default STREAM_BAUD)
+//   -p  create a pseudo-terminal and link its slave at LINK
+//
+//*****************************************************************************
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "stream.h"
+
+//
+// Largest frame on the line: a delta of every row
+//
+#define SEND_MAX_BYTES          (STREAM_OVERHEAD + 1 + STREAM_FRAME_BYTES)
+
+static uint8_t g_ppui8Frame[8][STREAM_ROW_BYTES];
+static uint8_t g_ppui8Sent[8][STREAM_ROW_BYTES];
+
+static void
+SendUsage(const char *pcName)
+{
+    fprintf(stderr, "usage: %s [-n frames] [-f fps] [-k interval] "
+            "[-i frames.rgb] [-b baud] DEVICE | -p LINK\n", pcName);
+    exit(2);
+}
+
+//*****************************************************************************
+//
+// Test animation: a color wash that steps every 16 frames, so that every
+// row changes, and a white dot bouncing across it, changing a row or two.
+//
+//*****************************************************************************
+static void
+SendAnimate(uint32_t ui32Frame)
+{
+    uint32_t ui32Row, ui32Col, ui32Wash, ui32X, ui32Y;
+
+    ui32Wash = ui32Frame / 16;
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        for(ui32Col = 0; ui32Col < 8; ui32Col++)
+        {
+            g_ppui8Frame[ui32Row][3 * ui32Col] =
+                ((ui32Row + ui32Wash) * 32) & 0xFF;
+            g_ppui8Frame[ui32Row][3 * ui32Col + 1] =
+                ((ui32Col + ui32Wash) * 32) & 0xFF;
+            g_ppui8Frame[ui32Row][3 * ui32Col + 2] = (ui32Wash * 8) & 0xFF;
+        }
+    }
+
+    //
+    // The dot bounces off the edges, 14 frames per crossing
+    //
+    ui32X = ui32Frame % 14;
+    ui32X = (ui32X < 7) ? ui32X : 14 - ui32X;
+    ui32Y = (ui32Frame * 3 / 2) % 14;
+    ui32Y = (ui32Y < 7) ? ui32Y : 14 - ui32Y;
+    memset(&g_ppui8Frame[ui32Y][3 * ui32X], 0xFF, 3);
+}
+
+//*****************************************************************************
+//
+// Encode a frame of ui8Type with sequence number ui8Seq into pui8Out. A
+// keyframe carries every row, a delta the rows that differ from the frame
+// sent before. Returns the length.
+//
+//*****************************************************************************
+static uint32_t
+SendEncode(uint8_t *pui8Out, uint8_t ui8Type, uint8_t ui8Seq)
+{
+    uint32_t ui32Len, ui32Row, idx, ui32Sum1, ui32Sum2;
+    uint8_t ui8Mask;
+
+    ui32Len = 0;
+    pui8Out[ui32Len++] = STREAM_SYNC0;
+    pui8Out[ui32Len++] = STREAM_SYNC1;
+    pui8Out[ui32Len++] = ui8Type;
+    pui8Out[ui32Len++] = ui8Seq;
+
+    if(ui8Type == STREAM_DELTA)
+    {
+        ui8Mask = 0;
+        for(ui32Row = 0; ui32Row < 8; ui32Row++)
+        {
+            if(memcmp(g_ppui8Frame[ui32Row], g_ppui8Sent[ui32Row],
+                      STREAM_ROW_BYTES) != 0)
+            {
+                ui8Mask |= 1 << ui32Row;
+            }
+        }
+        pui8Out[ui32Len++] = ui8Mask;
+    }
+    else
+    {
+        ui8Mask = (ui8Type == STREAM_KEYFRAME) ? 0xFF : 0;
+    }
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        if(ui8Mask & (1 << ui32Row))
+        {
+            memcpy(&pui8Out[ui32Len], g_ppui8Frame[ui32Row], STREAM_ROW_BYTES);
+            memcpy(g_ppui8Sent[ui32Row], g_ppui8Frame[ui32Row],
+                   STREAM_ROW_BYTES);
+            ui32Len += STREAM_ROW_BYTES;
+        }
+    }
+
+    //
+    // Fletcher-16 of everything after the sync bytes, as in stream.c
+    //
+    ui32Sum1 = ui32Sum2 = 0;
+    for(idx = 2; idx < ui32Len; idx++)
+    {
+        ui32Sum1 = (ui32Sum1 + pui8Out[idx]) % 255;
+        ui32Sum2 = (ui32Sum2 + ui32Sum1) % 255;
+    }
+    pui8Out[ui32Len++] = ui32Sum1;
+    pui8Out[ui32Len++] = ui32Sum2;
+    return(ui32Len);
+}
+
+static void
+SendWrite(int iFd, const uint8_t *pui8Data, uint32_t ui32Len)
+{
+    ssize_t iWritten;
+
+    while(ui32Len)
+    {
+        iWritten = write(iFd, pui8Data, ui32Len);
+        if(iWritten < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            perror("write");
+            exit(1);
+        }
+        pui8Data += iWritten;
+        ui32Len -= iWritten;
+    }
+}
+
+//
+// Raw 8-bit line at ui32Baud, where the device has a rate
+//
+static void
+SendRaw(int iFd, uint32_t ui32Baud)
+{
+    struct termios sTerm;
+
+    if(tcgetattr(iFd, &sTerm) != 0)
+    {
+        return;
+    }
+    cfmakeraw(&sTerm);
+    if(ui32Baud)
+    {
+        cfsetspeed(&sTerm, (ui32Baud == 1000000) ? B1000000 :
+                           (ui32Baud == 921600) ? B921600 :
+                           (ui32Baud == 460800) ? B460800 : B115200);
+    }
+    tcsetattr(iFd, TCSANOW, &sTerm);
+}
+
+static double
+SendNow(void)
+{
+    struct timespec sNow;
+
+    clock_gettime(CLOCK_MONOTONIC, &sNow);
+    return(sNow.tv_sec + sNow.tv_nsec * 1e-9);
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+    uint32_t ui32Frames = 600, ui32Fps = 0, ui32KeyInterval = 32;
+    uint32_t ui32Baud = STREAM_BAUD, ui32Frame, ui32Len, ui32Keys;
+    uint64_t ui64Bytes;
+    uint8_t pui8Out[SEND_MAX_BYTES];
+    const char *pcInput = NULL, *pcLink = NULL;
+    double dStart, dNext, dElapsed;
+    FILE *pInput = NULL;
+    int iOpt, iFd, iSlave = -1, iQueued, iIdle;
+
+    while((iOpt = getopt(argc, argv, "n:f:k:i:b:p:")) != -1)
+    {
+        switch(iOpt)
+        {
+            case 'n':
+                ui32Frames = strtoul(optarg, NULL, 0);
+                break;
+            case 'f':
+                ui32Fps = strtoul(optarg, NULL, 0);
+                break;
+            case 'k':
+                ui32KeyInterval = strtoul(optarg, NULL, 0);
+                break;
+            case 'i':
+                pcInput = optarg;
+                break;
+            case 'b':
+                ui32Baud = strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                pcLink = optarg;
+                break;
+            default:
+                SendUsage(argv[0]);
+        }
+    }
+    if((!pcLink && (optind != argc - 1)) || (pcLink && (optind != argc)) ||
+       !ui32KeyInterval)
+    {
+        SendUsage(argv[0]);
+    }
+
+    if(pcInput)
+    {
+        pInput = fopen(pcInput, "rb");
+        if(!pInput)
+        {
+            perror(pcInput);
+            return(1);
+        }
+    }
+
+    if(pcLink)
+    {
+        //
+        // The slave is held open, raw, from before the link appears, so that
+        // nothing sent is echoed or line edited, and so that the line does
+        // not hang up between readers
+        //
+        iFd = posix_openpt(O_RDWR | O_NOCTTY);
+        if((iFd < 0) || (grantpt(iFd) != 0) || (unlockpt(iFd) != 0) ||
+           ((iSlave = open(ptsname(iFd), O_RDWR | O_NOCTTY)) < 0))
+        {
+            perror("pseudo-terminal");
+            return(1);
+        }
+        SendRaw(iSlave, 0);
+        unlink(pcLink);
+        if(symlink(ptsname(iFd), pcLink) != 0)
+        {
+            perror(pcLink);
+            return(1);
+        }
+    }
+    else
+    {
+        iFd = open(argv[optind], O_RDWR | O_NOCTTY);
+        if(iFd < 0)
+        {
+            perror(argv[optind]);
+            return(1);
+        }
+        SendRaw(iFd, ui32Baud);
+    }
+
+    ui64Bytes = 0;
+    ui32Keys = 0;
+    dStart = dNext = SendNow();
+    for(ui32Frame = 0; ui32Frame < ui32Frames; ui32Frame++)
+    {
+        if(pInput)
+        {
+            if(fread(g_ppui8Frame, sizeof(g_ppui8Frame), 1, pInput) != 1)
+            {
+                rewind(pInput);
+                if(fread(g_ppui8Frame, sizeof(g_ppui8Frame), 1, pInput) != 1)
+                {
+                    fprintf(stderr, "%s: no whole frame\n", pcInput);
+                    return(1);
+                }
+            }
+        }
+        else
+        {
+            SendAnimate(ui32Frame);
+        }
+
+        if((ui32Frame % ui32KeyInterval) == 0)
+        {
+            ui32Len = SendEncode(pui8Out, STREAM_KEYFRAME, ui32Frame);
+            ui32Keys++;
+        }
+        else
+        {
+            ui32Len = SendEncode(pui8Out, STREAM_DELTA, ui32Frame);
+        }
+        SendWrite(iFd, pui8Out, ui32Len);
+        ui64Bytes += ui32Len;
+
+        if(ui32Fps)
+        {
+            dNext += 1.0 / ui32Fps;
+            dElapsed = dNext - SendNow();
+            if(dElapsed > 0)
+            {
+                usleep(dElapsed * 1e6);
+            }
+        }
+    }
+    ui32Len = SendEncode(pui8Out, STREAM_RELEASE, ui32Frame);
+    SendWrite(iFd, pui8Out, ui32Len);
+    ui64Bytes += ui32Len;
+    dElapsed = SendNow() - dStart;
+
+    if(pcLink)
+    {
+        //
+        // Wait until the reader has taken everything, seen twice 100ms
+        // apart since the pseudo-terminal passes data on in the background
+        //
+        for(iIdle = 0; iIdle < 2; )
+        {
+            usleep(100000);
+            if(ioctl(iSlave, FIONREAD, &iQueued) != 0)
+            {
+                break;
+            }
+            iIdle = iQueued ? 0 : iIdle + 1;
+        }
+        unlink(pcLink);
+        close(iSlave);
+    }
+    else
+    {
+        tcdrain(iFd);
+    }
+    close(iFd);
+
+    printf("sent %u frames (%u key), %llu bytes, %.1f bytes/frame, "
+           "%.0f fps over %.2fs\n", ui32Frames, ui32Keys,
+           (unsigned long long)ui64Bytes,
+           ui32Frames ? (double)ui64Bytes / ui32Frames : 0.0,
+           (dElapsed > 0) ? ui32Frames / dElapsed : 0.0, dElapsed);
+    return(0);
+}
@@ -0,0 +1,545 @@
+//*****************************************************************************
+//
+// telemetry_decode.c - Print or log the telemetry records of the Idiotbox.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Reads the firmware's UART output, console text with the telemetry records
+// of test_tlc5941/telemetry.h among it, from a serial line, a file or
+// stdin. The text is passed through to stdout and each record printed as a
+// line, with the key events and the interrupts per frame since the record
+// before, or written as a row of a CSV file.
+//
+// With -e the records are first asked for: a STREAM_TELEMETRY frame with
+// the period is sent on the line, which is then opened for writing too.
+//
+// At the end, or after -n records, a summary is printed. It exits with 1
+// if any record was lost or damaged on the line.
+//
+// Usage: telemetry_decode [-c records.csv] [-e frames] [-b baud] [-n records]
+//                         [-q] [INPUT]
+//   -c  write every record to this CSV file
+//   -e  ask for a record every this many display frames; INPUT must be the
+//       serial line
+//   -b  line rate of INPUT when it is a serial line (default STREAM_BAUD)
+//   -n  stop after this many records
+//   -q  print neither the text nor the records, only the summary
+//
+//*****************************************************************************
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include "stream.h"
+#include "telemetry.h"
+
+//
+// Bytes of a record after its sync bytes and type: seq, payload and check
+//
+#define DECODE_BODY_BYTES       (TELEMETRY_STATUS_BYTES + 3)
+
+//
+// Decoder states
+//
+#define DECODE_TEXT             0
+#define DECODE_SYNC1            1
+#define DECODE_TYPE             2
+#define DECODE_BODY             3
+
+//*****************************************************************************
+//
+// Decoder state and totals
+//
+//*****************************************************************************
+static struct
+{
+    uint32_t ui32State;
+    uint8_t pui8Body[DECODE_BODY_BYTES];
+    uint32_t ui32BodyLen;
+
+    bool bQuiet;
+    FILE *pCsv;
+
+    uint32_t ui32Records;
+    uint32_t ui32Lost;
+    uint32_t ui32Damaged;
+    uint32_t ui32Skipped;       // bytes neither text nor a whole record
+    uint32_t ui32KeyEvents;
+    uint32_t ui32KeysMissed;    // events past TELEMETRY_KEYS between records
+
+    //
+    // The record before, for the sequence and the differences
+    //
+    bool bHavePrev;
+    uint8_t ui8PrevSeq;
+    tTelemetryStatus sPrev;
+
+    //
+    // Sums over the records after the first
+    //
+    uint32_t ui32Frames;
+    uint32_t pui32Ints[TELEMETRY_NUM_INTS];
+    uint32_t ui32RenderPeak;
+    uint32_t ui32RefillPeak;
+}
+g_sDecode;
+
+static const char *g_ppcIntNames[TELEMETRY_NUM_INTS] =
+{
+    "pwm", "systick", "stream"
+};
+
+static void
+DecodeUsage(const char *pcName)
+{
+    fprintf(stderr, "usage: %s [-c records.csv] [-e frames] [-b baud] "
+            "[-n records] [-q] [INPUT]\n", pcName);
+    exit(2);
+}
+
+//*****************************************************************************
+//
+// Format the key events new in psStatus, oldest first, as "+5 -5": a press
+// and a release of key 5. Returns the number of new events.
+//
+//*****************************************************************************
+static uint32_t
+DecodeKeys(const tTelemetryStatus *psStatus, char *pcOut)
+{
+    uint32_t ui32New, ui32Shown, idx;
+    uint8_t ui8Key;
+
+    ui32New = (uint16_t)(psStatus->ui16KeyEvents -
+                         (g_sDecode.bHavePrev ?
+                          g_sDecode.sPrev.ui16KeyEvents : 0));
+    ui32Shown = (ui32New > TELEMETRY_KEYS) ? TELEMETRY_KEYS : ui32New;
+
+    *pcOut = '\0';
+    for(idx = ui32Shown; idx; idx--)
+    {
+        ui8Key = psStatus->pui8Keys[idx - 1];
+        pcOut += sprintf(pcOut, "%s%c%u", (idx == ui32Shown) ? "" : " ",
+                         (ui8Key & TELEMETRY_KEY_DOWN) ? '+' : '-',
+                         ui8Key & 0xF);
+    }
+    g_sDecode.ui32KeysMissed += ui32New - ui32Shown;
+    return(ui32New);
+}
+
+static void
+DecodeCsvHeader(FILE *pCsv)
+{
+    fprintf(pCsv, "seq,frame,pwm_ints,systick_ints,stream_ints,row_missed,"
+            "audio_underruns,faults,render_mean,render_peak,refill_mean,"
+            "refill_peak,key_events,keys,function,freq_idx,patt_idx,flags,"
+            "period,dropped,console_dropped\n");
+}
+
+//*****************************************************************************
+//
+// Act on a record that has passed its check
+//
+//*****************************************************************************
+static void
+DecodeRecord(uint8_t ui8Seq, const tTelemetryStatus *psStatus)
+{
+    char pcKeys[TELEMETRY_KEYS * 5];
+    uint32_t ui32Frames, idx;
+
+    if(g_sDecode.bHavePrev && (ui8Seq != (uint8_t)(g_sDecode.ui8PrevSeq + 1)))
+    {
+        g_sDecode.ui32Lost += (uint8_t)(ui8Seq - g_sDecode.ui8PrevSeq - 1);
+    }
+    g_sDecode.ui32KeyEvents += DecodeKeys(psStatus, pcKeys);
+
+    //
+    // Interrupts per frame since the record before
+    //
+    ui32Frames = g_sDecode.bHavePrev ?
+                 psStatus->ui32Frame - g_sDecode.sPrev.ui32Frame : 0;
+    if(ui32Frames)
+    {
+        g_sDecode.ui32Frames += ui32Frames;
+        for(idx = 0; idx < TELEMETRY_NUM_INTS; idx++)
+        {
+            g_sDecode.pui32Ints[idx] += psStatus->pui32Ints[idx] -
+                                        g_sDecode.sPrev.pui32Ints[idx];
+        }
+    }
+    if(psStatus->ui16RenderPeak > g_sDecode.ui32RenderPeak)
+    {
+        g_sDecode.ui32RenderPeak = psStatus->ui16RenderPeak;
+    }
+    if(psStatus->ui16RefillPeak > g_sDecode.ui32RefillPeak)
+    {
+        g_sDecode.ui32RefillPeak = psStatus->ui16RefillPeak;
+    }
+
+    if(!g_sDecode.bQuiet)
+    {
+        printf("telemetry %3u frame %6u", ui8Seq, psStatus->ui32Frame);
+        for(idx = 0; idx < TELEMETRY_NUM_INTS; idx++)
+        {
+            printf(" %s %u", g_ppcIntNames[idx],
+                   ui32Frames ? (psStatus->pui32Ints[idx] -
+                                 g_sDecode.sPrev.pui32Ints[idx]) /
+                                ui32Frames : 0);
+        }
+        printf(" missed %u underruns %u faults %u render %u/%u "
+               "refill %u/%u fn %u freq %u patt %u %c%c%c%c",
+               psStatus->ui32RowMissed, psStatus->ui32AudioUnderruns,
+               psStatus->ui32Faults, psStatus->ui16RenderMean,
+               psStatus->ui16RenderPeak, psStatus->ui16RefillMean,
+               psStatus->ui16RefillPeak, psStatus->ui8Function,
+               psStatus->ui8FreqIdx, psStatus->ui16PattIdx,
+               (psStatus->ui8Flags & TELEMETRY_FLAG_KEY) ? 'K' : '-',
+               (psStatus->ui8Flags & TELEMETRY_FLAG_STREAM) ? 'S' : '-',
+               (psStatus->ui8Flags & TELEMETRY_FLAG_PARKED) ? 'P' : '-',
+               (psStatus->ui8Flags & TELEMETRY_FLAG_SONG) ? 'M' : '-');
+        if(pcKeys[0])
+        {
+            printf(" keys %s", pcKeys);
+        }
+        printf("\n");
+    }
+
+    if(g_sDecode.pCsv)
+    {
+        fprintf(g_sDecode.pCsv, "%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,"
+                "%s,%u,%u,%u,%u,%u,%u,%u\n", ui8Seq, psStatus->ui32Frame,
+                psStatus->pui32Ints[TELEMETRY_INT_PWM],
+                psStatus->pui32Ints[TELEMETRY_INT_SYSTICK],
+                psStatus->pui32Ints[TELEMETRY_INT_STREAM],
+                psStatus->ui32RowMissed, psStatus->ui32AudioUnderruns,
+                psStatus->ui32Faults, psStatus->ui16RenderMean,
+                psStatus->ui16RenderPeak, psStatus->ui16RefillMean,
+                psStatus->ui16RefillPeak, psStatus->ui16KeyEvents, pcKeys,
+                psStatus->ui8Function, psStatus->ui8FreqIdx,
+                psStatus->ui16PattIdx, psStatus->ui8Flags,
+                psStatus->ui8Period, psStatus->ui16Dropped,
+                psStatus->ui16ConsoleDropped);
+    }
+
+    g_sDecode.ui32Records++;
+    g_sDecode.bHavePrev = true;
+    g_sDecode.ui8PrevSeq = ui8Seq;
+    g_sDecode.sPrev = *psStatus;
+}
+
+//*****************************************************************************
+//
+// Check a whole record body, seq to check, and act on it if it passes
+//
+//*****************************************************************************
+static void
+DecodeBody(void)
+{
+    tTelemetryStatus sStatus;
+    uint32_t ui32Sum1, ui32Sum2, idx;
+
+    //
+    // Fletcher-16 of the type, seq and payload, as in telemetry.c
+    //
+    ui32Sum1 = ui32Sum2 = TELEMETRY_STATUS;
+    for(idx = 0; idx < DECODE_BODY_BYTES - 2; idx++)
+    {
+        ui32Sum1 = (ui32Sum1 + g_sDecode.pui8Body[idx]) % 255;
+        ui32Sum2 = (ui32Sum2 + ui32Sum1) % 255;
+    }
+    if((g_sDecode.pui8Body[DECODE_BODY_BYTES - 2] != ui32Sum1) ||
+       (g_sDecode.pui8Body[DECODE_BODY_BYTES - 1] != ui32Sum2))
+    {
+        g_sDecode.ui32Damaged++;
+        return;
+    }
+    memcpy(&sStatus, &g_sDecode.pui8Body[1], TELEMETRY_STATUS_BYTES);
+    DecodeRecord(g_sDecode.pui8Body[0], &sStatus);
+}
+
+static void
+DecodeText(uint8_t ui8Byte)
+{
+    if(ui8Byte & 0x80)
+    {
+        g_sDecode.ui32Skipped++;
+    }
+    else if(!g_sDecode.bQuiet)
+    {
+        putchar(ui8Byte);
+    }
+}
+
+//*****************************************************************************
+//
+// Feed one byte from the line through the decoder
+//
+//*****************************************************************************
+static void
+DecodeByte(uint8_t ui8Byte)
+{
+    switch(g_sDecode.ui32State)
+    {
+        case DECODE_TEXT:
+            if(ui8Byte == STREAM_SYNC0)
+            {
+                g_sDecode.ui32State = DECODE_SYNC1;
+            }
+            else
+            {
+                DecodeText(ui8Byte);
+            }
+            break;
+
+        case DECODE_SYNC1:
+            if(ui8Byte == STREAM_SYNC1)
+            {
+                g_sDecode.ui32State = DECODE_TYPE;
+                break;
+            }
+            g_sDecode.ui32Skipped++;
+            if(ui8Byte != STREAM_SYNC0)
+            {
+                g_sDecode.ui32State = DECODE_TEXT;
+                DecodeText(ui8Byte);
+            }
+            break;
+
+        case DECODE_TYPE:
+            if(ui8Byte == TELEMETRY_STATUS)
+            {
+                g_sDecode.ui32BodyLen = 0;
+                g_sDecode.ui32State = DECODE_BODY;
+            }
+            else
+            {
+                g_sDecode.ui32Damaged++;
+                g_sDecode.ui32State = DECODE_TEXT;
+            }
+            break;
+
+        default:
+            g_sDecode.pui8Body[g_sDecode.ui32BodyLen++] = ui8Byte;
+            if(g_sDecode.ui32BodyLen == DECODE_BODY_BYTES)
+            {
+                DecodeBody();
+                g_sDecode.ui32State = DECODE_TEXT;
+            }
+            break;
+    }
+}
+
+//*****************************************************************************
+//
+// Send the STREAM_TELEMETRY frame asking for a record every ui32Period
+// frames. It takes no part in the stream's sequence, so its seq is 0.
+//
+//*****************************************************************************
+static void
+DecodeRequest(int iFd, uint32_t ui32Period)
+{
+    uint8_t pui8Frame[STREAM_OVERHEAD + 1];
+    uint32_t ui32Sum1, ui32Sum2, idx;
+
+    pui8Frame[0] = STREAM_SYNC0;
+    pui8Frame[1] = STREAM_SYNC1;
+    pui8Frame[2] = STREAM_TELEMETRY;
+    pui8Frame[3] = 0;
+    pui8Frame[4] = ui32Period;
+    ui32Sum1 = ui32Sum2 = 0;
+    for(idx = 2; idx < 5; idx++)
+    {
+        ui32Sum1 = (ui32Sum1 + pui8Frame[idx]) % 255;
+        ui32Sum2 = (ui32Sum2 + ui32Sum1) % 255;
+    }
+    pui8Frame[5] = ui32Sum1;
+    pui8Frame[6] = ui32Sum2;
+    if(write(iFd, pui8Frame, sizeof(pui8Frame)) != sizeof(pui8Frame))
+    {
+        perror("write");
+        exit(1);
+    }
+}
+
+//
+// Raw 8-bit line at ui32Baud, where the input has a rate
+//
+static void
+DecodeRaw(int iFd, uint32_t ui32Baud)
+{
+    struct termios sTerm;
+
+    if(tcgetattr(iFd, &sTerm) != 0)
+    {
+        return;
+    }
+    cfmakeraw(&sTerm);
+    cfsetspeed(&sTerm, (ui32Baud == 1000000) ? B1000000 :
+                       (ui32Baud == 921600) ? B921600 :
+                       (ui32Baud == 460800) ? B460800 : B115200);
+    tcsetattr(iFd, TCSANOW, &sTerm);
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+    uint32_t ui32Period = 0, ui32Baud = STREAM_BAUD, ui32Max = 0, idx;
+    const char *pcCsv = NULL;
+    bool bRequest = false;
+    uint8_t pui8Data[256];
+    ssize_t iRead;
+    int iOpt, iFd;
+
+    while((iOpt = getopt(argc, argv, "c:e:b:n:q")) != -1)
+    {
+        switch(iOpt)
+        {
+            case 'c':
+                pcCsv = optarg;
+                break;
+            case 'e':
+                ui32Period = strtoul(optarg, NULL, 0);
+                bRequest = true;
+                if(ui32Period > TELEMETRY_PERIOD_MAX)
+                {
+                    DecodeUsage(argv[0]);
+                }
+                break;
+            case 'b':
+                ui32Baud = strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                ui32Max = strtoul(optarg, NULL, 0);
+                break;
+            case 'q':
+                g_sDecode.bQuiet = true;
+                break;
+            default:
+                DecodeUsage(argv[0]);
+        }
+    }
+    if((optind < argc - 1) || (bRequest && (optind == argc)))
+    {
+        DecodeUsage(argv[0]);
+    }
+
+    iFd = STDIN_FILENO;
+    if(optind < argc)
+    {
+        iFd = open(argv[optind], (bRequest ? O_RDWR : O_RDONLY) | O_NOCTTY);
+        if(iFd < 0)
+        {
+            perror(argv[optind]);
+            return(1);
+        }
+    }
+    if(isatty(iFd))
+    {
+        DecodeRaw(iFd, ui32Baud);
+    }
+    if(bRequest)
+    {
+        DecodeRequest(iFd, ui32Period);
+    }
+
+    if(pcCsv)
+    {
+        g_sDecode.pCsv = fopen(pcCsv, "w");
+        if(!g_sDecode.pCsv)
+        {
+            perror(pcCsv);
+            return(1);
+        }
+        DecodeCsvHeader(g_sDecode.pCsv);
+    }
+
+    while(!ui32Max || (g_sDecode.ui32Records < ui32Max))
+    {
+        iRead = read(iFd, pui8Data, sizeof(pui8Data));
+        if(iRead < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            //
+            // EIO from a pseudo-terminal whose writer has gone ends it too
+            //
+            if(errno != EIO)
+            {
+                perror("read");
+            }
+            break;
+        }
+        if(iRead == 0)
+        {
+            break;
+        }
+        for(idx = 0; idx < (uint32_t)iRead; idx++)
+        {
+            DecodeByte(pui8Data[idx]);
+            if(ui32Max && (g_sDecode.ui32Records == ui32Max))
+            {
+                break;
+            }
+        }
+        if(!g_sDecode.bQuiet)
+        {
+            fflush(stdout);
+        }
+    }
+    if(bRequest)
+    {
+        DecodeRequest(iFd, 0);
+    }
+    if(g_sDecode.pCsv)
+    {
+        fclose(g_sDecode.pCsv);
+    }
+    if(iFd != STDIN_FILENO)
+    {
+        close(iFd);
+    }
+
+    printf("telemetry %u records, %u lost, %u damaged, %u bytes skipped\n",
+           g_sDecode.ui32Records, g_sDecode.ui32Lost, g_sDecode.ui32Damaged,
+           g_sDecode.ui32Skipped);
+    if(g_sDecode.bHavePrev)
+    {
+        printf("telemetry %u key events, %u not in a record; "
+               "%u records and %u console bytes dropped on the board\n",
+               g_sDecode.ui32KeyEvents, g_sDecode.ui32KeysMissed,
+               g_sDecode.sPrev.ui16Dropped,
+               g_sDecode.sPrev.ui16ConsoleDropped);
+        printf("telemetry %u frames:", g_sDecode.ui32Frames);
+        for(idx = 0; idx < TELEMETRY_NUM_INTS; idx++)
+        {
+            printf(" %s %.2f", g_ppcIntNames[idx], g_sDecode.ui32Frames ?
+                   (double)g_sDecode.pui32Ints[idx] / g_sDecode.ui32Frames :
+                   0.0);
+        }
+        printf(" interrupts/frame\n");
+        printf("telemetry %u rows missed, %u audio underruns, %u faults; "
+               "peak render %u, refill %u cycles\n",
+               g_sDecode.sPrev.ui32RowMissed,
+               g_sDecode.sPrev.ui32AudioUnderruns,
+               g_sDecode.sPrev.ui32Faults, g_sDecode.ui32RenderPeak,
+               g_sDecode.ui32RefillPeak);
+    }
+    return((g_sDecode.ui32Lost || g_sDecode.ui32Damaged) ? 1 : 0);
+}
@@ -0,0 +1,1254 @@
+//*****************************************************************************
+//
+// trace_replay.c - Turn event traces into LED frames and DAC waveforms.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Reads traces written by hostrun or saved from g_sTrace on the target (see
+// trace.h for the layout).
+//
+// Usage:
+//   trace_replay dump TRACE            print every record
+//   trace_replay frames TRACE [PREFIX] show each 8x8 frame as text, or write
+//                                      PREFIX_NNNN.ppm images
+//   trace_replay dac TRACE OUT.csv     write the PWM DAC timer match values
+//   trace_replay wav TRACE OUT.wav     write the PWM DAC output as 16-bit PCM
+//   trace_replay audio TRACE           measure every tone; exit 1 if one
+//                                      breaks the AUDIO_MAX_ limits
+//   trace_replay diff TRACE1 TRACE2    compare records and frames; exit 1 if
+//                                      the traces differ
+//   trace_replay latches TRACE1 TRACE2 compare only what each XLAT latched;
+//                                      exit 1 if any latch differs
+//   trace_replay scan TRACE [FROM TO]  slots, duty, refresh rate and light of
+//                                      each LED row, from tick FROM to TO
+//
+// Frames are rebuilt the way the hardware sees the data: an XLAT rising edge
+// latches the 32 grayscale values in the TLC5941s' shift registers and, in
+// the row driver, the row pins written after the previous XLAT (the last
+// TRACE_ROW record). The shift registers are modelled bit by bit, 384 bits
+// for the two chips, so 12-bit frames (TRACE_SSI) and 16-bit frames packed
+// with GS_PACKED (TRACE_SSI16) load them alike.
+// A frame is complete at the latch of the last slot of the scan plan, or of
+// row 7 in traces from before the plan (version 1).
+//
+// The scan command counts the latches of each row: its share of the slots
+// (duty), how often it was latched and the longest wait between latches,
+// and its light, the mean grayscale of its LEDs weighted by its duty and
+// scaled to a plain scan's 1/8 duty, which the scan plan keeps even.
+//
+// Audio is the TRACE_MATCH value sent every tick. The audio command splits
+// it into runs of sound between silences, the DAC resting at its midpoint,
+// and prints a CSV line for each: the key held, its tone's frequency as
+// set by toneFreqMap and as measured, level, SNR, THD and THD+N from a
+// least-squares fit of the fundamental and its harmonics over the
+// sustained part of the tone, the largest sample-to-sample step of the fit
+// residual at the start of a refilled buffer half and inside halves,
+// halves that do not fit the tone, the step from and to silence at the
+// onset and cut, in timer match counts, and the energy of the larger step
+// against a full-scale sine, the click heard at the note's edge.
+//
+//*****************************************************************************
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+//
+// GPIO port A pins and port number for BLANK and XLAT
+//
+#define REPLAY_PORTA            0x04
+#define REPLAY_PIN_XLAT         0x40
+#define REPLAY_PIN_BLANK        0x80
+
+//
+// Grayscale word index of each color per column, as REDIDX, GREENIDX and
+// BLUEIDX in test_tlc5941.c for the model 2 board.
+//
+#define REPLAY_RED(col)         (31 - (col))
+#define REPLAY_GREEN(col)       ((col) + 4)
+#define REPLAY_BLUE(col)        (23 - (col))
+
+#define REPLAY_MAX_DIFFS        10
+
+//
+// PWM DAC timer period, as PWMDAC_PERIOD in test_tlc5941.c, and the phase
+// step per sample of each key's tone, as toneFreqMap. Keys from
+// AUDIO_FIRST_SONG_KEY (MELODY_FIRST_KEY in melody.h) play songs instead.
+//
+#define REPLAY_PWM_PERIOD       2500
+#define AUDIO_FIRST_SONG_KEY    12
+
+static const uint32_t g_pui32ToneFreq[16] =
+{
+    1500, 1783, 2119, 2518, 2993, 3557, 4227, 5024,
+    5791, 7097, 8434, 10024, 11914, 14159, 16828, 20000
+};
+
+//
+// Audio measurement: sound ends once the DAC rests at the midpoint for
+// AUDIO_SILENCE samples. A tone is fitted from the end of its attack and
+// decay to the start of its release, g_sToneShape in test_tlc5941.c plus a
+// buffer half for the envelope's steps, if that leaves AUDIO_MIN_TONE
+// samples. A tone fails if its frequency is off by more than
+// AUDIO_MAX_FREQ_PPM, its THD+N is above AUDIO_MAX_THDN_DB, or a buffer
+// half fits AUDIO_GAP_NOISE times worse than the tone as a whole. Any run
+// of sound fails if it starts or stops with a step above AUDIO_MAX_EDGE_DB.
+//
+#define AUDIO_SILENCE           32
+#define AUDIO_SETTLE            (80 + 800 + 32)
+#define AUDIO_RELEASE           (800 + 32)
+#define AUDIO_MIN_TONE          512
+#define AUDIO_MAX_HARMONICS     9
+#define AUDIO_MAX_FREQ_PPM      100.0
+#define AUDIO_MAX_THDN_DB       -60.0
+#define AUDIO_GAP_NOISE         4.0
+#define AUDIO_MAX_EDGE_DB       -30.0
+
+typedef struct
+{
+    tTraceRecord *psRecords;
+    uint32_t ui32Count;
+    uint16_t ui16Version;
+}
+tTrace;
+
+typedef struct
+{
+    uint32_t ui32Tick;
+    uint16_t pui16Pixel[8][8][3];
+}
+tFrame;
+
+//
+// The two daisy-chained TLC5941 grayscale shift registers, 192 bits each.
+// Bit 0 of pui64Bits[0] is the last bit shifted in; the first value sent,
+// word 0, is the top 12 bits.
+//
+#define REPLAY_SHIFT_BITS       384
+
+typedef struct
+{
+    uint64_t pui64Bits[REPLAY_SHIFT_BITS / 64];
+    uint32_t ui32Bits;              // shifted in so far
+}
+tShift;
+
+//*****************************************************************************
+//
+// Load a trace, unwrapping the ring into time order.
+//
+//*****************************************************************************
+static int
+ReplayLoad(const char *pcFile, tTrace *psTrace)
+{
+    tTraceHeader sHeader;
+    tTraceRecord *psRing;
+    uint32_t idx, ui32Tail;
+    FILE *pFile;
+
+    pFile = fopen(pcFile, "rb");
+    if(!pFile)
+    {
+        perror(pcFile);
+        return(-1);
+    }
+    if((fread(&sHeader, sizeof(sHeader), 1, pFile) != 1) ||
+       (sHeader.ui32Magic != TRACE_MAGIC) ||
+       (sHeader.ui16RecordSize != sizeof(tTraceRecord)) ||
+       (sHeader.ui32Count > sHeader.ui32Capacity))
+    {
+        fprintf(stderr, "%s: not a trace file\n", pcFile);
+        fclose(pFile);
+        return(-1);
+    }
+
+    psRing = calloc(sHeader.ui32Capacity + 1, sizeof(tTraceRecord));
+    psTrace->psRecords = calloc(sHeader.ui32Count + 1, sizeof(tTraceRecord));
+    if(fread(psRing, sizeof(tTraceRecord), sHeader.ui32Capacity, pFile) !=
+       sHeader.ui32Capacity)
+    {
+        fprintf(stderr, "%s: truncated\n", pcFile);
+        fclose(pFile);
+        return(-1);
+    }
+    fclose(pFile);
+
+    ui32Tail = (sHeader.ui32Head + sHeader.ui32Capacity - sHeader.ui32Count) %
+               (sHeader.ui32Capacity ? sHeader.ui32Capacity : 1);
+    for(idx = 0; idx < sHeader.ui32Count; idx++)
+    {
+        psTrace->psRecords[idx] =
+            psRing[(ui32Tail + idx) % sHeader.ui32Capacity];
+    }
+    psTrace->ui32Count = sHeader.ui32Count;
+    psTrace->ui16Version = sHeader.ui16Version;
+    free(psRing);
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Shift register model. An SSI record shifts its frame in MSB first.
+// Returns false for records that are not SSI frames.
+//
+//*****************************************************************************
+static bool
+ReplayShiftRecord(tShift *psShift, const tTraceRecord *psRec)
+{
+    uint32_t idx, ui32Width;
+
+    if(psRec->ui8Type == TRACE_SSI)
+    {
+        ui32Width = 12;
+    }
+    else if(psRec->ui8Type == TRACE_SSI16)
+    {
+        ui32Width = 16;
+    }
+    else
+    {
+        return(false);
+    }
+    for(idx = REPLAY_SHIFT_BITS / 64 - 1; idx > 0; idx--)
+    {
+        psShift->pui64Bits[idx] = (psShift->pui64Bits[idx] << ui32Width) |
+                                  (psShift->pui64Bits[idx - 1] >>
+                                   (64 - ui32Width));
+    }
+    psShift->pui64Bits[0] = (psShift->pui64Bits[0] << ui32Width) |
+                            (psRec->ui16Value & ((1 << ui32Width) - 1));
+    psShift->ui32Bits += ui32Width;
+    return(true);
+}
+
+//
+// The 12-bit value of grayscale word 0 to 31, in the order they are sent
+//
+static uint16_t
+ReplayShiftValue(const tShift *psShift, uint32_t ui32Word)
+{
+    uint32_t ui32Bit;
+    uint64_t ui64Value;
+
+    ui32Bit = REPLAY_SHIFT_BITS - 12 * (ui32Word + 1);
+    ui64Value = psShift->pui64Bits[ui32Bit / 64] >> (ui32Bit % 64);
+    if((ui32Bit % 64) > 52)
+    {
+        ui64Value |= psShift->pui64Bits[ui32Bit / 64 + 1] <<
+                     (64 - ui32Bit % 64);
+    }
+    return(ui64Value & 0xFFF);
+}
+
+//*****************************************************************************
+//
+// Rebuild frames. Returns the number of complete frames; *ppsFrames is
+// allocated to hold them.
+//
+//*****************************************************************************
+static uint32_t
+ReplayFrames(const tTrace *psTrace, tFrame **ppsFrames)
+{
+    tShift sShift;
+    uint32_t idx, ui32Frames, ui32Max, ui32Col, ui32Row;
+    uint32_t ui32Last;
+    const tTraceRecord *psRec;
+    tFrame sCurrent;
+    int32_t i32PendingRow, i32PendingLast;
+    bool bXlat;
+
+    memset(&sShift, 0, sizeof(sShift));
+    memset(&sCurrent, 0, sizeof(sCurrent));
+    ui32Frames = 0;
+    ui32Max = 16;
+    *ppsFrames = malloc(ui32Max * sizeof(tFrame));
+    i32PendingRow = -1;
+    i32PendingLast = -1;
+    bXlat = false;
+
+    //
+    // What marks the last latch of a frame: slot 7, or row 7 before slots
+    //
+    ui32Last = (psTrace->ui16Version >= 2) ? 3 : 0;
+
+    for(idx = 0; idx < psTrace->ui32Count; idx++)
+    {
+        psRec = &psTrace->psRecords[idx];
+        if(ReplayShiftRecord(&sShift, psRec))
+        {
+            continue;
+        }
+        switch(psRec->ui8Type)
+        {
+            case TRACE_ROW:
+                i32PendingRow = psRec->ui8Arg & 7;
+                i32PendingLast = ((psRec->ui8Arg >> ui32Last) & 7) == 7;
+                break;
+
+            case TRACE_GPIO:
+                if(((psRec->ui16Value >> 8) != REPLAY_PORTA) ||
+                   !(psRec->ui8Arg & REPLAY_PIN_XLAT))
+                {
+                    break;
+                }
+                if((psRec->ui16Value & REPLAY_PIN_XLAT) && !bXlat &&
+                   (i32PendingRow >= 0))
+                {
+                    ui32Row = i32PendingRow;
+                    for(ui32Col = 0; ui32Col < 8; ui32Col++)
+                    {
+                        sCurrent.pui16Pixel[ui32Row][ui32Col][0] =
+                            ReplayShiftValue(&sShift, REPLAY_RED(ui32Col));
+                        sCurrent.pui16Pixel[ui32Row][ui32Col][1] =
+                            ReplayShiftValue(&sShift, REPLAY_GREEN(ui32Col));
+                        sCurrent.pui16Pixel[ui32Row][ui32Col][2] =
+                            ReplayShiftValue(&sShift, REPLAY_BLUE(ui32Col));
+                    }
+                    if(i32PendingLast &&
+                       (sShift.ui32Bits >= REPLAY_SHIFT_BITS))
+                    {
+                        if(ui32Frames == ui32Max)
+                        {
+                            ui32Max *= 2;
+                            *ppsFrames = realloc(*ppsFrames,
+                                                 ui32Max * sizeof(tFrame));
+                        }
+                        sCurrent.ui32Tick = psRec->ui32Tick;
+                        (*ppsFrames)[ui32Frames++] = sCurrent;
+                    }
+                }
+                bXlat = (psRec->ui16Value & REPLAY_PIN_XLAT) != 0;
+                break;
+
+            default:
+                break;
+        }
+    }
+    return(ui32Frames);
+}
+
+//*****************************************************************************
+//
+// Commands
+//
+//*****************************************************************************
+static int
+ReplayDump(const tTrace *psTrace)
+{
+    static const char *ppcType[] = { "?", "SSI", "GPIO", "MATCH", "ROW",
+                                     "KEY", "SSI16" };
+    const tTraceRecord *psRec;
+    uint32_t idx;
+
+    for(idx = 0; idx < psTrace->ui32Count; idx++)
+    {
+        psRec = &psTrace->psRecords[idx];
+        printf("%10u %-5s %3u 0x%04x\n", psRec->ui32Tick,
+               ppcType[(psRec->ui8Type <= TRACE_SSI16) ? psRec->ui8Type : 0],
+               psRec->ui8Arg, psRec->ui16Value);
+    }
+    return(0);
+}
+
+static int
+ReplayShowFrames(const tTrace *psTrace, const char *pcPrefix)
+{
+    tFrame *psFrames;
+    uint32_t ui32Frames, idx, ui32Row, ui32Col, ui32Chan;
+    char pcName[256];
+    FILE *pFile;
+
+    ui32Frames = ReplayFrames(psTrace, &psFrames);
+    for(idx = 0; idx < ui32Frames; idx++)
+    {
+        if(pcPrefix)
+        {
+            snprintf(pcName, sizeof(pcName), "%s_%04u.ppm", pcPrefix, idx);
+            pFile = fopen(pcName, "wb");
+            if(!pFile)
+            {
+                perror(pcName);
+                return(1);
+            }
+            fprintf(pFile, "P6\n8 8\n255\n");
+            for(ui32Row = 0; ui32Row < 8; ui32Row++)
+            {
+                for(ui32Col = 0; ui32Col < 8; ui32Col++)
+                {
+                    for(ui32Chan = 0; ui32Chan < 3; ui32Chan++)
+                    {
+                        fputc(psFrames[idx].pui16Pixel[ui32Row][ui32Col]
+                              [ui32Chan] >> 4, pFile);
+                    }
+                }
+            }
+            fclose(pFile);
+            continue;
+        }
+
+        printf("frame %u, tick %u\n", idx, psFrames[idx].ui32Tick);
+        for(ui32Row = 0; ui32Row < 8; ui32Row++)
+        {
+            for(ui32Col = 0; ui32Col < 8; ui32Col++)
+            {
+                const uint16_t *pui16Px =
+                    psFrames[idx].pui16Pixel[ui32Row][ui32Col];
+                putchar((pui16Px[0] | pui16Px[1] | pui16Px[2]) ? '#' : '.');
+            }
+            putchar('\n');
+        }
+    }
+    if(pcPrefix)
+    {
+        printf("%u frames written to %s_NNNN.ppm\n", ui32Frames, pcPrefix);
+    }
+    free(psFrames);
+    return(0);
+}
+
+static int
+ReplayDac(const tTrace *psTrace, const char *pcFile)
+{
+    const tTraceRecord *psRec;
+    uint32_t idx, ui32Samples;
+    FILE *pFile;
+
+    pFile = fopen(pcFile, "w");
+    if(!pFile)
+    {
+        perror(pcFile);
+        return(1);
+    }
+    fprintf(pFile, "tick,match\n");
+    ui32Samples = 0;
+    for(idx = 0; idx < psTrace->ui32Count; idx++)
+    {
+        psRec = &psTrace->psRecords[idx];
+        if(psRec->ui8Type == TRACE_MATCH)
+        {
+            fprintf(pFile, "%u,%u\n", psRec->ui32Tick, psRec->ui16Value);
+            ui32Samples++;
+        }
+    }
+    fclose(pFile);
+    printf("%u DAC samples written to %s\n", ui32Samples, pcFile);
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Audio. The DAC samples are the TRACE_MATCH records, one per 16kHz tick.
+// Each is tagged with the key held when it was sent and whether it is the
+// first sample of a freshly filled buffer half, which is where
+// PWMIntHandler writes TRACE_ROW. While the display is parked the PWM DAC
+// is stopped and no samples are sent; the output filter holds the last
+// level, which fills the ticks missing between two samples.
+//
+//*****************************************************************************
+#define AUDIO_REFILL            0x01    // first sample of a buffer half
+#define AUDIO_NO_KEY            0xFF
+
+typedef struct
+{
+    uint16_t *pui16Match;
+    uint8_t *pui8Key;
+    uint8_t *pui8Flags;
+    uint32_t ui32Count;
+}
+tAudio;
+
+static void
+ReplayAudio(const tTrace *psTrace, tAudio *psAudio)
+{
+    const tTraceRecord *psRec;
+    uint32_t idx, ui32Count, ui32Size, ui32LastTick;
+    uint8_t ui8Key;
+    bool bStarted;
+
+    //
+    // Room for a sample every tick the trace spans
+    //
+    ui32Size = psTrace->ui32Count;
+    if(psTrace->ui32Count &&
+       (psTrace->psRecords[psTrace->ui32Count - 1].ui32Tick -
+        psTrace->psRecords[0].ui32Tick >= ui32Size))
+    {
+        ui32Size = psTrace->psRecords[psTrace->ui32Count - 1].ui32Tick -
+                   psTrace->psRecords[0].ui32Tick + 1;
+    }
+    psAudio->pui16Match = calloc(ui32Size + 1, sizeof(uint16_t));
+    psAudio->pui8Key = calloc(ui32Size + 1, 1);
+    psAudio->pui8Flags = calloc(ui32Size + 1, 1);
+    ui32Count = 0;
+    ui32LastTick = 0;
+    bStarted = false;
+    ui8Key = AUDIO_NO_KEY;
+    for(idx = 0; idx < psTrace->ui32Count; idx++)
+    {
+        psRec = &psTrace->psRecords[idx];
+        if(psRec->ui8Type == TRACE_KEY)
+        {
+            //
+            // Bit 4 of the key code is set while any key is held
+            //
+            if(psRec->ui16Value & 0x10)
+            {
+                ui8Key = psRec->ui16Value & 0xF;
+            }
+        }
+        else if(psRec->ui8Type == TRACE_MATCH)
+        {
+            while(bStarted && (psRec->ui32Tick - ui32LastTick > 1) &&
+                  (ui32Count < ui32Size))
+            {
+                psAudio->pui16Match[ui32Count] =
+                    psAudio->pui16Match[ui32Count - 1];
+                psAudio->pui8Key[ui32Count] = ui8Key;
+                ui32Count++;
+                ui32LastTick++;
+            }
+            bStarted = true;
+            ui32LastTick = psRec->ui32Tick;
+            psAudio->pui16Match[ui32Count] = psRec->ui16Value;
+            psAudio->pui8Key[ui32Count] = ui8Key;
+            ui32Count++;
+        }
+        else if((psRec->ui8Type == TRACE_ROW) && ui32Count)
+        {
+            psAudio->pui8Flags[ui32Count - 1] |= AUDIO_REFILL;
+        }
+    }
+    psAudio->ui32Count = ui32Count;
+}
+
+static void
+ReplayAudioFree(tAudio *psAudio)
+{
+    free(psAudio->pui16Match);
+    free(psAudio->pui8Key);
+    free(psAudio->pui8Flags);
+}
+
+//
+// PCM sample of a timer match value: 0% duty is full scale negative, 100%
+// full scale positive, so silence (match 0) is -32767, not 0.
+//
+static int16_t
+ReplayPcm(uint16_t ui16Match)
+{
+    int32_t i32Pcm;
+
+    i32Pcm = ((int32_t)ui16Match * 2 - REPLAY_PWM_PERIOD) * 32767 /
+             REPLAY_PWM_PERIOD;
+    return((i32Pcm > 32767) ? 32767 : ((i32Pcm < -32767) ? -32767 : i32Pcm));
+}
+
+static void
+ReplayPutLE(FILE *pFile, uint32_t ui32Value, uint32_t ui32Bytes)
+{
+    while(ui32Bytes--)
+    {
+        fputc(ui32Value & 0xFF, pFile);
+        ui32Value >>= 8;
+    }
+}
+
+static int
+ReplayWav(const tTrace *psTrace, const char *pcFile)
+{
+    tAudio sAudio;
+    uint32_t idx;
+    FILE *pFile;
+
+    pFile = fopen(pcFile, "wb");
+    if(!pFile)
+    {
+        perror(pcFile);
+        return(1);
+    }
+    ReplayAudio(psTrace, &sAudio);
+
+    //
+    // RIFF header for 16-bit mono PCM at the sample tick rate
+    //
+    fwrite("RIFF", 1, 4, pFile);
+    ReplayPutLE(pFile, 36 + sAudio.ui32Count * 2, 4);
+    fwrite("WAVEfmt ", 1, 8, pFile);
+    ReplayPutLE(pFile, 16, 4);
+    ReplayPutLE(pFile, 1, 2);
+    ReplayPutLE(pFile, 1, 2);
+    ReplayPutLE(pFile, TRACE_TICK_HZ, 4);
+    ReplayPutLE(pFile, TRACE_TICK_HZ * 2, 4);
+    ReplayPutLE(pFile, 2, 2);
+    ReplayPutLE(pFile, 16, 2);
+    fwrite("data", 1, 4, pFile);
+    ReplayPutLE(pFile, sAudio.ui32Count * 2, 4);
+    for(idx = 0; idx < sAudio.ui32Count; idx++)
+    {
+        ReplayPutLE(pFile, (uint16_t)ReplayPcm(sAudio.pui16Match[idx]), 2);
+    }
+    fclose(pFile);
+    printf("%u samples written to %s\n", sAudio.ui32Count, pcFile);
+    ReplayAudioFree(&sAudio);
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Least-squares fit of a DC term and the first ui32Harmonics harmonics of
+// dFreq (cycles per sample) to pdX. pdCoef receives the DC term followed by
+// the cosine and sine amplitude of each harmonic, pdRes (if not NULL) the
+// residual. Returns the residual energy.
+//
+//*****************************************************************************
+#define AUDIO_MAX_TERMS         (1 + 2 * AUDIO_MAX_HARMONICS)
+
+static void
+ReplayBasis(uint32_t ui32Sample, double dFreq, uint32_t ui32Harmonics,
+            double *pdBasis)
+{
+    double dAngle;
+    uint32_t ui32H;
+
+    pdBasis[0] = 1.0;
+    for(ui32H = 1; ui32H <= ui32Harmonics; ui32H++)
+    {
+        dAngle = 2.0 * M_PI * dFreq * ui32H * ui32Sample;
+        pdBasis[2 * ui32H - 1] = cos(dAngle);
+        pdBasis[2 * ui32H] = sin(dAngle);
+    }
+}
+
+static double
+ReplayFit(const double *pdX, uint32_t ui32Count, double dFreq,
+          uint32_t ui32Harmonics, double *pdCoef, double *pdRes)
+{
+    double ppdA[AUDIO_MAX_TERMS][AUDIO_MAX_TERMS + 1];
+    double pdBasis[AUDIO_MAX_TERMS], dRow, dFit, dEnergy;
+    uint32_t idx, ui32I, ui32J, ui32K, ui32Pivot, ui32Terms;
+
+    //
+    // Normal equations, with the right hand side as the last column
+    //
+    ui32Terms = 1 + 2 * ui32Harmonics;
+    memset(ppdA, 0, sizeof(ppdA));
+    for(idx = 0; idx < ui32Count; idx++)
+    {
+        ReplayBasis(idx, dFreq, ui32Harmonics, pdBasis);
+        for(ui32I = 0; ui32I < ui32Terms; ui32I++)
+        {
+            for(ui32J = ui32I; ui32J < ui32Terms; ui32J++)
+            {
+                ppdA[ui32I][ui32J] += pdBasis[ui32I] * pdBasis[ui32J];
+            }
+            ppdA[ui32I][ui32Terms] += pdBasis[ui32I] * pdX[idx];
+        }
+    }
+    for(ui32I = 0; ui32I < ui32Terms; ui32I++)
+    {
+        for(ui32J = 0; ui32J < ui32I; ui32J++)
+        {
+            ppdA[ui32I][ui32J] = ppdA[ui32J][ui32I];
+        }
+    }
+
+    //
+    // Gaussian elimination with partial pivoting, then back substitution
+    //
+    for(ui32K = 0; ui32K < ui32Terms; ui32K++)
+    {
+        ui32Pivot = ui32K;
+        for(ui32I = ui32K + 1; ui32I < ui32Terms; ui32I++)
+        {
+            if(fabs(ppdA[ui32I][ui32K]) > fabs(ppdA[ui32Pivot][ui32K]))
+            {
+                ui32Pivot = ui32I;
+            }
+        }
+        for(ui32J = 0; ui32J <= ui32Terms; ui32J++)
+        {
+            dRow = ppdA[ui32K][ui32J];
+            ppdA[ui32K][ui32J] = ppdA[ui32Pivot][ui32J];
+            ppdA[ui32Pivot][ui32J] = dRow;
+        }
+        for(ui32I = ui32K + 1; ui32I < ui32Terms; ui32I++)
+        {
+            dRow = ppdA[ui32I][ui32K] / ppdA[ui32K][ui32K];
+            for(ui32J = ui32K; ui32J <= ui32Terms; ui32J++)
+            {
+                ppdA[ui32I][ui32J] -= dRow * ppdA[ui32K][ui32J];
+            }
+        }
+    }
+    for(ui32I = ui32Terms; ui32I-- > 0; )
+    {
+        dRow = ppdA[ui32I][ui32Terms];
+        for(ui32J = ui32I + 1; ui32J < ui32Terms; ui32J++)
+        {
+            dRow -= ppdA[ui32I][ui32J] * pdCoef[ui32J];
+        }
+        pdCoef[ui32I] = dRow / ppdA[ui32I][ui32I];
+    }
+
+    dEnergy = 0.0;
+    for(idx = 0; idx < ui32Count; idx++)
+    {
+        ReplayBasis(idx, dFreq, ui32Harmonics, pdBasis);
+        dFit = 0.0;
+        for(ui32I = 0; ui32I < ui32Terms; ui32I++)
+        {
+            dFit += pdCoef[ui32I] * pdBasis[ui32I];
+        }
+        if(pdRes)
+        {
+            pdRes[idx] = pdX[idx] - dFit;
+        }
+        dEnergy += (pdX[idx] - dFit) * (pdX[idx] - dFit);
+    }
+    return(dEnergy);
+}
+
+//
+// Frequency in cycles per sample: a first estimate from the rising zero
+// crossings, then a golden section search for the best fitting sine within
+// a DFT bin of it.
+//
+static double
+ReplayFrequency(const double *pdX, uint32_t ui32Count, double dMean)
+{
+    double pdCoef[3], dFirst, dLast, dLo, dHi, dA, dB, dEA, dEB, dT;
+    uint32_t idx, ui32Crossings;
+
+    dFirst = dLast = 0.0;
+    ui32Crossings = 0;
+    for(idx = 1; idx < ui32Count; idx++)
+    {
+        if((pdX[idx - 1] < dMean) && (pdX[idx] >= dMean))
+        {
+            dT = idx - 1 + (dMean - pdX[idx - 1]) / (pdX[idx] - pdX[idx - 1]);
+            if(!ui32Crossings)
+            {
+                dFirst = dT;
+            }
+            dLast = dT;
+            ui32Crossings++;
+        }
+    }
+    if(ui32Crossings < 2)
+    {
+        return(0.0);
+    }
+
+    dT = (ui32Crossings - 1) / (dLast - dFirst);
+    dLo = dT - 1.0 / ui32Count;
+    dHi = dT + 1.0 / ui32Count;
+    dA = dHi - 0.618034 * (dHi - dLo);
+    dB = dLo + 0.618034 * (dHi - dLo);
+    dEA = ReplayFit(pdX, ui32Count, dA, 1, pdCoef, NULL);
+    dEB = ReplayFit(pdX, ui32Count, dB, 1, pdCoef, NULL);
+    while((dHi - dLo) > 1e-10 * dT)
+    {
+        if(dEA < dEB)
+        {
+            dHi = dB;
+            dB = dA;
+            dEB = dEA;
+            dA = dHi - 0.618034 * (dHi - dLo);
+            dEA = ReplayFit(pdX, ui32Count, dA, 1, pdCoef, NULL);
+        }
+        else
+        {
+            dLo = dA;
+            dA = dB;
+            dEA = dEB;
+            dB = dLo + 0.618034 * (dHi - dLo);
+            dEB = ReplayFit(pdX, ui32Count, dB, 1, pdCoef, NULL);
+        }
+    }
+    return((dLo + dHi) / 2);
+}
+
+//*****************************************************************************
+//
+// Measure one run of sound, pui16Match[0] to [ui32Count - 1], played for
+// ui8Key and followed by a cut to silence if bCut. Prints one CSV line and
+// returns the number of limits it breaks.
+//
+//*****************************************************************************
+static uint32_t
+ReplayTone(const tAudio *psAudio, uint32_t ui32Start, uint32_t ui32Count,
+           bool bCut)
+{
+    double pdCoef[AUDIO_MAX_TERMS], *pdX, *pdRes;
+    double dMean, dFreq, dExpected, dPpm, dFund, dHarm, dNoise, dStep;
+    double dRefillStep, dInnerStep, dHalf, dEdge;
+    const uint16_t *pui16Match;
+    uint32_t idx, ui32H, ui32Harmonics, ui32Gaps, ui32Refills, ui32Fails;
+    uint32_t ui32HalfStart, ui32Onset, ui32Cut;
+    uint8_t ui8Key;
+
+    pui16Match = &psAudio->pui16Match[ui32Start];
+    ui8Key = psAudio->pui8Key[ui32Start];
+    printf("%u,%u,", ui32Start, ui32Count);
+    if(ui8Key == AUDIO_NO_KEY)
+    {
+        printf("-,");
+    }
+    else
+    {
+        printf("%u,", ui8Key);
+    }
+
+    //
+    // Steps from and to the midpoint at the edges of the run, and their
+    // energy against a full-scale sine
+    //
+    ui32Onset = abs((int32_t)pui16Match[0] - REPLAY_PWM_PERIOD / 2);
+    ui32Cut = bCut ? abs((int32_t)pui16Match[ui32Count - 1] -
+                         REPLAY_PWM_PERIOD / 2) : 0;
+    dEdge = (ui32Onset > ui32Cut) ? ui32Onset : ui32Cut;
+    dEdge = 10 * log10(dEdge * dEdge /
+                       (REPLAY_PWM_PERIOD * REPLAY_PWM_PERIOD / 8.0));
+    ui32Fails = 0;
+    if(dEdge > AUDIO_MAX_EDGE_DB)
+    {
+        fprintf(stderr, "sample %u: %.1f dB step at the note's edge\n",
+                ui32Start, dEdge);
+        ui32Fails++;
+    }
+
+    //
+    // Only the tones of the sine keys are measured, over their sustain;
+    // songs and runs too short to fit get just their onset and cut.
+    //
+    if((ui8Key >= AUDIO_FIRST_SONG_KEY) ||
+       (ui32Count < AUDIO_SETTLE + AUDIO_MIN_TONE + AUDIO_RELEASE))
+    {
+        printf(",,,,,,,,,,,%u,%u,%.1f\n", ui32Onset, ui32Cut, dEdge);
+        return(ui32Fails);
+    }
+    ui32Start += AUDIO_SETTLE;
+    ui32Count -= AUDIO_SETTLE + AUDIO_RELEASE;
+    pui16Match += AUDIO_SETTLE;
+
+    pdX = malloc(ui32Count * sizeof(double));
+    pdRes = malloc(ui32Count * sizeof(double));
+    dMean = 0.0;
+    for(idx = 0; idx < ui32Count; idx++)
+    {
+        pdX[idx] = pui16Match[idx];
+        dMean += pdX[idx];
+    }
+    dMean /= ui32Count;
+
+    //
+    // Fundamental and every harmonic below Nyquist
+    //
+    dFreq = ReplayFrequency(pdX, ui32Count, dMean);
+    ui32Harmonics = (dFreq > 0.0) ? (uint32_t)(0.5 / dFreq) : 1;
+    ui32Harmonics = (ui32Harmonics > AUDIO_MAX_HARMONICS) ?
+                    AUDIO_MAX_HARMONICS : ui32Harmonics;
+    dNoise = ReplayFit(pdX, ui32Count, dFreq, ui32Harmonics, pdCoef, pdRes) /
+             ui32Count;
+    dFund = (pdCoef[1] * pdCoef[1] + pdCoef[2] * pdCoef[2]) / 2;
+    dHarm = 0.0;
+    for(ui32H = 2; ui32H <= ui32Harmonics; ui32H++)
+    {
+        dHarm += (pdCoef[2 * ui32H - 1] * pdCoef[2 * ui32H - 1] +
+                  pdCoef[2 * ui32H] * pdCoef[2 * ui32H]) / 2;
+    }
+    dExpected = g_pui32ToneFreq[ui8Key] / 65536.0;
+    dPpm = (dFreq - dExpected) / dExpected * 1e6;
+
+    //
+    // Sample to sample steps of the residual at the start of each refilled
+    // half against those inside halves, and halves that fit badly: a late
+    // refill replays stale samples, a lost phase shows as a step.
+    //
+    dRefillStep = dInnerStep = 0.0;
+    ui32Refills = ui32Gaps = 0;
+    ui32HalfStart = 0;
+    dHalf = 0.0;
+    for(idx = 1; idx <= ui32Count; idx++)
+    {
+        if((idx == ui32Count) ||
+           (psAudio->pui8Flags[ui32Start + idx] & AUDIO_REFILL))
+        {
+            if((idx - ui32HalfStart == 32) &&
+               (sqrt(dHalf / 32) > AUDIO_GAP_NOISE * sqrt(dNoise) + 1.0))
+            {
+                ui32Gaps++;
+            }
+            ui32HalfStart = idx;
+            dHalf = 0.0;
+            if(idx == ui32Count)
+            {
+                break;
+            }
+        }
+        dHalf += pdRes[idx] * pdRes[idx];
+        dStep = fabs(pdRes[idx] - pdRes[idx - 1]);
+        if(psAudio->pui8Flags[ui32Start + idx] & AUDIO_REFILL)
+        {
+            ui32Refills++;
+            dRefillStep = (dStep > dRefillStep) ? dStep : dRefillStep;
+        }
+        else
+        {
+            dInnerStep = (dStep > dInnerStep) ? dStep : dInnerStep;
+        }
+    }
+
+    printf("%.3f,%.3f,%.1f,%.2f,%.2f,%.2f,%.2f,%u,%.2f,%.2f,%u,%u,%u,"
+           "%.1f\n", dExpected * TRACE_TICK_HZ, dFreq * TRACE_TICK_HZ, dPpm,
+           10 * log10(dFund / (REPLAY_PWM_PERIOD * REPLAY_PWM_PERIOD / 8.0)),
+           10 * log10(dFund / dNoise), 10 * log10(dHarm / dFund),
+           10 * log10((dHarm + dNoise) / dFund), ui32Refills, dRefillStep,
+           dInnerStep, ui32Gaps, ui32Onset, ui32Cut, dEdge);
+
+    if(fabs(dPpm) > AUDIO_MAX_FREQ_PPM)
+    {
+        fprintf(stderr, "sample %u: frequency off by %.1f ppm\n", ui32Start,
+                dPpm);
+        ui32Fails++;
+    }
+    if(10 * log10((dHarm + dNoise) / dFund) > AUDIO_MAX_THDN_DB)
+    {
+        fprintf(stderr, "sample %u: THD+N %.2f dB\n", ui32Start,
+                10 * log10((dHarm + dNoise) / dFund));
+        ui32Fails++;
+    }
+    if(ui32Gaps)
+    {
+        fprintf(stderr, "sample %u: %u buffer halves not refilled in time\n",
+                ui32Start, ui32Gaps);
+        ui32Fails++;
+    }
+    free(pdX);
+    free(pdRes);
+    return(ui32Fails);
+}
+
+//
+// Split the DAC stream into runs of sound between silences, AUDIO_SILENCE
+// samples or more at the midpoint, or at 0 before the timer runs, and
+// measure each. A tone crosses the midpoint, but never rests there.
+// Returns 1 if any breaks a limit.
+//
+static int
+ReplayAudioQuality(const tTrace *psTrace)
+{
+    tAudio sAudio;
+    uint32_t idx, ui32Start, ui32End, ui32Fails;
+    uint16_t ui16Match;
+
+    ReplayAudio(psTrace, &sAudio);
+    printf("start,samples,key,expected_hz,freq_hz,freq_err_ppm,level_dbfs,"
+           "snr_db,thd_db,thdn_db,refills,refill_step,inner_step,gaps,"
+           "onset,cut,edge_db\n");
+    ui32Fails = 0;
+    ui32Start = 0;
+    ui32End = 0;
+    for(idx = 0; idx <= sAudio.ui32Count; idx++)
+    {
+        ui16Match = (idx < sAudio.ui32Count) ? sAudio.pui16Match[idx] : 0;
+        if((ui16Match != REPLAY_PWM_PERIOD / 2) && (ui16Match != 0))
+        {
+            if(ui32End == ui32Start)
+            {
+                ui32Start = idx;
+            }
+            ui32End = idx + 1;
+        }
+        else if((ui32End > ui32Start) &&
+                ((idx == sAudio.ui32Count) || (idx - ui32End >= AUDIO_SILENCE)))
+        {
+            ui32Fails += ReplayTone(&sAudio, ui32Start, ui32End - ui32Start,
+                                    ui32End < sAudio.ui32Count);
+            ui32Start = ui32End;
+        }
+    }
+    ReplayAudioFree(&sAudio);
+    return(ui32Fails ? 1 : 0);
+}
+
+//*****************************************************************************
+//
+// Row scan: per LED row, the latches from tick ui32From to ui32To, those
+// with the row lit and their share of all latches, the refresh rate and
+// longest wait from one lit latch to the next, and the light.
+//
+//*****************************************************************************
+static int
+ReplayScan(const tTrace *psTrace, uint32_t ui32From, uint32_t ui32To)
+{
+    tShift sShift;
+    uint32_t pui32Latches[8], pui32Lit[8], pui32Last[8], pui32MaxGap[8];
+    uint32_t pui32Gaps[8];
+    uint64_t pui64GapSum[8], pui64Light[8];
+    uint32_t idx, ui32Row, ui32Col, ui32Sum, ui32Total, ui32LitTotal;
+    uint32_t ui32LitRows, ui32Gap, ui32Worst, ui32Gaps;
+    uint64_t ui64GapSum;
+    const tTraceRecord *psRec;
+    int32_t i32PendingRow;
+    double dSeconds;
+    bool pbLastLit[8];
+    bool bXlat;
+
+    memset(&sShift, 0, sizeof(sShift));
+    memset(pui32Latches, 0, sizeof(pui32Latches));
+    memset(pui32Lit, 0, sizeof(pui32Lit));
+    memset(pui32Last, 0, sizeof(pui32Last));
+    memset(pui32MaxGap, 0, sizeof(pui32MaxGap));
+    memset(pui32Gaps, 0, sizeof(pui32Gaps));
+    memset(pui64GapSum, 0, sizeof(pui64GapSum));
+    memset(pui64Light, 0, sizeof(pui64Light));
+    memset(pbLastLit, 0, sizeof(pbLastLit));
+    ui32Total = 0;
+    i32PendingRow = -1;
+    bXlat = false;
+
+    for(idx = 0; idx < psTrace->ui32Count; idx++)
+    {
+        psRec = &psTrace->psRecords[idx];
+        if(ReplayShiftRecord(&sShift, psRec))
+        {
+            continue;
+        }
+        if(psRec->ui8Type == TRACE_ROW)
+        {
+            i32PendingRow = psRec->ui8Arg & 7;
+        }
+        else if((psRec->ui8Type == TRACE_GPIO) &&
+                ((psRec->ui16Value >> 8) == REPLAY_PORTA) &&
+                (psRec->ui8Arg & REPLAY_PIN_XLAT))
+        {
+            if((psRec->ui16Value & REPLAY_PIN_XLAT) && !bXlat &&
+               (i32PendingRow >= 0) && (psRec->ui32Tick >= ui32From) &&
+               (psRec->ui32Tick < ui32To))
+            {
+                ui32Row = i32PendingRow;
+                for(ui32Sum = 0, ui32Col = 0; ui32Col < 32; ui32Col++)
+                {
+                    ui32Sum += ReplayShiftValue(&sShift, ui32Col);
+                }
+
+                //
+                // The refresh of a row is timed from one lit latch to the
+                // next, so a row that goes dark while the content is
+                // elsewhere does not count as a gap
+                //
+                if(ui32Sum && pbLastLit[ui32Row])
+                {
+                    ui32Gap = psRec->ui32Tick - pui32Last[ui32Row];
+                    pui64GapSum[ui32Row] += ui32Gap;
+                    pui32Gaps[ui32Row]++;
+                    if(ui32Gap > pui32MaxGap[ui32Row])
+                    {
+                        pui32MaxGap[ui32Row] = ui32Gap;
+                    }
+                }
+                if(ui32Sum)
+                {
+                    pui32Lit[ui32Row]++;
+                }
+                pbLastLit[ui32Row] = ui32Sum != 0;
+                pui32Last[ui32Row] = psRec->ui32Tick;
+                pui32Latches[ui32Row]++;
+                pui64Light[ui32Row] += ui32Sum;
+                ui32Total++;
+            }
+            bXlat = (psRec->ui16Value & REPLAY_PIN_XLAT) != 0;
+        }
+    }
+    if(!ui32Total)
+    {
+        fprintf(stderr, "no rows latched between ticks %u and %u\n",
+                ui32From, ui32To);
+        return(1);
+    }
+
+    //
+    // Latches are 32 ticks apart
+    //
+    dSeconds = (double)ui32Total * 32 / TRACE_TICK_HZ;
+    printf("row latches    lit  duty%%  refresh_hz max_gap_ms  light\n");
+    ui32LitRows = 0;
+    ui32LitTotal = 0;
+    ui32Worst = 0;
+    ui32Gaps = 0;
+    ui64GapSum = 0;
+    for(ui32Row = 0; ui32Row < 8; ui32Row++)
+    {
+        printf("%3u %7u %6u %6.1f %11.1f %10.1f %6.0f\n", ui32Row,
+               pui32Latches[ui32Row], pui32Lit[ui32Row],
+               100.0 * pui32Lit[ui32Row] / ui32Total,
+               pui32Gaps[ui32Row] ? (double)TRACE_TICK_HZ *
+                   pui32Gaps[ui32Row] / pui64GapSum[ui32Row] : 0.0,
+               pui32MaxGap[ui32Row] * 1000.0 / TRACE_TICK_HZ,
+               (double)pui64Light[ui32Row] * 8 / ui32Total / 24);
+        ui32LitTotal += pui32Lit[ui32Row];
+        ui32Gaps += pui32Gaps[ui32Row];
+        ui64GapSum += pui64GapSum[ui32Row];
+        if(pui32Lit[ui32Row])
+        {
+            ui32LitRows++;
+        }
+        if(pui32MaxGap[ui32Row] > ui32Worst)
+        {
+            ui32Worst = pui32MaxGap[ui32Row];
+        }
+    }
+    printf("%u rows lit over %.2fs, in %.1f%% of row slots, refreshed at "
+           "%.1f Hz, %.1f ms at worst\n", ui32LitRows, dSeconds,
+           100.0 * ui32LitTotal / ui32Total,
+           ui32Gaps ? (double)TRACE_TICK_HZ * ui32Gaps / ui64GapSum : 0.0,
+           ui32Worst * 1000.0 / TRACE_TICK_HZ);
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Compare the frames two traces latched, returning how many differ in
+// content or time, or both traces' frame counts if they differ.
+//
+//*****************************************************************************
+static uint32_t
+ReplayFramesDiffer(const tTrace *psA, const tTrace *psB)
+{
+    uint32_t idx, ui32Count, ui32Frames, ui32FramesA, ui32FramesB;
+    tFrame *psFramesA, *psFramesB;
+
+    ui32FramesA = ReplayFrames(psA, &psFramesA);
+    ui32FramesB = ReplayFrames(psB, &psFramesB);
+    ui32Count = (ui32FramesA < ui32FramesB) ? ui32FramesA : ui32FramesB;
+    ui32Frames = 0;
+    for(idx = 0; idx < ui32Count; idx++)
+    {
+        if((psFramesA[idx].ui32Tick != psFramesB[idx].ui32Tick) ||
+           (memcmp(psFramesA[idx].pui16Pixel, psFramesB[idx].pui16Pixel,
+                   sizeof(psFramesA[idx].pui16Pixel)) != 0))
+        {
+            if(ui32Frames == 0)
+            {
+                printf("first differing frame %u at tick %u\n", idx,
+                       psFramesA[idx].ui32Tick);
+            }
+            ui32Frames++;
+        }
+    }
+    printf("%u of %u frames differ, counts %u and %u\n", ui32Frames,
+           ui32Count, ui32FramesA, ui32FramesB);
+    free(psFramesA);
+    free(psFramesB);
+
+    return(ui32Frames + ((ui32FramesA != ui32FramesB) ? 1 : 0));
+}
+
+static int
+ReplayDiff(const tTrace *psA, const tTrace *psB)
+{
+    uint32_t idx, ui32Count, ui32Diffs, ui32Frames;
+    const tTraceRecord *psRecA, *psRecB;
+
+    ui32Count = (psA->ui32Count < psB->ui32Count) ? psA->ui32Count :
+                                                     psB->ui32Count;
+    ui32Diffs = 0;
+    for(idx = 0; idx < ui32Count; idx++)
+    {
+        psRecA = &psA->psRecords[idx];
+        psRecB = &psB->psRecords[idx];
+        if(memcmp(psRecA, psRecB, sizeof(tTraceRecord)) != 0)
+        {
+            if(ui32Diffs < REPLAY_MAX_DIFFS)
+            {
+                printf("record %u: tick %u type %u arg %u value 0x%04x != "
+                       "tick %u type %u arg %u value 0x%04x\n", idx,
+                       psRecA->ui32Tick, psRecA->ui8Type, psRecA->ui8Arg,
+                       psRecA->ui16Value, psRecB->ui32Tick, psRecB->ui8Type,
+                       psRecB->ui8Arg, psRecB->ui16Value);
+            }
+            ui32Diffs++;
+        }
+    }
+    printf("%u of %u records differ, lengths %u and %u\n", ui32Diffs,
+           ui32Count, psA->ui32Count, psB->ui32Count);
+
+    ui32Frames = ReplayFramesDiffer(psA, psB);
+
+    return((ui32Diffs || ui32Frames || (psA->ui32Count != psB->ui32Count)) ?
+           1 : 0);
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(int argc, char *argv[])
+{
+    tTrace sTraceA, sTraceB;
+
+    if((argc < 3) || (ReplayLoad(argv[2], &sTraceA) != 0))
+    {
+        fprintf(stderr, "usage: %s dump|frames|dac|wav|audio|diff|latches|scan "
+                "TRACE [ARG]\n",
+                argv[0]);
+        return(2);
+    }
+
+    if(strcmp(argv[1], "dump") == 0)
+    {
+        return(ReplayDump(&sTraceA));
+    }
+    if(strcmp(argv[1], "frames") == 0)
+    {
+        return(ReplayShowFrames(&sTraceA, (argc > 3) ? argv[3] : NULL));
+    }
+    if((strcmp(argv[1], "dac") == 0) && (argc > 3))
+    {
+        return(ReplayDac(&sTraceA, argv[3]));
+    }
+    if((strcmp(argv[1], "wav") == 0) && (argc > 3))
+    {
+        return(ReplayWav(&sTraceA, argv[3]));
+    }
+    if(strcmp(argv[1], "audio") == 0)
+    {
+        return(ReplayAudioQuality(&sTraceA));
+    }
+    if((strcmp(argv[1], "diff") == 0) && (argc > 3))
+    {
+        if(ReplayLoad(argv[3], &sTraceB) != 0)
+        {
+            return(2);
+        }
+        return(ReplayDiff(&sTraceA, &sTraceB));
+    }
+    if((strcmp(argv[1], "latches") == 0) && (argc > 3))
+    {
+        if(ReplayLoad(argv[3], &sTraceB) != 0)
+        {
+            return(2);
+        }
+        return(ReplayFramesDiffer(&sTraceA, &sTraceB) ? 1 : 0);
+    }
+    if(strcmp(argv[1], "scan") == 0)
+    {
+        return(ReplayScan(&sTraceA, (argc > 3) ? strtoul(argv[3], NULL, 0) : 0,
+                          (argc > 4) ? strtoul(argv[4], NULL, 0) :
+                                       0xFFFFFFFF));
+    }
+    fprintf(stderr, "unknown command %s\n", argv[1]);
+    return(2);
+}
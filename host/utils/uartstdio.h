@@ -0,0 +1,20 @@
+//*****************************************************************************
+//
+// uartstdio.h - Host stand-in for the TivaWare UART console utility.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __UARTSTDIO_H__
+#define __UARTSTDIO_H__
+
+#include <stdint.h>
+
+extern void UARTStdioConfig(uint32_t ui32Port, uint32_t ui32Baud,
+                            uint32_t ui32SrcClock);
+extern void UARTprintf(const char *pcString, ...);
+
+#endif // __UARTSTDIO_H__
@@ -0,0 +1,20 @@
+//*****************************************************************************
+//
+// ustdlib.h - Host stand-in for the TivaWare string formatting utility.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __USTDLIB_H__
+#define __USTDLIB_H__
+
+#include <stdarg.h>
+#include <stdint.h>
+
+extern int uvsnprintf(char *pcBuf, uint32_t ui32Size, const char *pcString,
+                      va_list vaArgP);
+
+#endif // __USTDLIB_H__
@@ -0,0 +1,134 @@
+//*****************************************************************************
+//
+// anim.c - Palettized, delta-coded animations played from flash.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "palette.h"
+#include "anim.h"
+
+//*****************************************************************************
+//
+// AnimDecode
+// Inputs:
+//   1. Coded frame
+//   2. Frame it was coded against, updated to it
+// Outputs: Bytes the coded frame takes
+// Description:
+// Apply one frame's changes. A whole row is read as its word; otherwise the
+// changed pixels are gathered into a mask and a word and merged at once.
+//
+//*****************************************************************************
+uint32_t
+AnimDecode(const uint8_t *pui8Data, tPaletteFrame *psFrame)
+{
+  const uint8_t *next;
+  uint32_t rows, cols, row, col, mask, value, nibble;
+
+  rows = pui8Data[1];
+  next = pui8Data + 2;
+  for (row = 0; rows; row++, rows >>= 1)
+  {
+    if (!(rows & 1))
+    {
+      continue;
+    }
+    cols = *next++;
+    if (cols == 0xFF)
+    {
+      psFrame->pui32Row[row] = next[0] | (next[1] << 8) | (next[2] << 16) |
+                               ((uint32_t)next[3] << 24);
+      next += 4;
+      continue;
+    }
+
+    mask = 0;
+    value = 0;
+    nibble = 0;
+    for (col = 0; cols; col += 4, cols >>= 1)
+    {
+      if (cols & 1)
+      {
+        mask |= 0xF << col;
+        value |= ((next[nibble >> 1] >> (4 * (nibble & 1))) & 0xF) << col;
+        nibble++;
+      }
+    }
+    next += (nibble + 1) >> 1;
+    psFrame->pui32Row[row] = (psFrame->pui32Row[row] & ~mask) | value;
+  }
+  return next - pui8Data;
+}
+
+//*****************************************************************************
+//
+// AnimStart
+// Inputs:
+//   1. Player
+//   2. Animation
+//   3. Frame to show it in
+//   4. Palette to show it with
+// Outputs: None
+// Description:
+// Load the animation's palette, clear the frame and show the first frame
+// for its hold.
+//
+//*****************************************************************************
+void
+AnimStart(tAnimPlayer *psPlayer, const tAnim *psAnim, tPaletteFrame *psFrame,
+          tPalette *psPalette)
+{
+  uint32_t idx;
+
+  for (idx = 0; idx < PALETTE_ENTRIES; idx++)
+  {
+    PaletteSetColor(psPalette, idx, psAnim->pui32Palette[idx]);
+  }
+  PaletteFrameFill(psFrame, 0);
+
+  psPlayer->psAnim = psAnim;
+  psPlayer->ui32Hold = psAnim->pui8Data[0];
+  psPlayer->ui32Frame = 0;
+  psPlayer->pui8Next = psAnim->pui8Data + AnimDecode(psAnim->pui8Data,
+                                                     psFrame);
+}
+
+//*****************************************************************************
+//
+// AnimFrame
+// Inputs:
+//   1. Player
+//   2. Frame the animation is shown in
+// Outputs: True if the frame changed
+// Description:
+// Called once a display frame. When the frame shown has been held long
+// enough, decode the next one, going back to the loop at the end.
+//
+//*****************************************************************************
+bool
+AnimFrame(tAnimPlayer *psPlayer, tPaletteFrame *psFrame)
+{
+  const tAnim *psAnim;
+
+  if (--psPlayer->ui32Hold)
+  {
+    return false;
+  }
+
+  psAnim = psPlayer->psAnim;
+  if (psPlayer->pui8Next >= psAnim->pui8Data + psAnim->ui16Bytes)
+  {
+    psPlayer->pui8Next = psAnim->pui8Data + psAnim->ui16Loop;
+  }
+  psPlayer->ui32Hold = psPlayer->pui8Next[0];
+  psPlayer->ui32Frame = (psPlayer->ui32Frame + 1 >= psAnim->ui16Frames) ?
+                        0 : psPlayer->ui32Frame + 1;
+  psPlayer->pui8Next += AnimDecode(psPlayer->pui8Next, psFrame);
+  return true;
+}
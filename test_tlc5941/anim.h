@@ -0,0 +1,81 @@
+//*****************************************************************************
+//
+// anim.h - Palettized, delta-coded animations played from flash.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __ANIM_H__
+#define __ANIM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "palette.h"
+
+//*****************************************************************************
+//
+// Animations are made from GIF or PNG sequences by host/animconv and kept
+// in flash. Each has one palette of up to PALETTE_ENTRIES colors, entry 0
+// black, and its frames are coded in turn against the frame before, the
+// first against a black frame. A frame is:
+//
+//   hold    display frames to show it, 1 to 255
+//   rows    bit n set if row n changes
+//   for each changed row, from row 0:
+//     cols    bit c set if pixel c changes
+//     the new entries of the changed pixels from column 0, two to a byte,
+//     low nibble first; a row of 8 is then the row's tPaletteFrame word
+//
+// so a frame is 2 to ANIM_MAX_FRAME_BYTES bytes. After the last frame comes
+// one more that changes it back to the first, with the first's hold, and
+// the loop goes on from the second: the first frame is only decoded from
+// black once.
+//
+// The player decodes one frame into a tPaletteFrame as its hold runs out,
+// reading it straight from flash, so the whole animation takes no more
+// SRAM than the frame and its palette. A frame changes at most 64 pixels,
+// which bounds the time a frame takes to decode.
+//
+// Holds count display frames of ANIM_FRAME_US. animconv rounds durations to
+// them and splits a hold longer than 255 over empty frames.
+//
+//*****************************************************************************
+#define ANIM_FRAME_US           16000
+#define ANIM_MAX_HOLD           255
+#define ANIM_MAX_FRAME_BYTES    (2 + 8 * 5)
+
+typedef struct
+{
+    const uint8_t *pui8Data;
+    uint16_t ui16Bytes;
+    uint16_t ui16Loop;              // offset of the second frame
+    uint16_t ui16Frames;            // frames in a loop
+    uint16_t ui16Colors;            // palette entries used
+    uint32_t pui32Palette[PALETTE_ENTRIES]; // 0xBBGGRR, as in colors
+}
+tAnim;
+
+typedef struct
+{
+    const tAnim *psAnim;
+    const uint8_t *pui8Next;        // next frame to decode
+    uint32_t ui32Hold;              // display frames left of the one shown
+    uint32_t ui32Frame;             // frame shown, 0 to ui16Frames - 1
+}
+tAnimPlayer;
+
+//
+// The sample animations, in anim_samples.c
+//
+extern const tAnim *const g_ppsAnims[];
+extern const uint32_t g_ui32NumAnims;
+
+extern uint32_t AnimDecode(const uint8_t *pui8Data, tPaletteFrame *psFrame);
+extern void AnimStart(tAnimPlayer *psPlayer, const tAnim *psAnim,
+                      tPaletteFrame *psFrame, tPalette *psPalette);
+extern bool AnimFrame(tAnimPlayer *psPlayer, tPaletteFrame *psFrame);
+
+#endif // __ANIM_H__
@@ -0,0 +1,165 @@
+//*****************************************************************************
+//
+// anim_samples.c - Sample animations.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Generated by host/animconv, do not edit:
+//   animconv -o anim_samples.c -n Heart heart.gif -n Comet comet.gif -n Spiral spiral.gif
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "anim.h"
+
+//
+// Heart: 2 frames in 650 ms, 2 colors
+//
+static const uint8_t g_pui8AnimHeartData[] = {
+  0x19, 0xFE, 0x36, 0x11, 0x11, 0x49, 0x11, 0x01, 0x41, 0x11,
+  0x41, 0x11, 0x22, 0x11, 0x14, 0x11, 0x08, 0x01,   // frame 0
+  0x10, 0xFE, 0x36, 0x00, 0x00, 0xFF, 0x10, 0x01, 0x11, 0x00,
+  0x6B, 0x10, 0x11, 0x00, 0x63, 0x10, 0x01, 0x36, 0x10, 0x01,
+  0x1C, 0x10, 0x00, 0x08, 0x00,   // frame 1
+  0x19, 0xFE, 0x36, 0x11, 0x11, 0xFF, 0x01, 0x10, 0x00, 0x01,
+  0x6B, 0x01, 0x00, 0x01, 0x63, 0x01, 0x10, 0x36, 0x01, 0x10,
+  0x1C, 0x01, 0x01, 0x08, 0x01,   // back to frame 0
+};
+
+const tAnim g_sAnimHeart = {
+  g_pui8AnimHeartData, 68, 18, 2, 2,
+  {
+    0x000000, 0x2000FF, 0x000000, 0x000000,
+    0x000000, 0x000000, 0x000000, 0x000000,
+    0x000000, 0x000000, 0x000000, 0x000000,
+    0x000000, 0x000000, 0x000000, 0x000000
+  }
+};
+
+//
+// Comet: 20 frames in 1200 ms, 6 colors
+//
+static const uint8_t g_pui8AnimCometData[] = {
+  0x04, 0xFF, 0x55, 0x41, 0x11, 0xAA, 0x13, 0x11, 0x55, 0x15,
+  0x11, 0xAB, 0x12, 0x11, 0x01, 0x55, 0x11, 0x11, 0xAA, 0x11,
+  0x11, 0x55, 0x11, 0x11, 0xAA, 0x11, 0x11,   // frame 0
+  0x04, 0x0F, 0x0C, 0x43, 0x02, 0x05, 0x01, 0x02, 0x01, 0x00,   // frame 1
+  0x04, 0x07, 0x1C, 0x35, 0x04, 0x02, 0x02, 0x01, 0x01,   // frame 2
+  0x04, 0x03, 0x3C, 0x52, 0x43, 0x02, 0x01,   // frame 3
+  0x04, 0x03, 0x3C, 0x21, 0x35, 0x40, 0x04,   // frame 4
+  0x04, 0x07, 0x38, 0x20, 0x05, 0x40, 0x03, 0x80, 0x04,   // frame 5
+  0x04, 0x0F, 0x30, 0x21, 0x40, 0x05, 0x80, 0x03, 0x80, 0x04,   // frame 6
+  0x04, 0x1F, 0x20, 0x00, 0x40, 0x02, 0x80, 0x05, 0x80, 0x03,
+  0x80, 0x04,   // frame 7
+  0x04, 0x3E, 0x40, 0x00, 0x80, 0x02, 0x80, 0x05, 0x80, 0x03,
+  0x80, 0x04,   // frame 8
+  0x04, 0x7C, 0x80, 0x00, 0x80, 0x02, 0x80, 0x05, 0x80, 0x03,
+  0x40, 0x04,   // frame 9
+  0x04, 0xF8, 0x80, 0x01, 0x80, 0x02, 0x80, 0x05, 0x40, 0x03,
+  0x20, 0x04,   // frame 10
+  0x04, 0xF0, 0x80, 0x00, 0x80, 0x02, 0x40, 0x05, 0x30, 0x34,   // frame 11
+  0x04, 0xE0, 0x80, 0x01, 0x40, 0x02, 0x38, 0x34, 0x05,   // frame 12
+  0x04, 0xC0, 0x40, 0x01, 0x3C, 0x34, 0x25,   // frame 13
+  0x04, 0xC0, 0x02, 0x04, 0x3C, 0x53, 0x12,   // frame 14
+  0x04, 0xE0, 0x01, 0x04, 0x02, 0x03, 0x1C, 0x25, 0x00,   // frame 15
+  0x04, 0xF0, 0x01, 0x04, 0x01, 0x03, 0x02, 0x05, 0x0C, 0x12,   // frame 16
+  0x04, 0xF8, 0x01, 0x04, 0x01, 0x03, 0x01, 0x05, 0x02, 0x02,
+  0x04, 0x00,   // frame 17
+  0x04, 0x7C, 0x01, 0x04, 0x01, 0x03, 0x01, 0x05, 0x01, 0x02,
+  0x02, 0x00,   // frame 18
+  0x04, 0x3E, 0x02, 0x04, 0x01, 0x03, 0x01, 0x05, 0x01, 0x02,
+  0x01, 0x00,   // frame 19
+  0x04, 0x1F, 0x04, 0x04, 0x02, 0x03, 0x01, 0x05, 0x01, 0x02,
+  0x01, 0x01,   // back to frame 0
+};
+
+const tAnim g_sAnimComet = {
+  g_pui8AnimCometData, 227, 27, 20, 6,
+  {
+    0x000000, 0x280008, 0x00083C, 0x00A0FF,
+    0xC8FFFF, 0x0028A0, 0x000000, 0x000000,
+    0x000000, 0x000000, 0x000000, 0x000000,
+    0x000000, 0x000000, 0x000000, 0x000000
+  }
+};
+
+//
+// Spiral: 12 frames in 960 ms, 16 colors
+//
+static const uint8_t g_pui8AnimSpiralData[] = {
+  0x05, 0xFF, 0x7E, 0x62, 0x66, 0x1B, 0xFF, 0x21, 0x55, 0x69,
+  0x02, 0xFF, 0xF0, 0xDF, 0x98, 0x12, 0xFF, 0x45, 0xAA, 0x98,
+  0x31, 0xFF, 0xA8, 0xBE, 0x15, 0x72, 0xFF, 0x48, 0x73, 0xCC,
+  0xE7, 0xFF, 0x4F, 0x3F, 0x77, 0x3E, 0x7E, 0xFF, 0x1D, 0xD3,   // frame 0
+  0x05, 0xFF, 0x3E, 0x21, 0xCC, 0x0C, 0xFF, 0x10, 0x21, 0xC6,
+  0x0B, 0xFF, 0x51, 0xF8, 0x65, 0x0B, 0x67, 0x89, 0x64, 0x02,
+  0xFF, 0x49, 0x73, 0x25, 0xE1, 0x77, 0x89, 0x71, 0xE7, 0xFF,
+  0x85, 0xED, 0xAA, 0x3A, 0x7E, 0xDD, 0xF0, 0x3F,   // frame 1
+  0x05, 0xFF, 0x60, 0x37, 0xD8, 0xB1, 0x17, 0xFF, 0x62, 0x89,
+  0xC2, 0x17, 0xFF, 0x96, 0x48, 0x65, 0x1B, 0x96, 0xD8, 0x3B,
+  0xBE, 0x35, 0xEA, 0x43, 0x0A, 0x45, 0x6C, 0xD0, 0xF4,   // frame 2
+  0x05, 0xFF, 0x3E, 0x10, 0x73, 0x0E, 0xFF, 0x21, 0x12, 0x72,
+  0xDE, 0x99, 0x9B, 0x31, 0xE8, 0xC8, 0xD7, 0xEB, 0x56, 0x7E,
+  0xD3, 0xC7, 0x26, 0x3F, 0x0F, 0xF3, 0x22, 0x44, 0xD4, 0x3A,
+  0x51, 0x88,   // frame 3
+  0x05, 0xFF, 0x14, 0xE0, 0xFF, 0xB1, 0x2B, 0xE1, 0x3A, 0xFF,
+  0xCC, 0x66, 0x72, 0xFA, 0xE7, 0x6C, 0x75, 0x3A, 0xFF, 0x2C,
+  0xAF, 0x77, 0x0E, 0xFF, 0x1B, 0x48, 0x13, 0xDD, 0x4F, 0x11,
+  0x85, 0x08, 0x7E, 0x10, 0x99, 0x59,   // frame 4
+  0x05, 0xFF, 0x7E, 0x11, 0x31, 0xF4, 0x8F, 0x73, 0xB7, 0x0F,
+  0xA5, 0xC7, 0x43, 0xBE, 0x2B, 0xB5, 0xFE, 0xEE, 0x81, 0xA4,
+  0xD4, 0xBD, 0x92, 0xD8, 0x03, 0x7C, 0x96, 0x58, 0x05, 0x6C,
+  0x62, 0x26,   // frame 5
+  0x05, 0xFF, 0x3E, 0x3D, 0xDD, 0x0F, 0x7A, 0x7E, 0x33, 0x04,
+  0xDB, 0x7E, 0x7C, 0x84, 0xC7, 0x27, 0x41, 0x08, 0x9D, 0x93,
+  0xA8, 0x05, 0x23, 0x21, 0x0F, 0xD3, 0x20, 0x25, 0x01, 0x76,
+  0xB1, 0xB6, 0x01,   // frame 6
+  0x05, 0xFF, 0x7E, 0xF3, 0x03, 0xDD, 0xFF, 0xA3, 0xAA, 0xDE,
+  0x58, 0xEE, 0x7E, 0x17, 0x98, 0xB7, 0x1E, 0x72, 0x93, 0xE6,
+  0x62, 0x84, 0x09, 0xFF, 0xB0, 0x56, 0x8F, 0x15, 0xFF, 0xB0,
+  0x6C, 0x12, 0x01, 0x3C, 0xCC, 0x2C,   // frame 7
+  0x05, 0xFF, 0x3E, 0x4F, 0xDF, 0x01, 0x51, 0x4F, 0x05, 0x7D,
+  0x34, 0xAE, 0x53, 0x69, 0xB3, 0x8D, 0xFF, 0x71, 0x56, 0x84,
+  0x69, 0xFF, 0x71, 0x2C, 0x98, 0x26, 0x1B, 0x71, 0x1B, 0x16,
+  0x73, 0x07,   // frame 8
+  0x05, 0xFF, 0x7C, 0x88, 0x05, 0x01, 0xEE, 0x44, 0xF4, 0x22,
+  0xA3, 0x3F, 0x6F, 0xD7, 0x3D, 0xA7, 0x65, 0x15, 0xCD, 0x08,
+  0x99, 0x13, 0xB9, 0xFF, 0xED, 0x27, 0x21, 0x12, 0x7C, 0x7E,
+  0x13, 0x00,   // frame 9
+  0x05, 0xFF, 0x7E, 0x95, 0x99, 0x01, 0xFF, 0x8D, 0x48, 0x58,
+  0x11, 0xFF, 0xDD, 0x31, 0x84, 0x21, 0xEB, 0xE0, 0xF7, 0xC2,
+  0xE7, 0xAF, 0x57, 0xC6, 0xFF, 0xAF, 0x27, 0x66, 0xCC, 0x3F,
+  0xA3, 0x1E, 0xB2, 0x28, 0x0E,   // frame 10
+  0x05, 0xFF, 0x30, 0x26, 0x3E, 0x55, 0x98, 0x06, 0x3D, 0x31,
+  0x8D, 0x09, 0x77, 0x4D, 0x4A, 0x18, 0x7C, 0xBE, 0x25, 0x0B,
+  0xA5, 0x34, 0x7C, 0xF1, 0xBD, 0x77, 0x03, 0x3E, 0x4F, 0x03,
+  0x01,   // frame 11
+  0x05, 0xFF, 0x6E, 0x62, 0xB6, 0x01, 0xCB, 0x21, 0x25, 0x00,
+  0xC7, 0xF0, 0x2F, 0x01, 0xB9, 0xA5, 0x98, 0x03, 0xE1, 0x18,
+  0x72, 0xDB, 0x48, 0xC7, 0xE7, 0x5F, 0x4F, 0x3F, 0xE7, 0x7C,
+  0xDF, 0x31, 0x0D,   // back to frame 0
+};
+
+const tAnim g_sAnimSpiral = {
+  g_pui8AnimSpiralData, 439, 40, 12, 16,
+  {
+    0x000000, 0x050601, 0x132402, 0x210119,
+    0x43039C, 0x0F302F, 0x09A02F, 0x983C02,
+    0x053490, 0x00A093, 0xB90192, 0x377702,
+    0x95A501, 0x060411, 0x760422, 0x0A043B
+  }
+};
+
+const tAnim *const g_ppsAnims[] = {
+  &g_sAnimHeart,
+  &g_sAnimComet,
+  &g_sAnimSpiral,
+};
+
+const uint32_t g_ui32NumAnims = 3;
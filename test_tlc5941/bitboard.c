@@ -0,0 +1,191 @@
+//*****************************************************************************
+//
+// bitboard.c - 8x8 monochrome planes held in a 64-bit word.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Every operation here works on all 64 pixels at once with a fixed number
+// of word operations, using the swap and adder networks from the chess
+// programming literature. The Cortex-M4 does a 64-bit operation as two
+// 32-bit ones.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "bitboard.h"
+
+//*****************************************************************************
+//
+// BitboardFromGlyph
+// Inputs:
+//   1. 8 row bytes of an 8x8 glyph, as in font8x8_basic
+// Outputs: The glyph as a bitboard
+// Description:
+// Pack the rows of a glyph, row 0 in the low byte.
+//
+//*****************************************************************************
+tBitboard
+BitboardFromGlyph(const char glyph[8])
+{
+  uint32_t lo, hi;
+
+  lo = (uint8_t)glyph[0] | ((uint8_t)glyph[1] << 8) |
+       ((uint8_t)glyph[2] << 16) | ((uint32_t)(uint8_t)glyph[3] << 24);
+  hi = (uint8_t)glyph[4] | ((uint8_t)glyph[5] << 8) |
+       ((uint8_t)glyph[6] << 16) | ((uint32_t)(uint8_t)glyph[7] << 24);
+  return ((tBitboard)hi << 32) | lo;
+}
+
+//*****************************************************************************
+//
+// BitboardCount
+// Inputs:
+//   1. Bitboard
+// Outputs: Number of pixels set
+// Description:
+// Population count by adding neighbouring bit fields in parallel.
+//
+//*****************************************************************************
+uint32_t
+BitboardCount(tBitboard board)
+{
+  board = board - ((board >> 1) & 0x5555555555555555ULL);
+  board = (board & 0x3333333333333333ULL) +
+          ((board >> 2) & 0x3333333333333333ULL);
+  board = (board + (board >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (uint32_t)((board * 0x0101010101010101ULL) >> 56);
+}
+
+//*****************************************************************************
+//
+// BitboardFlipRows
+// Inputs:
+//   1. Bitboard
+// Outputs: The bitboard upside down, row 0 swapped with row 7
+// Description:
+// Byte swap.
+//
+//*****************************************************************************
+tBitboard
+BitboardFlipRows(tBitboard board)
+{
+  board = ((board >> 8) & 0x00FF00FF00FF00FFULL) |
+          ((board & 0x00FF00FF00FF00FFULL) << 8);
+  board = ((board >> 16) & 0x0000FFFF0000FFFFULL) |
+          ((board & 0x0000FFFF0000FFFFULL) << 16);
+  return (board >> 32) | (board << 32);
+}
+
+//*****************************************************************************
+//
+// BitboardFlipCols
+// Inputs:
+//   1. Bitboard
+// Outputs: The bitboard mirrored, column 0 swapped with column 7
+// Description:
+// Reverse the bits of every byte.
+//
+//*****************************************************************************
+tBitboard
+BitboardFlipCols(tBitboard board)
+{
+  board = ((board >> 1) & 0x5555555555555555ULL) |
+          ((board & 0x5555555555555555ULL) << 1);
+  board = ((board >> 2) & 0x3333333333333333ULL) |
+          ((board & 0x3333333333333333ULL) << 2);
+  return ((board >> 4) & 0x0F0F0F0F0F0F0F0FULL) |
+         ((board & 0x0F0F0F0F0F0F0F0FULL) << 4);
+}
+
+//*****************************************************************************
+//
+// BitboardTranspose
+// Inputs:
+//   1. Bitboard
+// Outputs: The bitboard mirrored about its main diagonal, row r column c
+//          swapped with row c column r
+// Description:
+// Three delta swaps: single pixels within 2x2 blocks, 2x2 blocks within
+// 4x4 blocks, then 4x4 blocks.
+//
+//*****************************************************************************
+tBitboard
+BitboardTranspose(tBitboard board)
+{
+  tBitboard t;
+
+  t = (board ^ (board >> 7)) & 0x00AA00AA00AA00AAULL;
+  board ^= t ^ (t << 7);
+  t = (board ^ (board >> 14)) & 0x0000CCCC0000CCCCULL;
+  board ^= t ^ (t << 14);
+  t = (board ^ (board >> 28)) & 0x00000000F0F0F0F0ULL;
+  board ^= t ^ (t << 28);
+  return board;
+}
+
+//*****************************************************************************
+//
+// BitboardRotate90
+// Inputs:
+//   1. Bitboard
+// Outputs: The bitboard turned a quarter turn, column 0 becoming row 0
+// Description:
+// Transpose, then flip the columns.
+//
+//*****************************************************************************
+tBitboard
+BitboardRotate90(tBitboard board)
+{
+  return BitboardFlipCols(BitboardTranspose(board));
+}
+
+//*****************************************************************************
+//
+// BitboardLifeStep
+// Inputs:
+//   1. Bitboard of live cells
+// Outputs: Live cells one generation later
+// Description:
+// One generation of Conway's Life on an 8x8 torus. The eight neighbour
+// planes are added into a bit-sliced 3-bit count per cell; a count of 8
+// wraps to 0, which like 0 is neither 2 nor 3. A cell lives on with 2 or 3
+// neighbours and is born with 3.
+//
+//*****************************************************************************
+tBitboard
+BitboardLifeStep(tBitboard board)
+{
+  tBitboard up, down, neighbour[8];
+  tBitboard ones, twos, fours, carry, carry2;
+  uint32_t idx;
+
+  up = BB_ROLL_UP(board);
+  down = BB_ROLL_DOWN(board);
+  neighbour[0] = up;
+  neighbour[1] = down;
+  neighbour[2] = BB_ROLL_LEFT(board);
+  neighbour[3] = BB_ROLL_RIGHT(board);
+  neighbour[4] = BB_ROLL_LEFT(up);
+  neighbour[5] = BB_ROLL_RIGHT(up);
+  neighbour[6] = BB_ROLL_LEFT(down);
+  neighbour[7] = BB_ROLL_RIGHT(down);
+
+  ones = 0;
+  twos = 0;
+  fours = 0;
+  for (idx = 0; idx < 8; idx++)
+  {
+    carry = ones & neighbour[idx];
+    ones ^= neighbour[idx];
+    carry2 = twos & carry;
+    twos ^= carry;
+    fours ^= carry2;
+  }
+  return twos & ~fours & (ones | board);
+}
@@ -0,0 +1,59 @@
+//*****************************************************************************
+//
+// bitboard.h - 8x8 monochrome planes held in a 64-bit word.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __BITBOARD_H__
+#define __BITBOARD_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Byte r of a bitboard is LED row r and bit c of that byte is column c, the
+// same bit order as the rows of font8x8_basic, so a glyph loads as it is.
+// Masking and combining planes needs no functions: &, |, ^ and ~ work on
+// all 64 pixels at once.
+//
+// The shifts move every pixel one row or column, dropping those that leave
+// the plane; the rolls wrap them around to the other side.
+//
+//*****************************************************************************
+typedef uint64_t tBitboard;
+
+#define BB_EMPTY                ((tBitboard)0)
+#define BB_FULL                 (~(tBitboard)0)
+#define BB_ROW_MASK(row)        ((tBitboard)0xFF << (8 * (row)))
+#define BB_COL_MASK(col)        ((tBitboard)0x0101010101010101ULL << (col))
+#define BB_BIT(row, col)        ((tBitboard)1 << (8 * (row) + (col)))
+#define BB_ROW(board, row)      ((uint8_t)((board) >> (8 * (row))))
+
+//
+// One row towards row 0 or row 7, one column towards column 0 or column 7
+//
+#define BB_SHIFT_UP(board)      ((board) >> 8)
+#define BB_SHIFT_DOWN(board)    ((board) << 8)
+#define BB_SHIFT_LEFT(board)    (((board) >> 1) & ~BB_COL_MASK(7))
+#define BB_SHIFT_RIGHT(board)   (((board) << 1) & ~BB_COL_MASK(0))
+
+#define BB_ROLL_UP(board)       (((board) >> 8) | ((board) << 56))
+#define BB_ROLL_DOWN(board)     (((board) << 8) | ((board) >> 56))
+#define BB_ROLL_LEFT(board)     (BB_SHIFT_LEFT(board) |                       \
+                                 (((board) << 7) & BB_COL_MASK(7)))
+#define BB_ROLL_RIGHT(board)    (BB_SHIFT_RIGHT(board) |                      \
+                                 (((board) >> 7) & BB_COL_MASK(0)))
+
+extern tBitboard BitboardFromGlyph(const char glyph[8]);
+extern uint32_t BitboardCount(tBitboard board);
+extern tBitboard BitboardFlipRows(tBitboard board);
+extern tBitboard BitboardFlipCols(tBitboard board);
+extern tBitboard BitboardTranspose(tBitboard board);
+extern tBitboard BitboardRotate90(tBitboard board);
+extern tBitboard BitboardLifeStep(tBitboard board);
+
+#endif // __BITBOARD_H__
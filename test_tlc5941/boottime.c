@@ -0,0 +1,136 @@
+//*****************************************************************************
+//
+// boottime.c - Boot stage timestamps and time to the first frame.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "console.h"
+#include "dwt.h"
+#include "boottime.h"
+
+//*****************************************************************************
+//
+// Globals
+//
+//*****************************************************************************
+static tBootStage g_psBootStages[BOOT_MAX_STAGES];
+static uint32_t g_ui32BootNumStages;
+
+static uint32_t g_ui32BootStart;
+
+// Row boundaries seen, up to BOOT_FIRST_FRAME_ROWS, and the first frame
+static uint32_t g_ui32BootRows;
+static uint32_t g_ui32BootFirstFrame;
+
+//*****************************************************************************
+//
+// BootTimeStart
+// Inputs: None
+// Outputs: None
+// Description:
+// Start the cycle counter and take the time all stages are measured from.
+//
+//*****************************************************************************
+void
+BootTimeStart(void)
+{
+  DWTStart();
+  g_ui32BootStart = DWTCycles();
+  g_ui32BootNumStages = 0;
+  g_ui32BootRows = 0;
+}
+
+//*****************************************************************************
+//
+// BootTimeMark
+// Inputs:
+//   1. Name of the init stage just finished
+// Outputs: None
+// Description:
+// Timestamp the end of an init stage. Stages past BOOT_MAX_STAGES are not
+// recorded.
+//
+//*****************************************************************************
+void
+BootTimeMark(const char *pcName)
+{
+  if (g_ui32BootNumStages < BOOT_MAX_STAGES)
+  {
+    g_psBootStages[g_ui32BootNumStages].pcName = pcName;
+    g_psBootStages[g_ui32BootNumStages].ui32Cycles =
+      DWTCycles() - g_ui32BootStart;
+    g_ui32BootNumStages++;
+  }
+}
+
+//*****************************************************************************
+//
+// BootTimeRow
+// Inputs: None
+// Outputs: None
+// Description:
+// Count a row boundary. At the one that completes the first frame, take
+// its time and queue the boot report.
+//
+//*****************************************************************************
+void
+BootTimeRow(void)
+{
+  if (g_ui32BootRows < BOOT_FIRST_FRAME_ROWS)
+  {
+    g_ui32BootRows++;
+    if (g_ui32BootRows == BOOT_FIRST_FRAME_ROWS)
+    {
+      g_ui32BootFirstFrame = DWTCycles() - g_ui32BootStart;
+      BootTimeReport();
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// BootTimeFirstFrameUs
+// Inputs: None
+// Outputs: Microseconds from BootTimeStart to the first frame, 0 before it
+// Description:
+// Time to the first frame.
+//
+//*****************************************************************************
+uint32_t
+BootTimeFirstFrameUs(void)
+{
+  return g_ui32BootFirstFrame / DWT_CYCLES_PER_US;
+}
+
+//*****************************************************************************
+//
+// BootTimeReport
+// Inputs: None
+// Outputs: None
+// Description:
+// Print the time at the end of every init stage and the time to the first
+// frame against its target.
+//
+//*****************************************************************************
+void
+BootTimeReport(void)
+{
+  uint32_t idx, us;
+
+  ConsolePrintf("boot     us stage\n");
+  for (idx = 0; idx < g_ui32BootNumStages; idx++)
+  {
+    ConsolePrintf("%11u %s\n",
+                  g_psBootStages[idx].ui32Cycles / DWT_CYCLES_PER_US,
+                  g_psBootStages[idx].pcName);
+  }
+  us = BootTimeFirstFrameUs();
+  ConsolePrintf("first frame %u us, target %u us%s\n", us,
+                BOOT_FIRST_FRAME_TARGET_US,
+                (us > BOOT_FIRST_FRAME_TARGET_US) ? ", MISSED" : "");
+}
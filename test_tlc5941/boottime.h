@@ -0,0 +1,47 @@
+//*****************************************************************************
+//
+// boottime.h - Boot stage timestamps and time to the first frame.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __BOOTTIME_H__
+#define __BOOTTIME_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// ConfigureBoard marks the end of each init stage with BootTimeMark. Time
+// is counted from BootTimeStart, called once the system clock is set; the
+// reset and PLL lock before it take a fixed time. The main loop calls
+// BootTimeRow at every row boundary until the first frame is complete, then
+// the stage times and the time to the first frame are reported on the
+// console, with the first frame checked against BOOT_FIRST_FRAME_TARGET_US.
+//
+// A frame is complete once eight rows rendered by the main loop have been
+// latched. The first row boundary latches the buffer cleared at boot, so
+// that is the ninth boundary.
+//
+//*****************************************************************************
+#define BOOT_MAX_STAGES         16
+#define BOOT_FIRST_FRAME_ROWS   9
+#define BOOT_FIRST_FRAME_TARGET_US 20000
+
+typedef struct
+{
+    const char *pcName;
+    uint32_t ui32Cycles;
+}
+tBootStage;
+
+extern void BootTimeStart(void);
+extern void BootTimeMark(const char *pcName);
+extern void BootTimeRow(void);
+extern uint32_t BootTimeFirstFrameUs(void);
+extern void BootTimeReport(void);
+
+#endif // __BOOTTIME_H__
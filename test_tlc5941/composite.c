@@ -0,0 +1,203 @@
+//*****************************************************************************
+//
+// composite.c - Layered 8x8 RGB renderer with packed 16-bit blending.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Layers are composited bottom to top into one row of 12-bit RGB values.
+// The blend kernels work on whole 32-bit words, two channels at a time:
+// - additive: SMULWB/SMULWT scale both lanes by the opacity, PKHBT packs
+//   them back and UQADD16 adds with saturation, 6 instructions per word:
+//   both lanes are offset by 0x8000 around the add, so that the unsigned
+//   saturation clamps them at 32767 and they stay valid signed lanes
+// - alpha: PKHBT/PKHTB pair each source lane with its destination lane and
+//   SMUAD forms src * a + dst * (256 - a) in one step, where a is the
+//   opacity on covered pixels and 0 elsewhere
+// A full 8x8x3 composite of three layers is 8 rows of 12 words per layer.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "simd.h"
+#include "composite.h"
+
+//*****************************************************************************
+//
+// Pixel column of each 16-bit lane in a layer row
+//
+//*****************************************************************************
+static const uint8_t laneColumn[2*LAYER_ROW_WORDS] = {
+  0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3,
+  4, 4, 4, 5, 5, 5, 6, 6, 6, 7, 7, 7
+};
+
+//*****************************************************************************
+//
+// LayerClear
+// Inputs:
+//   1. Layer to clear
+// Outputs: None
+// Description:
+// Make every pixel of a layer black and uncovered.
+//
+//*****************************************************************************
+void
+LayerClear(tLayer *psLayer)
+{
+  uint32_t row, word;
+
+  for (row = 0; row < 8; row++)
+  {
+    for (word = 0; word < LAYER_ROW_WORDS; word++)
+    {
+      psLayer->pui32Pix[row][word] = 0;
+    }
+    psLayer->pui8Mask[row] = 0;
+  }
+}
+
+//*****************************************************************************
+//
+// LayerSetPixel
+// Inputs:
+//   1. Layer to draw on
+//   2. Pixel row, 0 to 7
+//   3. Pixel column, 0 to 7
+//   4. RGB color, red in the low byte
+// Outputs: None
+// Description:
+// Set one pixel to a color and mark it covered.
+//
+//*****************************************************************************
+void
+LayerSetPixel(tLayer *psLayer, uint32_t row, uint32_t col, uint32_t color)
+{
+  uint16_t *chan;
+
+  chan = (uint16_t *)psLayer->pui32Pix[row] + 3*col;
+  chan[0] = ((color&0xFF) << 4) << LAYER_SHIFT;
+  chan[1] = ((color&0xFF00) >> 4) << LAYER_SHIFT;
+  chan[2] = ((color&0xFF0000) >> 12) << LAYER_SHIFT;
+  psLayer->pui8Mask[row] |= 1 << col;
+}
+
+//*****************************************************************************
+//
+// LayerDrawBitmap
+// Inputs:
+//   1. Layer to draw on
+//   2. 8x8 bitmap, one byte per row, bit 0 is column 0
+//   3. RGB color, red in the low byte
+// Outputs: None
+// Description:
+// Set every pixel lit in the bitmap, such as a font8x8_basic glyph.
+//
+//*****************************************************************************
+void
+LayerDrawBitmap(tLayer *psLayer, const char bitmap[8], uint32_t color)
+{
+  uint32_t row, col;
+
+  for (row = 0; row < 8; row++)
+  {
+    for (col = 0; col < 8; col++)
+    {
+      if (bitmap[row] & (1 << col))
+      {
+        LayerSetPixel(psLayer, row, col, color);
+      }
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// CompositeRow
+// Inputs:
+//   1. Layers, bottom first
+//   2. Number of layers
+//   3. Row to composite, 0 to 7
+//   4. Output: 12-bit R, G and B values for each column
+// Outputs: None
+// Description:
+// Blend one row of all enabled layers over black.
+//
+//*****************************************************************************
+void
+CompositeRow(const tLayer *psLayers, uint32_t numLayers, uint32_t row,
+             uint16_t rgbValues[8][3])
+{
+  uint32_t acc[LAYER_ROW_WORDS];
+  const uint32_t *src;
+  uint16_t *out;
+  uint32_t word, layer, mask, s, d;
+  uint32_t scale, wOn, wOff, wLo, wHi;
+  int32_t lo, hi;
+
+  for (word = 0; word < LAYER_ROW_WORDS; word++)
+  {
+    acc[word] = 0;
+  }
+
+  for (layer = 0; layer < numLayers; layer++)
+  {
+    mask = psLayers[layer].pui8Mask[row];
+    if (!psLayers[layer].ui8Enabled || !mask || !psLayers[layer].ui16Opacity)
+    {
+      continue;
+    }
+    src = psLayers[layer].pui32Pix[row];
+
+    if (psLayers[layer].ui8Mode == LAYER_BLEND_ADD)
+    {
+      //
+      // acc += src * opacity / 256, both lanes at once
+      //
+      scale = psLayers[layer].ui16Opacity << 8;
+      for (word = 0; word < LAYER_ROW_WORDS; word++)
+      {
+        s = src[word];
+        lo = SIMD_SMULWB(scale, s);
+        hi = SIMD_SMULWT(scale, s);
+        acc[word] = SIMD_UQADD16(acc[word],
+                                 SIMD_PKHBT(lo, hi << 16) + 0x80008000) -
+                    0x80008000;
+      }
+    }
+    else
+    {
+      //
+      // acc = (src * a + acc * (256 - a)) / 256, a = 0 on uncovered pixels
+      //
+      wOn = psLayers[layer].ui16Opacity |
+            ((LAYER_OPAQUE - psLayers[layer].ui16Opacity) << 16);
+      wOff = LAYER_OPAQUE << 16;
+      for (word = 0; word < LAYER_ROW_WORDS; word++)
+      {
+        s = src[word];
+        d = acc[word];
+        wLo = (mask & (1 << laneColumn[2*word])) ? wOn : wOff;
+        wHi = (mask & (1 << laneColumn[2*word + 1])) ? wOn : wOff;
+        lo = SIMD_SMUAD(SIMD_PKHBT(s, d << 16), wLo) >> 8;
+        hi = SIMD_SMUAD(SIMD_PKHTB(d, s >> 16), wHi) >> 8;
+        acc[word] = SIMD_PKHBT(lo, hi << 16);
+      }
+    }
+  }
+
+  //
+  // Drop the guard bits, two channels per word
+  //
+  out = &rgbValues[0][0];
+  for (word = 0; word < LAYER_ROW_WORDS; word++)
+  {
+    out[2*word] = (acc[word] & 0xFFFF) >> LAYER_SHIFT;
+    out[2*word + 1] = acc[word] >> (16 + LAYER_SHIFT);
+  }
+}
@@ -0,0 +1,56 @@
+//*****************************************************************************
+//
+// composite.h - Layered 8x8 RGB renderer with packed 16-bit blending.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __COMPOSITE_H__
+#define __COMPOSITE_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// A layer holds an 8x8 image with one coverage bit per pixel. Channels are
+// 12-bit grayscale values shifted left by LAYER_SHIFT, so every channel fits
+// a signed 16-bit lane and a saturating add clamps at 4095. A row is 24
+// channels, R G B per column, packed two to a word.
+//
+//*****************************************************************************
+#define LAYER_SHIFT             3
+#define LAYER_ROW_WORDS         12
+
+//
+// Blend modes
+//
+#define LAYER_BLEND_ALPHA       0   // covered pixels mix by opacity
+#define LAYER_BLEND_ADD         1   // pixels scaled by opacity, added, clamped
+
+//
+// Opacity runs from 0 (invisible) to LAYER_OPAQUE
+//
+#define LAYER_OPAQUE            256
+
+typedef struct
+{
+    uint32_t pui32Pix[8][LAYER_ROW_WORDS];
+    uint8_t pui8Mask[8];
+    uint16_t ui16Opacity;
+    uint8_t ui8Mode;
+    uint8_t ui8Enabled;
+}
+tLayer;
+
+extern void LayerClear(tLayer *psLayer);
+extern void LayerSetPixel(tLayer *psLayer, uint32_t row, uint32_t col,
+                          uint32_t color);
+extern void LayerDrawBitmap(tLayer *psLayer, const char bitmap[8],
+                            uint32_t color);
+extern void CompositeRow(const tLayer *psLayers, uint32_t numLayers,
+                         uint32_t row, uint16_t rgbValues[8][3]);
+
+#endif // __COMPOSITE_H__
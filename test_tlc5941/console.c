@@ -0,0 +1,143 @@
+//*****************************************************************************
+//
+// console.c - Deferred UART console output.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// UARTprintf from uartstdio waits on the UART for every character past the
+// 16-byte FIFO, 87us each at 115200 baud, so a line of boot or report text
+// held up the main loop for milliseconds. Messages are formatted with the
+// TivaWare uvsnprintf, which takes the same format strings, into a ring
+// buffer instead.
+//
+//*****************************************************************************
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_memmap.h"
+#include "driverlib/rom.h"
+#include "driverlib/uart.h"
+#include "utils/ustdlib.h"
+#include "console.h"
+
+//*****************************************************************************
+//
+// Globals
+//
+//*****************************************************************************
+static char g_pcConsoleBuffer[CONSOLE_BUFFER_SIZE];
+
+// Next byte to write and next byte to send
+static uint32_t g_ui32ConsoleHead;
+static uint32_t g_ui32ConsoleTail;
+
+// Bytes of dropped messages
+uint32_t g_ui32ConsoleDropped;
+
+//*****************************************************************************
+//
+// ConsolePrintf
+// Inputs:
+//   1. Format string, as for UARTprintf
+//   2. Arguments
+// Outputs: None
+// Description:
+// Queue a formatted message for the UART.
+//
+//*****************************************************************************
+void
+ConsolePrintf(const char *pcString, ...)
+{
+  va_list vaArgP;
+  char line[CONSOLE_LINE_MAX];
+  uint32_t len, idx, head;
+
+  va_start(vaArgP, pcString);
+  len = uvsnprintf(line, sizeof(line), pcString, vaArgP);
+  va_end(vaArgP);
+  if (len > sizeof(line) - 1)
+  {
+    len = sizeof(line) - 1;
+  }
+
+  //
+  // One byte is left unused so that a full buffer differs from an empty one
+  //
+  head = g_ui32ConsoleHead;
+  if (len > ((g_ui32ConsoleTail - head - 1) & (CONSOLE_BUFFER_SIZE - 1)))
+  {
+    g_ui32ConsoleDropped += len;
+    return;
+  }
+  for (idx = 0; idx < len; idx++)
+  {
+    g_pcConsoleBuffer[head] = line[idx];
+    head = (head + 1) & (CONSOLE_BUFFER_SIZE - 1);
+  }
+  g_ui32ConsoleHead = head;
+}
+
+//*****************************************************************************
+//
+// ConsoleWrite
+// Inputs:
+//   1. Bytes to send
+//   2. Number of bytes
+// Outputs: True if queued, false if the buffer had no room for all of them
+// Description:
+// Queue a binary record for the UART, whole or not at all, so that a reader
+// never sees part of one.
+//
+//*****************************************************************************
+bool
+ConsoleWrite(const uint8_t *pui8Data, uint32_t ui32Count)
+{
+  uint32_t idx, head;
+
+  head = g_ui32ConsoleHead;
+  if (ui32Count > ((g_ui32ConsoleTail - head - 1) & (CONSOLE_BUFFER_SIZE - 1)))
+  {
+    return false;
+  }
+  for (idx = 0; idx < ui32Count; idx++)
+  {
+    g_pcConsoleBuffer[head] = pui8Data[idx];
+    head = (head + 1) & (CONSOLE_BUFFER_SIZE - 1);
+  }
+  g_ui32ConsoleHead = head;
+  return true;
+}
+
+//*****************************************************************************
+//
+// ConsoleFlush
+// Inputs: None
+// Outputs: None
+// Description:
+// Send queued bytes until the UART transmit FIFO is full or nothing is left.
+// Never waits.
+//
+//*****************************************************************************
+void
+ConsoleFlush(void)
+{
+  uint32_t tail;
+
+  tail = g_ui32ConsoleTail;
+  while (tail != g_ui32ConsoleHead)
+  {
+    if (!ROM_UARTCharPutNonBlocking(UART0_BASE, g_pcConsoleBuffer[tail]))
+    {
+      break;
+    }
+    tail = (tail + 1) & (CONSOLE_BUFFER_SIZE - 1);
+  }
+  g_ui32ConsoleTail = tail;
+}
@@ -0,0 +1,40 @@
+//*****************************************************************************
+//
+// console.h - Deferred UART console output.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __CONSOLE_H__
+#define __CONSOLE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// ConsolePrintf formats into a RAM buffer and returns at once; ConsoleFlush,
+// run as idle work, moves what fits into the UART transmit FIFO. A message
+// that does not fit in the buffer is dropped whole and counted in
+// g_ui32ConsoleDropped. ConsoleWrite queues binary records the same way,
+// whole or not at all, leaving the counting to its caller. All are for the
+// main loop only, not for interrupt handlers.
+//
+// The buffer holds CONSOLE_BUFFER_SIZE bytes, a power of 2, which drains in
+// 10ms at the 1Mbaud the UART runs at for the frame stream (stream.h). A
+// message is at most CONSOLE_LINE_MAX - 1 bytes.
+//
+//*****************************************************************************
+#define CONSOLE_BUFFER_SIZE     1024
+#define CONSOLE_LINE_MAX        96
+
+extern uint32_t g_ui32ConsoleDropped;
+
+extern void ConsolePrintf(const char *pcString, ...);
+extern bool ConsoleWrite(const uint8_t *pui8Data, uint32_t ui32Count);
+extern void ConsoleFlush(void);
+
+#endif // __CONSOLE_H__
@@ -0,0 +1,609 @@
+//*****************************************************************************
+//
+// draw.c - Clipped line, rectangle, circle, blit and flood fill primitives
+//          for the 8x8 layers.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "bitboard.h"
+#include "composite.h"
+#include "draw.h"
+
+//
+// Cohen-Sutherland outcode bits
+//
+#define DRAW_ABOVE              1
+#define DRAW_BELOW              2
+#define DRAW_LEFT               4
+#define DRAW_RIGHT              8
+
+//
+// Column of a single set bit of a row byte: 0x17 is a de Bruijn sequence
+// for 3-bit indexes, so the top three bits of the product differ for each
+// of the eight bits
+//
+#define DRAW_BIT_INDEX(bit)     (g_pui8DrawBitIndex[(((bit) * 0x17) >> 5) & 7])
+
+static const uint8_t g_pui8DrawBitIndex[8] = { 0, 1, 2, 4, 7, 3, 6, 5 };
+
+//*****************************************************************************
+//
+// DrawPattern
+// Inputs:
+//   1. RGB color, red in the low byte
+//   2. Output: a whole layer row of the color
+// Outputs: None
+// Description:
+// Expand a color once per primitive, so each span it draws is a copy of
+// part of this row.
+//
+//*****************************************************************************
+static void
+DrawPattern(uint32_t color, uint32_t pattern[LAYER_ROW_WORDS])
+{
+  uint32_t r, g, b, rg, br, gb, idx;
+
+  r = ((color&0xFF) << 4) << LAYER_SHIFT;
+  g = ((color&0xFF00) >> 4) << LAYER_SHIFT;
+  b = ((color&0xFF0000) >> 12) << LAYER_SHIFT;
+  rg = r | (g << 16);
+  br = b | (r << 16);
+  gb = g | (b << 16);
+  for (idx = 0; idx < LAYER_ROW_WORDS; idx += 3)
+  {
+    pattern[idx] = rg;
+    pattern[idx + 1] = br;
+    pattern[idx + 2] = gb;
+  }
+}
+
+//*****************************************************************************
+//
+// DrawRun
+// Inputs:
+//   1. Layer to draw on
+//   2. Row, 0 to 7
+//   3. First column, 0 to 7
+//   4. Last column, first to 7
+//   5. Row from DrawPattern
+// Outputs: None
+// Description:
+// Copy the channels of columns first to last, a halfword at an odd start
+// or end and whole words between, and cover them with one OR.
+//
+//*****************************************************************************
+static void
+DrawRun(tLayer *psLayer, uint32_t row, uint32_t col0, uint32_t col1,
+        const uint32_t pattern[LAYER_ROW_WORDS])
+{
+  uint32_t *word;
+  uint32_t first, last, idx;
+
+  word = psLayer->pui32Pix[row];
+  first = 3*col0;
+  last = 3*col1 + 3;
+  if (first & 1)
+  {
+    ((uint16_t *)word)[first] = ((const uint16_t *)pattern)[first];
+    first++;
+  }
+  if (last & 1)
+  {
+    last--;
+    ((uint16_t *)word)[last] = ((const uint16_t *)pattern)[last];
+  }
+  for (idx = first >> 1; idx < (last >> 1); idx++)
+  {
+    word[idx] = pattern[idx];
+  }
+  psLayer->pui8Mask[row] |= (0xFF >> (7 - (col1 - col0))) << col0;
+}
+
+//*****************************************************************************
+//
+// DrawRuns
+// Inputs:
+//   1. Layer to draw on
+//   2. Row, 0 to 7
+//   3. Columns to set, bit 0 is column 0
+//   4. Row from DrawPattern
+// Outputs: None
+// Description:
+// Draw each run of set bits in a row as one span. The lowest set bit
+// marks where a run starts, and adding it to the bits carries through the
+// run to the bit after its end.
+//
+//*****************************************************************************
+static void
+DrawRuns(tLayer *psLayer, uint32_t row, uint32_t bits,
+         const uint32_t pattern[LAYER_ROW_WORDS])
+{
+  uint32_t low, run;
+
+  while (bits)
+  {
+    low = bits & -bits;
+    run = bits & ~(bits + low);
+    bits ^= run;
+    DrawRun(psLayer, row, DRAW_BIT_INDEX(low),
+            DRAW_BIT_INDEX((run + low) >> 1), pattern);
+  }
+}
+
+//*****************************************************************************
+//
+// DrawPixel
+// Inputs:
+//   1. Layer to draw on
+//   2. Row and column, anywhere
+//   3. Row from DrawPattern
+// Outputs: None
+// Description:
+// Draw one pixel if it is on the display.
+//
+//*****************************************************************************
+static void
+DrawPixel(tLayer *psLayer, int32_t row, int32_t col,
+          const uint32_t pattern[LAYER_ROW_WORDS])
+{
+  if (((uint32_t)row < 8) && ((uint32_t)col < 8))
+  {
+    DrawRun(psLayer, row, col, col, pattern);
+  }
+}
+
+//*****************************************************************************
+//
+// DrawOutcode
+// Inputs:
+//   1. Row and column, anywhere
+// Outputs: DRAW_ABOVE, DRAW_BELOW, DRAW_LEFT and DRAW_RIGHT bits for the
+//          sides of the display the point lies beyond
+// Description:
+// Classify a line end for clipping.
+//
+//*****************************************************************************
+static uint32_t
+DrawOutcode(int32_t row, int32_t col)
+{
+  uint32_t code;
+
+  code = 0;
+  if (row < 0)
+  {
+    code |= DRAW_ABOVE;
+  }
+  else if (row > 7)
+  {
+    code |= DRAW_BELOW;
+  }
+  if (col < 0)
+  {
+    code |= DRAW_LEFT;
+  }
+  else if (col > 7)
+  {
+    code |= DRAW_RIGHT;
+  }
+  return code;
+}
+
+//*****************************************************************************
+//
+// DrawDivRound
+// Inputs:
+//   1. Numerator
+//   2. Denominator, not 0
+// Outputs: Quotient rounded to nearest
+// Description:
+// Where a clipped line crosses a display edge.
+//
+//*****************************************************************************
+static int32_t
+DrawDivRound(int32_t num, int32_t den)
+{
+  if (den < 0)
+  {
+    num = -num;
+    den = -den;
+  }
+  return (num >= 0) ? (num + den/2) / den : -((den/2 - num) / den);
+}
+
+//*****************************************************************************
+//
+// DrawSpan
+// Inputs:
+//   1. Layer to draw on
+//   2. Row
+//   3. Columns at the two ends, in either order
+//   4. RGB color, red in the low byte
+// Outputs: None
+// Description:
+// Draw the part of a horizontal run that is on the display.
+//
+//*****************************************************************************
+void
+DrawSpan(tLayer *psLayer, int32_t row, int32_t col0, int32_t col1,
+         uint32_t color)
+{
+  uint32_t pattern[LAYER_ROW_WORDS];
+  int32_t swap;
+
+  if (col0 > col1)
+  {
+    swap = col0;
+    col0 = col1;
+    col1 = swap;
+  }
+  if (((uint32_t)row > 7) || (col1 < 0) || (col0 > 7))
+  {
+    return;
+  }
+  DrawPattern(color, pattern);
+  DrawRun(psLayer, row, (col0 < 0) ? 0 : col0, (col1 > 7) ? 7 : col1,
+          pattern);
+}
+
+//*****************************************************************************
+//
+// DrawLine
+// Inputs:
+//   1. Layer to draw on
+//   2. Row and column of one end
+//   3. Row and column of the other end
+//   4. RGB color, red in the low byte
+// Outputs: None
+// Description:
+// Clip the line to the display, then step it with Bresenham's algorithm,
+// drawing the pixels it sets on each row as one span.
+//
+//*****************************************************************************
+void
+DrawLine(tLayer *psLayer, int32_t row0, int32_t col0, int32_t row1,
+         int32_t col1, uint32_t color)
+{
+  uint32_t pattern[LAYER_ROW_WORDS];
+  uint32_t code0, code1, code;
+  int32_t row, col, dRow, dCol, sRow, sCol, err, e2, next, start;
+
+  //
+  // Move each end that is off the display to where the line crosses the
+  // edge it lies beyond, until both are on it or the line misses
+  //
+  code0 = DrawOutcode(row0, col0);
+  code1 = DrawOutcode(row1, col1);
+  while (code0 | code1)
+  {
+    if (code0 & code1)
+    {
+      return;
+    }
+    code = code0 ? code0 : code1;
+    if (code & DRAW_ABOVE)
+    {
+      col = col0 + DrawDivRound((col1 - col0) * (0 - row0), row1 - row0);
+      row = 0;
+    }
+    else if (code & DRAW_BELOW)
+    {
+      col = col0 + DrawDivRound((col1 - col0) * (7 - row0), row1 - row0);
+      row = 7;
+    }
+    else if (code & DRAW_LEFT)
+    {
+      row = row0 + DrawDivRound((row1 - row0) * (0 - col0), col1 - col0);
+      col = 0;
+    }
+    else
+    {
+      row = row0 + DrawDivRound((row1 - row0) * (7 - col0), col1 - col0);
+      col = 7;
+    }
+    if (code == code0)
+    {
+      row0 = row;
+      col0 = col;
+      code0 = DrawOutcode(row0, col0);
+    }
+    else
+    {
+      row1 = row;
+      col1 = col;
+      code1 = DrawOutcode(row1, col1);
+    }
+  }
+
+  DrawPattern(color, pattern);
+  dCol = (col1 > col0) ? col1 - col0 : col0 - col1;
+  dRow = (row1 > row0) ? row0 - row1 : row1 - row0;
+  sCol = (col0 < col1) ? 1 : -1;
+  sRow = (row0 < row1) ? 1 : -1;
+  err = dCol + dRow;
+  row = row0;
+  col = col0;
+  start = col0;
+  for (;;)
+  {
+    if ((row == row1) && (col == col1))
+    {
+      DrawRun(psLayer, row, (start < col) ? start : col,
+              (start < col) ? col : start, pattern);
+      break;
+    }
+    e2 = 2*err;
+    next = col;
+    if (e2 >= dRow)
+    {
+      err += dRow;
+      next += sCol;
+    }
+    if (e2 <= dCol)
+    {
+      DrawRun(psLayer, row, (start < col) ? start : col,
+              (start < col) ? col : start, pattern);
+      err += dCol;
+      row += sRow;
+      start = next;
+    }
+    col = next;
+  }
+}
+
+//*****************************************************************************
+//
+// DrawRect
+// Inputs:
+//   1. Layer to draw on
+//   2. Row and column of one corner
+//   3. Row and column of the opposite corner
+//   4. RGB color, red in the low byte
+// Outputs: None
+// Description:
+// Draw the outline of a rectangle: a span for the top and bottom and a
+// pixel at each side of the rows between.
+//
+//*****************************************************************************
+void
+DrawRect(tLayer *psLayer, int32_t row0, int32_t col0, int32_t row1,
+         int32_t col1, uint32_t color)
+{
+  uint32_t pattern[LAYER_ROW_WORDS];
+  int32_t row, last, swap;
+
+  if (row0 > row1)
+  {
+    swap = row0;
+    row0 = row1;
+    row1 = swap;
+  }
+  if (col0 > col1)
+  {
+    swap = col0;
+    col0 = col1;
+    col1 = swap;
+  }
+  DrawSpan(psLayer, row0, col0, col1, color);
+  if (row1 != row0)
+  {
+    DrawSpan(psLayer, row1, col0, col1, color);
+  }
+  DrawPattern(color, pattern);
+  row = (row0 + 1 < 0) ? 0 : row0 + 1;
+  last = (row1 - 1 > 7) ? 7 : row1 - 1;
+  for (; row <= last; row++)
+  {
+    DrawPixel(psLayer, row, col0, pattern);
+    DrawPixel(psLayer, row, col1, pattern);
+  }
+}
+
+//*****************************************************************************
+//
+// DrawFillRect
+// Inputs:
+//   1. Layer to draw on
+//   2. Row and column of one corner
+//   3. Row and column of the opposite corner
+//   4. RGB color, red in the low byte
+// Outputs: None
+// Description:
+// Draw a solid rectangle, one span per row.
+//
+//*****************************************************************************
+void
+DrawFillRect(tLayer *psLayer, int32_t row0, int32_t col0, int32_t row1,
+             int32_t col1, uint32_t color)
+{
+  uint32_t pattern[LAYER_ROW_WORDS];
+  int32_t row, swap;
+
+  if (row0 > row1)
+  {
+    swap = row0;
+    row0 = row1;
+    row1 = swap;
+  }
+  if (col0 > col1)
+  {
+    swap = col0;
+    col0 = col1;
+    col1 = swap;
+  }
+  if ((row1 < 0) || (row0 > 7) || (col1 < 0) || (col0 > 7))
+  {
+    return;
+  }
+  row0 = (row0 < 0) ? 0 : row0;
+  row1 = (row1 > 7) ? 7 : row1;
+  col0 = (col0 < 0) ? 0 : col0;
+  col1 = (col1 > 7) ? 7 : col1;
+  DrawPattern(color, pattern);
+  for (row = row0; row <= row1; row++)
+  {
+    DrawRun(psLayer, row, col0, col1, pattern);
+  }
+}
+
+//*****************************************************************************
+//
+// DrawCircle
+// Inputs:
+//   1. Layer to draw on
+//   2. Row and column of the center
+//   3. Radius, 0 for a single pixel
+//   4. RGB color, red in the low byte
+// Outputs: None
+// Description:
+// Draw the outline of a circle with the midpoint algorithm, stepping one
+// octant and mirroring each pixel into the other seven.
+//
+//*****************************************************************************
+void
+DrawCircle(tLayer *psLayer, int32_t row, int32_t col, int32_t radius,
+           uint32_t color)
+{
+  uint32_t pattern[LAYER_ROW_WORDS];
+  int32_t x, y, err;
+
+  if ((radius < 0) || (row + radius < 0) || (row - radius > 7) ||
+      (col + radius < 0) || (col - radius > 7))
+  {
+    return;
+  }
+  DrawPattern(color, pattern);
+  x = radius;
+  y = 0;
+  err = 1 - radius;
+  while (x >= y)
+  {
+    DrawPixel(psLayer, row + y, col + x, pattern);
+    DrawPixel(psLayer, row + y, col - x, pattern);
+    DrawPixel(psLayer, row - y, col + x, pattern);
+    DrawPixel(psLayer, row - y, col - x, pattern);
+    DrawPixel(psLayer, row + x, col + y, pattern);
+    DrawPixel(psLayer, row + x, col - y, pattern);
+    DrawPixel(psLayer, row - x, col + y, pattern);
+    DrawPixel(psLayer, row - x, col - y, pattern);
+    y++;
+    if (err < 0)
+    {
+      err += 2*y + 1;
+    }
+    else
+    {
+      x--;
+      err += 2*(y - x) + 1;
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// DrawBlit
+// Inputs:
+//   1. Layer to draw on
+//   2. Row and column for the bitmap's top left corner
+//   3. 8x8 bitmap, one byte per row, bit 0 is column 0
+//   4. RGB color, red in the low byte
+// Outputs: None
+// Description:
+// Draw the lit pixels of a bitmap, such as a font8x8_basic glyph, at an
+// offset, each run of them in a row as one span.
+//
+//*****************************************************************************
+void
+DrawBlit(tLayer *psLayer, int32_t row, int32_t col, const char bitmap[8],
+         uint32_t color)
+{
+  uint32_t pattern[LAYER_ROW_WORDS];
+  uint32_t line, bits;
+  int32_t dst;
+
+  if ((row < -7) || (row > 7) || (col < -7) || (col > 7))
+  {
+    return;
+  }
+  DrawPattern(color, pattern);
+  for (line = 0; line < 8; line++)
+  {
+    dst = row + (int32_t)line;
+    if ((uint32_t)dst > 7)
+    {
+      continue;
+    }
+    bits = (uint8_t)bitmap[line];
+    bits = (col >= 0) ? (bits << col) & 0xFF : bits >> -col;
+    DrawRuns(psLayer, dst, bits, pattern);
+  }
+}
+
+//*****************************************************************************
+//
+// DrawFloodFill
+// Inputs:
+//   1. Layer to draw on
+//   2. Row and column to fill from, 0 to 7
+//   3. RGB color, red in the low byte
+// Outputs: None
+// Description:
+// Fill the region of pixels joined to the start pixel, up, down, left or
+// right, that match it: covered in the same color, or uncovered. The
+// matching pixels go into a bitboard and the region grows through it a
+// step in all four directions at once until it stops, then each row of it
+// is drawn as spans.
+//
+//*****************************************************************************
+void
+DrawFloodFill(tLayer *psLayer, int32_t row, int32_t col, uint32_t color)
+{
+  uint32_t pattern[LAYER_ROW_WORDS];
+  const uint16_t *chan, *seed;
+  tBitboard match, region, last;
+  uint32_t r, c, covered;
+
+  if (((uint32_t)row > 7) || ((uint32_t)col > 7))
+  {
+    return;
+  }
+  seed = (const uint16_t *)psLayer->pui32Pix[row] + 3*col;
+  covered = psLayer->pui8Mask[row] & (1 << col);
+  match = BB_EMPTY;
+  for (r = 0; r < 8; r++)
+  {
+    chan = (const uint16_t *)psLayer->pui32Pix[r];
+    for (c = 0; c < 8; c++, chan += 3)
+    {
+      if (!(psLayer->pui8Mask[r] & (1 << c)) != !covered)
+      {
+        continue;
+      }
+      if (!covered ||
+          ((chan[0] == seed[0]) && (chan[1] == seed[1]) &&
+           (chan[2] == seed[2])))
+      {
+        match |= BB_BIT(r, c);
+      }
+    }
+  }
+
+  region = BB_BIT(row, col);
+  do
+  {
+    last = region;
+    region |= (BB_SHIFT_UP(region) | BB_SHIFT_DOWN(region) |
+               BB_SHIFT_LEFT(region) | BB_SHIFT_RIGHT(region)) & match;
+  }
+  while (region != last);
+
+  DrawPattern(color, pattern);
+  for (r = 0; r < 8; r++)
+  {
+    DrawRuns(psLayer, r, BB_ROW(region, r), pattern);
+  }
+}
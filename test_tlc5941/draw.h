@@ -0,0 +1,46 @@
+//*****************************************************************************
+//
+// draw.h - Clipped line, rectangle, circle, blit and flood fill primitives
+//          for the 8x8 layers.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __DRAW_H__
+#define __DRAW_H__
+
+#include <stdint.h>
+#include "composite.h"
+
+//*****************************************************************************
+//
+// Every primitive breaks its shape into horizontal spans and writes each
+// span as one run of the layer row: a run of pixels is a run of R G B
+// channels, which repeats every three words, so a span costs a word store
+// per two channels and one OR into the coverage mask instead of three
+// halfword stores and a mask update per pixel.
+//
+// Coordinates are signed and may lie off the display, within +/-32767; the
+// primitives draw only the part that falls on it. Colors are 0xBBGGRR, as
+// for LayerSetPixel.
+//
+//*****************************************************************************
+extern void DrawSpan(tLayer *psLayer, int32_t row, int32_t col0, int32_t col1,
+                     uint32_t color);
+extern void DrawLine(tLayer *psLayer, int32_t row0, int32_t col0,
+                     int32_t row1, int32_t col1, uint32_t color);
+extern void DrawRect(tLayer *psLayer, int32_t row0, int32_t col0,
+                     int32_t row1, int32_t col1, uint32_t color);
+extern void DrawFillRect(tLayer *psLayer, int32_t row0, int32_t col0,
+                         int32_t row1, int32_t col1, uint32_t color);
+extern void DrawCircle(tLayer *psLayer, int32_t row, int32_t col,
+                       int32_t radius, uint32_t color);
+extern void DrawBlit(tLayer *psLayer, int32_t row, int32_t col,
+                     const char bitmap[8], uint32_t color);
+extern void DrawFloodFill(tLayer *psLayer, int32_t row, int32_t col,
+                          uint32_t color);
+
+#endif // __DRAW_H__
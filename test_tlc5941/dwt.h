@@ -0,0 +1,42 @@
+//*****************************************************************************
+//
+// dwt.h - Cortex-M4 DWT cycle counter.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __DWT_H__
+#define __DWT_H__
+
+#include "inc/hw_types.h"
+
+//*****************************************************************************
+//
+// The DWT cycle counter counts CPU clocks, at 40MHz once the PLL is set up,
+// and wraps every 107s. It is not part of the TivaWare register headers, so
+// its addresses are defined here. Once started it keeps counting; starting
+// it again does not reset it.
+//
+//*****************************************************************************
+#define DWT_DEMCR               0xE000EDFC
+#define DWT_DEMCR_TRCENA        0x01000000
+#define DWT_CTRL                0xE0001000
+#define DWT_CTRL_CYCCNTENA      0x00000001
+#define DWT_CYCCNT              0xE0001004
+
+#define DWT_CYCLES_PER_US       40
+
+#define DWTStart()                                                            \
+    do                                                                        \
+    {                                                                         \
+        HWREG(DWT_DEMCR) |= DWT_DEMCR_TRCENA;                                 \
+        HWREG(DWT_CTRL) |= DWT_CTRL_CYCCNTENA;                                \
+    }                                                                         \
+    while(0)
+
+#define DWTCycles()             HWREG(DWT_CYCCNT)
+
+#endif // __DWT_H__
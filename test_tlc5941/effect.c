@@ -0,0 +1,254 @@
+//*****************************************************************************
+//
+// effect.c - Procedural full-frame effects: plasma, fire, rainbow and
+//            sparkle.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "fxmath.h"
+#include "simd.h"
+#include "effect.h"
+
+//
+// Time advanced per step: a full turn every 64 steps
+//
+#define EFFECT_PHASE_STEP       1024
+
+//
+// Plasma wave numbers, phase per pixel, for the column, row and diagonal
+// terms
+//
+#define EFFECT_PLASMA_COL       5461
+#define EFFECT_PLASMA_ROW       7282
+#define EFFECT_PLASMA_DIAG      3641
+
+//
+// Rainbow hue change per column and per row
+//
+#define EFFECT_RAINBOW_COL      4096
+#define EFFECT_RAINBOW_ROW      2048
+
+//
+// Sparkle: new sparks per step and how pale they are
+//
+#define EFFECT_SPARKS           2
+#define EFFECT_SPARKLE_SAT      160
+
+//*****************************************************************************
+//
+// EffectRandom
+// Inputs:
+//   1. Effect state
+// Outputs: 32 random bits
+// Description:
+// Step the xorshift LFSR.
+//
+//*****************************************************************************
+static uint32_t
+EffectRandom(tEffect *psEffect)
+{
+  uint32_t x;
+
+  x = psEffect->ui32Random;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  psEffect->ui32Random = x;
+  return x;
+}
+
+//*****************************************************************************
+//
+// EffectInit
+// Inputs:
+//   1. Effect state
+//   2. Effect, EFFECT_PLASMA to EFFECT_SPARKLE
+//   3. Random seed
+// Outputs: None
+// Description:
+// Start an effect from a cold, dark frame.
+//
+//*****************************************************************************
+void
+EffectInit(tEffect *psEffect, uint32_t type, uint32_t seed)
+{
+  uint32_t row, col;
+
+  for (row = 0; row < 8; row++)
+  {
+    psEffect->ppui32Heat[row][0] = 0;
+    psEffect->ppui32Heat[row][1] = 0;
+    psEffect->ppui32Level[row][0] = 0;
+    psEffect->ppui32Level[row][1] = 0;
+    for (col = 0; col < 8; col++)
+    {
+      psEffect->ppui8Hue[row][col] = 0;
+    }
+  }
+  psEffect->ui32Random = seed ? seed : 0x2545F491;
+  psEffect->ui16Phase = 0;
+  psEffect->ui8Type = (type < EFFECT_NUM_TYPES) ? type : EFFECT_PLASMA;
+  EffectStep(psEffect);
+}
+
+//*****************************************************************************
+//
+// EffectStep
+// Inputs:
+//   1. Effect state
+// Outputs: None
+// Description:
+// Advance the effect a frame: the plasma's column sines, which every row
+// shares, a generation of the fire, or the sparkles' fade and new sparks.
+//
+//*****************************************************************************
+void
+EffectStep(tEffect *psEffect)
+{
+  uint32_t row, col, bits, lo, hi, left, right, idx;
+
+  psEffect->ui16Phase += EFFECT_PHASE_STEP;
+  if (psEffect->ui8Type == EFFECT_PLASMA)
+  {
+    for (col = 0; col < 8; col++)
+    {
+      psEffect->pi16ColWave[col] = FxSin(col * EFFECT_PLASMA_COL +
+                                         psEffect->ui16Phase);
+    }
+  }
+  else if (psEffect->ui8Type == EFFECT_FIRE)
+  {
+    //
+    // Each row rises from the one below before that is updated, the
+    // bottom row from fresh heat of 128 to 248 under it: each cell is the
+    // average of its neighbour on each side, averaged with the cell below,
+    // less a cooling of 0 to 45. Neighbours past the edge are the edge
+    // cell itself.
+    //
+    bits = EffectRandom(psEffect);
+    for (row = 0; row < 8; row++)
+    {
+      if (row < 7)
+      {
+        lo = psEffect->ppui32Heat[row + 1][0];
+        hi = psEffect->ppui32Heat[row + 1][1];
+      }
+      else
+      {
+        lo = 0x80808080 + ((bits & 0x0F0F0F0F) << 3);
+        hi = 0x80808080 + (((bits >> 4) & 0x0F0F0F0F) << 3);
+      }
+      left = (lo << 8) | (lo & 0xFF);
+      right = (lo >> 8) | (hi << 24);
+      bits = EffectRandom(psEffect);
+      psEffect->ppui32Heat[row][0] =
+        SIMD_UQSUB8(SIMD_UHADD8(SIMD_UHADD8(left, right), lo),
+                    3*(bits & 0x0F0F0F0F));
+      left = (hi << 8) | (lo >> 24);
+      right = (hi >> 8) | (hi & 0xFF000000);
+      psEffect->ppui32Heat[row][1] =
+        SIMD_UQSUB8(SIMD_UHADD8(SIMD_UHADD8(left, right), hi),
+                    3*((bits >> 4) & 0x0F0F0F0F));
+    }
+  }
+  else if (psEffect->ui8Type == EFFECT_SPARKLE)
+  {
+    //
+    // Every pixel loses a quarter of its brightness, then new sparks light
+    //
+    for (row = 0; row < 8; row++)
+    {
+      lo = psEffect->ppui32Level[row][0];
+      hi = psEffect->ppui32Level[row][1];
+      psEffect->ppui32Level[row][0] = lo - ((lo >> 2) & 0x3F3F3F3F);
+      psEffect->ppui32Level[row][1] = hi - ((hi >> 2) & 0x3F3F3F3F);
+    }
+    for (idx = 0; idx < EFFECT_SPARKS; idx++)
+    {
+      bits = EffectRandom(psEffect);
+      row = (bits >> 3) & 7;
+      col = bits & 7;
+      psEffect->ppui32Level[row][col >> 2] |= 0xFF << (8 * (col & 3));
+      psEffect->ppui8Hue[row][col] = bits >> 24;
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// EffectRow
+// Inputs:
+//   1. Effect state
+//   2. Row, 0 to 7
+//   3. Output: 12-bit R, G and B values for each column
+// Outputs: None
+// Description:
+// Work out one row of the effect's frame.
+//
+//*****************************************************************************
+void
+EffectRow(const tEffect *psEffect, uint32_t row, uint16_t rgbValues[8][3])
+{
+  uint32_t col, heat, cells;
+  int32_t rowWave, sum;
+  uint16_t phase;
+
+  phase = psEffect->ui16Phase;
+  if (psEffect->ui8Type == EFFECT_PLASMA)
+  {
+    //
+    // The three waves add to +/-1.5 in Q15; half of that turns the hue
+    // three quarters of the wheel either way
+    //
+    rowWave = FxSin(row * EFFECT_PLASMA_ROW - 2*phase);
+    for (col = 0; col < 8; col++)
+    {
+      sum = psEffect->pi16ColWave[col] + rowWave +
+            FxSin((row + col) * EFFECT_PLASMA_DIAG + 3*phase);
+      FxHsvToRgb(phase + (sum >> 1), FX_SAT_FULL, FX_VAL_FULL,
+                 rgbValues[col]);
+    }
+  }
+  else if (psEffect->ui8Type == EFFECT_FIRE)
+  {
+    cells = psEffect->ppui32Heat[row][0];
+    for (col = 0; col < 8; col++, cells >>= 8)
+    {
+      if (col == 4)
+      {
+        cells = psEffect->ppui32Heat[row][1];
+      }
+      heat = 3*(cells & 0xFF);
+      rgbValues[col][0] = ((heat < 255) ? heat : 255) << 4;
+      rgbValues[col][1] = ((heat < 255) ? 0 :
+                           (heat < 510) ? heat - 255 : 255) << 4;
+      rgbValues[col][2] = ((heat < 510) ? 0 : heat - 510) << 4;
+    }
+  }
+  else if (psEffect->ui8Type == EFFECT_RAINBOW)
+  {
+    for (col = 0; col < 8; col++)
+    {
+      FxHsvToRgb(phase + col * EFFECT_RAINBOW_COL + row * EFFECT_RAINBOW_ROW,
+                 FX_SAT_FULL, FX_VAL_FULL, rgbValues[col]);
+    }
+  }
+  else
+  {
+    cells = psEffect->ppui32Level[row][0];
+    for (col = 0; col < 8; col++, cells >>= 8)
+    {
+      if (col == 4)
+      {
+        cells = psEffect->ppui32Level[row][1];
+      }
+      FxHsvToRgb(psEffect->ppui8Hue[row][col] << 8, EFFECT_SPARKLE_SAT,
+                 (cells & 0xFF) << 4, rgbValues[col]);
+    }
+  }
+}
@@ -0,0 +1,71 @@
+//*****************************************************************************
+//
+// effect.h - Procedural full-frame effects: plasma, fire, rainbow and
+//            sparkle.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __EFFECT_H__
+#define __EFFECT_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Each effect is computed, not stored: EffectStep advances it a frame from
+// the pattern task and EffectRow works out one row's 12-bit RGB from the
+// row task, in fixed point on the kernels in fxmath.h.
+//
+// - Plasma: the hue of each pixel follows the sum of three sines, of the
+//   column, the row and the diagonal, drifting at different rates
+// - Fire: a heat map, seeded with random heat below the bottom row, where
+//   each cell takes the average of the three below it less a random
+//   cooling, shown black to red to yellow to white
+// - Rainbow: the hue wheel swept diagonally across the display
+// - Sparkle: pixels lit at random places and hues that fade out
+//
+// Random bits come from a 32-bit xorshift LFSR. Fire heat and sparkle
+// brightness are held four pixels to a word, column c in byte c & 3 of word
+// c >> 2, so a generation works on four at a time with the byte-lane
+// instructions in simd.h.
+//
+// Cost per row of EffectRow plus RenderRGBRow, and per frame of
+// EffectStep, in Cortex-M4 cycles estimated by host/bench_kernels. A row
+// gives the row task 6000 cycles of its 80000, and the pattern task 2000
+// per step; FillSineHalf refills the audio in about 1700.
+//
+//   Effect    Row    Step
+//   Plasma    1089    411
+//   Fire       425    815
+//   Rainbow    675     24
+//   Sparkle    745    153
+//
+//*****************************************************************************
+#define EFFECT_PLASMA           0
+#define EFFECT_FIRE             1
+#define EFFECT_RAINBOW          2
+#define EFFECT_SPARKLE          3
+#define EFFECT_NUM_TYPES        4
+
+typedef struct
+{
+    uint32_t ppui32Heat[8][2];      // fire: heat per cell, 0 to 255
+    uint32_t ppui32Level[8][2];     // sparkle: brightness per pixel
+    uint8_t ppui8Hue[8][8];         // sparkle: hue per pixel, top 8 bits
+    int16_t pi16ColWave[8];         // plasma: column sine this frame, Q15
+    uint32_t ui32Random;            // LFSR state, never 0
+    uint16_t ui16Phase;             // time, 65536 to the turn
+    uint8_t ui8Type;
+}
+tEffect;
+
+extern void EffectInit(tEffect *psEffect, uint32_t type, uint32_t seed);
+extern void EffectStep(tEffect *psEffect);
+extern void EffectRow(const tEffect *psEffect, uint32_t row,
+                      uint16_t rgbValues[8][3]);
+
+#endif // __EFFECT_H__
@@ -0,0 +1,167 @@
+//*****************************************************************************
+//
+// envelope.c - Attack, decay, sustain and release envelope for the voices
+//              of the PWM DAC audio path.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "envelope.h"
+
+//*****************************************************************************
+//
+// EnvelopeInit
+// Inputs:
+//   1. Envelope state
+//   2. Attack, decay and release lengths and sustain level
+// Outputs: None
+// Description:
+// Turn the shape into a level step per sample for each stage, and start
+// silent.
+//
+//*****************************************************************************
+void
+EnvelopeInit(tEnvelope *psEnvelope, const tEnvelopeShape *psShape)
+{
+  uint32_t sustain;
+
+  sustain = (psShape->ui16Sustain < 256) ? psShape->ui16Sustain : 256;
+  psEnvelope->ui32SustainLevel = sustain << (ENVELOPE_LEVEL_SHIFT - 8);
+  psEnvelope->ui32AttackStep = ENVELOPE_LEVEL_FULL /
+    (psShape->ui16AttackSamples ? psShape->ui16AttackSamples : 1);
+  psEnvelope->ui32DecayStep =
+    (ENVELOPE_LEVEL_FULL - psEnvelope->ui32SustainLevel) /
+    (psShape->ui16DecaySamples ? psShape->ui16DecaySamples : 1);
+  psEnvelope->ui32ReleaseStep = ENVELOPE_LEVEL_FULL /
+    (psShape->ui16ReleaseSamples ? psShape->ui16ReleaseSamples : 1);
+  psEnvelope->ui32Level = 0;
+  psEnvelope->ui8Stage = ENVELOPE_IDLE;
+}
+
+//*****************************************************************************
+//
+// EnvelopeGate
+// Inputs:
+//   1. Envelope state
+//   2. True while the note is held
+// Outputs: None
+// Description:
+// Start the attack from the present level when the gate goes on, or the
+// release when it goes off. Called every run, it only acts on a change.
+//
+//*****************************************************************************
+void
+EnvelopeGate(tEnvelope *psEnvelope, bool on)
+{
+  if (on)
+  {
+    if ((psEnvelope->ui8Stage == ENVELOPE_IDLE) ||
+        (psEnvelope->ui8Stage == ENVELOPE_RELEASE))
+    {
+      psEnvelope->ui8Stage = ENVELOPE_ATTACK;
+    }
+  }
+  else if (psEnvelope->ui8Stage != ENVELOPE_IDLE)
+  {
+    psEnvelope->ui8Stage = ENVELOPE_RELEASE;
+  }
+}
+
+//*****************************************************************************
+//
+// EnvelopeActive
+// Inputs:
+//   1. Envelope state
+// Outputs: True until the release has reached silence
+// Description:
+// An idle voice need not be rendered.
+//
+//*****************************************************************************
+bool
+EnvelopeActive(const tEnvelope *psEnvelope)
+{
+  return psEnvelope->ui8Stage != ENVELOPE_IDLE;
+}
+
+//*****************************************************************************
+//
+// EnvelopeRamp
+// Inputs:
+//   1. Envelope state
+//   2. Samples in the run
+//   3. Sine amplitude at full level
+//   4. Returns the amplitude step per sample, Q16
+// Outputs: Amplitude at the first sample of the run, Q16
+// Description:
+// Advance the envelope over a run of samples, through as many stages as
+// end in it, and give the straight line from the amplitude at its start
+// to that at its end.
+//
+//*****************************************************************************
+int32_t
+EnvelopeRamp(tEnvelope *psEnvelope, uint32_t count, uint32_t scale,
+             int32_t *pi32Step)
+{
+  uint32_t level, left, need;
+  int32_t start;
+
+  level = psEnvelope->ui32Level;
+  start = level * scale;
+  left = count;
+  while (left)
+  {
+    if (psEnvelope->ui8Stage == ENVELOPE_ATTACK)
+    {
+      need = (ENVELOPE_LEVEL_FULL - level + psEnvelope->ui32AttackStep - 1) /
+             psEnvelope->ui32AttackStep;
+      if (need > left)
+      {
+        level += left * psEnvelope->ui32AttackStep;
+        break;
+      }
+      level = ENVELOPE_LEVEL_FULL;
+      left -= need;
+      psEnvelope->ui8Stage = ENVELOPE_DECAY;
+    }
+    else if (psEnvelope->ui8Stage == ENVELOPE_DECAY)
+    {
+      need = psEnvelope->ui32DecayStep ?
+             (level - psEnvelope->ui32SustainLevel +
+              psEnvelope->ui32DecayStep - 1) / psEnvelope->ui32DecayStep : 0;
+      if (need > left)
+      {
+        level -= left * psEnvelope->ui32DecayStep;
+        break;
+      }
+      level = psEnvelope->ui32SustainLevel;
+      left -= need;
+      psEnvelope->ui8Stage = ENVELOPE_SUSTAIN;
+    }
+    else if (psEnvelope->ui8Stage == ENVELOPE_RELEASE)
+    {
+      need = (level + psEnvelope->ui32ReleaseStep - 1) /
+             psEnvelope->ui32ReleaseStep;
+      if (need > left)
+      {
+        level -= left * psEnvelope->ui32ReleaseStep;
+        break;
+      }
+      level = 0;
+      psEnvelope->ui8Stage = ENVELOPE_IDLE;
+      break;
+    }
+    else
+    {
+      break;
+    }
+  }
+  psEnvelope->ui32Level = level;
+  *pi32Step = ((int32_t)(level * scale) - start) /
+              (int32_t)(count ? count : 1);
+  return start;
+}
@@ -0,0 +1,75 @@
+//*****************************************************************************
+//
+// envelope.h - Attack, decay, sustain and release envelope for the voices
+//              of the PWM DAC audio path.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __ENVELOPE_H__
+#define __ENVELOPE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// A voice's level rises from silence to full over the attack, falls to the
+// sustain level over the decay and holds there while its gate is on. Once
+// the gate goes off it falls to silence at the release rate, from
+// wherever it is, so a note that starts or stops anywhere in its sine
+// never jumps.
+//
+// The level is worked out once per run of samples, at most a buffer half:
+// EnvelopeRamp advances it over the run and gives the sine amplitude at
+// the start of the run and the step to add each sample to reach the
+// amplitude at its end. The amplitude is the scale SineApprox multiplies
+// by, so enveloped samples still cost one multiply each.
+//
+//*****************************************************************************
+#define ENVELOPE_IDLE           0
+#define ENVELOPE_ATTACK         1
+#define ENVELOPE_DECAY          2
+#define ENVELOPE_SUSTAIN        3
+#define ENVELOPE_RELEASE        4
+
+//
+// Level, Q16: ENVELOPE_LEVEL_FULL is full amplitude
+//
+#define ENVELOPE_LEVEL_SHIFT    16
+#define ENVELOPE_LEVEL_FULL     (1 << ENVELOPE_LEVEL_SHIFT)
+
+//
+// Lengths in samples; the sustain level is out of 256. The release time
+// is from full level.
+//
+typedef struct
+{
+    uint16_t ui16AttackSamples;
+    uint16_t ui16DecaySamples;
+    uint16_t ui16Sustain;
+    uint16_t ui16ReleaseSamples;
+}
+tEnvelopeShape;
+
+typedef struct
+{
+    uint32_t ui32Level;             // Q16
+    uint32_t ui32AttackStep;        // level change per sample in each stage
+    uint32_t ui32DecayStep;
+    uint32_t ui32SustainLevel;
+    uint32_t ui32ReleaseStep;
+    uint8_t ui8Stage;
+}
+tEnvelope;
+
+extern void EnvelopeInit(tEnvelope *psEnvelope, const tEnvelopeShape *psShape);
+extern void EnvelopeGate(tEnvelope *psEnvelope, bool on);
+extern bool EnvelopeActive(const tEnvelope *psEnvelope);
+extern int32_t EnvelopeRamp(tEnvelope *psEnvelope, uint32_t count,
+                            uint32_t scale, int32_t *pi32Step);
+
+#endif // __ENVELOPE_H__
@@ -0,0 +1,391 @@
+//*****************************************************************************
+//
+// font.c - Compressed variable-width fonts with a decoded-glyph cache.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Glyphs stay compressed in flash (see font.h) and are decoded into a small
+// 2-way set-associative cache the first time they are drawn. A cached glyph
+// is 8 row bytes laid out like a font8x8_basic entry, so drawing a row of it
+// is the same single indexed load as fontTable[charAddr][row].
+//
+// Scrolling text is composed into an 8x8 window once per frame with
+// FontScrollRender; the rows of the window are then drawn like any other
+// 8x8 bitmap.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "font.h"
+
+//
+// Display width in columns
+//
+#define FONT_WINDOW_WIDTH 8
+
+//*****************************************************************************
+//
+// Decoded-glyph cache
+//
+//*****************************************************************************
+static tFontGlyph g_psFontCache[FONT_CACHE_SETS][FONT_CACHE_WAYS];
+
+//*****************************************************************************
+//
+// FontNextCode
+// Inputs:
+//   1. Pointer to the UTF-8 text pointer
+// Outputs: Code point of the next character, 0 at the end of the text
+// Description:
+// Decode one 1, 2 or 3 byte UTF-8 sequence and advance past it. Malformed
+// bytes are returned as Latin-1 codes.
+//
+//*****************************************************************************
+uint32_t
+FontNextCode(const char **ppcText)
+{
+  const uint8_t *pui8Text;
+  uint32_t code;
+
+  pui8Text = (const uint8_t *)*ppcText;
+  code = pui8Text[0];
+  if (code == 0)
+  {
+    return 0;
+  }
+  if (((code & 0xE0) == 0xC0) && ((pui8Text[1] & 0xC0) == 0x80))
+  {
+    code = ((code & 0x1F) << 6) | (pui8Text[1] & 0x3F);
+    *ppcText += 2;
+  }
+  else if (((code & 0xF0) == 0xE0) && ((pui8Text[1] & 0xC0) == 0x80) &&
+           ((pui8Text[2] & 0xC0) == 0x80))
+  {
+    code = ((code & 0x0F) << 12) | ((pui8Text[1] & 0x3F) << 6) |
+           (pui8Text[2] & 0x3F);
+    *ppcText += 3;
+  }
+  else
+  {
+    *ppcText += 1;
+  }
+  return code;
+}
+
+//*****************************************************************************
+//
+// FontGlyphFind
+// Inputs:
+//   1. Font
+//   2. Code point
+// Outputs: Pointer to the glyph header byte in flash, 0 if not in the font
+// Description:
+// Find the glyph set holding a code, then walk at most FONT_INDEX_STEP - 1
+// glyphs from the nearest indexed one.
+//
+//*****************************************************************************
+static const uint8_t *
+FontGlyphFind(const tFont *psFont, uint32_t code)
+{
+  const tFontSet *psSet;
+  const uint8_t *pui8Glyph;
+  uint32_t setIdx, glyphIdx;
+
+  for (setIdx = 0; setIdx < psFont->ui8NumSets; setIdx++)
+  {
+    psSet = &psFont->psSets[setIdx];
+    glyphIdx = code - psSet->ui16First;
+    if (glyphIdx < psSet->ui16Count)
+    {
+      pui8Glyph = psSet->pui8Data +
+                  psSet->pui16Index[glyphIdx / FONT_INDEX_STEP];
+      for (glyphIdx %= FONT_INDEX_STEP; glyphIdx; glyphIdx--)
+      {
+        pui8Glyph += 1 + FONT_GLYPH_BYTES(*pui8Glyph);
+      }
+      return FONT_GLYPH_MISSING(*pui8Glyph) ? 0 : pui8Glyph;
+    }
+  }
+  return 0;
+}
+
+//*****************************************************************************
+//
+// FontGlyphDecode
+// Inputs:
+//   1. Pointer to the glyph header byte
+//   2. Output: the 8 glyph rows, bit 0 is the leftmost column
+// Outputs: None
+// Description:
+// Expand a bit-packed or run-length coded glyph.
+//
+//*****************************************************************************
+void
+FontGlyphDecode(const uint8_t *pui8Glyph, uint8_t pui8Rows[FONT_HEIGHT])
+{
+  uint32_t header, width, count, row;
+  uint32_t bits, numBits, pixel, run, lit;
+
+  header = *pui8Glyph++;
+  width = FONT_GLYPH_WIDTH(header);
+  count = FONT_GLYPH_BYTES(header);
+
+  for (row = 0; row < FONT_HEIGHT; row++)
+  {
+    pui8Rows[row] = 0;
+  }
+
+  if (!(header & FONT_GLYPH_RLE))
+  {
+    //
+    // Bit-packed: pull width bits per row from an LSB-first stream
+    //
+    bits = 0;
+    numBits = 0;
+    for (row = 0; row < FONT_HEIGHT; row++)
+    {
+      while (numBits < width)
+      {
+        bits |= (count ? *pui8Glyph++ : 0) << numBits;
+        count -= count ? 1 : 0;
+        numBits += 8;
+      }
+      pui8Rows[row] = bits & ((1 << width) - 1);
+      bits >>= width;
+      numBits -= width;
+    }
+  }
+  else
+  {
+    //
+    // Run-length: alternate blank and lit runs, 2 per byte
+    //
+    pixel = 0;
+    lit = 0;
+    for (count *= 2; count; count--, pixel += run)
+    {
+      run = (count & 1) ? (*pui8Glyph++ >> 4) : (*pui8Glyph & 0xF);
+      if (lit)
+      {
+        for (bits = pixel; (bits < pixel + run) && (bits < 8 * width); bits++)
+        {
+          pui8Rows[bits / width] |= 1 << (bits % width);
+        }
+      }
+      if (run != 15)
+      {
+        lit ^= 1;
+      }
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// FontGlyphGet
+// Inputs:
+//   1. Font
+//   2. Code point
+// Outputs: Decoded glyph
+// Description:
+// Look a glyph up in the cache, decoding it from flash on a miss. Codes the
+// font lacks are drawn as its ui16Missing glyph. The returned glyph stays
+// valid until FONT_CACHE_WAYS other glyphs of the same cache set are
+// fetched.
+//
+//*****************************************************************************
+const tFontGlyph *
+FontGlyphGet(const tFont *psFont, uint16_t ui16Code)
+{
+  tFontGlyph *psWays;
+  tFontGlyph *psGlyph;
+  const uint8_t *pui8Glyph;
+  uint32_t way;
+
+  psWays = g_psFontCache[(ui16Code ^ (ui16Code >> 3)) & (FONT_CACHE_SETS - 1)];
+
+  //
+  // Hit: mark the way most recently used
+  //
+  for (way = 0; way < FONT_CACHE_WAYS; way++)
+  {
+    if ((psWays[way].ui16Code == ui16Code) && (psWays[way].psFont == psFont))
+    {
+      psWays[way].ui8Age = 0;
+      psWays[way ^ 1].ui8Age = 1;
+      return &psWays[way];
+    }
+  }
+
+  //
+  // Miss: replace the least recently used way
+  //
+  way = psWays[0].ui8Age ? 0 : 1;
+  psGlyph = &psWays[way];
+  pui8Glyph = FontGlyphFind(psFont, ui16Code);
+  if (!pui8Glyph)
+  {
+    pui8Glyph = FontGlyphFind(psFont, psFont->ui16Missing);
+  }
+  if (pui8Glyph)
+  {
+    FontGlyphDecode(pui8Glyph, psGlyph->pui8Rows);
+    psGlyph->ui8Width = FONT_GLYPH_WIDTH(*pui8Glyph);
+  }
+  else
+  {
+    for (way = 0; way < FONT_HEIGHT; way++)
+    {
+      psGlyph->pui8Rows[way] = 0;
+    }
+    psGlyph->ui8Width = 1;
+  }
+  psGlyph->psFont = psFont;
+  psGlyph->ui16Code = ui16Code;
+  psGlyph->ui8Age = 0;
+  psWays[(psGlyph - psWays) ^ 1].ui8Age = 1;
+  return psGlyph;
+}
+
+//*****************************************************************************
+//
+// FontTextWidth
+// Inputs:
+//   1. Font
+//   2. UTF-8 text
+// Outputs: Width of the text in columns, including spacing
+// Description:
+// Add up the widths of all glyphs in a text.
+//
+//*****************************************************************************
+uint32_t
+FontTextWidth(const tFont *psFont, const char *pcText)
+{
+  uint32_t code, width;
+
+  width = 0;
+  while ((code = FontNextCode(&pcText)) != 0)
+  {
+    width += FontGlyphGet(psFont, code)->ui8Width + psFont->ui8Spacing;
+  }
+  return width;
+}
+
+//*****************************************************************************
+//
+// FontScrollInit
+// Inputs:
+//   1. Scroll state
+//   2. Font
+//   3. UTF-8 text, 0 terminated
+//   4. Blank columns between the end of the text and its next repeat
+// Outputs: None
+// Description:
+// Start a text scrolling in from the right edge of the display.
+//
+//*****************************************************************************
+void
+FontScrollInit(tFontScroll *psScroll, const tFont *psFont, const char *pcText,
+               uint8_t ui8Gap)
+{
+  psScroll->psFont = psFont;
+  psScroll->pcText = pcText;
+  psScroll->pcPos = pcText;
+  psScroll->i32X = FONT_WINDOW_WIDTH;
+  psScroll->ui8Gap = ui8Gap;
+}
+
+//*****************************************************************************
+//
+// FontScrollStep
+// Inputs:
+//   1. Scroll state
+// Outputs: None
+// Description:
+// Move the text one column to the left, wrapping to its start after the gap.
+//
+//*****************************************************************************
+void
+FontScrollStep(tFontScroll *psScroll)
+{
+  const char *pcNext;
+  uint32_t code, width;
+
+  if (!psScroll->pcText[0])
+  {
+    return;
+  }
+  psScroll->i32X--;
+  pcNext = psScroll->pcPos;
+  code = FontNextCode(&pcNext);
+  if (code)
+  {
+    width = FontGlyphGet(psScroll->psFont, code)->ui8Width +
+            psScroll->psFont->ui8Spacing;
+  }
+  else
+  {
+    width = psScroll->ui8Gap;
+    pcNext = psScroll->pcText;
+  }
+  if (psScroll->i32X + (int32_t)width <= 0)
+  {
+    psScroll->i32X += width;
+    psScroll->pcPos = pcNext;
+  }
+}
+
+//*****************************************************************************
+//
+// FontScrollRender
+// Inputs:
+//   1. Scroll state
+//   2. Output: 8x8 window, one byte per row, bit 0 is column 0
+// Outputs: None
+// Description:
+// Compose the glyphs that are visible at the current scroll position.
+//
+//*****************************************************************************
+void
+FontScrollRender(const tFontScroll *psScroll, char pcWindow[FONT_HEIGHT])
+{
+  const tFontGlyph *psGlyph;
+  const char *pcText;
+  uint32_t code, row;
+  int32_t x;
+
+  for (row = 0; row < FONT_HEIGHT; row++)
+  {
+    pcWindow[row] = 0;
+  }
+  if (!psScroll->pcText[0])
+  {
+    return;
+  }
+
+  x = psScroll->i32X;
+  pcText = psScroll->pcPos;
+  while (x < FONT_WINDOW_WIDTH)
+  {
+    code = FontNextCode(&pcText);
+    if (!code)
+    {
+      x += psScroll->ui8Gap;
+      pcText = psScroll->pcText;
+      continue;
+    }
+    psGlyph = FontGlyphGet(psScroll->psFont, code);
+    for (row = 0; row < FONT_HEIGHT; row++)
+    {
+      pcWindow[row] |= (x < 0) ? (psGlyph->pui8Rows[row] >> -x) :
+                                 (psGlyph->pui8Rows[row] << x);
+    }
+    x += psGlyph->ui8Width + psScroll->psFont->ui8Spacing;
+  }
+}
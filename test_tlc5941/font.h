@@ -0,0 +1,111 @@
+//*****************************************************************************
+//
+// font.h - Compressed variable-width fonts with a decoded-glyph cache.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __FONT_H__
+#define __FONT_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Glyphs are 8 rows high and 1 to 8 columns wide. A decoded glyph row has
+// the same layout as a font8x8_basic row: bit 0 is the leftmost column.
+//
+// In flash a font is a list of glyph sets, each covering a run of
+// consecutive code points (Unicode, so Latin-1 and symbols fit alongside
+// ASCII). Each glyph is a header byte followed by its data:
+//   bits 0-2  width - 1
+//   bit  3    FONT_GLYPH_RLE: data is run-length coded, else bit-packed
+//   bits 4-7  number of data bytes
+// Bit-packed data is the 8 * width pixels row by row, LSB first. Run-length
+// data is the same pixel stream as 4-bit run lengths, low nibble first,
+// alternating between blank and lit runs and starting with blank. A run of
+// 15 continues with the same color. Either way, pixels past the end of the
+// data are blank. A run-length glyph with no data marks a code missing from
+// the set, so short gaps do not need a set of their own.
+//
+// The glyph tables are written by host/fontconv from BDF or PNG fonts.
+//
+//*****************************************************************************
+#define FONT_HEIGHT             8
+#define FONT_GLYPH_WIDTH(h)     (((h) & 0x7) + 1)
+#define FONT_GLYPH_RLE          0x08
+#define FONT_GLYPH_BYTES(h)     ((h) >> 4)
+#define FONT_GLYPH_MISSING(h)   (((h) & 0xF8) == FONT_GLYPH_RLE)
+
+//
+// Every FONT_INDEX_STEP-th glyph in a set has its data offset indexed
+//
+#define FONT_INDEX_STEP         8
+
+//
+// Decoded glyphs kept in RAM: FONT_CACHE_SETS sets of 2 ways
+//
+#define FONT_CACHE_SETS         8
+#define FONT_CACHE_WAYS         2
+
+typedef struct
+{
+    uint16_t ui16First;
+    uint16_t ui16Count;
+    const uint16_t *pui16Index;
+    const uint8_t *pui8Data;
+}
+tFontSet;
+
+typedef struct
+{
+    const tFontSet *psSets;
+    uint8_t ui8NumSets;
+    uint8_t ui8Spacing;         // blank columns after each glyph
+    uint16_t ui16Missing;       // code drawn in place of missing glyphs
+}
+tFont;
+
+typedef struct
+{
+    const tFont *psFont;
+    uint16_t ui16Code;
+    uint8_t ui8Width;
+    uint8_t ui8Age;
+    uint8_t pui8Rows[FONT_HEIGHT];
+}
+tFontGlyph;
+
+//*****************************************************************************
+//
+// Scrolling text. pcPos is the first glyph that is at least partly visible
+// and i32X is its left column relative to the display's left edge.
+//
+//*****************************************************************************
+typedef struct
+{
+    const tFont *psFont;
+    const char *pcText;         // UTF-8, 0 terminated
+    const char *pcPos;
+    int32_t i32X;
+    uint8_t ui8Gap;             // blank columns between repeats
+}
+tFontScroll;
+
+extern const tFont g_sFontIdiotBox;
+
+extern uint32_t FontNextCode(const char **ppcText);
+extern const tFontGlyph *FontGlyphGet(const tFont *psFont, uint16_t ui16Code);
+extern void FontGlyphDecode(const uint8_t *pui8Glyph,
+                            uint8_t pui8Rows[FONT_HEIGHT]);
+extern uint32_t FontTextWidth(const tFont *psFont, const char *pcText);
+extern void FontScrollInit(tFontScroll *psScroll, const tFont *psFont,
+                           const char *pcText, uint8_t ui8Gap);
+extern void FontScrollStep(tFontScroll *psScroll);
+extern void FontScrollRender(const tFontScroll *psScroll,
+                             char pcWindow[FONT_HEIGHT]);
+
+#endif // __FONT_H__
@@ -0,0 +1,303 @@
+//*****************************************************************************
+//
+// font_idiotbox.c - Compressed IdiotBox font tables.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Generated by host/fontconv, do not edit:
+//   fontconv -n IdiotBox -s 1 -w 3 -o font_idiotbox.c idiotbox.bdf
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "font.h"
+
+//
+// U+0020 - U+007E
+//
+static const uint8_t g_pui8FontIdiotBoxData0[] = {
+  0x02,                                                   // U+0020 ( )
+  0x43, 0xF6, 0x6F, 0x06, 0x06,                           // U+0021 (!)
+  0x24, 0x7B, 0x03,                                       // U+0022 (")
+  0x66, 0x36, 0xDB, 0xDF, 0xF6, 0xB7, 0xD9,               // U+0023 (#)
+  0x55, 0x8C, 0x3F, 0x78, 0xF0, 0xC7,                     // U+0024 ($)
+  0x76, 0x80, 0xF1, 0x0C, 0xC3, 0x30, 0x8F, 0x01,         // U+0025 (%)
+  0x76, 0x1C, 0x1B, 0xC7, 0xBD, 0x9B, 0xB9, 0x01,         // U+0026 (&)
+  0x12, 0xF6,                                             // U+0027 (')
+  0x43, 0x6C, 0x33, 0x63, 0x0C,                           // U+0028 (()
+  0x43, 0x63, 0xCC, 0x6C, 0x03,                           // U+0029 ())
+  0x67, 0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66,               // U+002A (*)
+  0x55, 0x00, 0xC3, 0xFC, 0x0C, 0x03,                     // U+002B (+)
+  0x32, 0x00, 0x00, 0x7B,                                 // U+002C (,)
+  0x2D, 0x3F, 0x06,                                       // U+002D (-)
+  0x19, 0x4A,                                             // U+002E (.)
+  0x66, 0x60, 0x18, 0x86, 0x61, 0x18, 0x04,               // U+002F (/)
+  0x66, 0xBE, 0xF1, 0x7C, 0xFF, 0x3E, 0xFB,               // U+0030 (0)
+  0x65, 0x8C, 0xC3, 0x30, 0x0C, 0xF3, 0x03,               // U+0031 (1)
+  0x65, 0xDE, 0x0C, 0x73, 0xC6, 0xFC, 0x03,               // U+0032 (2)
+  0x65, 0xDE, 0x0C, 0x73, 0xF0, 0xEC, 0x01,               // U+0033 (3)
+  0x76, 0x38, 0x9E, 0x6D, 0xF6, 0x87, 0xE1, 0x01,         // U+0034 (4)
+  0x65, 0xFF, 0xF0, 0xC1, 0xF0, 0xEC, 0x01,               // U+0035 (5)
+  0x65, 0x9C, 0x31, 0x7C, 0xF3, 0xEC, 0x01,               // U+0036 (6)
+  0x55, 0xFF, 0x0C, 0x63, 0x0C, 0xC3,                     // U+0037 (7)
+  0x65, 0xDE, 0x3C, 0x7B, 0xF3, 0xEC, 0x01,               // U+0038 (8)
+  0x55, 0xDE, 0x3C, 0xFB, 0x30, 0xE6,                     // U+0039 (9)
+  0x21, 0x3C, 0x3C,                                       // U+003A (:)
+  0x32, 0xB0, 0x01, 0x7B,                                 // U+003B (;)
+  0x54, 0x98, 0x99, 0x61, 0x18, 0x06,                     // U+003C (<)
+  0x2D, 0x6C, 0x6C,                                       // U+003D (=)
+  0x44, 0xC3, 0x30, 0xCC, 0xCC,                           // U+003E (>)
+  0x55, 0xDE, 0x0C, 0x63, 0x0C, 0xC0,                     // U+003F (?)
+  0x66, 0xBE, 0xF1, 0x7E, 0xBF, 0x1F, 0x78,               // U+0040 (@)
+  0x65, 0x8C, 0x37, 0xCF, 0xFF, 0x3C, 0x03,               // U+0041 (A)
+  0x66, 0x3F, 0xB3, 0xD9, 0x67, 0x36, 0xFF,               // U+0042 (B)
+  0x66, 0x3C, 0xF3, 0x60, 0x30, 0x30, 0xF3,               // U+0043 (C)
+  0x66, 0x1F, 0x9B, 0xD9, 0x6C, 0xB6, 0x7D,               // U+0044 (D)
+  0x76, 0x7F, 0xA3, 0xC5, 0x63, 0x31, 0xFE, 0x01,         // U+0045 (E)
+  0x66, 0x7F, 0xA3, 0xC5, 0x63, 0x31, 0x3C,               // U+0046 (F)
+  0x76, 0x3C, 0xF3, 0x60, 0x30, 0x37, 0xF3, 0x01,         // U+0047 (G)
+  0x65, 0xF3, 0x3C, 0xFF, 0xF3, 0x3C, 0x03,               // U+0048 (H)
+  0x43, 0x6F, 0x66, 0x66, 0x0F,                           // U+0049 (I)
+  0x66, 0x78, 0x18, 0x0C, 0x36, 0x9B, 0x79,               // U+004A (J)
+  0x76, 0x67, 0xB3, 0xCD, 0x63, 0x33, 0x9F, 0x01,         // U+004B (K)
+  0x76, 0x0F, 0x83, 0xC1, 0x60, 0x34, 0xFF, 0x01,         // U+004C (L)
+  0x76, 0xE3, 0xFB, 0xFF, 0xBF, 0x1E, 0x8F, 0x01,         // U+004D (M)
+  0x76, 0xE3, 0xF3, 0x7B, 0x3F, 0x1F, 0x8F, 0x01,         // U+004E (N)
+  0x66, 0x1C, 0xDB, 0x78, 0x3C, 0xB6, 0x71,               // U+004F (O)
+  0x66, 0x3F, 0xB3, 0xD9, 0x67, 0x30, 0x3C,               // U+0050 (P)
+  0x65, 0xDE, 0x3C, 0xCF, 0xBB, 0x87, 0x03,               // U+0051 (Q)
+  0x76, 0x3F, 0xB3, 0xD9, 0x67, 0x33, 0x9F, 0x01,         // U+0052 (R)
+  0x65, 0xDE, 0x7C, 0x38, 0xF8, 0xEC, 0x01,               // U+0053 (S)
+  0x65, 0x7F, 0xCB, 0x30, 0x0C, 0xE3, 0x01,               // U+0054 (T)
+  0x65, 0xF3, 0x3C, 0xCF, 0xF3, 0xFC, 0x03,               // U+0055 (U)
+  0x55, 0xF3, 0x3C, 0xCF, 0xB3, 0xC7,                     // U+0056 (V)
+  0x76, 0xE3, 0xF1, 0x78, 0xFD, 0xBF, 0x8F, 0x01,         // U+0057 (W)
+  0x76, 0xE3, 0xB1, 0x8D, 0xC3, 0xB1, 0x8D, 0x01,         // U+0058 (X)
+  0x65, 0xF3, 0x3C, 0x7B, 0x0C, 0xE3, 0x01,               // U+0059 (Y)
+  0x76, 0xFF, 0x71, 0x0C, 0xC3, 0x34, 0xFF, 0x01,         // U+005A (Z)
+  0x43, 0x3F, 0x33, 0x33, 0x0F,                           // U+005B ([)
+  0x76, 0x03, 0x03, 0x03, 0x03, 0x03, 0x03, 0x01,         // U+005C (\)
+  0x43, 0xCF, 0xCC, 0xCC, 0x0F,                           // U+005D (])
+  0x46, 0x08, 0x8E, 0x6D, 0x0C,                           // U+005E (^)
+  0x3F, 0xFF, 0xBF, 0x08,                                 // U+005F (_)
+  0x22, 0x9B, 0x01,                                       // U+0060 (`)
+  0x76, 0x00, 0x80, 0x07, 0xE6, 0x9B, 0xB9, 0x01,         // U+0061 (a)
+  0x66, 0x07, 0x83, 0xC1, 0x67, 0x36, 0xEF,               // U+0062 (b)
+  0x65, 0x00, 0xE0, 0xCD, 0xC3, 0xEC, 0x01,               // U+0063 (c)
+  0x76, 0x38, 0x18, 0xCC, 0x37, 0x9B, 0xB9, 0x01,         // U+0064 (d)
+  0x4D, 0x4D, 0x21, 0xA2, 0x45,                           // U+0065 (e)
+  0x55, 0x9C, 0x6D, 0x3C, 0x86, 0xF1,                     // U+0066 (f)
+  0x76, 0x00, 0x80, 0x7B, 0x36, 0xF3, 0xC1, 0x3E,         // U+0067 (g)
+  0x76, 0x07, 0x83, 0xCD, 0x6D, 0x36, 0x9F, 0x01,         // U+0068 (h)
+  0x43, 0x06, 0x67, 0x66, 0x0F,                           // U+0069 (i)
+  0x65, 0x30, 0x00, 0xC3, 0xF0, 0x3C, 0x7B,               // U+006A (j)
+  0x76, 0x07, 0x83, 0xD9, 0xE6, 0xB1, 0x9D, 0x01,         // U+006B (k)
+  0x43, 0x67, 0x66, 0x66, 0x0F,                           // U+006C (l)
+  0x76, 0x00, 0xC0, 0xEC, 0xFF, 0x5F, 0x8F, 0x01,         // U+006D (m)
+  0x65, 0x00, 0xF0, 0xCD, 0xF3, 0x3C, 0x03,               // U+006E (n)
+  0x65, 0x00, 0xE0, 0xCD, 0xF3, 0xEC, 0x01,               // U+006F (o)
+  0x76, 0x00, 0xC0, 0xCE, 0x6C, 0xF6, 0x19, 0x1E,         // U+0070 (p)
+  0x76, 0x00, 0x80, 0x7B, 0x36, 0xF3, 0xC1, 0xF0,         // U+0071 (q)
+  0x66, 0x00, 0xC0, 0xCE, 0x6D, 0x36, 0x3C,               // U+0072 (r)
+  0x3D, 0x7D, 0x45, 0x75,                                 // U+0073 (s)
+  0x54, 0xC4, 0x7C, 0x63, 0x2C, 0x03,                     // U+0074 (t)
+  0x76, 0x00, 0xC0, 0x6C, 0x36, 0x9B, 0xB9, 0x01,         // U+0075 (u)
+  0x55, 0x00, 0x30, 0xCF, 0xB3, 0xC7,                     // U+0076 (v)
+  0x66, 0x00, 0xC0, 0x78, 0xFD, 0xFF, 0xDB,               // U+0077 (w)
+  0x76, 0x00, 0xC0, 0xD8, 0xC6, 0xB1, 0x8D, 0x01,         // U+0078 (x)
+  0x65, 0x00, 0x30, 0xCF, 0xB3, 0x0F, 0x7F,               // U+0079 (y)
+  0x5D, 0x7C, 0x22, 0x23, 0x23, 0x72,                     // U+007A (z)
+  0x65, 0x38, 0xC3, 0x1C, 0x0C, 0x83, 0x03,               // U+007B ({)
+  0x21, 0x3F, 0x3F,                                       // U+007C (|)
+  0x55, 0x07, 0xC3, 0xE0, 0x0C, 0x73,                     // U+007D (})
+  0x26, 0xEE, 0x1D,                                       // U+007E (~)
+};
+static const uint16_t g_pui16FontIdiotBoxIndex0[] = {
+  0, 40, 79, 135, 175, 233, 291, 348, 398, 450, 505, 559,
+};
+
+//
+// U+00A1 - U+00B0
+//
+static const uint8_t g_pui8FontIdiotBoxData1[] = {
+  0x43, 0x06, 0x66, 0xFF, 0x06,                           // U+00A1 (¡)
+  0x08,                                                   // U+00A2 missing
+  0x66, 0x1C, 0x9B, 0xE9, 0x61, 0x38, 0xFF,               // U+00A3 (£)
+  0x08,                                                   // U+00A4 missing
+  0x08,                                                   // U+00A5 missing
+  0x08,                                                   // U+00A6 missing
+  0x08,                                                   // U+00A7 missing
+  0x08,                                                   // U+00A8 missing
+  0x87, 0x3C, 0x42, 0x99, 0x85, 0x85, 0x99, 0x42, 0x3C,   // U+00A9 (©)
+  0x08,                                                   // U+00AA missing
+  0x08,                                                   // U+00AB missing
+  0x08,                                                   // U+00AC missing
+  0x08,                                                   // U+00AD missing
+  0x08,                                                   // U+00AE missing
+  0x08,                                                   // U+00AF missing
+  0x24, 0x6E, 0x3B,                                       // U+00B0 (°)
+};
+static const uint16_t g_pui16FontIdiotBoxIndex1[] = {
+  0, 18,
+};
+
+//
+// U+00BF - U+00FC
+//
+static const uint8_t g_pui8FontIdiotBoxData2[] = {
+  0x65, 0x0C, 0xC0, 0x18, 0xC3, 0xEC, 0x01,               // U+00BF (¿)
+  0x08,                                                   // U+00C0 missing
+  0x08,                                                   // U+00C1 missing
+  0x08,                                                   // U+00C2 missing
+  0x08,                                                   // U+00C3 missing
+  0x65, 0x33, 0xE3, 0xCD, 0xFF, 0x3C, 0x03,               // U+00C4 (Ä)
+  0x08,                                                   // U+00C5 missing
+  0x08,                                                   // U+00C6 missing
+  0x08,                                                   // U+00C7 missing
+  0x08,                                                   // U+00C8 missing
+  0x65, 0xD0, 0x6F, 0x78, 0x86, 0xF1, 0x03,               // U+00C9 (É)
+  0x08,                                                   // U+00CA missing
+  0x08,                                                   // U+00CB missing
+  0x08,                                                   // U+00CC missing
+  0x08,                                                   // U+00CD missing
+  0x08,                                                   // U+00CE missing
+  0x08,                                                   // U+00CF missing
+  0x08,                                                   // U+00D0 missing
+  0x08,                                                   // U+00D1 missing
+  0x08,                                                   // U+00D2 missing
+  0x08,                                                   // U+00D3 missing
+  0x08,                                                   // U+00D4 missing
+  0x08,                                                   // U+00D5 missing
+  0x66, 0x63, 0x8E, 0x6D, 0x3C, 0xB6, 0x71,               // U+00D6 (Ö)
+  0x66, 0x80, 0xB1, 0x8D, 0x63, 0x1B, 0x03,               // U+00D7 (×)
+  0x08,                                                   // U+00D8 missing
+  0x08,                                                   // U+00D9 missing
+  0x08,                                                   // U+00DA missing
+  0x08,                                                   // U+00DB missing
+  0x65, 0x33, 0x30, 0xCF, 0xF3, 0xEC, 0x01,               // U+00DC (Ü)
+  0x08,                                                   // U+00DD missing
+  0x08,                                                   // U+00DE missing
+  0x65, 0xDE, 0x3C, 0x6F, 0xF3, 0xBC, 0x0D,               // U+00DF (ß)
+  0x76, 0x04, 0x84, 0x07, 0xE6, 0x9B, 0xB9, 0x01,         // U+00E0 (à)
+  0x76, 0x10, 0x84, 0x07, 0xE6, 0x9B, 0xB9, 0x01,         // U+00E1 (á)
+  0x76, 0x0C, 0x89, 0x07, 0xE6, 0x9B, 0xB9, 0x01,         // U+00E2 (â)
+  0x08,                                                   // U+00E3 missing
+  0x76, 0x80, 0x99, 0x07, 0xE6, 0x9B, 0xB9, 0x01,         // U+00E4 (ä)
+  0x08,                                                   // U+00E5 missing
+  0x08,                                                   // U+00E6 missing
+  0x65, 0x00, 0xE0, 0xCD, 0xC3, 0xEC, 0x31,               // U+00E7 (ç)
+  0x65, 0x04, 0xE2, 0xCD, 0xFF, 0xE0, 0x01,               // U+00E8 (è)
+  0x65, 0x10, 0xE2, 0xCD, 0xFF, 0xE0, 0x01,               // U+00E9 (é)
+  0x65, 0x8C, 0xE4, 0xCD, 0xFF, 0xE0, 0x01,               // U+00EA (ê)
+  0x65, 0xC0, 0xEC, 0xCD, 0xFF, 0xE0, 0x01,               // U+00EB (ë)
+  0x08,                                                   // U+00EC missing
+  0x08,                                                   // U+00ED missing
+  0x08,                                                   // U+00EE missing
+  0x08,                                                   // U+00EF missing
+  0x08,                                                   // U+00F0 missing
+  0x65, 0x6E, 0xF7, 0xCD, 0xF3, 0x3C, 0x03,               // U+00F1 (ñ)
+  0x65, 0x04, 0xE2, 0xCD, 0xF3, 0xEC, 0x01,               // U+00F2 (ò)
+  0x65, 0x10, 0xE2, 0xCD, 0xF3, 0xEC, 0x01,               // U+00F3 (ó)
+  0x65, 0x8C, 0xE4, 0xCD, 0xF3, 0xEC, 0x01,               // U+00F4 (ô)
+  0x08,                                                   // U+00F5 missing
+  0x65, 0xC0, 0xEC, 0xCD, 0xF3, 0xEC, 0x01,               // U+00F6 (ö)
+  0x3D, 0x28, 0x68, 0x28,                                 // U+00F7 (÷)
+  0x08,                                                   // U+00F8 missing
+  0x76, 0x04, 0xC4, 0x6C, 0x36, 0x9B, 0xB9, 0x01,         // U+00F9 (ù)
+  0x76, 0x10, 0xC4, 0x6C, 0x36, 0x9B, 0xB9, 0x01,         // U+00FA (ú)
+  0x76, 0x0C, 0xC9, 0x6C, 0x36, 0x9B, 0xB9, 0x01,         // U+00FB (û)
+  0x76, 0x80, 0xD9, 0x6C, 0x36, 0x9B, 0xB9, 0x01,         // U+00FC (ü)
+};
+static const uint16_t g_pui16FontIdiotBoxIndex2[] = {
+  0, 20, 34, 48, 68, 110, 148, 186,
+};
+
+//
+// U+2190 - U+2193
+//
+static const uint8_t g_pui8FontIdiotBoxData3[] = {
+  0x56, 0x00, 0x82, 0xE1, 0x6F, 0x20,                     // U+2190 (←)
+  0x54, 0xC4, 0x7D, 0x42, 0x08, 0x01,                     // U+2191 (↑)
+  0x56, 0x00, 0x08, 0xEC, 0x0F, 0x83,                     // U+2192 (→)
+  0x54, 0x84, 0x10, 0xF2, 0x1D, 0x01,                     // U+2193 (↓)
+};
+static const uint16_t g_pui16FontIdiotBoxIndex3[] = {
+  0,
+};
+
+//
+// U+2588 - U+2588
+//
+static const uint8_t g_pui8FontIdiotBoxData4[] = {
+  0x3F, 0xF0, 0xFF, 0x4F,                                 // U+2588 (█)
+};
+static const uint16_t g_pui16FontIdiotBoxIndex4[] = {
+  0,
+};
+
+//
+// U+2605 - U+2605
+//
+static const uint8_t g_pui8FontIdiotBoxData5[] = {
+  0x66, 0x08, 0xCE, 0xDF, 0xC7, 0xB1, 0x89,               // U+2605 (★)
+};
+static const uint16_t g_pui16FontIdiotBoxIndex5[] = {
+  0,
+};
+
+//
+// U+263A - U+263A
+//
+static const uint8_t g_pui8FontIdiotBoxData6[] = {
+  0x87, 0x3C, 0x42, 0xA5, 0x81, 0xA5, 0x99, 0x42, 0x3C,   // U+263A (☺)
+};
+static const uint16_t g_pui16FontIdiotBoxIndex6[] = {
+  0,
+};
+
+//
+// U+2665 - U+266A
+//
+static const uint8_t g_pui8FontIdiotBoxData7[] = {
+  0x66, 0x00, 0xDB, 0xFF, 0xEF, 0xE3, 0x20,               // U+2665 (♥)
+  0x08,                                                   // U+2666 missing
+  0x08,                                                   // U+2667 missing
+  0x08,                                                   // U+2668 missing
+  0x08,                                                   // U+2669 missing
+  0x66, 0x70, 0x28, 0x04, 0xE2, 0xF9, 0x38,               // U+266A (♪)
+};
+static const uint16_t g_pui16FontIdiotBoxIndex7[] = {
+  0,
+};
+
+//
+// U+2713 - U+2713
+//
+static const uint8_t g_pui8FontIdiotBoxData8[] = {
+  0x66, 0x00, 0x20, 0x18, 0xB6, 0x71, 0x10,               // U+2713 (✓)
+};
+static const uint16_t g_pui16FontIdiotBoxIndex8[] = {
+  0,
+};
+
+static const tFontSet g_psFontIdiotBoxSets[9] = {
+  { 0x0020, 95, g_pui16FontIdiotBoxIndex0, g_pui8FontIdiotBoxData0 },
+  { 0x00A1, 16, g_pui16FontIdiotBoxIndex1, g_pui8FontIdiotBoxData1 },
+  { 0x00BF, 62, g_pui16FontIdiotBoxIndex2, g_pui8FontIdiotBoxData2 },
+  { 0x2190, 4, g_pui16FontIdiotBoxIndex3, g_pui8FontIdiotBoxData3 },
+  { 0x2588, 1, g_pui16FontIdiotBoxIndex4, g_pui8FontIdiotBoxData4 },
+  { 0x2605, 1, g_pui16FontIdiotBoxIndex5, g_pui8FontIdiotBoxData5 },
+  { 0x263A, 1, g_pui16FontIdiotBoxIndex6, g_pui8FontIdiotBoxData6 },
+  { 0x2665, 6, g_pui16FontIdiotBoxIndex7, g_pui8FontIdiotBoxData7 },
+  { 0x2713, 1, g_pui16FontIdiotBoxIndex8, g_pui8FontIdiotBoxData8 },
+};
+
+const tFont g_sFontIdiotBox = {
+  g_psFontIdiotBoxSets, 9, 1, 0x003F
+};
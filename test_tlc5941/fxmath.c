@@ -0,0 +1,104 @@
+//*****************************************************************************
+//
+// fxmath.c - Q15 sine, cosine and HSV to RGB kernels for the procedural
+//            effects.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "fxmath.h"
+
+//*****************************************************************************
+//
+// FxSin
+// Inputs:
+//   1. Phase, 65536 to the turn
+// Outputs: Sine of the phase, Q15
+// Description:
+// Sine from the PWM DAC's sine kernel at full scale.
+//
+//*****************************************************************************
+int32_t
+FxSin(uint16_t phase)
+{
+  return SineApprox(phase, FX_Q15_ONE);
+}
+
+//*****************************************************************************
+//
+// FxCos
+// Inputs:
+//   1. Phase, 65536 to the turn
+// Outputs: Cosine of the phase, Q15
+// Description:
+// The sine a quarter turn on.
+//
+//*****************************************************************************
+int32_t
+FxCos(uint16_t phase)
+{
+  return SineApprox(phase + 16384, FX_Q15_ONE);
+}
+
+//*****************************************************************************
+//
+// FxHsvToRgb
+// Inputs:
+//   1. Hue, 65536 to the turn, 0 is red
+//   2. Saturation, 0 to FX_SAT_FULL
+//   3. Value, 0 to 4095
+//   4. Output: 12-bit R, G and B
+// Outputs: None
+// Description:
+// Split the hue into six sectors of 8-bit position and ramp one channel
+// across each, with integer multiplies only.
+//
+//*****************************************************************************
+void
+FxHsvToRgb(uint16_t hue, uint32_t sat, uint32_t val, uint16_t rgb[3])
+{
+  uint32_t sector, frac, p, q, t;
+
+  sector = (hue * 6) >> 16;
+  frac = ((hue * 6) >> 8) & 0xFF;
+  p = (val * (FX_SAT_FULL - sat)) >> 8;
+  q = (val * (65536 - sat * frac)) >> 16;
+  t = (val * (65536 - sat * (256 - frac))) >> 16;
+  switch (sector)
+  {
+    case 0:
+      rgb[0] = val;
+      rgb[1] = t;
+      rgb[2] = p;
+      break;
+    case 1:
+      rgb[0] = q;
+      rgb[1] = val;
+      rgb[2] = p;
+      break;
+    case 2:
+      rgb[0] = p;
+      rgb[1] = val;
+      rgb[2] = t;
+      break;
+    case 3:
+      rgb[0] = p;
+      rgb[1] = q;
+      rgb[2] = val;
+      break;
+    case 4:
+      rgb[0] = t;
+      rgb[1] = p;
+      rgb[2] = val;
+      break;
+    default:
+      rgb[0] = val;
+      rgb[1] = p;
+      rgb[2] = q;
+      break;
+  }
+}
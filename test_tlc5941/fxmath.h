@@ -0,0 +1,43 @@
+//*****************************************************************************
+//
+// fxmath.h - Q15 sine, cosine and HSV to RGB kernels for the procedural
+//            effects.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __FXMATH_H__
+#define __FXMATH_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Angles are 16-bit phases, 65536 to the turn, as for the PWM DAC's sine,
+// so they wrap for free. FxSin and FxCos are SineApprox at Q15 full scale,
+// on the tables of the kernel sine_approx.c is built with. Hues use the
+// same phase: 0 is red, 21845 green and 43690 blue.
+//
+//*****************************************************************************
+#define FX_Q15_ONE              32767
+
+//
+// Saturation, 0 (gray) to FX_SAT_FULL
+//
+#define FX_SAT_FULL             256
+
+//
+// Brightest HSV value, the 12-bit channel of a 0xFF color byte
+//
+#define FX_VAL_FULL             0xFF0
+
+extern int32_t SineApprox(uint16_t phase, uint16_t scale);
+extern int32_t FxSin(uint16_t phase);
+extern int32_t FxCos(uint16_t phase);
+extern void FxHsvToRgb(uint16_t hue, uint32_t sat, uint32_t val,
+                       uint16_t rgb[3]);
+
+#endif // __FXMATH_H__
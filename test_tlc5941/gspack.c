@@ -0,0 +1,55 @@
+//*****************************************************************************
+//
+// gspack.c - Packs grayscale rows into 16-bit SSI frames for the TLC5941s.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "power.h"
+#include "gspack.h"
+
+//*****************************************************************************
+//
+// GsPack
+// Inputs:
+//   1. 12-bit values in the order they are sent, a multiple of 8 of them
+//   2. Number of values
+//   3. Brightness scale, POWER_SCALE_FULL for none
+//   4. Output: 3/4 as many 16-bit SSI frames
+// Outputs: None
+// Description:
+// Pack 12-bit values into 16-bit frames, eight values to six frames. The
+// values are read and the frames written as 16 bits, as they are
+// declared; the compiler may merge neighbouring accesses where the
+// buffers allow.
+//
+//*****************************************************************************
+void
+GsPack(const uint16_t *values, uint32_t count, uint32_t scale,
+       uint16_t *packed)
+{
+  uint32_t a, b, c, d, e, f, g, h;
+
+  for (; count >= 8; count -= 8, values += 8, packed += 6)
+  {
+    a = ((values[0] * scale) >> POWER_SCALE_SHIFT) & 0xFFF;
+    b = ((values[1] * scale) >> POWER_SCALE_SHIFT) & 0xFFF;
+    c = ((values[2] * scale) >> POWER_SCALE_SHIFT) & 0xFFF;
+    d = ((values[3] * scale) >> POWER_SCALE_SHIFT) & 0xFFF;
+    e = ((values[4] * scale) >> POWER_SCALE_SHIFT) & 0xFFF;
+    f = ((values[5] * scale) >> POWER_SCALE_SHIFT) & 0xFFF;
+    g = ((values[6] * scale) >> POWER_SCALE_SHIFT) & 0xFFF;
+    h = ((values[7] * scale) >> POWER_SCALE_SHIFT) & 0xFFF;
+
+    packed[0] = (a << 4) | (b >> 8);
+    packed[1] = ((b & 0xFF) << 8) | (c >> 4);
+    packed[2] = ((c & 0xF) << 12) | d;
+    packed[3] = (e << 4) | (f >> 8);
+    packed[4] = ((f & 0xFF) << 8) | (g >> 4);
+    packed[5] = ((g & 0xF) << 12) | h;
+  }
+}
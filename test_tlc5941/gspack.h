@@ -0,0 +1,44 @@
+//*****************************************************************************
+//
+// gspack.h - Packs grayscale rows into 16-bit SSI frames for the TLC5941s.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __GSPACK_H__
+#define __GSPACK_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Each TLC5941 takes its 16 12-bit grayscale values as one 192-bit load,
+// MSB first, and the two chips are daisy-chained, so a row is 384 bits.
+// Sent as 12-bit SSI frames that is one frame per value, 32 a row. The
+// same bits fit in 24 16-bit frames, 12 a chip: every three frames carry
+// four values,
+//
+//   frame 0  a11..a0 b11..b8
+//   frame 1  b7..b0  c11..c4
+//   frame 2  c3..c0  d11..d0
+//
+// so the bit stream on the wire, and what the chips latch, is unchanged.
+//
+// GsPack packs values in the order they are sent, scaling each by the
+// power limiter's brightness on the way as PWMIntHandler does for 12-bit
+// frames. Bits above 12 are dropped, as a 12-bit frame would drop them.
+//
+//*****************************************************************************
+
+//
+// 16-bit frames in a row of 32 grayscale values
+//
+#define GSPACK_ROW_WORDS        24
+
+extern void GsPack(const uint16_t *values, uint32_t count, uint32_t scale,
+                   uint16_t *packed);
+
+#endif // __GSPACK_H__
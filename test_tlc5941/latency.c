@@ -0,0 +1,361 @@
+//*****************************************************************************
+//
+// latency.c - Key-to-light and key-to-sound latency measurement.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// One press is followed at a time. The main loop tasks report the scan that
+// saw it and the rows they render; PWMIntHandler reports every XLAT, which
+// is where a rendered half of g_gsValues is latched onto the LEDs and where
+// the PWM DAC starts playing the half filled before it. The stage
+// timestamps are described in latency.h.
+//
+// Statistics are updated in PWMIntHandler. LatencyPoll prints them from the
+// main loop, since the console is not for interrupt handlers.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driverlib/interrupt.h"
+#include "console.h"
+#include "latency.h"
+
+#ifdef LATENCY_ENABLE
+
+//
+// No buffer half yet
+//
+#define LATENCY_NO_HALF 0xFF
+
+//*****************************************************************************
+//
+// Globals
+//
+//*****************************************************************************
+
+// Sample counter used as the timestamp, advanced by PWMIntHandler, or by
+// SysTickIntHandler a row at a time while the display is parked
+volatile uint32_t g_ui32LatencyTick;
+
+// Statistics over all measured presses
+tLatencyStats g_sLatencyStats;
+
+// Stage timestamps of the press being followed and of the last one measured
+static uint32_t g_pui32Stamp[LATENCY_NUM_STAGES];
+static uint32_t g_pui32Last[LATENCY_NUM_STAGES];
+
+// Stages reached by the press being followed, one bit per stage
+static volatile uint32_t g_ui32Reached;
+
+// Buffer halves holding the first lit row and the first new DAC samples
+static uint32_t g_ui32LightHalf, g_ui32SoundHalf;
+
+// Presses already printed by LatencyPoll
+static uint32_t g_ui32Printed;
+
+//*****************************************************************************
+//
+// LatencyStart
+// Inputs: None
+// Outputs: None
+// Description:
+// Start following a new press at the current tick. A press still being
+// followed past its scan is dropped.
+//
+//*****************************************************************************
+static void
+LatencyStart(void)
+{
+  if (g_ui32Reached & (1 << LATENCY_STAGE_SCAN))
+  {
+    g_sLatencyStats.ui32Dropped++;
+  }
+  g_pui32Stamp[LATENCY_STAGE_PRESS] = g_ui32LatencyTick;
+  g_ui32LightHalf = LATENCY_NO_HALF;
+  g_ui32SoundHalf = LATENCY_NO_HALF;
+  g_ui32Reached = 1 << LATENCY_STAGE_PRESS;
+}
+
+//*****************************************************************************
+//
+// LatencyPress
+// Inputs: None
+// Outputs: None
+// Description:
+// Mark the moment a key goes down. Only a test harness knows this; on the
+// target a press is first seen by LatencyScan.
+//
+//*****************************************************************************
+void
+LatencyPress(void)
+{
+  LatencyStart();
+}
+
+//*****************************************************************************
+//
+// LatencyScan
+// Inputs: None
+// Outputs: None
+// Description:
+// Mark the scan that saw a new press.
+//
+//*****************************************************************************
+void
+LatencyScan(void)
+{
+  if (g_ui32Reached != (1 << LATENCY_STAGE_PRESS))
+  {
+    LatencyStart();
+  }
+  g_pui32Stamp[LATENCY_STAGE_SCAN] = g_ui32LatencyTick;
+  g_ui32Reached |= 1 << LATENCY_STAGE_SCAN;
+}
+
+//*****************************************************************************
+//
+// LatencyRender
+// Inputs:
+//   1. Index of the buffer half just filled, 0 or 0x20
+//   2. Pointer to that half of the grayscale buffer
+// Outputs: None
+// Description:
+// Note the first DAC half filled after the scan, and the first half holding
+// a lit row.
+//
+//*****************************************************************************
+void
+LatencyRender(uint32_t half, const uint16_t *gsValues)
+{
+  uint32_t idx;
+
+  if (!(g_ui32Reached & (1 << LATENCY_STAGE_SCAN)))
+  {
+    return;
+  }
+  if (g_ui32LatencyTick - g_pui32Stamp[LATENCY_STAGE_PRESS] > LATENCY_TIMEOUT)
+  {
+    g_sLatencyStats.ui32Dropped++;
+    g_ui32Reached = 0;
+    return;
+  }
+  if (g_ui32SoundHalf == LATENCY_NO_HALF)
+  {
+    g_ui32SoundHalf = half;
+  }
+  if (!(g_ui32Reached & (1 << LATENCY_STAGE_RENDER)))
+  {
+    for (idx = 0; idx < 32; idx++)
+    {
+      if (gsValues[idx])
+      {
+        g_pui32Stamp[LATENCY_STAGE_RENDER] = g_ui32LatencyTick;
+        g_ui32LightHalf = half;
+        g_ui32Reached |= 1 << LATENCY_STAGE_RENDER;
+        break;
+      }
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// LatencyRecord
+// Inputs: None
+// Outputs: None
+// Description:
+// Add a fully measured press to the statistics.
+//
+//*****************************************************************************
+static void
+LatencyRecord(void)
+{
+  uint32_t stage, light, sound;
+
+  for (stage = 0; stage < LATENCY_NUM_STAGES; stage++)
+  {
+    g_pui32Last[stage] = g_pui32Stamp[stage] -
+                         g_pui32Stamp[LATENCY_STAGE_PRESS];
+    g_sLatencyStats.pui32StageSum[stage] += g_pui32Last[stage];
+  }
+  light = g_pui32Last[LATENCY_STAGE_LIGHT];
+  sound = g_pui32Last[LATENCY_STAGE_SOUND];
+  g_sLatencyStats.pui32LightHist[(light / LATENCY_BIN_TICKS < LATENCY_BINS) ?
+                                 light / LATENCY_BIN_TICKS :
+                                 LATENCY_BINS - 1]++;
+  g_sLatencyStats.pui32SoundHist[(sound / LATENCY_BIN_TICKS < LATENCY_BINS) ?
+                                 sound / LATENCY_BIN_TICKS :
+                                 LATENCY_BINS - 1]++;
+  if (light > g_sLatencyStats.ui32LightMax)
+  {
+    g_sLatencyStats.ui32LightMax = light;
+  }
+  if (sound > g_sLatencyStats.ui32SoundMax)
+  {
+    g_sLatencyStats.ui32SoundMax = sound;
+  }
+  g_sLatencyStats.ui32Count++;
+  g_ui32Reached = 0;
+}
+
+//*****************************************************************************
+//
+// LatencyXlat
+// Inputs:
+//   1. g_count16kHz at the XLAT pulse
+// Outputs: None
+// Description:
+// Called by PWMIntHandler when it latches a row. The half just shifted out
+// goes onto the LEDs and the PWM DAC starts on the half beginning now.
+//
+//*****************************************************************************
+void
+LatencyXlat(uint32_t count)
+{
+  uint32_t playing;
+
+  if (!(g_ui32Reached & (1 << LATENCY_STAGE_SCAN)))
+  {
+    return;
+  }
+  playing = count & 0x20;
+  if ((g_ui32Reached & (1 << LATENCY_STAGE_RENDER)) &&
+      !(g_ui32Reached & (1 << LATENCY_STAGE_LIGHT)) &&
+      ((playing ^ 0x20) == g_ui32LightHalf))
+  {
+    g_pui32Stamp[LATENCY_STAGE_LIGHT] = g_ui32LatencyTick;
+    g_ui32Reached |= 1 << LATENCY_STAGE_LIGHT;
+  }
+  if (!(g_ui32Reached & (1 << LATENCY_STAGE_SOUND)) &&
+      (playing == g_ui32SoundHalf))
+  {
+    g_pui32Stamp[LATENCY_STAGE_SOUND] = g_ui32LatencyTick;
+    g_ui32Reached |= 1 << LATENCY_STAGE_SOUND;
+  }
+  if ((g_ui32Reached & (1 << LATENCY_STAGE_LIGHT)) &&
+      (g_ui32Reached & (1 << LATENCY_STAGE_SOUND)))
+  {
+    LatencyRecord();
+  }
+}
+
+//*****************************************************************************
+//
+// LatencyPrintTicks
+// Inputs:
+//   1. Label
+//   2. Ticks
+// Outputs: None
+// Description:
+// Print a time in ms with 3 decimals. A tick is 62.5us.
+//
+//*****************************************************************************
+static void
+LatencyPrintTicks(const char *pcLabel, uint32_t ticks)
+{
+  uint32_t us;
+
+  us = ticks * 125 / 2;
+  ConsolePrintf(" %s %u.%03u", pcLabel, us / 1000, us % 1000);
+}
+
+//*****************************************************************************
+//
+// LatencyPoll
+// Inputs: None
+// Outputs: None
+// Description:
+// Print the stages of each newly measured press, and the full report every
+// LATENCY_REPORT_EVERY presses. Called from the main loop.
+//
+//*****************************************************************************
+void
+LatencyPoll(void)
+{
+  uint32_t pui32Last[LATENCY_NUM_STAGES];
+  uint32_t stage, count;
+  bool wasDisabled;
+
+  wasDisabled = IntMasterDisable();
+  count = g_sLatencyStats.ui32Count;
+  for (stage = 0; stage < LATENCY_NUM_STAGES; stage++)
+  {
+    pui32Last[stage] = g_pui32Last[stage];
+  }
+  if (!wasDisabled)
+  {
+    IntMasterEnable();
+  }
+
+  if (count == g_ui32Printed)
+  {
+    return;
+  }
+  g_ui32Printed = count;
+
+  ConsolePrintf("key %u ms:", count);
+  LatencyPrintTicks("scan", pui32Last[LATENCY_STAGE_SCAN]);
+  LatencyPrintTicks("render", pui32Last[LATENCY_STAGE_RENDER]);
+  LatencyPrintTicks("light", pui32Last[LATENCY_STAGE_LIGHT]);
+  LatencyPrintTicks("sound", pui32Last[LATENCY_STAGE_SOUND]);
+  ConsolePrintf("\n");
+  if ((count % LATENCY_REPORT_EVERY) == 0)
+  {
+    LatencyReport();
+  }
+}
+
+//*****************************************************************************
+//
+// LatencyReport
+// Inputs: None
+// Outputs: None
+// Description:
+// Print the mean time from the press to each stage and the light and sound
+// latency histograms.
+//
+//*****************************************************************************
+void
+LatencyReport(void)
+{
+  static const char *const ppcStage[LATENCY_NUM_STAGES] = {
+    "press", "scan", "render", "light", "sound"
+  };
+  tLatencyStats *psStats;
+  uint32_t stage, bin;
+
+  psStats = &g_sLatencyStats;
+  ConsolePrintf("latency over %u presses, %u dropped\n", psStats->ui32Count,
+             psStats->ui32Dropped);
+  if (psStats->ui32Count == 0)
+  {
+    return;
+  }
+  ConsolePrintf("mean ms from press:");
+  for (stage = LATENCY_STAGE_SCAN; stage < LATENCY_NUM_STAGES; stage++)
+  {
+    LatencyPrintTicks(ppcStage[stage],
+                      psStats->pui32StageSum[stage] / psStats->ui32Count);
+  }
+  ConsolePrintf("\nmax ms from press:");
+  LatencyPrintTicks("light", psStats->ui32LightMax);
+  LatencyPrintTicks("sound", psStats->ui32SoundMax);
+  ConsolePrintf("\n   ms  light  sound\n");
+  for (bin = 0; bin < LATENCY_BINS; bin++)
+  {
+    if (psStats->pui32LightHist[bin] || psStats->pui32SoundHist[bin])
+    {
+      ConsolePrintf("%3u%s %6u %6u\n", bin, (bin == LATENCY_BINS - 1) ? "+" : " ",
+                 psStats->pui32LightHist[bin], psStats->pui32SoundHist[bin]);
+    }
+  }
+}
+
+#endif // LATENCY_ENABLE
@@ -0,0 +1,97 @@
+//*****************************************************************************
+//
+// latency.h - Key-to-light and key-to-sound latency measurement.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __LATENCY_H__
+#define __LATENCY_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Each keypress is timestamped, in 16kHz sample ticks, at every stage of its
+// path to the outputs:
+//   LATENCY_STAGE_PRESS   the key went down (known only to a test harness,
+//                         otherwise the scan that saw it)
+//   LATENCY_STAGE_SCAN    KeybdRead saw the key and the keypad task took it
+//   LATENCY_STAGE_RENDER  the first lit row was rendered into the back half
+//                         of g_gsValues
+//   LATENCY_STAGE_LIGHT   XLAT latched that row onto the LEDs
+//   LATENCY_STAGE_SOUND   the first sample of the key's PWM DAC output
+//                         was played
+// The light and sound latencies from the press go into histograms of
+// LATENCY_BINS bins of LATENCY_BIN_TICKS ticks (1ms), the last bin
+// collecting everything longer.
+//
+//*****************************************************************************
+#define LATENCY_STAGE_PRESS     0
+#define LATENCY_STAGE_SCAN      1
+#define LATENCY_STAGE_RENDER    2
+#define LATENCY_STAGE_LIGHT     3
+#define LATENCY_STAGE_SOUND     4
+#define LATENCY_NUM_STAGES      5
+
+#define LATENCY_BINS            16
+#define LATENCY_BIN_TICKS       16
+
+//
+// A press whose outputs have not both changed after this many ticks (1s)
+// is dropped
+//
+#define LATENCY_TIMEOUT         16000
+
+//
+// Presses between full reports on the console
+//
+#define LATENCY_REPORT_EVERY    16
+
+typedef struct
+{
+    uint32_t ui32Count;                         // presses measured
+    uint32_t ui32Dropped;                       // presses timed out
+    uint32_t pui32StageSum[LATENCY_NUM_STAGES]; // ticks from the press
+    uint32_t pui32LightHist[LATENCY_BINS];
+    uint32_t pui32SoundHist[LATENCY_BINS];
+    uint32_t ui32LightMax;
+    uint32_t ui32SoundMax;
+}
+tLatencyStats;
+
+//*****************************************************************************
+//
+// Measurement is compiled in only when LATENCY_ENABLE is defined.
+//
+//*****************************************************************************
+#ifdef LATENCY_ENABLE
+#define LATENCY_TICK()                  (g_ui32LatencyTick++)
+#define LATENCY_ADVANCE(ticks)          (g_ui32LatencyTick += (ticks))
+#define LATENCY_SCAN()                  LatencyScan()
+#define LATENCY_RENDER(half, gsValues)  LatencyRender((half), (gsValues))
+#define LATENCY_XLAT(count)             LatencyXlat(count)
+#define LATENCY_POLL()                  LatencyPoll()
+#else
+#define LATENCY_TICK()
+#define LATENCY_ADVANCE(ticks)
+#define LATENCY_SCAN()
+#define LATENCY_RENDER(half, gsValues)
+#define LATENCY_XLAT(count)
+#define LATENCY_POLL()
+#endif
+
+extern volatile uint32_t g_ui32LatencyTick;
+extern tLatencyStats g_sLatencyStats;
+
+extern void LatencyPress(void);
+extern void LatencyScan(void);
+extern void LatencyRender(uint32_t half, const uint16_t *gsValues);
+extern void LatencyXlat(uint32_t count);
+extern void LatencyPoll(void);
+extern void LatencyReport(void);
+
+#endif // __LATENCY_H__
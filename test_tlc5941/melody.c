@@ -0,0 +1,305 @@
+//*****************************************************************************
+//
+// melody.c - Melody sequencer for the PWM DAC audio path.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Songs are played into the PWM DAC buffer one 32-sample half at a time by
+// MelodyFill. Note lengths are kept in samples, so a note starts and stops
+// on the exact sample its timing calls for, wherever that falls in the
+// half. A half is filled as at most a few runs of constant pitch; every
+// sample costs one SineApprox call whether the half holds one note or a
+// note change.
+//
+// Each note sounds for its duration less MELODY_GAP_DIV of a 16th, so
+// repeated notes are heard separately. A 16th is at least 941 samples even
+// at the fastest tempo, so a half holds at most one note change.
+//
+// Notes are shaped by an envelope (envelope.h), worked out once per run.
+// Its release starts at the end of the note and fades it out in the gap
+// after it, which is at least 117 samples, so each note starts and ends at
+// the midpoint.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "melody.h"
+#include "envelope.h"
+
+//
+// Sample rate of the PWM DAC
+//
+#define MELODY_SAMPLE_HZ 16000
+
+//
+// Silent part of every note, as a fraction of a 16th
+//
+#define MELODY_GAP_DIV 8
+
+//
+// Tempo used until a song sets one, in quarter notes per minute
+//
+#define MELODY_DEFAULT_TEMPO 120
+
+// Sine wave approximation function
+extern int32_t SineApprox(uint16_t phase, uint16_t scale);
+
+//
+// 16-bit phase increments per sample for the top octave, MIDI notes 108 to
+// 119 (C8 to B8). Lower octaves shift these right.
+//
+static const uint16_t noteIncTab[12] = {
+  17146, 18165, 19246, 20390, 21602, 22887,
+  24248, 25690, 27217, 28836, 30551, 32367
+};
+
+//
+// Sequencer state
+//
+static const uint8_t *g_pui8Event;
+static uint32_t g_ui32SamplesPer16th;
+static uint32_t g_ui32ToneLeft;     // samples of tone left in this note
+static uint32_t g_ui32SilenceLeft;  // samples of silence after the tone
+static uint16_t g_ui16NoteInc;
+static uint16_t g_ui16Phase;
+
+//
+// Envelope of every note: a 2ms attack, a 60ms decay to 5/8 and a 4ms
+// release, in samples
+//
+static const tEnvelopeShape g_sNoteShape = { 32, 960, 160, 64 };
+static tEnvelope g_sNoteEnvelope;
+
+//*****************************************************************************
+//
+// MelodyNextEvent
+// Inputs: None
+// Outputs: None
+// Description:
+// Read song events up to the next note or rest and set its tone and
+// silence lengths. Stops the song at MELODY_END. A note above the table's
+// top octave is taken as a rest rather than shifted a negative count.
+//
+//*****************************************************************************
+static void
+MelodyNextEvent(void)
+{
+  uint32_t note, length, gap;
+
+  while (g_pui8Event)
+  {
+    note = g_pui8Event[0];
+    length = g_pui8Event[1];
+    if (note == MELODY_END)
+    {
+      g_pui8Event = 0;
+      return;
+    }
+    g_pui8Event += 2;
+    if (note == MELODY_TEMPO)
+    {
+      g_ui32SamplesPer16th = (MELODY_SAMPLE_HZ * 60 / 4) / (length ? length : 1);
+      continue;
+    }
+
+    length = (length ? length : 1) * g_ui32SamplesPer16th;
+    if ((note == MELODY_REST) || (note > MELODY_LAST_NOTE))
+    {
+      g_ui32ToneLeft = 0;
+      g_ui32SilenceLeft = length;
+    }
+    else
+    {
+      gap = g_ui32SamplesPer16th / MELODY_GAP_DIV;
+      g_ui32ToneLeft = length - gap;
+      g_ui32SilenceLeft = gap;
+      g_ui16NoteInc = noteIncTab[note % 12] >> (9 - note / 12);
+    }
+    return;
+  }
+}
+
+//*****************************************************************************
+//
+// MelodyStart
+// Inputs:
+//   1. Song events
+// Outputs: None
+// Description:
+// Start playing a song from its beginning, replacing any song playing.
+// A note still sounding is not cut off: the first note's attack starts
+// from its level.
+//
+//*****************************************************************************
+void
+MelodyStart(const uint8_t *pui8Song)
+{
+  if (!EnvelopeActive(&g_sNoteEnvelope))
+  {
+    EnvelopeInit(&g_sNoteEnvelope, &g_sNoteShape);
+  }
+  g_pui8Event = pui8Song;
+  g_ui32SamplesPer16th = (MELODY_SAMPLE_HZ * 60 / 4) / MELODY_DEFAULT_TEMPO;
+  g_ui32ToneLeft = 0;
+  g_ui32SilenceLeft = 0;
+  MelodyNextEvent();
+}
+
+//*****************************************************************************
+//
+// MelodyStop
+// Inputs: None
+// Outputs: None
+// Description:
+// Stop the song playing.
+//
+//*****************************************************************************
+void
+MelodyStop(void)
+{
+  g_pui8Event = 0;
+  g_ui32ToneLeft = 0;
+  g_ui32SilenceLeft = 0;
+}
+
+//*****************************************************************************
+//
+// MelodyPlaying
+// Inputs: None
+// Outputs: Nonzero while a song is playing
+// Description:
+// A song plays until the silence after its last note has been output.
+//
+//*****************************************************************************
+uint32_t
+MelodyPlaying(void)
+{
+  return (g_pui8Event != 0) || g_ui32ToneLeft || g_ui32SilenceLeft;
+}
+
+//*****************************************************************************
+//
+// MelodySine
+// Inputs:
+//   1. Pointer to the PWM DAC values to fill
+//   2. Number of samples
+//   3. PWM match value for silence
+//   4. Sine wave amplitude in PWM match counts at full level
+//   5. Pointer to the sine phase, advanced by the samples
+// Outputs: None
+// Description:
+// Output a run of the note, its amplitude ramped along the envelope.
+//
+//*****************************************************************************
+static void
+MelodySine(uint16_t* dacValues, uint32_t count, uint16_t midScale,
+           uint16_t scale, uint16_t *phase)
+{
+  uint32_t idx;
+  uint16_t notePhase, phaseInc;
+  int32_t amplitude, step;
+
+  notePhase = *phase;
+  phaseInc = g_ui16NoteInc;
+  amplitude = EnvelopeRamp(&g_sNoteEnvelope, count, scale, &step);
+  for (idx = 0; idx < count; idx++)
+  {
+    dacValues[idx] = midScale +
+                     SineApprox(notePhase, amplitude >> ENVELOPE_LEVEL_SHIFT);
+    notePhase += phaseInc;
+    amplitude += step;
+  }
+  *phase = notePhase;
+}
+
+//*****************************************************************************
+//
+// MelodyFill
+// Inputs:
+//   1. Pointer to the PWM DAC values to fill
+//   2. Number of samples
+//   3. PWM match value for silence
+//   4. Sine wave amplitude in PWM match counts
+// Outputs: None
+// Description:
+// Output the next samples of the song, switching notes on the exact sample
+// each one is due.
+//
+//*****************************************************************************
+void
+MelodyFill(uint16_t* dacValues, uint32_t count, uint16_t midScale,
+           uint16_t scale)
+{
+  uint32_t idx, run;
+  uint16_t phase;
+
+  phase = g_ui16Phase;
+  idx = 0;
+  while (idx < count)
+  {
+    if (g_ui32ToneLeft)
+    {
+      //
+      // Tone up to the end of the note or of the buffer
+      //
+      run = g_ui32ToneLeft;
+      if (run > count - idx)
+      {
+        run = count - idx;
+      }
+      g_ui32ToneLeft -= run;
+      EnvelopeGate(&g_sNoteEnvelope, true);
+      MelodySine(&dacValues[idx], run, midScale, scale, &phase);
+      idx += run;
+    }
+    else if (g_ui32SilenceLeft)
+    {
+      //
+      // Silence between notes, the last note fading out into it, and the
+      // next note restarting at phase 0
+      //
+      run = g_ui32SilenceLeft;
+      if (run > count - idx)
+      {
+        run = count - idx;
+      }
+      g_ui32SilenceLeft -= run;
+      EnvelopeGate(&g_sNoteEnvelope, false);
+      if (EnvelopeActive(&g_sNoteEnvelope))
+      {
+        MelodySine(&dacValues[idx], run, midScale, scale, &phase);
+        idx += run;
+      }
+      else
+      {
+        for (run += idx; idx < run; idx++)
+        {
+          dacValues[idx] = midScale;
+        }
+        phase = 0;
+      }
+    }
+    else if (g_pui8Event)
+    {
+      MelodyNextEvent();
+    }
+    else
+    {
+      //
+      // Song over
+      //
+      for (; idx < count; idx++)
+      {
+        dacValues[idx] = midScale;
+      }
+    }
+  }
+  g_ui16Phase = phase;
+}
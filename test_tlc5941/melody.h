@@ -0,0 +1,76 @@
+//*****************************************************************************
+//
+// melody.h - Melody sequencer for the PWM DAC audio path.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __MELODY_H__
+#define __MELODY_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// A song is a list of 2-byte events in flash: a note byte and a duration or
+// tempo byte.
+//   note 1 - 119      MIDI note number (60 is middle C), duration in 16ths
+//   MELODY_REST       silence, duration in 16ths
+//   MELODY_TEMPO      set the tempo, in quarter notes per minute
+//   MELODY_END        end of song
+// Any other note byte above MELODY_LAST_NOTE is played as a rest.
+//
+//*****************************************************************************
+#define MELODY_REST             0x00
+#define MELODY_LAST_NOTE        119
+#define MELODY_TEMPO            0x80
+#define MELODY_END              0xFF
+
+//
+// Note numbers from name and octave: NOTE(C, 4) is middle C, NOTE(As, 3)
+// the B flat below it.
+//
+#define NOTE_C                  0
+#define NOTE_Cs                 1
+#define NOTE_D                  2
+#define NOTE_Ds                 3
+#define NOTE_E                  4
+#define NOTE_F                  5
+#define NOTE_Fs                 6
+#define NOTE_G                  7
+#define NOTE_Gs                 8
+#define NOTE_A                  9
+#define NOTE_As                 10
+#define NOTE_B                  11
+#define NOTE(name, octave)      (12 * ((octave) + 1) + NOTE_##name)
+
+//
+// Durations in 16ths
+//
+#define DUR_16                  1
+#define DUR_8                   2
+#define DUR_8D                  3
+#define DUR_4                   4
+#define DUR_4D                  6
+#define DUR_2                   8
+#define DUR_2D                  12
+#define DUR_1                   16
+
+//
+// Songs stored in songs.c, started by keypad keys MELODY_FIRST_KEY and up
+//
+#define NUM_SONGS               4
+#define MELODY_FIRST_KEY        12
+
+extern const uint8_t *const g_ppui8Songs[NUM_SONGS];
+
+extern void MelodyStart(const uint8_t *pui8Song);
+extern void MelodyStop(void);
+extern uint32_t MelodyPlaying(void);
+extern void MelodyFill(uint16_t* dacValues, uint32_t count, uint16_t midScale,
+                       uint16_t scale);
+
+#endif // __MELODY_H__
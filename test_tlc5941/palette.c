@@ -0,0 +1,154 @@
+//*****************************************************************************
+//
+// palette.c - 4-bit palette-indexed 8x8 frames and palette animation.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "palette.h"
+
+//*****************************************************************************
+//
+// PaletteFrameFill
+// Inputs:
+//   1. Palette frame
+//   2. Palette entry, 0 to 15
+// Outputs: None
+// Description:
+// Set every pixel of the frame to one entry, eight at a time.
+//
+//*****************************************************************************
+void
+PaletteFrameFill(tPaletteFrame *psFrame, uint32_t entry)
+{
+  uint32_t row, pixels;
+
+  pixels = (entry & 0xF) * 0x11111111;
+  for (row = 0; row < 8; row++)
+  {
+    psFrame->pui32Row[row] = pixels;
+  }
+}
+
+//*****************************************************************************
+//
+// PaletteFrameSet
+// Inputs:
+//   1. Palette frame
+//   2. Row, 0 to 7
+//   3. Column, 0 to 7
+//   4. Palette entry, 0 to 15
+// Outputs: None
+// Description:
+// Set one pixel of the frame.
+//
+//*****************************************************************************
+void
+PaletteFrameSet(tPaletteFrame *psFrame, uint32_t row, uint32_t col,
+                uint32_t entry)
+{
+  uint32_t shift;
+
+  shift = 4 * (col & 7);
+  psFrame->pui32Row[row & 7] = (psFrame->pui32Row[row & 7] &
+                                ~(0xFu << shift)) | ((entry & 0xF) << shift);
+}
+
+//*****************************************************************************
+//
+// PaletteSetColor
+// Inputs:
+//   1. Palette
+//   2. Palette entry, 0 to 15
+//   3. Color as 0xBBGGRR, as in the colors table
+// Outputs: None
+// Description:
+// Expand a color to 12-bit channels the way the renderers do, once, into
+// a palette entry.
+//
+//*****************************************************************************
+void
+PaletteSetColor(tPalette *psPalette, uint32_t entry, uint32_t color)
+{
+  uint16_t *rgb;
+
+  rgb = psPalette->ppui16RGB[entry & 0xF];
+  rgb[0] = (color&0xFF) << 4;
+  rgb[1] = (color&0xFF00) >> 4;
+  rgb[2] = (color&0xFF0000) >> 12;
+}
+
+//*****************************************************************************
+//
+// PaletteRotate
+// Inputs:
+//   1. Palette
+//   2. First entry of the run to rotate
+//   3. Number of entries in the run
+// Outputs: None
+// Description:
+// Move each color of the run one entry down, the first to the last, so
+// pixels drawn in entry n + 1 now show what entry n showed.
+//
+//*****************************************************************************
+void
+PaletteRotate(tPalette *psPalette, uint32_t first, uint32_t count)
+{
+  uint16_t saved[3];
+  uint32_t entry, last;
+
+  if ((count < 2) || (first + count > PALETTE_ENTRIES))
+  {
+    return;
+  }
+  last = first + count - 1;
+  saved[0] = psPalette->ppui16RGB[first][0];
+  saved[1] = psPalette->ppui16RGB[first][1];
+  saved[2] = psPalette->ppui16RGB[first][2];
+  for (entry = first; entry < last; entry++)
+  {
+    psPalette->ppui16RGB[entry][0] = psPalette->ppui16RGB[entry + 1][0];
+    psPalette->ppui16RGB[entry][1] = psPalette->ppui16RGB[entry + 1][1];
+    psPalette->ppui16RGB[entry][2] = psPalette->ppui16RGB[entry + 1][2];
+  }
+  psPalette->ppui16RGB[last][0] = saved[0];
+  psPalette->ppui16RGB[last][1] = saved[1];
+  psPalette->ppui16RGB[last][2] = saved[2];
+}
+
+//*****************************************************************************
+//
+// PaletteFade
+// Inputs:
+//   1. Palette to write
+//   2. Palette to fade from
+//   3. Level, 0 (black) to PALETTE_LEVEL_FULL (unchanged)
+// Outputs: None
+// Description:
+// Scale every entry of a palette, so the display fades without the frame
+// being touched. The source is kept at full level, so fading back up
+// loses no precision.
+//
+//*****************************************************************************
+void
+PaletteFade(tPalette *psPalette, const tPalette *psFrom, uint32_t level)
+{
+  const uint16_t *from;
+  uint16_t *to;
+  uint32_t idx;
+
+  if (level > PALETTE_LEVEL_FULL)
+  {
+    level = PALETTE_LEVEL_FULL;
+  }
+  from = &psFrom->ppui16RGB[0][0];
+  to = &psPalette->ppui16RGB[0][0];
+  for (idx = 0; idx < PALETTE_ENTRIES * 3; idx++)
+  {
+    to[idx] = (from[idx] * level) >> PALETTE_LEVEL_SHIFT;
+  }
+}
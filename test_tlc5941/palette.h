@@ -0,0 +1,63 @@
+//*****************************************************************************
+//
+// palette.h - 4-bit palette-indexed 8x8 frames and palette animation.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __PALETTE_H__
+#define __PALETTE_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// A palette frame holds a 4-bit palette index per pixel, one 32-bit word
+// per row with column c in bits 4c to 4c + 3: 32 bytes for the 8x8 display
+// against 384 for 12-bit RGB. The palette holds each entry's color already
+// expanded to 12-bit R, G and B, so rendering a pixel is one lookup and
+// three copies.
+//
+// Everything drawn in an entry changes with it: rotating a run of entries
+// cycles colors through the image, and fading a palette from another dims
+// the whole display, each for a pass over at most 16 entries and without
+// touching the pixels.
+//
+//*****************************************************************************
+#define PALETTE_ENTRIES         16
+
+//
+// Fade level, applied as (value * level) >> PALETTE_LEVEL_SHIFT
+//
+#define PALETTE_LEVEL_SHIFT     8
+#define PALETTE_LEVEL_FULL      (1 << PALETTE_LEVEL_SHIFT)
+
+#define PALETTE_PIXEL(frame, row, col)                                        \
+    (((frame)->pui32Row[row] >> (4 * (col))) & 0xF)
+
+typedef struct
+{
+    uint32_t pui32Row[8];
+}
+tPaletteFrame;
+
+typedef struct
+{
+    uint16_t ppui16RGB[PALETTE_ENTRIES][3];
+}
+tPalette;
+
+extern void PaletteFrameFill(tPaletteFrame *psFrame, uint32_t entry);
+extern void PaletteFrameSet(tPaletteFrame *psFrame, uint32_t row,
+                            uint32_t col, uint32_t entry);
+extern void PaletteSetColor(tPalette *psPalette, uint32_t entry,
+                            uint32_t color);
+extern void PaletteRotate(tPalette *psPalette, uint32_t first,
+                          uint32_t count);
+extern void PaletteFade(tPalette *psPalette, const tPalette *psFrom,
+                        uint32_t level);
+
+#endif // __PALETTE_H__
@@ -0,0 +1,131 @@
+//*****************************************************************************
+//
+// park.c - Parks the display drivers and the audio timer while nothing is
+//          lit or playing.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "console.h"
+#include "park.h"
+#include "gspack.h"
+
+//
+// SSI frames a running row sends
+//
+#ifdef GS_PACKED
+#define PARK_ROW_FRAMES         GSPACK_ROW_WORDS
+#else
+#define PARK_ROW_FRAMES         32
+#endif
+
+//*****************************************************************************
+//
+// ParkInit
+// Inputs:
+//   1. Park state
+// Outputs: None
+// Description:
+// Start running, with nothing counted.
+//
+//*****************************************************************************
+void
+ParkInit(tPark *psPark)
+{
+  psPark->bParked = false;
+  psPark->ui32DarkRows = 0;
+  psPark->ui32Parks = 0;
+  psPark->ui32Rows = 0;
+  psPark->ui32ParkedRows = 0;
+}
+
+//*****************************************************************************
+//
+// ParkRow
+// Inputs:
+//   1. Park state
+//   2. True if the row just prepared is dark and silent
+// Outputs: True if the display is to be parked or to resume after this row
+// Description:
+// Called once a row. Count the row as running or parked, then park after
+// PARK_DARK_ROWS dark rows in a row, or resume on the first that is not.
+//
+//*****************************************************************************
+bool
+ParkRow(tPark *psPark, bool dark)
+{
+  psPark->ui32Rows++;
+  if (psPark->bParked)
+  {
+    psPark->ui32ParkedRows++;
+  }
+
+  if (!dark)
+  {
+    psPark->ui32DarkRows = 0;
+    if (psPark->bParked)
+    {
+      psPark->bParked = false;
+      return true;
+    }
+    return false;
+  }
+  if (psPark->ui32DarkRows < PARK_DARK_ROWS)
+  {
+    psPark->ui32DarkRows++;
+    if (psPark->ui32DarkRows == PARK_DARK_ROWS)
+    {
+      psPark->bParked = true;
+      psPark->ui32Parks++;
+      return true;
+    }
+  }
+  return false;
+}
+
+//*****************************************************************************
+//
+// ParkPoll
+// Inputs:
+//   1. Park state
+// Outputs: None
+// Description:
+// Called from the main loop. Every PARK_REPORT_ROWS rows, a second, print
+// the interrupts, SSI words, latches and GSCLK time in it against those of
+// a display that never parks, if any row was parked. A running row takes
+// 32 PWMIntHandler interrupts, PARK_ROW_FRAMES of them sending an SSI
+// frame, and one latch, with GSCLK on throughout; a parked row takes one
+// SysTick interrupt.
+//
+//*****************************************************************************
+void
+ParkPoll(tPark *psPark)
+{
+  uint32_t running;
+
+  if (psPark->ui32Rows < PARK_REPORT_ROWS)
+  {
+    return;
+  }
+  if (psPark->ui32ParkedRows)
+  {
+    running = psPark->ui32Rows - psPark->ui32ParkedRows;
+    ConsolePrintf("park: %u/%u rows parked, %u parks; irq %u/%u, "
+                  "ssi %u/%u, xlat %u/%u, gsclk %u%%\n",
+                  psPark->ui32ParkedRows, psPark->ui32Rows,
+                  psPark->ui32Parks,
+                  32 * running + psPark->ui32ParkedRows,
+                  32 * psPark->ui32Rows, PARK_ROW_FRAMES * running,
+                  PARK_ROW_FRAMES * psPark->ui32Rows, running,
+                  psPark->ui32Rows,
+                  running * 100 / psPark->ui32Rows);
+  }
+  psPark->ui32Parks = 0;
+  psPark->ui32Rows = 0;
+  psPark->ui32ParkedRows = 0;
+}
@@ -0,0 +1,61 @@
+//*****************************************************************************
+//
+// park.h - Parks the display drivers and the audio timer while nothing is
+//          lit or playing.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __PARK_H__
+#define __PARK_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// With no key held, no stream and no sound, every row is rendered as 32
+// zero words that PWMIntHandler still shifts out, latches and lights, 16000
+// interrupts a second with GSCLK running throughout. Once PARK_DARK_ROWS
+// rows in a row have been dark, both grayscale halves and the one latched
+// are zeros and both PWM DAC halves rest at the midpoint, and the display
+// is parked:
+//   - BLANK is held high and the TLC5941s' GSCLK and SSI stream stopped
+//   - the row outputs and the row driver's ~CLR (PF4) are driven low
+//   - the PWM DAC timer's interrupt, and with it PWMIntHandler, is masked;
+//     the timer keeps driving its pin at half duty, the midpoint
+// SysTick then releases the row tasks every 2ms in place of the latch, so
+// the keypad is read at the same rate. A row that is not dark restarts
+// everything at once: the first latch follows within a row, as it would
+// have running, so a press is shown and heard no later.
+//
+// ParkRow counts the rows spent running and parked, and from them the
+// interrupts, SSI words, latches and GSCLK time, which ParkPoll reports
+// every PARK_REPORT_ROWS rows that were parked at all.
+//
+//*****************************************************************************
+#define PARK_DARK_ROWS          3
+
+//
+// Rows between reports on the console, a second
+//
+#define PARK_REPORT_ROWS        500
+
+typedef struct
+{
+    bool bParked;
+    uint32_t ui32DarkRows;          // dark rows in a row, up to the limit
+    uint32_t ui32Parks;             // times parked since the last report
+    uint32_t ui32Rows;              // rows since the last report
+    uint32_t ui32ParkedRows;        // of them, rows parked
+}
+tPark;
+
+extern void ParkInit(tPark *psPark);
+extern bool ParkRow(tPark *psPark, bool dark);
+extern void ParkPoll(tPark *psPark);
+
+#endif // __PARK_H__
@@ -0,0 +1,207 @@
+//*****************************************************************************
+//
+// power.c - LED current estimate and brightness limiter for the display.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "console.h"
+#include "power.h"
+
+//*****************************************************************************
+//
+// PowerInit
+// Inputs:
+//   1. Limiter state
+//   2. Dot correction written to every output, 0 to 63
+//   3. Budget for the current of the brightest row, mA
+//   4. Budget for the average frame current, mA
+// Outputs: None
+// Description:
+// Clear the limiter and start at full brightness.
+//
+//*****************************************************************************
+void
+PowerInit(tPowerLimiter *psPower, uint32_t dotCorrection,
+          uint32_t peakBudgetMa, uint32_t averageBudgetMa)
+{
+  uint32_t row;
+
+  psPower->ui32NanoAmpsPerCount =
+    (uint64_t)POWER_IMAX_UA * 1000 * dotCorrection / (63 * 4096);
+  psPower->ui32PeakBudgetMa = peakBudgetMa;
+  psPower->ui32AverageBudgetMa = averageBudgetMa;
+  for (row = 0; row < 8; row++)
+  {
+    psPower->pui32RowSum[row] = 0;
+  }
+  psPower->ui32FrameSum = 0;
+  psPower->ui32FrameMa = 0;
+  psPower->ui32PeakRowMa = 0;
+  psPower->ui32AverageMaQ8 = 0;
+  psPower->ui32Scale = POWER_SCALE_FULL;
+  psPower->ui32Frames = 0;
+  psPower->ui32LimitedFrames = 0;
+  psPower->ui32MaxDrawnMa = 0;
+  psPower->ui32Reported = 0;
+}
+
+//*****************************************************************************
+//
+// PowerRow
+// Inputs:
+//   1. Limiter state
+//   2. Slot in the frame of the row just rendered
+//   3. Pointer to the 32 grayscale values of the row
+// Outputs: None
+// Description:
+// Account for a newly rendered row. The 32 values are added as they are
+// declared, 16 bits at a time, into two sums of alternate values that the
+// compiler can keep apart.
+//
+//*****************************************************************************
+void
+PowerRow(tPowerLimiter *psPower, uint32_t row, const uint16_t *gsValues)
+{
+  uint32_t sum, sumOdd, idx;
+
+  sum = 0;
+  sumOdd = 0;
+  for (idx = 0; idx < 32; idx += 2)
+  {
+    sum += gsValues[idx];
+    sumOdd += gsValues[idx + 1];
+  }
+  sum += sumOdd;
+
+  psPower->ui32FrameSum += sum - psPower->pui32RowSum[row];
+  psPower->pui32RowSum[row] = sum;
+}
+
+//*****************************************************************************
+//
+// PowerFrame
+// Inputs:
+//   1. Limiter state
+// Outputs: None
+// Description:
+// Once a frame, estimate the frame and peak row current from the row sums
+// and move the brightness scale towards what both budgets allow.
+//
+//*****************************************************************************
+void
+PowerFrame(tPowerLimiter *psPower)
+{
+  uint32_t row, peakSum, target, limit, drawn;
+  int32_t delta;
+
+  peakSum = 0;
+  for (row = 0; row < 8; row++)
+  {
+    if (psPower->pui32RowSum[row] > peakSum)
+    {
+      peakSum = psPower->pui32RowSum[row];
+    }
+  }
+  psPower->ui32FrameMa = (uint64_t)psPower->ui32FrameSum *
+                         psPower->ui32NanoAmpsPerCount / (8 * 1000000);
+  psPower->ui32PeakRowMa = (uint64_t)peakSum *
+                           psPower->ui32NanoAmpsPerCount / 1000000;
+
+  delta = (int32_t)(psPower->ui32FrameMa << 8) -
+          (int32_t)psPower->ui32AverageMaQ8;
+  psPower->ui32AverageMaQ8 += delta >> POWER_AVERAGE_SHIFT;
+
+  //
+  // Brightness each budget allows, the lower of the two
+  //
+  target = POWER_SCALE_FULL;
+  if (psPower->ui32PeakRowMa > psPower->ui32PeakBudgetMa)
+  {
+    target = (psPower->ui32PeakBudgetMa << POWER_SCALE_SHIFT) /
+             psPower->ui32PeakRowMa;
+  }
+  if (psPower->ui32AverageMaQ8 > (psPower->ui32AverageBudgetMa << 8))
+  {
+    limit = (psPower->ui32AverageBudgetMa << (POWER_SCALE_SHIFT + 8)) /
+            psPower->ui32AverageMaQ8;
+    if (limit < target)
+    {
+      target = limit;
+    }
+  }
+
+  if (target < psPower->ui32Scale)
+  {
+    psPower->ui32Scale = target;
+  }
+  else
+  {
+    psPower->ui32Scale += (target - psPower->ui32Scale + 15) >> 4;
+  }
+
+  psPower->ui32Frames++;
+  if (psPower->ui32Scale < POWER_SCALE_FULL)
+  {
+    psPower->ui32LimitedFrames++;
+  }
+  drawn = PowerDrawnMa(psPower);
+  if (drawn > psPower->ui32MaxDrawnMa)
+  {
+    psPower->ui32MaxDrawnMa = drawn;
+  }
+}
+
+//*****************************************************************************
+//
+// PowerDrawnMa
+// Inputs:
+//   1. Limiter state
+// Outputs: Estimated mean current of the last frame after scaling, mA
+// Description:
+// What the last frame draws from the supply, with the brightness scale it
+// is shown at.
+//
+//*****************************************************************************
+uint32_t
+PowerDrawnMa(const tPowerLimiter *psPower)
+{
+  return (psPower->ui32FrameMa * psPower->ui32Scale) >> POWER_SCALE_SHIFT;
+}
+
+//*****************************************************************************
+//
+// PowerPoll
+// Inputs:
+//   1. Limiter state
+// Outputs: None
+// Description:
+// Called from the main loop. Every POWER_REPORT_FRAMES frames in which the
+// display drew any current, print the current estimates and brightness.
+//
+//*****************************************************************************
+void
+PowerPoll(tPowerLimiter *psPower)
+{
+  if (psPower->ui32Frames - psPower->ui32Reported < POWER_REPORT_FRAMES)
+  {
+    return;
+  }
+  psPower->ui32Reported = psPower->ui32Frames;
+  if (psPower->ui32MaxDrawnMa == 0)
+  {
+    return;
+  }
+  ConsolePrintf("power: %u mA, drawn %u, max %u, peak row %u, avg %u, "
+                "scale %u%%, limited %u/%u\n",
+                psPower->ui32FrameMa, PowerDrawnMa(psPower),
+                psPower->ui32MaxDrawnMa, psPower->ui32PeakRowMa,
+                psPower->ui32AverageMaQ8 >> 8,
+                (psPower->ui32Scale * 100) >> POWER_SCALE_SHIFT,
+                psPower->ui32LimitedFrames, psPower->ui32Frames);
+  psPower->ui32MaxDrawnMa = 0;
+}
@@ -0,0 +1,93 @@
+//*****************************************************************************
+//
+// power.h - LED current estimate and brightness limiter for the display.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __POWER_H__
+#define __POWER_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// A TLC5941 output sinks Imax * DC/63 * GS/4096 while its row is lit, Imax
+// being set by the IREF resistor. Only one row is lit at a time, so the
+// supply carries the current of one row at a time and, averaged over a
+// frame, the mean of the eight rows.
+//
+// PowerRow sums each row's grayscale values as it is rendered and updates
+// the frame total by the change from the last sum in that row's slot of the
+// frame, so nothing is rescanned. The scan plan (scan.h) may light a row in
+// several slots, or none, so the sums are kept per slot. PowerFrame turns
+// the totals into mA once a frame and sets the brightness scale that
+// PWMIntHandler applies to every grayscale value on its way to the TLC5941:
+//   - the brightest row may draw at most the peak budget, limiting the
+//     supply current; the scale drops at once to meet it
+//   - the frame current before scaling, averaged over about a second at
+//     62.5 frames per second, sets a scale that brings it down to the
+//     average budget, limiting LED and driver heating
+// Once within both budgets the scale recovers by 1/16 of the way each
+// frame, so brightness fades back in rather than jumping.
+//
+//*****************************************************************************
+
+//
+// Imax with the 640 ohm IREF resistor: 31.5 * 1.24V / 640 = 61mA
+//
+#define POWER_IMAX_UA           61000
+
+#ifndef POWER_PEAK_BUDGET_MA
+#define POWER_PEAK_BUDGET_MA    150
+#endif
+#ifndef POWER_AVERAGE_BUDGET_MA
+#define POWER_AVERAGE_BUDGET_MA 100
+#endif
+
+//
+// Brightness scale, applied as (gs * scale) >> POWER_SCALE_SHIFT
+//
+#define POWER_SCALE_SHIFT       12
+#define POWER_SCALE_FULL        (1 << POWER_SCALE_SHIFT)
+
+//
+// The average follows each frame by 1/2^POWER_AVERAGE_SHIFT, 64 frames
+//
+#define POWER_AVERAGE_SHIFT     6
+
+//
+// Frames between reports on the console
+//
+#define POWER_REPORT_FRAMES     64
+
+typedef struct
+{
+    uint32_t ui32NanoAmpsPerCount;  // current of one grayscale count
+    uint32_t ui32PeakBudgetMa;
+    uint32_t ui32AverageBudgetMa;
+    uint32_t pui32RowSum[8];        // grayscale sum of each row slot
+    uint32_t ui32FrameSum;          // sum of pui32RowSum
+    uint32_t ui32FrameMa;           // last frame's mean, before scaling
+    uint32_t ui32PeakRowMa;         // last frame's brightest row
+    uint32_t ui32AverageMaQ8;       // running average frame current, Q8
+    volatile uint32_t ui32Scale;    // brightness, POWER_SCALE_FULL is 1
+    uint32_t ui32Frames;
+    uint32_t ui32LimitedFrames;     // frames shown below full brightness
+    uint32_t ui32MaxDrawnMa;        // most drawn since the last report
+    uint32_t ui32Reported;          // ui32Frames at the last report
+}
+tPowerLimiter;
+
+extern void PowerInit(tPowerLimiter *psPower, uint32_t dotCorrection,
+                      uint32_t peakBudgetMa, uint32_t averageBudgetMa);
+extern void PowerRow(tPowerLimiter *psPower, uint32_t row,
+                     const uint16_t *gsValues);
+extern void PowerFrame(tPowerLimiter *psPower);
+extern uint32_t PowerDrawnMa(const tPowerLimiter *psPower);
+extern void PowerPoll(tPowerLimiter *psPower);
+
+#endif // __POWER_H__
@@ -0,0 +1,279 @@
+//*****************************************************************************
+//
+// scan.c - Row scan plan that gives the row slots of a frame to lit rows.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "scan.h"
+
+//*****************************************************************************
+//
+// ScanInit
+// Inputs:
+//   1. Scan state
+//   2. True to plan frames from the lit rows, false for the plain scan
+// Outputs: None
+// Description:
+// Start with the plain scan, on its first slot, at the gain of the plain
+// scan.
+//
+//*****************************************************************************
+void
+ScanInit(tRowScan *psScan, bool adaptive)
+{
+  uint32_t slot;
+
+  psScan->ui8Adaptive = adaptive;
+  psScan->ui8LitMask = 0;
+  for (slot = 0; slot < SCAN_SLOTS; slot++)
+  {
+    psScan->pui8Plan[slot] = slot;
+  }
+  psScan->ui8Slot = 0;
+  psScan->ui8LitRows = 0;
+  psScan->ui8RowSlots = 1;
+  psScan->ui8Probe = 0;
+  psScan->ui8Unprobed = 0;
+  psScan->ui32Gain = SCAN_SCALE_FULL;
+  psScan->ui32Scale = SCAN_SCALE_FULL;
+}
+
+//*****************************************************************************
+//
+// ScanPlan
+// Inputs:
+//   1. Scan state
+// Outputs: None
+// Description:
+// Plan the frame that is starting: the lit rows in order, as many times
+// over as fit, then dark rows in the slots left. The dark rows not in the
+// plan are left to probe. Then move the gain towards the slots per row.
+//
+//*****************************************************************************
+static void
+ScanPlan(tRowScan *psScan)
+{
+  uint32_t lit, count, rowSlots, slot, pass, row, target, planned;
+
+  lit = psScan->ui8Adaptive ? psScan->ui8LitMask : 0;
+  for (count = 0, row = lit; row; row &= row - 1)
+  {
+    count++;
+  }
+
+  if ((count == 0) || (count == 8))
+  {
+    for (slot = 0; slot < SCAN_SLOTS; slot++)
+    {
+      psScan->pui8Plan[slot] = slot;
+    }
+    rowSlots = 1;
+    planned = 0xFF;
+  }
+  else
+  {
+    rowSlots = SCAN_SLOTS / count;
+    planned = lit;
+    slot = 0;
+    for (pass = 0; pass < rowSlots; pass++)
+    {
+      for (row = 0; row < 8; row++)
+      {
+        if (lit & (1 << row))
+        {
+          psScan->pui8Plan[slot++] = row;
+        }
+      }
+    }
+    row = psScan->ui8Probe;
+    while (slot < SCAN_SLOTS)
+    {
+      while (lit & (1 << row))
+      {
+        row = (row + 1) & 7;
+      }
+      psScan->pui8Plan[slot++] = row;
+      planned |= 1 << row;
+      row = (row + 1) & 7;
+    }
+    psScan->ui8Probe = row;
+  }
+  psScan->ui8Unprobed = ~planned & 0xFF;
+  psScan->ui8LitRows = count;
+  psScan->ui8RowSlots = rowSlots;
+
+  //
+  // Nothing lit, nothing to keep even: the gain stays for when rows light
+  // up again
+  //
+  if (count == 0)
+  {
+    psScan->ui32Scale = SCAN_SCALE_FULL;
+    return;
+  }
+  target = ((rowSlots < SCAN_MAX_GAIN) ? rowSlots : SCAN_MAX_GAIN) <<
+           SCAN_SCALE_SHIFT;
+  if (psScan->ui32Gain > (rowSlots << SCAN_SCALE_SHIFT))
+  {
+    psScan->ui32Gain = rowSlots << SCAN_SCALE_SHIFT;
+  }
+  else if (target > psScan->ui32Gain)
+  {
+    psScan->ui32Gain += (target - psScan->ui32Gain + 31) >> 5;
+  }
+  else
+  {
+    psScan->ui32Gain -= (psScan->ui32Gain - target + 7) >> 3;
+  }
+  psScan->ui32Scale = psScan->ui32Gain / rowSlots;
+}
+
+//*****************************************************************************
+//
+// ScanNext
+// Inputs:
+//   1. Scan state
+// Outputs: LED row to render for the next slot
+// Description:
+// Advance to the next slot, planning a new frame at its first slot.
+//
+//*****************************************************************************
+uint32_t
+ScanNext(tRowScan *psScan)
+{
+  psScan->ui8Slot = (psScan->ui8Slot + 1 >= SCAN_SLOTS) ? 0 :
+                                                          psScan->ui8Slot + 1;
+  if (psScan->ui8Slot == 0)
+  {
+    ScanPlan(psScan);
+  }
+  return psScan->pui8Plan[psScan->ui8Slot];
+}
+
+//*****************************************************************************
+//
+// ScanSlot
+// Inputs:
+//   1. Scan state
+// Outputs: Slot in the frame of the row being rendered, 0 starts a frame
+// Description:
+// For the frame tasks, released at the last slot, and for accounting per
+// slot.
+//
+//*****************************************************************************
+uint32_t
+ScanSlot(const tRowScan *psScan)
+{
+  return psScan->ui8Slot;
+}
+
+//*****************************************************************************
+//
+// ScanLit
+// Inputs:
+//   1. Pointer to the 32 grayscale values of a row
+// Outputs: True if any LED of the row is lit
+// Description:
+// The values are ORed together as they are declared, 16 bits at a time.
+//
+//*****************************************************************************
+static bool
+ScanLit(const uint16_t *gsValues)
+{
+  uint32_t lit, idx;
+
+  lit = 0;
+  for (idx = 0; idx < 32; idx++)
+  {
+    lit |= gsValues[idx];
+  }
+  return lit != 0;
+}
+
+//*****************************************************************************
+//
+// ScanRow
+// Inputs:
+//   1. Scan state
+//   2. LED row just rendered
+//   3. Pointer to the 32 grayscale values of the row
+// Outputs: None
+// Description:
+// Note whether a newly rendered row is lit, for the next frame's plan, and
+// scale it for the slots it has.
+//
+//*****************************************************************************
+void
+ScanRow(tRowScan *psScan, uint32_t row, uint16_t *gsValues)
+{
+  uint32_t idx;
+
+  if (!ScanLit(gsValues))
+  {
+    psScan->ui8LitMask &= ~(1 << row);
+    return;
+  }
+  psScan->ui8LitMask |= 1 << row;
+
+  if (psScan->ui32Scale < SCAN_SCALE_FULL)
+  {
+    for (idx = 0; idx < 32; idx++)
+    {
+      gsValues[idx] = (gsValues[idx] * psScan->ui32Scale) >> SCAN_SCALE_SHIFT;
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// ScanNextProbe
+// Inputs:
+//   1. Scan state
+// Outputs: Dark row to probe, or SCAN_NO_ROW once all have been this frame
+// Description:
+// Called once a slot, after the slot's row is rendered. Rows are probed
+// from row 0 up, each once a frame.
+//
+//*****************************************************************************
+uint32_t
+ScanNextProbe(tRowScan *psScan)
+{
+  uint32_t row;
+
+  if (!psScan->ui8Unprobed)
+  {
+    return SCAN_NO_ROW;
+  }
+  for (row = 0; !(psScan->ui8Unprobed & (1 << row)); row++)
+  {
+  }
+  psScan->ui8Unprobed &= ~(1 << row);
+  return row;
+}
+
+//*****************************************************************************
+//
+// ScanProbe
+// Inputs:
+//   1. Scan state
+//   2. Dark row from ScanNextProbe
+//   3. Pointer to the 32 grayscale values it rendered to, not shown
+// Outputs: None
+// Description:
+// Note whether a dark row has lit up, for the next frame's plan.
+//
+//*****************************************************************************
+void
+ScanProbe(tRowScan *psScan, uint32_t row, const uint16_t *gsValues)
+{
+  if (ScanLit(gsValues))
+  {
+    psScan->ui8LitMask |= 1 << row;
+  }
+}
@@ -0,0 +1,91 @@
+//*****************************************************************************
+//
+// scan.h - Row scan plan that gives the row slots of a frame to lit rows.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __SCAN_H__
+#define __SCAN_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// A frame is SCAN_SLOTS grayscale cycles of 2ms, each lighting one LED row.
+// A plain scan lights rows 0 to 7 in turn, so each row is lit 1/8 of the
+// time at 62.5Hz however many rows are dark.
+//
+// The adaptive plan is made as each frame starts, from the rows that were
+// lit when they were last rendered. With n of them lit, each lit row gets
+// SCAN_SLOTS / n slots, interleaved, and any slots left over show dark rows
+// in turn. A row's refresh rate and duty rise with its slots. With no row
+// lit, or every row, the plan is the plain scan. Frames stay SCAN_SLOTS
+// slots, so everything timed in frames keeps its timing.
+//
+// Dark rows left out of the plan are probed off screen: each slot, one of
+// them is rendered into a spare buffer and only checked for light
+// (ScanNextProbe, ScanProbe). There are fewer of them than slots, so all
+// are probed every frame, and a row lighting up is in the next frame's
+// plan: it shows within two frames, 32ms, however few rows are lit.
+//
+// The duty gain is taken back by scaling the grayscale values of lit rows
+// by gain / slots, where gain, the brightness relative to the plain scan,
+// follows the slots per row up to SCAN_MAX_GAIN. It rises by 1/32 of the
+// way each frame and falls by 1/8, but it cannot stay above the slots per
+// row, so when they fall below it, as dark rows light up, the gain drops
+// at once.
+//
+// SCAN_MAX_GAIN is 1, so the extra slots buy refresh rate, not brightness:
+// every lit row shows as bright as in the plain scan however many rows are
+// lit, and lighting or darkening a row changes no other row's brightness.
+// A larger gain brightens sparse content, but then the brightness follows
+// the number of lit rows, and a row lighting up can dim the others by as
+// much as the gain in a single frame.
+//
+//*****************************************************************************
+#define SCAN_SLOTS              8
+
+#ifndef SCAN_MAX_GAIN
+#define SCAN_MAX_GAIN           1
+#endif
+
+//
+// ScanNextProbe when every dark row has been probed this frame
+//
+#define SCAN_NO_ROW             8
+
+//
+// Gain and grayscale scale, applied as (gs * scale) >> SCAN_SCALE_SHIFT
+//
+#define SCAN_SCALE_SHIFT        12
+#define SCAN_SCALE_FULL         (1 << SCAN_SCALE_SHIFT)
+
+typedef struct
+{
+    uint8_t ui8Adaptive;
+    uint8_t ui8LitMask;             // rows lit when last rendered
+    uint8_t pui8Plan[SCAN_SLOTS];   // row lit in each slot of this frame
+    uint8_t ui8Slot;                // slot being rendered
+    uint8_t ui8LitRows;             // lit rows in this frame's plan
+    uint8_t ui8RowSlots;            // slots of each of them
+    uint8_t ui8Probe;               // dark row to show next in a spare slot
+    uint8_t ui8Unprobed;            // dark rows not yet rendered this frame
+    uint32_t ui32Gain;              // SCAN_SCALE_FULL is the plain scan
+    uint32_t ui32Scale;             // of lit rows' grayscale values
+}
+tRowScan;
+
+extern void ScanInit(tRowScan *psScan, bool adaptive);
+extern uint32_t ScanNext(tRowScan *psScan);
+extern uint32_t ScanSlot(const tRowScan *psScan);
+extern void ScanRow(tRowScan *psScan, uint32_t row, uint16_t *gsValues);
+extern uint32_t ScanNextProbe(tRowScan *psScan);
+extern void ScanProbe(tRowScan *psScan, uint32_t row,
+                      const uint16_t *gsValues);
+
+#endif // __SCAN_H__
@@ -0,0 +1,278 @@
+//*****************************************************************************
+//
+// sched.c - Cooperative run-to-completion task scheduler.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// The task table belongs to the caller and is searched in full on every
+// pick; with a handful of tasks that is cheaper than keeping a queue.
+// Released tasks are picked by priority, ties going to the earlier entry.
+//
+// Runs are timed with the DWT cycle counter, which wraps every 107s, longer
+// than any task.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "console.h"
+#include "dwt.h"
+#include "sched.h"
+
+//*****************************************************************************
+//
+// Globals
+//
+//*****************************************************************************
+static tSchedTask *g_psSchedTasks;
+static uint32_t g_ui32SchedNumTasks;
+
+// Next idle task to run
+static uint32_t g_ui32SchedIdle;
+
+//*****************************************************************************
+//
+// SchedInit
+// Inputs:
+//   1. Task table
+//   2. Number of tasks
+// Outputs: None
+// Description:
+// Clear the run state of every task and start the cycle counter.
+//
+//*****************************************************************************
+void
+SchedInit(tSchedTask *psTasks, uint32_t ui32NumTasks)
+{
+  tSchedTask *psTask;
+  uint32_t idx;
+
+  for (idx = 0; idx < ui32NumTasks; idx++)
+  {
+    psTask = &psTasks[idx];
+    psTask->ui16Countdown = psTask->ui16Period;
+    psTask->ui8Released = 0;
+    psTask->ui32Runs = 0;
+    psTask->ui32Overruns = 0;
+    psTask->ui32Missed = 0;
+    psTask->ui32MaxCycles = 0;
+    psTask->ui32TotalCycles = 0;
+    psTask->ui32PeakCycles = 0;
+  }
+  g_psSchedTasks = psTasks;
+  g_ui32SchedNumTasks = ui32NumTasks;
+  g_ui32SchedIdle = 0;
+
+  DWTStart();
+}
+
+//*****************************************************************************
+//
+// SchedRelease
+// Inputs:
+//   1. True when the row rendered from this row boundary ends a frame
+// Outputs: None
+// Description:
+// Release the tasks triggered by a row boundary. Called from the main loop
+// when PWMIntHandler flags a new grayscale cycle. Frame tasks are released
+// with the last row of a frame so that, below the row tasks in priority,
+// they still prepare the next frame before its first row.
+//
+//*****************************************************************************
+void
+SchedRelease(bool bFrameEnd)
+{
+  tSchedTask *psTask;
+  uint32_t idx;
+  bool release;
+
+  for (idx = 0; idx < g_ui32SchedNumTasks; idx++)
+  {
+    psTask = &g_psSchedTasks[idx];
+    switch (psTask->ui8Trigger)
+    {
+      case SCHED_ROW:
+        release = true;
+        break;
+      case SCHED_FRAME:
+        release = bFrameEnd;
+        break;
+      case SCHED_PERIOD:
+        release = (psTask->ui16Countdown <= 1);
+        psTask->ui16Countdown = release ? psTask->ui16Period :
+                                          psTask->ui16Countdown - 1;
+        break;
+      default:
+        release = false;
+        break;
+    }
+    if (release)
+    {
+      if (psTask->ui8Released)
+      {
+        psTask->ui32Missed++;
+      }
+      psTask->ui8Released = 1;
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// SchedRunTask
+// Inputs:
+//   1. Task
+// Outputs: None
+// Description:
+// Run a task and account for the cycles it took.
+//
+//*****************************************************************************
+static void
+SchedRunTask(tSchedTask *psTask)
+{
+  uint32_t start, cycles;
+
+  psTask->ui8Released = 0;
+  start = DWTCycles();
+  psTask->pfnRun();
+  cycles = DWTCycles() - start;
+
+  psTask->ui32Runs++;
+  psTask->ui32TotalCycles += cycles;
+  if (cycles > psTask->ui32MaxCycles)
+  {
+    psTask->ui32MaxCycles = cycles;
+  }
+  if (cycles > psTask->ui32PeakCycles)
+  {
+    psTask->ui32PeakCycles = cycles;
+  }
+  if (psTask->ui32Budget && (cycles > psTask->ui32Budget))
+  {
+    psTask->ui32Overruns++;
+  }
+}
+
+//*****************************************************************************
+//
+// SchedRunNext
+// Inputs: None
+// Outputs: True if a released task ran, false if only idle work was left
+// Description:
+// Run the released task of highest priority, or else the next idle task.
+// The main loop calls this repeatedly, releasing tasks in between, so a new
+// row boundary is seen after every task.
+//
+//*****************************************************************************
+bool
+SchedRunNext(void)
+{
+  tSchedTask *psTask, *psBest;
+  uint32_t idx;
+
+  psBest = 0;
+  for (idx = 0; idx < g_ui32SchedNumTasks; idx++)
+  {
+    psTask = &g_psSchedTasks[idx];
+    if (psTask->ui8Released &&
+        (!psBest || (psTask->ui8Priority < psBest->ui8Priority)))
+    {
+      psBest = psTask;
+    }
+  }
+  if (psBest)
+  {
+    SchedRunTask(psBest);
+    return true;
+  }
+
+  for (idx = 0; idx < g_ui32SchedNumTasks; idx++)
+  {
+    psTask = &g_psSchedTasks[g_ui32SchedIdle];
+    g_ui32SchedIdle = (g_ui32SchedIdle + 1 >= g_ui32SchedNumTasks) ?
+                      0 : g_ui32SchedIdle + 1;
+    if (psTask->ui8Trigger == SCHED_IDLE)
+    {
+      SchedRunTask(psTask);
+      break;
+    }
+  }
+  return false;
+}
+
+//*****************************************************************************
+//
+// SchedSetPeriod
+// Inputs:
+//   1. Task
+//   2. Period in rows, 1 or more
+// Outputs: None
+// Description:
+// Change the period of a SCHED_PERIOD task. Takes effect from its next
+// release, so a task can set its own period while it runs.
+//
+//*****************************************************************************
+void
+SchedSetPeriod(tSchedTask *psTask, uint32_t ui32Rows)
+{
+  psTask->ui16Period = ui32Rows ? ui32Rows : 1;
+  if (!psTask->ui8Released)
+  {
+    psTask->ui16Countdown = psTask->ui16Period;
+  }
+}
+
+//*****************************************************************************
+//
+// SchedFaults
+// Inputs: None
+// Outputs: Total of overruns and missed deadlines of all tasks
+// Description:
+// Lets the caller notice new faults without walking the task table.
+//
+//*****************************************************************************
+uint32_t
+SchedFaults(void)
+{
+  uint32_t idx, faults;
+
+  faults = 0;
+  for (idx = 0; idx < g_ui32SchedNumTasks; idx++)
+  {
+    faults += g_psSchedTasks[idx].ui32Overruns +
+              g_psSchedTasks[idx].ui32Missed;
+  }
+  return faults;
+}
+
+//*****************************************************************************
+//
+// SchedReport
+// Inputs: None
+// Outputs: None
+// Description:
+// Print the run count, longest run, budget, overruns and missed deadlines
+// of every task.
+//
+//*****************************************************************************
+void
+SchedReport(void)
+{
+  tSchedTask *psTask;
+  uint32_t idx;
+
+  ConsolePrintf("   runs   max cyc  budget overrun missed task\n");
+  for (idx = 0; idx < g_ui32SchedNumTasks; idx++)
+  {
+    psTask = &g_psSchedTasks[idx];
+    ConsolePrintf("%7u %9u %7u %7u %6u %s\n", psTask->ui32Runs,
+               psTask->ui32MaxCycles, psTask->ui32Budget,
+               psTask->ui32Overruns, psTask->ui32Missed, psTask->pcName);
+  }
+}
@@ -0,0 +1,65 @@
+//*****************************************************************************
+//
+// sched.h - Cooperative run-to-completion task scheduler.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Tasks are released by the 2ms row boundary and run from the main loop, one
+// at a time and each to completion, highest priority (lowest number) first.
+// A released task must finish before its next release, so a row task has
+// until the next row boundary. Idle tasks are never released; they run one
+// at a time in turn whenever no released task is waiting.
+//
+// Each run is timed with the Cortex-M4 cycle counter. A run longer than the
+// task's budget counts as an overrun; a task still waiting when it is
+// released again counts as a missed deadline.
+//
+//*****************************************************************************
+#define SCHED_ROW               0   // every row boundary
+#define SCHED_FRAME             1   // at the row boundary of a frame's last row
+#define SCHED_PERIOD            2   // every ui16Period row boundaries
+#define SCHED_IDLE              3   // when nothing else is waiting
+
+typedef struct
+{
+    const char *pcName;
+    void (*pfnRun)(void);
+    uint8_t ui8Trigger;         // SCHED_ROW etc.
+    uint8_t ui8Priority;        // 0 runs first
+    uint16_t ui16Period;        // rows, for SCHED_PERIOD
+    uint32_t ui32Budget;        // cycles per run, 0 for no limit
+
+    //
+    // Run state and accounting, cleared by SchedInit
+    //
+    uint16_t ui16Countdown;
+    uint8_t ui8Released;
+    uint32_t ui32Runs;
+    uint32_t ui32Overruns;
+    uint32_t ui32Missed;
+    uint32_t ui32MaxCycles;
+    uint32_t ui32TotalCycles;   // wraps; differences give mean run times
+    uint32_t ui32PeakCycles;    // longest run since a reader cleared it
+}
+tSchedTask;
+
+extern void SchedInit(tSchedTask *psTasks, uint32_t ui32NumTasks);
+extern void SchedRelease(bool bFrameEnd);
+extern bool SchedRunNext(void);
+extern void SchedSetPeriod(tSchedTask *psTask, uint32_t ui32Rows);
+extern uint32_t SchedFaults(void);
+extern void SchedReport(void);
+
+#endif // __SCHED_H__
@@ -0,0 +1,90 @@
+//*****************************************************************************
+//
+// simd.h - Cortex-M4 packed 16-bit arithmetic used by the render kernels.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Each macro is one Cortex-M4 DSP instruction working on two 16-bit or four
+// 8-bit lanes of a 32-bit word. The TI compiler provides them as
+// intrinsics; other compilers get the C definitions below, which give the
+// same results but not the same speed.
+//
+//   SIMD_UQADD16(a, b)    lanes a + b, unsigned, saturated to 65535
+//   SIMD_SMUAD(a, b)      a.lo * b.lo + a.hi * b.hi, signed lanes
+//   SIMD_SMULWB(a, b)     (a * b.lo) >> 16, b.lo signed
+//   SIMD_SMULWT(a, b)     (a * b.hi) >> 16, b.hi signed
+//   SIMD_PKHBT(a, b)      a.lo in the low lane, b.hi in the high lane
+//   SIMD_PKHTB(a, b)      b.lo in the low lane, a.hi in the high lane
+//   SIMD_UHADD8(a, b)     byte lanes (a + b) / 2, unsigned, rounded down
+//   SIMD_UQSUB8(a, b)     byte lanes a - b, unsigned, saturated to 0
+//
+//*****************************************************************************
+#ifdef __TI_ARM__
+
+#define SIMD_UQADD16(a, b)      _uqadd16((a), (b))
+#define SIMD_SMUAD(a, b)        _smuad((a), (b))
+#define SIMD_SMULWB(a, b)       _smulwb((a), (b))
+#define SIMD_SMULWT(a, b)       _smulwt((a), (b))
+#define SIMD_PKHBT(a, b)        _pkhbt((a), (b), 0)
+#define SIMD_PKHTB(a, b)        _pkhtb((a), (b), 0)
+#define SIMD_UHADD8(a, b)       _uhadd8((a), (b))
+#define SIMD_UQSUB8(a, b)       _uqsub8((a), (b))
+
+#else
+
+static inline uint32_t
+SimdUSat16(uint32_t ui32Value)
+{
+    return((ui32Value > 65535) ? 65535 : ui32Value);
+}
+
+//
+// Byte lanes a - b without borrows between them, then zeroed where the
+// lane borrowed
+//
+static inline uint32_t
+SimdUQSub8(uint32_t a, uint32_t b)
+{
+    uint32_t ui32Diff, ui32Borrow;
+
+    ui32Diff = ((a | 0x80808080) - (b & 0x7F7F7F7F)) ^
+               ((a ^ ~b) & 0x80808080);
+    ui32Borrow = ((~a & b) | (~(a ^ b) & ui32Diff)) & 0x80808080;
+    return(ui32Diff & ~((ui32Borrow >> 7) * 0xFF));
+}
+
+#define SIMD_LO(a)              ((int32_t)(int16_t)((a) & 0xFFFF))
+#define SIMD_HI(a)              ((int32_t)(int16_t)((uint32_t)(a) >> 16))
+
+#define SIMD_UQADD16(a, b)                                                    \
+    (SimdUSat16(((a) & 0xFFFF) + ((b) & 0xFFFF)) |                            \
+     (SimdUSat16(((uint32_t)(a) >> 16) + ((uint32_t)(b) >> 16)) << 16))
+#define SIMD_SMUAD(a, b)                                                      \
+    (SIMD_LO(a) * SIMD_LO(b) + SIMD_HI(a) * SIMD_HI(b))
+#define SIMD_SMULWB(a, b)                                                     \
+    ((int32_t)(((int64_t)(int32_t)(a) * SIMD_LO(b)) >> 16))
+#define SIMD_SMULWT(a, b)                                                     \
+    ((int32_t)(((int64_t)(int32_t)(a) * SIMD_HI(b)) >> 16))
+#define SIMD_PKHBT(a, b)                                                      \
+    (((uint32_t)(a) & 0x0000FFFF) | ((uint32_t)(b) & 0xFFFF0000))
+#define SIMD_PKHTB(a, b)                                                      \
+    (((uint32_t)(a) & 0xFFFF0000) | ((uint32_t)(b) & 0x0000FFFF))
+#define SIMD_UHADD8(a, b)                                                     \
+    (((uint32_t)(a) & (uint32_t)(b)) +                                        \
+     ((((uint32_t)(a) ^ (uint32_t)(b)) >> 1) & 0x7F7F7F7F))
+#define SIMD_UQSUB8(a, b)       SimdUQSub8((a), (b))
+
+#endif
+
+#endif // __SIMD_H__
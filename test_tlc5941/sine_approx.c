@@ -14,6 +14,19 @@
 // to 65535. The output is scaled so that full scale runs from Y1 to Y2, where
 // Y1 is 10% and Y2 is 90% of the counts in the PWM waveform.
 //
+// The approximation kernel is chosen at build time by defining
+// SINE_APPROX_KERNEL to one of the SINE_KERNEL_ values below. All kernels
+// return round(scale * sin(2*pi*phase/65536)) to within the error listed.
+// Errors are in LSB of a Q15 full scale; cycles are Cortex-M4 estimates from
+// host/sine_study.
+//
+//   Kernel                  Flash   Max err  RMS err  SFDR     Cycles
+//   SINE_KERNEL_TAB32       130 B   11.1     2.75     92.7 dB  43
+//   SINE_KERNEL_TAB256      132 B   4.1      2.05     102.6 dB 46
+//   SINE_KERNEL_TAB1024     516 B   2.0      0.98     102.6 dB 46
+//   SINE_KERNEL_PARABOLIC   0 B     37.6     19.4     63.6 dB  46
+//   SINE_KERNEL_CORDIC      64 B    5.7      1.21     99.8 dB  282
+//
 //*****************************************************************************
 
 #include <stdint.h>
@@ -21,14 +34,31 @@
 #include "driverlib/debug.h"
 #include "driverlib/fpu.h"
 
+//*****************************************************************************
+//
+// Kernel selection
+//
+//*****************************************************************************
+#define SINE_KERNEL_TAB32       0
+#define SINE_KERNEL_TAB256      1
+#define SINE_KERNEL_TAB1024     2
+#define SINE_KERNEL_PARABOLIC   3
+#define SINE_KERNEL_CORDIC      4
+
+#ifndef SINE_APPROX_KERNEL
+#define SINE_APPROX_KERNEL SINE_KERNEL_TAB32
+#endif
+
 //*****************************************************************************
 //
 // Initialized data
 //
 //*****************************************************************************
 
+#if SINE_APPROX_KERNEL == SINE_KERNEL_TAB32
+
 // Sine wave table with full scale = pi * 2^13
-static int16_t sinTab[32] = {
+static const int16_t sinTab[32] = {
   0, 5021, 9849, 14298, 18198, 21399, 23777, 25241,
   25736, 25241, 23777, 21399, 18198, 14298, 9849, 5021,
   0, -5021, -9849, -14298, -18198, -21399, -23777, -25241,
@@ -36,7 +66,7 @@ static int16_t sinTab[32] = {
 };
 
 // Table of 2^17/pi * cos(x), x = (-16, ..., 16) * 2*pi/1024
-static uint16_t resCosTab[33] = {
+static const uint16_t resCosTab[33] = {
   41521, 41545, 41568, 41589, 41608, 41627, 41643, 41658,
   41671, 41683, 41693, 41702, 41709, 41714, 41718, 41721,
   41722, 41721, 41718, 41714, 41709, 41702, 41693, 41683,
@@ -61,3 +91,206 @@ int32_t SineApprox(uint16_t phase, uint16_t scale)
   sinVal = (sinQ * dcos + cosQ * resQ + 16384) >> 15;
   return((sinVal * scale + 16384) >> 15);
 }
+
+#define SINE_TABLE_BYTES (sizeof(sinTab) + sizeof(resCosTab))
+
+#elif (SINE_APPROX_KERNEL == SINE_KERNEL_TAB256) || \
+      (SINE_APPROX_KERNEL == SINE_KERNEL_TAB1024)
+
+//
+// Quarter wave of 32767 * sin(x), x = (0, ..., N/4) * 2*pi/N, plus one guard
+// entry so the interpolation at the quarter point may read past it.
+//
+#if SINE_APPROX_KERNEL == SINE_KERNEL_TAB256
+#define QTAB_SHIFT 8
+static const int16_t quarterSinTab[64 + 2] = {
+      0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+   6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+  12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+  18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+  23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+  27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+  30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+  32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+  32767, 32757
+};
+#else
+#define QTAB_SHIFT 6
+static const int16_t quarterSinTab[256 + 2] = {
+      0,   201,   402,   603,   804,  1005,  1206,  1407,
+   1608,  1809,  2009,  2210,  2410,  2611,  2811,  3012,
+   3212,  3412,  3612,  3811,  4011,  4210,  4410,  4609,
+   4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,
+   6393,  6590,  6786,  6983,  7179,  7375,  7571,  7767,
+   7962,  8157,  8351,  8545,  8739,  8933,  9126,  9319,
+   9512,  9704,  9896, 10087, 10278, 10469, 10659, 10849,
+  11039, 11228, 11417, 11605, 11793, 11980, 12167, 12353,
+  12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828,
+  14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+  15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673,
+  16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+  18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357,
+  19519, 19680, 19841, 20000, 20159, 20317, 20475, 20631,
+  20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856,
+  22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027,
+  23170, 23311, 23452, 23592, 23731, 23870, 24007, 24143,
+  24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+  25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198,
+  26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133,
+  27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001,
+  28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803,
+  28898, 28992, 29085, 29177, 29268, 29358, 29447, 29534,
+  29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+  30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783,
+  30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297,
+  31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736,
+  31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098,
+  32137, 32176, 32213, 32250, 32285, 32318, 32351, 32382,
+  32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+  32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717,
+  32728, 32737, 32745, 32752, 32757, 32761, 32765, 32766,
+  32767, 32766
+};
+#endif
+
+int32_t SineApprox(uint16_t phase, uint16_t scale)
+{
+  uint32_t qPhase, idx, frac;
+  int32_t lo, sinVal;
+
+  // Fold the phase into the first quadrant, 0 to 16384
+  qPhase = phase & 0x7FFF;
+  if (qPhase > 16384)
+  {
+    qPhase = 32768 - qPhase;
+  }
+
+  // Linear interpolation between table entries
+  idx = qPhase >> QTAB_SHIFT;
+  frac = qPhase & ((1 << QTAB_SHIFT) - 1);
+  lo = quarterSinTab[idx];
+  sinVal = lo + (((quarterSinTab[idx + 1] - lo) * (int32_t)frac +
+                  (1 << (QTAB_SHIFT - 1))) >> QTAB_SHIFT);
+
+  // Second half of the cycle is negative
+  if (phase & 0x8000)
+  {
+    sinVal = -sinVal;
+  }
+  return((sinVal * scale + 16384) >> 15);
+}
+
+#define SINE_TABLE_BYTES (sizeof(quarterSinTab))
+
+#elif SINE_APPROX_KERNEL == SINE_KERNEL_PARABOLIC
+
+//
+// Parabola 4x(1-|x|) through the zeros and peaks of the sine, followed by one
+// correction step y += P(y|y| - y) with P = 0.225. No table is needed.
+//
+#define PARABOLA_P_Q15 7373
+
+int32_t SineApprox(uint16_t phase, uint16_t scale)
+{
+  int32_t x, absX, y, absY;
+
+  // x runs from -1 to 1 in Q15 as the phase runs from -pi to pi
+  x = (int16_t)phase;
+  absX = (x < 0) ? -x : x;
+
+  // y = 4x(1-|x|) in Q15, saturated at +/-32767
+  y = (x * (32768 - absX)) >> 13;
+  if (y > 32767)
+  {
+    y = 32767;
+  }
+  else if (y < -32767)
+  {
+    y = -32767;
+  }
+
+  absY = (y < 0) ? -y : y;
+  y += (PARABOLA_P_Q15 * (((y * absY) >> 15) - y)) >> 15;
+  return((y * scale + 16384) >> 15);
+}
+
+#define SINE_TABLE_BYTES 0
+
+#elif SINE_APPROX_KERNEL == SINE_KERNEL_CORDIC
+
+//
+// atan(2^-i) in units of 2^24 per full cycle
+//
+static const int32_t cordicAtanTab[16] = {
+  2097152, 1238021, 654136, 332050, 166669, 83416, 41718, 20860,
+  10430, 5215, 2608, 1304, 652, 326, 163, 81
+};
+
+// CORDIC gain compensation, 0.60725 in Q16
+#define CORDIC_K_Q16 39797
+
+int32_t SineApprox(uint16_t phase, uint16_t scale)
+{
+  int32_t x, y, z, dx;
+  uint32_t idx;
+  int32_t negate;
+
+  // Rotate into -pi/2 to pi/2 where CORDIC converges
+  z = (int16_t)phase;
+  negate = 0;
+  if (z > 16384)
+  {
+    z -= 32768;
+    negate = 1;
+  }
+  else if (z < -16384)
+  {
+    z += 32768;
+    negate = 1;
+  }
+  z <<= 8;
+
+  x = CORDIC_K_Q16;
+  y = 0;
+  for (idx = 0; idx < 16; idx++)
+  {
+    dx = x;
+    if (z >= 0)
+    {
+      x -= y >> idx;
+      y += dx >> idx;
+      z -= cordicAtanTab[idx];
+    }
+    else
+    {
+      x += y >> idx;
+      y -= dx >> idx;
+      z += cordicAtanTab[idx];
+    }
+  }
+
+  // Q16 to Q15
+  y = (y + 1) >> 1;
+  if (y > 32767)
+  {
+    y = 32767;
+  }
+  if (negate)
+  {
+    y = -y;
+  }
+  return((y * scale + 16384) >> 15);
+}
+
+#define SINE_TABLE_BYTES (sizeof(cordicAtanTab))
+
+#else
+#error "Unknown SINE_APPROX_KERNEL"
+#endif
+
+#ifdef SINE_APPROX_STUDY
+//
+// Host study build only: let host/sine_study report the flash cost
+//
+const uint32_t SineApproxTableBytes = SINE_TABLE_BYTES;
+#endif
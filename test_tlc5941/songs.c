@@ -0,0 +1,85 @@
+//*****************************************************************************
+//
+// songs.c - Songs played by the melody sequencer.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "melody.h"
+
+//
+// Jingle Bells, chorus
+//
+static const uint8_t jingleBells[] = {
+  MELODY_TEMPO, 160,
+  NOTE(E, 5), DUR_4, NOTE(E, 5), DUR_4, NOTE(E, 5), DUR_2,
+  NOTE(E, 5), DUR_4, NOTE(E, 5), DUR_4, NOTE(E, 5), DUR_2,
+  NOTE(E, 5), DUR_4, NOTE(G, 5), DUR_4, NOTE(C, 5), DUR_4D, NOTE(D, 5), DUR_8,
+  NOTE(E, 5), DUR_1,
+  NOTE(F, 5), DUR_4, NOTE(F, 5), DUR_4, NOTE(F, 5), DUR_4D, NOTE(F, 5), DUR_8,
+  NOTE(F, 5), DUR_4, NOTE(E, 5), DUR_4, NOTE(E, 5), DUR_4, NOTE(E, 5), DUR_8,
+  NOTE(E, 5), DUR_8,
+  NOTE(E, 5), DUR_4, NOTE(D, 5), DUR_4, NOTE(D, 5), DUR_4, NOTE(E, 5), DUR_4,
+  NOTE(D, 5), DUR_2, NOTE(G, 5), DUR_2,
+  MELODY_END, 0
+};
+
+//
+// Twinkle Twinkle Little Star, first verse
+//
+static const uint8_t twinkle[] = {
+  MELODY_TEMPO, 120,
+  NOTE(C, 5), DUR_4, NOTE(C, 5), DUR_4, NOTE(G, 5), DUR_4, NOTE(G, 5), DUR_4,
+  NOTE(A, 5), DUR_4, NOTE(A, 5), DUR_4, NOTE(G, 5), DUR_2,
+  NOTE(F, 5), DUR_4, NOTE(F, 5), DUR_4, NOTE(E, 5), DUR_4, NOTE(E, 5), DUR_4,
+  NOTE(D, 5), DUR_4, NOTE(D, 5), DUR_4, NOTE(C, 5), DUR_2,
+  MELODY_END, 0
+};
+
+//
+// Happy Birthday
+//
+static const uint8_t happyBirthday[] = {
+  MELODY_TEMPO, 100,
+  NOTE(G, 4), DUR_8D, NOTE(G, 4), DUR_16,
+  NOTE(A, 4), DUR_4, NOTE(G, 4), DUR_4, NOTE(C, 5), DUR_4,
+  NOTE(B, 4), DUR_2, NOTE(G, 4), DUR_8D, NOTE(G, 4), DUR_16,
+  NOTE(A, 4), DUR_4, NOTE(G, 4), DUR_4, NOTE(D, 5), DUR_4,
+  NOTE(C, 5), DUR_2, NOTE(G, 4), DUR_8D, NOTE(G, 4), DUR_16,
+  NOTE(G, 5), DUR_4, NOTE(E, 5), DUR_4, NOTE(C, 5), DUR_4,
+  NOTE(B, 4), DUR_4, NOTE(A, 4), DUR_4, NOTE(F, 5), DUR_8D, NOTE(F, 5), DUR_16,
+  NOTE(E, 5), DUR_4, NOTE(C, 5), DUR_4, NOTE(D, 5), DUR_4,
+  NOTE(C, 5), DUR_2D,
+  MELODY_END, 0
+};
+
+//
+// Ode to Joy, with a faster 16th-note run to close
+//
+static const uint8_t odeToJoy[] = {
+  MELODY_TEMPO, 132,
+  NOTE(E, 5), DUR_4, NOTE(E, 5), DUR_4, NOTE(F, 5), DUR_4, NOTE(G, 5), DUR_4,
+  NOTE(G, 5), DUR_4, NOTE(F, 5), DUR_4, NOTE(E, 5), DUR_4, NOTE(D, 5), DUR_4,
+  NOTE(C, 5), DUR_4, NOTE(C, 5), DUR_4, NOTE(D, 5), DUR_4, NOTE(E, 5), DUR_4,
+  NOTE(E, 5), DUR_4D, NOTE(D, 5), DUR_8, NOTE(D, 5), DUR_2,
+  MELODY_REST, DUR_4,
+  MELODY_TEMPO, 200,
+  NOTE(C, 5), DUR_16, NOTE(D, 5), DUR_16, NOTE(E, 5), DUR_16, NOTE(F, 5), DUR_16,
+  NOTE(G, 5), DUR_16, NOTE(A, 5), DUR_16, NOTE(B, 5), DUR_16, NOTE(C, 6), DUR_16,
+  NOTE(C, 6), DUR_2,
+  MELODY_END, 0
+};
+
+//
+// Songs for keypad keys MELODY_FIRST_KEY and up
+//
+const uint8_t *const g_ppui8Songs[NUM_SONGS] = {
+  jingleBells,
+  twinkle,
+  happyBirthday,
+  odeToJoy
+};
@@ -0,0 +1,317 @@
+//*****************************************************************************
+//
+// spectrum.c - 8-band spectrum and VU meter for the 8x8 matrix.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Each band is a Goertzel filter on bin k of an N-point block at 16kHz,
+// s[n] = x[n] + 2cos(2 pi k / N) s[n-1] - s[n-2], with the coefficient in
+// Q14. At the end of a block the bin power is
+// s1^2 + s2^2 - 2cos(2 pi k / N) s1 s2. N runs from 256 for the lowest band
+// down to 16 for the highest; the block powers are added up over the frame
+// and scaled by 256 / N, and the base 2 logarithm of the sum sets the bar
+// height. The state of the lowest band grows to about 22 bits for a full
+// scale 12-bit input, so the coefficient product is taken to 64 bits, which
+// is a single SMULL on the Cortex-M4.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include "spectrum.h"
+
+//
+// Base 2 logarithm of the bin power that lights one bar row. A full scale
+// 12-bit sine on a bin has a power of about 2^36, which fills the bar.
+//
+#define SPECTRUM_POWER_FLOOR 23
+
+//
+// Base 2 logarithm of the average level that lights one VU meter column.
+// A full scale 12-bit input averages about 2^11.
+//
+#define SPECTRUM_VU_FLOOR 4
+
+//
+// Frames a peak marker stays up before it starts to fall
+//
+#define SPECTRUM_PEAK_HOLD 30
+
+//
+// Bands at 250, 375, 500, 750, 1000, 1500, 2500 and 4000Hz: base 2
+// logarithm of the block length N and 2cos(2 pi k / N) in Q14
+//
+static const uint8_t bandLog2Len[SPECTRUM_BANDS] = {
+  8, 7, 7, 6, 6, 5, 5, 4
+};
+static const int32_t bandCoeff[SPECTRUM_BANDS] = {
+  32610, 32413, 32138, 31357, 30274, 27246, 18205, 0
+};
+
+//
+// Colors, 0xBBGGRR: bar rows from the bottom up, peak marker and VU meter
+//
+static const uint32_t barColors[SPECTRUM_BAR_ROWS] = {
+  0x00FF00, 0x00FF00, 0x00FF00, 0x00FF00, 0x00C0FF, 0x0080FF, 0x0000FF
+};
+#define SPECTRUM_PEAK_COLOR 0x8080FF
+#define SPECTRUM_VU_COLOR   0xFF6000
+
+//*****************************************************************************
+//
+// SpectrumLog2
+// Inputs:
+//   1. Value
+// Outputs: Number of significant bits in the value, 0 for 0
+// Description:
+// Integer base 2 logarithm by binary search.
+//
+//*****************************************************************************
+static uint32_t
+SpectrumLog2(uint64_t value)
+{
+  uint32_t bits, shift;
+
+  bits = 0;
+  for (shift = 32; shift; shift >>= 1)
+  {
+    if (value >> shift)
+    {
+      value >>= shift;
+      bits += shift;
+    }
+  }
+  return bits + (uint32_t)value;
+}
+
+//*****************************************************************************
+//
+// SpectrumInit
+// Inputs:
+//   1. Spectrum state
+// Outputs: None
+// Description:
+// Clear the filters and the display.
+//
+//*****************************************************************************
+void
+SpectrumInit(tSpectrum *psSpectrum)
+{
+  uint32_t band;
+
+  for (band = 0; band < SPECTRUM_BANDS; band++)
+  {
+    psSpectrum->pi32S1[band] = 0;
+    psSpectrum->pi32S2[band] = 0;
+    psSpectrum->pi64Power[band] = 0;
+    psSpectrum->pui8Bar[band] = 0;
+    psSpectrum->pui8Peak[band] = 0;
+    psSpectrum->pui8Hold[band] = 0;
+  }
+  psSpectrum->ui32SumAbs = 0;
+  psSpectrum->ui16Count = 0;
+  psSpectrum->ui8Vu = 0;
+}
+
+//*****************************************************************************
+//
+// SpectrumFrameEnd
+// Inputs:
+//   1. Spectrum state
+// Outputs: None
+// Description:
+// Turn the band powers of a finished frame into bar heights and let bars
+// and peaks fall.
+//
+//*****************************************************************************
+static void
+SpectrumFrameEnd(tSpectrum *psSpectrum)
+{
+  uint32_t band, height;
+  int64_t power;
+
+  for (band = 0; band < SPECTRUM_BANDS; band++)
+  {
+    power = psSpectrum->pi64Power[band] << (8 - bandLog2Len[band]);
+    psSpectrum->pi64Power[band] = 0;
+    height = SpectrumLog2(power > 0 ? (uint64_t)power : 0);
+    height = (height > SPECTRUM_POWER_FLOOR) ?
+             (height - SPECTRUM_POWER_FLOOR) / 2 : 0;
+    if (height > SPECTRUM_BAR_ROWS)
+    {
+      height = SPECTRUM_BAR_ROWS;
+    }
+
+    //
+    // Bars jump up and fall a row per frame
+    //
+    if (height >= psSpectrum->pui8Bar[band])
+    {
+      psSpectrum->pui8Bar[band] = height;
+    }
+    else
+    {
+      psSpectrum->pui8Bar[band]--;
+    }
+
+    //
+    // Peaks hold, then fall a row every 4 frames
+    //
+    if (height >= psSpectrum->pui8Peak[band])
+    {
+      psSpectrum->pui8Peak[band] = height;
+      psSpectrum->pui8Hold[band] = SPECTRUM_PEAK_HOLD;
+    }
+    else if (psSpectrum->pui8Hold[band])
+    {
+      psSpectrum->pui8Hold[band]--;
+    }
+    else
+    {
+      psSpectrum->pui8Peak[band]--;
+      psSpectrum->pui8Hold[band] = 3;
+    }
+  }
+
+  height = SpectrumLog2(psSpectrum->ui32SumAbs / SPECTRUM_FRAME);
+  height = (height > SPECTRUM_VU_FLOOR) ? height - SPECTRUM_VU_FLOOR : 0;
+  psSpectrum->ui8Vu = (height > 8) ? 8 : height;
+  psSpectrum->ui32SumAbs = 0;
+  psSpectrum->ui16Count = 0;
+}
+
+//*****************************************************************************
+//
+// SpectrumFeed
+// Inputs:
+//   1. Spectrum state
+//   2. Samples
+//   3. Number of samples
+//   4. Sample value for silence
+// Outputs: None
+// Description:
+// Run one slice of samples through the filter bank, updating the bars at
+// each frame boundary. Called with one row's 32 samples every row, a frame
+// ends every 8th call.
+//
+//*****************************************************************************
+void
+SpectrumFeed(tSpectrum *psSpectrum, const uint16_t *pui16Samples,
+             uint32_t count, uint16_t midScale)
+{
+  uint32_t band, idx, end, run, pos, lenMask, sumAbs;
+  int32_t s0, s1, s2, coeff, x;
+
+  while (count)
+  {
+    pos = psSpectrum->ui16Count;
+    run = SPECTRUM_FRAME - pos;
+    if (run > count)
+    {
+      run = count;
+    }
+
+    for (band = 0; band < SPECTRUM_BANDS; band++)
+    {
+      coeff = bandCoeff[band];
+      lenMask = (1 << bandLog2Len[band]) - 1;
+      s1 = psSpectrum->pi32S1[band];
+      s2 = psSpectrum->pi32S2[band];
+      for (idx = 0; idx < run; )
+      {
+        //
+        // Filter up to the end of the block or of the slice
+        //
+        end = idx + lenMask + 1 - ((pos + idx) & lenMask);
+        if (end > run)
+        {
+          end = run;
+        }
+        for (; idx < end; idx++)
+        {
+          s0 = (int32_t)pui16Samples[idx] - midScale +
+               (int32_t)(((int64_t)coeff * s1) >> 14) - s2;
+          s2 = s1;
+          s1 = s0;
+        }
+        if (((pos + idx) & lenMask) == 0)
+        {
+          psSpectrum->pi64Power[band] += (int64_t)s1 * s1 +
+                                         (int64_t)s2 * s2 -
+                                         (((int64_t)coeff * s1) >> 14) * s2;
+          s1 = 0;
+          s2 = 0;
+        }
+      }
+      psSpectrum->pi32S1[band] = s1;
+      psSpectrum->pi32S2[band] = s2;
+    }
+
+    sumAbs = 0;
+    for (idx = 0; idx < run; idx++)
+    {
+      x = (int32_t)pui16Samples[idx] - midScale;
+      sumAbs += (x < 0) ? -x : x;
+    }
+    psSpectrum->ui32SumAbs += sumAbs;
+
+    psSpectrum->ui16Count += run;
+    if (psSpectrum->ui16Count == SPECTRUM_FRAME)
+    {
+      SpectrumFrameEnd(psSpectrum);
+    }
+    pui16Samples += run;
+    count -= run;
+  }
+}
+
+//*****************************************************************************
+//
+// SpectrumRow
+// Inputs:
+//   1. Spectrum state
+//   2. LED row, 0 at the top
+//   3. Output: 12-bit R, G and B values for each column of the row
+// Outputs: None
+// Description:
+// Draw one row of the VU meter or the band bars.
+//
+//*****************************************************************************
+void
+SpectrumRow(const tSpectrum *psSpectrum, uint32_t row,
+            uint16_t rgbValues[8][3])
+{
+  uint32_t col, level, color;
+
+  //
+  // Bar rows count up from the bottom row, 1 to SPECTRUM_BAR_ROWS
+  //
+  level = 8 - row;
+  for (col = 0; col < 8; col++)
+  {
+    if (row == 0)
+    {
+      color = (col < psSpectrum->ui8Vu) ? SPECTRUM_VU_COLOR : 0;
+    }
+    else if (level <= psSpectrum->pui8Bar[col])
+    {
+      color = barColors[level - 1];
+    }
+    else if (level == psSpectrum->pui8Peak[col])
+    {
+      color = SPECTRUM_PEAK_COLOR;
+    }
+    else
+    {
+      color = 0;
+    }
+    rgbValues[col][0] = (color & 0xFF) << 4;
+    rgbValues[col][1] = (color & 0xFF00) >> 4;
+    rgbValues[col][2] = (color & 0xFF0000) >> 12;
+  }
+}
@@ -0,0 +1,54 @@
+//*****************************************************************************
+//
+// spectrum.h - 8-band spectrum and VU meter for the 8x8 matrix.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __SPECTRUM_H__
+#define __SPECTRUM_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// Audio is analysed in frames of SPECTRUM_FRAME samples, one display sweep
+// of 8 rows at 32 samples per row, by a bank of fixed-point Goertzel filters
+// tuned to SPECTRUM_BANDS frequencies from 250Hz to 4kHz. Higher bands run
+// on shorter blocks, so each is wide enough to cover the gap to its
+// neighbours, and add up their power over the frame. Samples are fed one
+// row's slice at a time, so the work per row is the same every row.
+//
+// The top row of the display is a VU meter of the average level; below it
+// each column is a band, with bars of up to SPECTRUM_BAR_ROWS rows at 6dB
+// per row and a falling peak marker.
+//
+//*****************************************************************************
+#define SPECTRUM_BANDS          8
+#define SPECTRUM_FRAME          256
+#define SPECTRUM_BAR_ROWS       7
+
+typedef struct
+{
+    int32_t pi32S1[SPECTRUM_BANDS];     // Goertzel state, previous sample
+    int32_t pi32S2[SPECTRUM_BANDS];     // Goertzel state, sample before
+    int64_t pi64Power[SPECTRUM_BANDS];  // power of the blocks this frame
+    uint32_t ui32SumAbs;                // sum of |x| over the frame
+    uint16_t ui16Count;                 // samples fed this frame
+    uint8_t pui8Bar[SPECTRUM_BANDS];    // bar heights, 0 to SPECTRUM_BAR_ROWS
+    uint8_t pui8Peak[SPECTRUM_BANDS];   // peak marker heights
+    uint8_t pui8Hold[SPECTRUM_BANDS];   // frames left before a peak falls
+    uint8_t ui8Vu;                      // VU meter width, 0 to 8
+}
+tSpectrum;
+
+extern void SpectrumInit(tSpectrum *psSpectrum);
+extern void SpectrumFeed(tSpectrum *psSpectrum, const uint16_t *pui16Samples,
+                         uint32_t count, uint16_t midScale);
+extern void SpectrumRow(const tSpectrum *psSpectrum, uint32_t row,
+                        uint16_t rgbValues[8][3]);
+
+#endif // __SPECTRUM_H__
@@ -0,0 +1,623 @@
+//*****************************************************************************
+//
+// stream.c - Frames streamed from a PC over the UART.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// At 1Mbaud a byte arrives every 10us, too often for an interrupt each, so
+// the uDMA moves received bytes into the ring and interrupts only when a half
+// is full. StreamReceive runs every row and decodes what has arrived since,
+// finding how far the uDMA has written from the transfer count left in the
+// half it is filling.
+//
+// A frame is decoded into a staging buffer and applied to the back frame
+// buffer only once its check passes, so a damaged frame never shows. The
+// newest back frame is copied to the front at the start of a display frame,
+// so a frame never changes part way down the display.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "inc/hw_ints.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_uart.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/rom.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/uart.h"
+#include "driverlib/udma.h"
+#include "console.h"
+#include "stream.h"
+#include "telemetry.h"
+
+#define STREAM_HALF             (STREAM_RING_SIZE / 2)
+
+//
+// A reader this far behind the uDMA may find the bytes it is decoding
+// overwritten, so they are thrown away. 64 bytes is 640us of line time,
+// far longer than a pass of StreamReceive.
+//
+#define STREAM_RING_SLACK       64
+
+//
+// Decoder states, one per field of a frame
+//
+#define STREAM_STATE_SYNC0      0
+#define STREAM_STATE_SYNC1      1
+#define STREAM_STATE_TYPE       2
+#define STREAM_STATE_SEQ        3
+#define STREAM_STATE_MASK       4
+#define STREAM_STATE_PAYLOAD    5
+#define STREAM_STATE_CHECK0     6
+#define STREAM_STATE_CHECK1     7
+
+//*****************************************************************************
+//
+// Globals
+//
+//*****************************************************************************
+
+//
+// uDMA channel control table. The uDMA requires its base aligned to 1024
+// bytes, the 32 primary structures first and the alternates from byte 512.
+// Only channel 8 is used, so the table ends with its alternate structure,
+// 656 bytes in, and the linker is free to place other data after it.
+//
+#define STREAM_DMA_CONTROL_ENTRIES  (32 + UDMA_CHANNEL_UART0RX + 1)
+
+#ifdef __TI_ARM__
+#pragma DATA_ALIGN(g_psStreamDMAControl, 1024)
+static tDMAControlTable g_psStreamDMAControl[STREAM_DMA_CONTROL_ENTRIES];
+#else
+static tDMAControlTable g_psStreamDMAControl[STREAM_DMA_CONTROL_ENTRIES]
+    __attribute__((aligned(1024)));
+#endif
+
+static uint8_t g_pui8StreamRing[STREAM_RING_SIZE];
+
+// Ring halves filled by the uDMA, counted by StreamIntHandler
+static volatile uint32_t g_ui32StreamHalves;
+
+// Bytes taken from the ring
+static uint32_t g_ui32StreamRead;
+
+//
+// Decoder state and the frame being received
+//
+static uint8_t g_ui8StreamState;
+static uint8_t g_ui8StreamType;
+static uint8_t g_ui8StreamSeq;
+static uint8_t g_ui8StreamMask;
+static uint8_t g_ui8StreamCheck;
+static uint32_t g_ui32StreamLen;
+static uint32_t g_ui32StreamPos;
+static uint32_t g_ui32StreamSum1, g_ui32StreamSum2;
+static uint8_t g_pui8StreamPayload[STREAM_FRAME_BYTES];
+
+// Sequence number expected next, once one frame has set it
+static uint8_t g_ui8StreamNextSeq;
+static bool g_bStreamSeqValid;
+
+// Deltas cannot be applied until a keyframe arrives
+static bool g_bStreamNeedKey;
+
+//
+// Frame buffers, 8 rows of STREAM_ROW_BYTES
+//
+static uint8_t g_ppui8StreamBack[8][STREAM_ROW_BYTES];
+static uint8_t g_ppui8StreamFront[8][STREAM_ROW_BYTES];
+
+// The back frame changed since the last display frame
+static bool g_bStreamNew;
+
+// A release frame arrived
+static bool g_bStreamReleased;
+
+// Showing the stream, display frames left before it times out, and a
+// stream has ended since the last report
+static bool g_bStreamActive;
+static uint32_t g_ui32StreamCountdown;
+static bool g_bStreamEnded;
+
+static tStreamStats g_sStreamStats;
+
+//*****************************************************************************
+//
+// StreamInit
+// Inputs: None
+// Outputs: None
+// Description:
+// Start the uDMA receiving UART0 into both halves of the ring. The UART must
+// already be configured.
+//
+//*****************************************************************************
+void
+StreamInit(void)
+{
+  ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_UDMA);
+  ROM_uDMAEnable();
+  ROM_uDMAControlBaseSet(g_psStreamDMAControl);
+
+  //
+  // Single requests as well as bursts, so that the last bytes of a frame
+  // are moved without waiting for the FIFO to fill to its trigger level
+  //
+  uDMAChannelAssign(UDMA_CH8_UART0RX);
+  ROM_uDMAChannelAttributeDisable(UDMA_CHANNEL_UART0RX,
+                                  UDMA_ATTR_ALTSELECT | UDMA_ATTR_USEBURST |
+                                  UDMA_ATTR_HIGH_PRIORITY |
+                                  UDMA_ATTR_REQMASK);
+  ROM_uDMAChannelControlSet(UDMA_CHANNEL_UART0RX | UDMA_PRI_SELECT,
+                            UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 |
+                            UDMA_ARB_4);
+  ROM_uDMAChannelControlSet(UDMA_CHANNEL_UART0RX | UDMA_ALT_SELECT,
+                            UDMA_SIZE_8 | UDMA_SRC_INC_NONE | UDMA_DST_INC_8 |
+                            UDMA_ARB_4);
+  ROM_uDMAChannelTransferSet(UDMA_CHANNEL_UART0RX | UDMA_PRI_SELECT,
+                             UDMA_MODE_PINGPONG,
+                             (void *)(UART0_BASE + UART_O_DR),
+                             g_pui8StreamRing, STREAM_HALF);
+  ROM_uDMAChannelTransferSet(UDMA_CHANNEL_UART0RX | UDMA_ALT_SELECT,
+                             UDMA_MODE_PINGPONG,
+                             (void *)(UART0_BASE + UART_O_DR),
+                             g_pui8StreamRing + STREAM_HALF, STREAM_HALF);
+  g_ui32StreamHalves = 0;
+  g_ui32StreamRead = 0;
+
+  g_ui8StreamState = STREAM_STATE_SYNC0;
+  g_bStreamSeqValid = false;
+  g_bStreamNeedKey = true;
+  g_bStreamNew = false;
+  g_bStreamReleased = false;
+  g_bStreamActive = false;
+  g_ui32StreamCountdown = 0;
+  g_bStreamEnded = false;
+
+  ROM_UARTFIFOLevelSet(UART0_BASE, UART_FIFO_TX4_8, UART_FIFO_RX4_8);
+  ROM_UARTDMAEnable(UART0_BASE, UART_DMA_RX);
+  ROM_uDMAChannelEnable(UDMA_CHANNEL_UART0RX);
+  IntEnable(INT_UART0);
+}
+
+//*****************************************************************************
+//
+// StreamIntHandler
+// Inputs: None
+// Outputs: None
+// Description:
+// UART0 interrupt, raised when the uDMA has filled a half of the ring. The
+// uDMA has already moved on to the other half; set this one up again. Both
+// are stopped only if this interrupt was held off for a whole half, and
+// then the channel must be enabled again too.
+//
+//*****************************************************************************
+void
+StreamIntHandler(void)
+{
+  uint32_t idx, select;
+
+  ROM_UARTIntClear(UART0_BASE, ROM_UARTIntStatus(UART0_BASE, true));
+  TELEMETRY_INT(TELEMETRY_INT_STREAM);
+
+  for (idx = 0; idx < 2; idx++)
+  {
+    select = (g_ui32StreamHalves & 1) ? UDMA_ALT_SELECT : UDMA_PRI_SELECT;
+    if (ROM_uDMAChannelModeGet(UDMA_CHANNEL_UART0RX | select) !=
+        UDMA_MODE_STOP)
+    {
+      break;
+    }
+    ROM_uDMAChannelTransferSet(UDMA_CHANNEL_UART0RX | select,
+                               UDMA_MODE_PINGPONG,
+                               (void *)(UART0_BASE + UART_O_DR),
+                               g_pui8StreamRing +
+                               (g_ui32StreamHalves & 1) * STREAM_HALF,
+                               STREAM_HALF);
+    g_ui32StreamHalves++;
+  }
+  if (idx == 2)
+  {
+    ROM_uDMAChannelEnable(UDMA_CHANNEL_UART0RX);
+  }
+}
+
+//*****************************************************************************
+//
+// StreamWritten
+// Inputs: None
+// Outputs: Bytes written to the ring since StreamInit
+// Description:
+// Halves filled plus the part of the half being filled. Read again if the
+// interrupt counted a half meanwhile; a half that has just stopped reads as
+// 0 bytes left, which is right.
+//
+//*****************************************************************************
+static uint32_t
+StreamWritten(void)
+{
+  uint32_t halves, left;
+
+  do
+  {
+    halves = g_ui32StreamHalves;
+    left = ROM_uDMAChannelSizeGet(UDMA_CHANNEL_UART0RX |
+                                  ((halves & 1) ? UDMA_ALT_SELECT :
+                                                  UDMA_PRI_SELECT));
+  }
+  while (halves != g_ui32StreamHalves);
+
+  return(halves * STREAM_HALF + STREAM_HALF - left);
+}
+
+//*****************************************************************************
+//
+// StreamApply
+// Inputs: None
+// Outputs: None
+// Description:
+// Act on a frame that has passed its check. Frames missing from the
+// sequence count as dropped, and the deltas after them as well until a
+// keyframe arrives. A telemetry command only sets the telemetry period.
+//
+//*****************************************************************************
+static void
+StreamApply(void)
+{
+  uint32_t row, idx;
+  const uint8_t *pui8Src;
+
+  if (g_ui8StreamType == STREAM_TELEMETRY)
+  {
+    TelemetrySetPeriod(g_pui8StreamPayload[0]);
+    return;
+  }
+  if (g_bStreamSeqValid && (g_ui8StreamSeq != g_ui8StreamNextSeq))
+  {
+    g_sStreamStats.ui32Dropped += (uint8_t)(g_ui8StreamSeq -
+                                            g_ui8StreamNextSeq);
+    g_bStreamNeedKey = true;
+  }
+  g_ui8StreamNextSeq = g_ui8StreamSeq + 1;
+  g_bStreamSeqValid = true;
+
+  if (g_ui8StreamType == STREAM_RELEASE)
+  {
+    //
+    // The next stream starts its own sequence
+    //
+    g_bStreamReleased = true;
+    g_bStreamSeqValid = false;
+    g_bStreamNeedKey = true;
+    return;
+  }
+  if (g_ui8StreamType == STREAM_KEYFRAME)
+  {
+    g_ui8StreamMask = 0xFF;
+    g_bStreamNeedKey = false;
+    g_sStreamStats.ui32Keyframes++;
+  }
+  else if (g_bStreamNeedKey)
+  {
+    g_sStreamStats.ui32Dropped++;
+    return;
+  }
+
+  pui8Src = g_pui8StreamPayload;
+  for (row = 0; row < 8; row++)
+  {
+    if (g_ui8StreamMask & (1 << row))
+    {
+      for (idx = 0; idx < STREAM_ROW_BYTES; idx++)
+      {
+        g_ppui8StreamBack[row][idx] = *pui8Src++;
+      }
+    }
+  }
+  g_sStreamStats.ui32Frames++;
+  g_bStreamNew = true;
+}
+
+//*****************************************************************************
+//
+// StreamReceive
+// Inputs: None
+// Outputs: None
+// Description:
+// Decode everything received since the last call, applying each frame
+// that completes. Called every row.
+//
+//*****************************************************************************
+void
+StreamReceive(void)
+{
+  uint32_t written, read, end, sum1, sum2, row;
+  uint8_t byte;
+
+  written = StreamWritten();
+  read = g_ui32StreamRead;
+  if (written - read > STREAM_RING_SIZE - STREAM_RING_SLACK)
+  {
+    g_sStreamStats.ui32Overruns++;
+    g_sStreamStats.ui32Bytes += written - read;
+    g_ui8StreamState = STREAM_STATE_SYNC0;
+    g_bStreamNeedKey = true;
+    g_ui32StreamRead = written;
+    return;
+  }
+  g_sStreamStats.ui32Bytes += written - read;
+
+  sum1 = g_ui32StreamSum1;
+  sum2 = g_ui32StreamSum2;
+  while (read != written)
+  {
+    //
+    // Payload bytes go straight to the staging buffer without the
+    // per-byte state switch
+    //
+    if (g_ui8StreamState == STREAM_STATE_PAYLOAD)
+    {
+      end = g_ui32StreamLen - g_ui32StreamPos;
+      end = read + ((written - read < end) ? written - read : end);
+      while (read != end)
+      {
+        byte = g_pui8StreamRing[read++ & (STREAM_RING_SIZE - 1)];
+        g_pui8StreamPayload[g_ui32StreamPos++] = byte;
+        sum1 += byte;
+        sum1 -= (sum1 >= 255) ? 255 : 0;
+        sum2 += sum1;
+        sum2 -= (sum2 >= 255) ? 255 : 0;
+      }
+      if (g_ui32StreamPos == g_ui32StreamLen)
+      {
+        g_ui8StreamState = STREAM_STATE_CHECK0;
+      }
+      continue;
+    }
+
+    byte = g_pui8StreamRing[read++ & (STREAM_RING_SIZE - 1)];
+    switch (g_ui8StreamState)
+    {
+      case STREAM_STATE_SYNC0:
+        if (byte == STREAM_SYNC0)
+        {
+          g_ui8StreamState = STREAM_STATE_SYNC1;
+        }
+        break;
+
+      case STREAM_STATE_SYNC1:
+        if (byte != STREAM_SYNC0)
+        {
+          g_ui8StreamState = (byte == STREAM_SYNC1) ? STREAM_STATE_TYPE :
+                                                      STREAM_STATE_SYNC0;
+        }
+        break;
+
+      case STREAM_STATE_TYPE:
+        if ((byte < STREAM_KEYFRAME) || (byte > STREAM_TELEMETRY))
+        {
+          g_sStreamStats.ui32Errors++;
+          g_bStreamNeedKey = true;
+          g_ui8StreamState = STREAM_STATE_SYNC0;
+          break;
+        }
+        g_ui8StreamType = byte;
+        sum1 = byte;
+        sum2 = byte;
+        g_ui8StreamState = STREAM_STATE_SEQ;
+        break;
+
+      case STREAM_STATE_SEQ:
+        g_ui8StreamSeq = byte;
+        sum1 += byte;
+        sum1 -= (sum1 >= 255) ? 255 : 0;
+        sum2 += sum1;
+        sum2 -= (sum2 >= 255) ? 255 : 0;
+        g_ui32StreamPos = 0;
+        if (g_ui8StreamType == STREAM_DELTA)
+        {
+          g_ui8StreamState = STREAM_STATE_MASK;
+        }
+        else
+        {
+          g_ui32StreamLen = (g_ui8StreamType == STREAM_KEYFRAME) ?
+                            STREAM_FRAME_BYTES :
+                            (g_ui8StreamType == STREAM_TELEMETRY) ? 1 : 0;
+          g_ui8StreamState = g_ui32StreamLen ? STREAM_STATE_PAYLOAD :
+                                               STREAM_STATE_CHECK0;
+        }
+        break;
+
+      case STREAM_STATE_MASK:
+        g_ui8StreamMask = byte;
+        sum1 += byte;
+        sum1 -= (sum1 >= 255) ? 255 : 0;
+        sum2 += sum1;
+        sum2 -= (sum2 >= 255) ? 255 : 0;
+        g_ui32StreamLen = 0;
+        for (row = 0; row < 8; row++)
+        {
+          g_ui32StreamLen += (byte & (1 << row)) ? STREAM_ROW_BYTES : 0;
+        }
+        g_ui8StreamState = g_ui32StreamLen ? STREAM_STATE_PAYLOAD :
+                                             STREAM_STATE_CHECK0;
+        break;
+
+      case STREAM_STATE_CHECK0:
+        g_ui8StreamCheck = byte;
+        g_ui8StreamState = STREAM_STATE_CHECK1;
+        break;
+
+      default:
+        if ((g_ui8StreamCheck == sum1) && (byte == sum2))
+        {
+          StreamApply();
+        }
+        else
+        {
+          g_sStreamStats.ui32Errors++;
+          g_bStreamNeedKey = true;
+        }
+        g_ui8StreamState = STREAM_STATE_SYNC0;
+        break;
+    }
+  }
+  g_ui32StreamSum1 = sum1;
+  g_ui32StreamSum2 = sum2;
+  g_ui32StreamRead = read;
+}
+
+//*****************************************************************************
+//
+// StreamFrame
+// Inputs: None
+// Outputs: None
+// Description:
+// At the start of a display frame, show the newest complete frame. The
+// stream stops showing when released or when no frame has come for
+// STREAM_TIMEOUT_FRAMES.
+//
+//*****************************************************************************
+void
+StreamFrame(void)
+{
+  uint32_t row, idx;
+
+  if (g_bStreamNew)
+  {
+    g_bStreamNew = false;
+    for (row = 0; row < 8; row++)
+    {
+      for (idx = 0; idx < STREAM_ROW_BYTES; idx++)
+      {
+        g_ppui8StreamFront[row][idx] = g_ppui8StreamBack[row][idx];
+      }
+    }
+    g_bStreamActive = true;
+    g_ui32StreamCountdown = STREAM_TIMEOUT_FRAMES;
+  }
+  else if (g_ui32StreamCountdown && (--g_ui32StreamCountdown == 0))
+  {
+    g_bStreamActive = false;
+    g_bStreamSeqValid = false;
+    g_bStreamEnded = true;
+  }
+
+  if (g_bStreamReleased)
+  {
+    g_bStreamReleased = false;
+    g_bStreamActive = false;
+    g_ui32StreamCountdown = 0;
+    g_bStreamEnded = true;
+  }
+  if (g_bStreamActive)
+  {
+    g_sStreamStats.ui32ShownFrames++;
+  }
+}
+
+//*****************************************************************************
+//
+// StreamActive
+// Inputs: None
+// Outputs: True while the stream has the display
+// Description:
+// Changes only in StreamFrame, so it holds for a whole display frame.
+//
+//*****************************************************************************
+bool
+StreamActive(void)
+{
+  return(g_bStreamActive);
+}
+
+//*****************************************************************************
+//
+// StreamRow
+// Inputs:
+//   1. LED row
+//   2. Receives 12-bit red, green and blue of each pixel of the row
+// Outputs: None
+// Description:
+// One row of the frame being shown, for RenderRGBRow.
+//
+//*****************************************************************************
+void
+StreamRow(uint32_t ui32Row, uint16_t pui16RGB[8][3])
+{
+  const uint8_t *pui8Src;
+  uint32_t col;
+
+  pui8Src = g_ppui8StreamFront[ui32Row];
+  for (col = 0; col < 8; col++)
+  {
+    pui16RGB[col][0] = pui8Src[0] << 4;
+    pui16RGB[col][1] = pui8Src[1] << 4;
+    pui16RGB[col][2] = pui8Src[2] << 4;
+    pui8Src += 3;
+  }
+}
+
+//*****************************************************************************
+//
+// StreamStats
+// Inputs: None
+// Outputs: Counts since boot
+// Description:
+// For a test harness to check the counts StreamReport prints.
+//
+//*****************************************************************************
+const tStreamStats *
+StreamStats(void)
+{
+  return(&g_sStreamStats);
+}
+
+//*****************************************************************************
+//
+// StreamReport
+// Inputs: None
+// Outputs: None
+// Description:
+// Print the frame counts and the frames received per second the stream was
+// showing, counted in 62.5Hz display frames.
+//
+//*****************************************************************************
+void
+StreamReport(void)
+{
+  tStreamStats *psStats = &g_sStreamStats;
+
+  ConsolePrintf("stream %u frames (%u key) %u fps, %u dropped %u bad "
+                "%u overruns, %u bytes\n", psStats->ui32Frames,
+                psStats->ui32Keyframes,
+                psStats->ui32ShownFrames ?
+                psStats->ui32Frames * 125 / (2 * psStats->ui32ShownFrames) :
+                0, psStats->ui32Dropped, psStats->ui32Errors,
+                psStats->ui32Overruns, psStats->ui32Bytes);
+}
+
+//*****************************************************************************
+//
+// StreamPoll
+// Inputs: None
+// Outputs: None
+// Description:
+// Console work: report once each time a stream ends.
+//
+//*****************************************************************************
+void
+StreamPoll(void)
+{
+  if (g_bStreamEnded)
+  {
+    g_bStreamEnded = false;
+    StreamReport();
+  }
+}
@@ -0,0 +1,103 @@
+//*****************************************************************************
+//
+// stream.h - Frames streamed from a PC over the UART.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// UART0 receives at STREAM_BAUD; the console shares UART0 and so transmits
+// at this rate too. The PIOSC clocks the UART, 16MHz being exactly 16x the
+// rate.
+//
+// Received bytes are moved by uDMA in ping-pong mode into a ring of
+// STREAM_RING_SIZE bytes, two halves, with one interrupt per half. The ring
+// holds 5ms of a full line, more than two rows, and is drained every row.
+//
+//*****************************************************************************
+#define STREAM_BAUD             1000000
+#define STREAM_RING_SIZE        512
+
+//*****************************************************************************
+//
+// Each frame on the line is:
+//
+//   STREAM_SYNC0 STREAM_SYNC1 type seq payload check_lo check_hi
+//
+// where seq counts frames modulo 256 and the check is the Fletcher-16 sum of
+// type, seq and the payload, low byte first. Payloads:
+//
+//   STREAM_KEYFRAME  all 8 rows
+//   STREAM_DELTA     a row mask, bit n for row n, then each row in the mask
+//                    in order; the other rows are as in the frame before
+//   STREAM_RELEASE   none; hands the display back to the keypad functions
+//   STREAM_TELEMETRY one byte, the display frames between telemetry records
+//                    sent back, 0 to stop them (telemetry.h). It takes no
+//                    part in the sequence and leaves the display as it is.
+//
+// A row is 8 pixels from column 0, each red, green and blue, 8 bits each.
+//
+// A delta applies only to the frame sent just before it, so after a lost or
+// damaged frame deltas are dropped until the next keyframe. A sender should
+// send a keyframe every so often to bound the damage.
+//
+//*****************************************************************************
+#define STREAM_SYNC0            0xA5
+#define STREAM_SYNC1            0x5A
+#define STREAM_KEYFRAME         0x01
+#define STREAM_DELTA            0x02
+#define STREAM_RELEASE          0x03
+#define STREAM_TELEMETRY        0x04
+
+#define STREAM_ROW_BYTES        (8 * 3)
+#define STREAM_FRAME_BYTES      (8 * STREAM_ROW_BYTES)
+
+//
+// Bytes on the line around the payload: sync, type, seq and check
+//
+#define STREAM_OVERHEAD         6
+
+//
+// The stream shows once a frame has arrived and for STREAM_TIMEOUT_FRAMES
+// display frames (1s) after the last one, unless released sooner
+//
+#define STREAM_TIMEOUT_FRAMES   62
+
+//*****************************************************************************
+//
+// Counts since boot
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Bytes;         // received
+    uint32_t ui32Frames;        // received whole and applied
+    uint32_t ui32Keyframes;     // of those, keyframes
+    uint32_t ui32Dropped;       // lost on the line or not applicable
+    uint32_t ui32Errors;        // damaged: bad type or check
+    uint32_t ui32Overruns;      // ring overwritten before it was drained
+    uint32_t ui32ShownFrames;   // display frames showing the stream
+}
+tStreamStats;
+
+extern void StreamInit(void);
+extern void StreamIntHandler(void);
+extern void StreamReceive(void);
+extern void StreamFrame(void);
+extern bool StreamActive(void);
+extern void StreamRow(uint32_t ui32Row, uint16_t pui16RGB[8][3]);
+extern const tStreamStats *StreamStats(void);
+extern void StreamReport(void);
+extern void StreamPoll(void);
+
+#endif // __STREAM_H__
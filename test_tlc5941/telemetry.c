@@ -0,0 +1,277 @@
+//*****************************************************************************
+//
+// telemetry.c - Binary status records sent over the UART console.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "console.h"
+#include "sched.h"
+#include "stream.h"
+#include "telemetry.h"
+
+//*****************************************************************************
+//
+// A task whose run times are reported, and its totals at the last record
+//
+//*****************************************************************************
+typedef struct
+{
+    tSchedTask *psTask;
+    uint32_t ui32Runs;
+    uint32_t ui32Cycles;
+}
+tTelemetryTiming;
+
+//*****************************************************************************
+//
+// Globals
+//
+//*****************************************************************************
+volatile uint32_t g_pui32TelemetryInts[TELEMETRY_NUM_INTS];
+
+static tTelemetryTiming g_sTelemetryRender;
+static tTelemetryTiming g_sTelemetryRefill;
+
+// Frames between records, 0 for none, and frames left to the next
+static uint32_t g_ui32TelemetryPeriod;
+static uint32_t g_ui32TelemetryCountdown;
+
+static uint32_t g_ui32TelemetryFrame;
+static uint8_t g_ui8TelemetrySeq;
+static uint16_t g_ui16TelemetryDropped;
+
+// Key events since boot, and the last few, newest first
+static uint16_t g_ui16TelemetryKeyEvents;
+static uint8_t g_pui8TelemetryKeys[TELEMETRY_KEYS];
+
+static tTelemetryStatus g_sTelemetryStatus;
+static uint8_t g_pui8TelemetryLine[TELEMETRY_LINE_BYTES];
+
+//*****************************************************************************
+//
+// TelemetryInit
+// Inputs:
+//   1. Task rendering the rows
+//   2. Task refilling the PWM DAC
+// Outputs: None
+// Description:
+// Clear the counts and turn telemetry off. The tasks' missed deadlines are
+// reported as missed rows and audio underruns, and their run times as the
+// render and refill cycles.
+//
+//*****************************************************************************
+void
+TelemetryInit(tSchedTask *psRender, tSchedTask *psRefill)
+{
+  uint32_t idx;
+
+  for (idx = 0; idx < TELEMETRY_NUM_INTS; idx++)
+  {
+    g_pui32TelemetryInts[idx] = 0;
+  }
+  for (idx = 0; idx < TELEMETRY_KEYS; idx++)
+  {
+    g_pui8TelemetryKeys[idx] = 0;
+  }
+  g_sTelemetryRender.psTask = psRender;
+  g_sTelemetryRender.ui32Runs = psRender->ui32Runs;
+  g_sTelemetryRender.ui32Cycles = psRender->ui32TotalCycles;
+  g_sTelemetryRefill.psTask = psRefill;
+  g_sTelemetryRefill.ui32Runs = psRefill->ui32Runs;
+  g_sTelemetryRefill.ui32Cycles = psRefill->ui32TotalCycles;
+  g_ui32TelemetryPeriod = 0;
+  g_ui32TelemetryCountdown = 0;
+  g_ui32TelemetryFrame = 0;
+  g_ui8TelemetrySeq = 0;
+  g_ui16TelemetryDropped = 0;
+  g_ui16TelemetryKeyEvents = 0;
+}
+
+//*****************************************************************************
+//
+// TelemetrySetPeriod
+// Inputs:
+//   1. Display frames between records, up to TELEMETRY_PERIOD_MAX; 0 to stop
+// Outputs: None
+// Description:
+// Start, stop or change the records. The first is sent with the next frame.
+//
+//*****************************************************************************
+void
+TelemetrySetPeriod(uint32_t ui32Frames)
+{
+  g_ui32TelemetryPeriod = (ui32Frames > TELEMETRY_PERIOD_MAX) ?
+                          TELEMETRY_PERIOD_MAX : ui32Frames;
+  g_ui32TelemetryCountdown = 1;
+}
+
+//*****************************************************************************
+//
+// TelemetryKey
+// Inputs:
+//   1. Key, 0 to 15
+//   2. True for a press, false for a release
+// Outputs: None
+// Description:
+// Note a key event for the records. Only the last TELEMETRY_KEYS are kept;
+// the event count tells a reader how many it missed.
+//
+//*****************************************************************************
+void
+TelemetryKey(uint32_t ui32Key, bool bDown)
+{
+  uint32_t idx;
+
+  for (idx = TELEMETRY_KEYS - 1; idx; idx--)
+  {
+    g_pui8TelemetryKeys[idx] = g_pui8TelemetryKeys[idx - 1];
+  }
+  g_pui8TelemetryKeys[0] = (ui32Key & 0xF) | (bDown ? TELEMETRY_KEY_DOWN : 0);
+  g_ui16TelemetryKeyEvents++;
+}
+
+//*****************************************************************************
+//
+// TelemetryTiming
+// Inputs:
+//   1. Task and its totals at the last record, updated
+//   2. Output: mean cycles of the runs since
+//   3. Output: longest of them
+// Outputs: None
+// Description:
+// Take the run times since the last record and clear the task's peak.
+//
+//*****************************************************************************
+static void
+TelemetryTiming(tTelemetryTiming *psTiming, uint16_t *pui16Mean,
+                uint16_t *pui16Peak)
+{
+  tSchedTask *psTask;
+  uint32_t runs, cycles;
+
+  psTask = psTiming->psTask;
+  runs = psTask->ui32Runs - psTiming->ui32Runs;
+  cycles = psTask->ui32TotalCycles - psTiming->ui32Cycles;
+  psTiming->ui32Runs = psTask->ui32Runs;
+  psTiming->ui32Cycles = psTask->ui32TotalCycles;
+
+  cycles = runs ? cycles / runs : 0;
+  *pui16Mean = (cycles > 0xFFFF) ? 0xFFFF : cycles;
+  *pui16Peak = (psTask->ui32PeakCycles > 0xFFFF) ? 0xFFFF :
+               psTask->ui32PeakCycles;
+  psTask->ui32PeakCycles = 0;
+}
+
+//*****************************************************************************
+//
+// TelemetryEncode
+// Inputs:
+//   1. Status record
+//   2. Sequence number
+//   3. Output: TELEMETRY_LINE_BYTES to send
+// Outputs: Bytes written, TELEMETRY_LINE_BYTES
+// Description:
+// Frame a status record, summing the check as the payload is copied.
+//
+//*****************************************************************************
+uint32_t
+TelemetryEncode(const tTelemetryStatus *psStatus, uint8_t ui8Seq,
+                uint8_t *pui8Line)
+{
+  const uint8_t *pui8Src;
+  uint32_t idx, sum1, sum2;
+
+  pui8Line[0] = STREAM_SYNC0;
+  pui8Line[1] = STREAM_SYNC1;
+  pui8Line[2] = TELEMETRY_STATUS;
+  pui8Line[3] = ui8Seq;
+
+  //
+  // Over this few bytes the sums cannot overflow, so they are reduced
+  // modulo 255 once at the end rather than after every byte
+  //
+  sum1 = TELEMETRY_STATUS + ui8Seq;
+  sum2 = 2 * TELEMETRY_STATUS + ui8Seq;
+  pui8Src = (const uint8_t *)psStatus;
+  for (idx = 0; idx < TELEMETRY_STATUS_BYTES; idx++)
+  {
+    pui8Line[4 + idx] = pui8Src[idx];
+    sum1 += pui8Src[idx];
+    sum2 += sum1;
+  }
+  pui8Line[4 + TELEMETRY_STATUS_BYTES] = sum1 % 255;
+  pui8Line[5 + TELEMETRY_STATUS_BYTES] = sum2 % 255;
+  return TELEMETRY_LINE_BYTES;
+}
+
+//*****************************************************************************
+//
+// TelemetryFrame
+// Inputs:
+//   1. Display function
+//   2. Key frequency index
+//   3. Pattern index
+//   4. TELEMETRY_FLAG_KEY etc.
+// Outputs: None
+// Description:
+// Called once a display frame. When a record is due, fill it in from the
+// counters and queue it; when the console buffer has no room it is dropped
+// and counted, so this never waits on the UART.
+//
+//*****************************************************************************
+void
+TelemetryFrame(uint32_t ui32Function, uint32_t ui32FreqIdx,
+               uint32_t ui32PattIdx, uint32_t ui32Flags)
+{
+  tTelemetryStatus *psStatus;
+  uint32_t idx;
+
+  g_ui32TelemetryFrame++;
+  if (!g_ui32TelemetryPeriod || --g_ui32TelemetryCountdown)
+  {
+    return;
+  }
+  g_ui32TelemetryCountdown = g_ui32TelemetryPeriod;
+
+  psStatus = &g_sTelemetryStatus;
+  psStatus->ui32Frame = g_ui32TelemetryFrame;
+  for (idx = 0; idx < TELEMETRY_NUM_INTS; idx++)
+  {
+    psStatus->pui32Ints[idx] = g_pui32TelemetryInts[idx];
+  }
+  psStatus->ui32RowMissed = g_sTelemetryRender.psTask->ui32Missed;
+  psStatus->ui32AudioUnderruns = g_sTelemetryRefill.psTask->ui32Missed;
+  psStatus->ui32Faults = SchedFaults();
+  TelemetryTiming(&g_sTelemetryRender, &psStatus->ui16RenderMean,
+                  &psStatus->ui16RenderPeak);
+  TelemetryTiming(&g_sTelemetryRefill, &psStatus->ui16RefillMean,
+                  &psStatus->ui16RefillPeak);
+  psStatus->ui16KeyEvents = g_ui16TelemetryKeyEvents;
+  psStatus->ui16PattIdx = ui32PattIdx;
+  for (idx = 0; idx < TELEMETRY_KEYS; idx++)
+  {
+    psStatus->pui8Keys[idx] = g_pui8TelemetryKeys[idx];
+  }
+  psStatus->ui8Function = ui32Function;
+  psStatus->ui8FreqIdx = ui32FreqIdx;
+  psStatus->ui8Flags = ui32Flags;
+  psStatus->ui8Period = g_ui32TelemetryPeriod;
+  psStatus->ui16Dropped = g_ui16TelemetryDropped;
+  psStatus->ui16ConsoleDropped = g_ui32ConsoleDropped;
+
+  TelemetryEncode(psStatus, g_ui8TelemetrySeq, g_pui8TelemetryLine);
+  if (ConsoleWrite(g_pui8TelemetryLine, TELEMETRY_LINE_BYTES))
+  {
+    g_ui8TelemetrySeq++;
+  }
+  else
+  {
+    g_ui16TelemetryDropped++;
+  }
+}
@@ -0,0 +1,127 @@
+//*****************************************************************************
+//
+// telemetry.h - Binary status records sent over the UART console.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sched.h"
+#include "stream.h"
+
+//*****************************************************************************
+//
+// Once enabled, a status record is sent every TelemetrySetPeriod display
+// frames, queued with the console text on UART0 and framed like the frames
+// streamed in (stream.h):
+//
+//   STREAM_SYNC0 STREAM_SYNC1 type seq payload check_lo check_hi
+//
+// The check is the Fletcher-16 sum of type, seq and the payload, and seq
+// counts the records sent, so a gap in it means records lost on the line;
+// records dropped for want of room are counted in the next. Console
+// text is 7-bit ASCII, so a reader finds the records by their sync bytes
+// and takes everything else as text. Types have the top bit set, being
+// sent to the PC rather than from it.
+//
+// A PC turns telemetry on or off by streaming a STREAM_TELEMETRY frame,
+// whose payload is the period in frames, 0 for off. It is off at boot so
+// that the console stays plain text.
+//
+// A record is built from counters the interrupt handlers and tasks keep
+// anyway, so it takes the same time every frame, and is queued whole or
+// dropped and counted when the console buffer has no room: it never waits
+// on the UART. A record every frame is TELEMETRY_LINE_BYTES every 16ms,
+// under 4% of the line.
+//
+//*****************************************************************************
+#define TELEMETRY_STATUS        0x81
+
+//
+// Interrupt handlers counted
+//
+#define TELEMETRY_INT_PWM       0
+#define TELEMETRY_INT_SYSTICK   1
+#define TELEMETRY_INT_STREAM    2
+#define TELEMETRY_NUM_INTS      3
+
+//
+// Key events kept in a record, and the bit marking a press
+//
+#define TELEMETRY_KEYS          4
+#define TELEMETRY_KEY_DOWN      0x80
+
+//
+// State flags
+//
+#define TELEMETRY_FLAG_KEY      0x01    // a key is held
+#define TELEMETRY_FLAG_STREAM   0x02    // the stream has the display
+#define TELEMETRY_FLAG_PARKED   0x04    // display and PWM DAC parked
+#define TELEMETRY_FLAG_SONG     0x08    // a song is playing
+
+#define TELEMETRY_PERIOD_MAX    255
+
+//*****************************************************************************
+//
+// The TELEMETRY_STATUS payload, little-endian as on the wire. Every field
+// is at its natural alignment, so the structure has no padding on the
+// target or the host. Counts are since boot and wrap; cycle figures are for
+// the runs since the record before, and saturate at 0xFFFF.
+//
+//*****************************************************************************
+typedef struct
+{
+    uint32_t ui32Frame;             // display frames since boot
+    uint32_t pui32Ints[TELEMETRY_NUM_INTS]; // interrupt handler runs
+    uint32_t ui32RowMissed;         // rows not rendered by their boundary
+    uint32_t ui32AudioUnderruns;    // PWM DAC halves not refilled in time
+    uint32_t ui32Faults;            // overruns and missed deadlines, all tasks
+    uint16_t ui16RenderMean;        // row task cycles
+    uint16_t ui16RenderPeak;
+    uint16_t ui16RefillMean;        // audio task cycles
+    uint16_t ui16RefillPeak;
+    uint16_t ui16KeyEvents;         // presses and releases since boot
+    uint16_t ui16PattIdx;
+    uint8_t pui8Keys[TELEMETRY_KEYS]; // newest first, key | TELEMETRY_KEY_DOWN
+    uint8_t ui8Function;
+    uint8_t ui8FreqIdx;
+    uint8_t ui8Flags;               // TELEMETRY_FLAG_KEY etc.
+    uint8_t ui8Period;              // frames between records
+    uint16_t ui16Dropped;           // records with no room in the console
+    uint16_t ui16ConsoleDropped;    // bytes of console text dropped
+}
+tTelemetryStatus;
+
+#define TELEMETRY_STATUS_BYTES  52
+
+//
+// Bytes on the line per record
+//
+#define TELEMETRY_LINE_BYTES    (TELEMETRY_STATUS_BYTES + STREAM_OVERHEAD)
+
+//*****************************************************************************
+//
+// Interrupt handlers count their runs with TELEMETRY_INT, a single
+// increment.
+//
+//*****************************************************************************
+extern volatile uint32_t g_pui32TelemetryInts[TELEMETRY_NUM_INTS];
+
+#define TELEMETRY_INT(n)        (g_pui32TelemetryInts[n]++)
+
+extern void TelemetryInit(tSchedTask *psRender, tSchedTask *psRefill);
+extern void TelemetrySetPeriod(uint32_t ui32Frames);
+extern void TelemetryKey(uint32_t ui32Key, bool bDown);
+extern void TelemetryFrame(uint32_t ui32Function, uint32_t ui32FreqIdx,
+                           uint32_t ui32PattIdx, uint32_t ui32Flags);
+extern uint32_t TelemetryEncode(const tTelemetryStatus *psStatus,
+                                uint8_t ui8Seq, uint8_t *pui8Line);
+
+#endif // __TELEMETRY_H__
@@ -28,16 +28,21 @@
 // - XLAT    - PA6
 // - BLANK   - PA7
 // - TIMER1 peripheral (interrupt)
+// - ADC0 peripheral, only with SPECTRUM_ADC
+// - AIN9    - PE4
 //
-// The following UART signals are configured only for displaying console
-// messages for this program.
+// The following UART signals are configured for displaying console
+// messages and for receiving frames streamed from a PC.
 // - UART0 peripheral
 // - GPIO Port A peripheral (for UART0 pins)
 // - UART0RX - PA0
 // - UART0TX - PA1
+// - uDMA channel 8 (UART0 RX)
 //
 // This program uses the following interrupt handlers:
 // - Timer1IntHandler
+// - StreamIntHandler (UART0, uDMA receive)
+// - SysTickIntHandler, only while the display is parked
 //
 //*****************************************************************************
 
@@ -48,6 +53,7 @@
 #include "inc/hw_types.h"
 #include "inc/hw_gpio.h"
 #include "inc/hw_ssi.h"
+#include "driverlib/adc.h"
 #include "driverlib/debug.h"
 #include "driverlib/fpu.h"
 #include "driverlib/gpio.h"
@@ -56,14 +62,44 @@
 #include "driverlib/rom.h"
 #include "driverlib/ssi.h"
 #include "driverlib/sysctl.h"
+#include "driverlib/systick.h"
 #include "driverlib/timer.h"
 #include "driverlib/uart.h"
 #include "driverlib/udma.h"
 #include "utils/uartstdio.h"
+#include "trace.h"
+#include "latency.h"
+#include "composite.h"
+#include "draw.h"
+#include "font.h"
+#include "melody.h"
+#include "spectrum.h"
+#include "sched.h"
+#include "console.h"
+#include "boottime.h"
+#include "power.h"
+#include "bitboard.h"
+#include "stream.h"
+#include "transition.h"
+#include "scan.h"
+#include "palette.h"
+#include "envelope.h"
+#include "effect.h"
+#include "park.h"
+#include "gspack.h"
+#include "anim.h"
+#include "telemetry.h"
 
 //#define MODEL1 1
 #define MODEL2 2
 
+//
+// Define SPECTRUM_ADC to drive the spectrum display from an audio input on
+// AIN9 (PE4), sampled at the PWM DAC rate. Without it the display shows the
+// audio the box is playing.
+//
+//#define SPECTRUM_ADC 1
+
 // Model 1 vs Model 2 definitions
 
 #ifdef MODEL1
@@ -102,7 +138,7 @@
 #define BLUEIDX(colIdx) (colIdx+12+3*(colIdx&4))
 
 // Table to convert LED row value to GPIO pin number
-static uint32_t ledRowPin[8] = {
+static const uint32_t ledRowPin[8] = {
    GPIO_PIN_2,
    GPIO_PIN_3,
    GPIO_PIN_5,
@@ -156,7 +192,7 @@ static uint32_t ledRowPin[8] = {
 #define BLUEIDX(colIdx) (23-colIdx)
 
 // Table to convert LED row value to GPIO pin number
-static uint32_t ledRowPin[8] = {
+static const uint32_t ledRowPin[8] = {
    GPIO_PIN_7,
    GPIO_PIN_6,
    GPIO_PIN_5,
@@ -189,6 +225,21 @@ static uint32_t ledRowPin[8] = {
 //*****************************************************************************
 #define PWMDAC_PERIOD 2500
 
+//*****************************************************************************
+//
+// Grayscale SSI frames. By default each grayscale value is sent as one
+// 12-bit SSI frame, 32 a row, scaled by the power limiter's brightness in
+// PWMIntHandler as it goes. Built with GS_PACKED, the row task scales and
+// packs the row into 24 16-bit frames (gspack.h), which PWMIntHandler
+// sends in the first 24 interrupts of the grayscale cycle.
+//
+//*****************************************************************************
+#ifdef GS_PACKED
+#define GS_SSI_BITS 16
+#else
+#define GS_SSI_BITS 12
+#endif
+
 //*****************************************************************************
 //
 // Globals
@@ -196,7 +247,7 @@ static uint32_t ledRowPin[8] = {
 //*****************************************************************************
 
 // font table for ASCII values 32 to 127.
-extern char font8x8_basic[128-32][8];
+extern const char font8x8_basic[128-32][8];
 
 // Sine wave approximation function
 extern int32_t SineApprox(uint16_t phase, uint16_t scale);
@@ -204,18 +255,68 @@ extern int32_t SineApprox(uint16_t phase, uint16_t scale);
 // Bit indicating an new grayscale cycle should begin
 volatile uint32_t g_NewGSCycle;
 
-// Pointer to PWMDAC waveform table
-volatile uint32_t g_pwmDacValues[2*32];
+//
+// The 16-bit sample and grayscale buffers below are word aligned, so that
+// each half starts on a word: the compiler may merge accesses to a half
+// into LDRD, LDM or STM, which fault on an unaligned address.
+//
+
+// Pointer to PWMDAC waveform table. Match values are below PWMDAC_PERIOD so
+// they are stored as 16 bits.
+#ifdef __TI_ARM__
+#pragma DATA_ALIGN(g_pwmDacValues, 4)
+volatile uint16_t g_pwmDacValues[2*32];
+#else
+volatile uint16_t g_pwmDacValues[2*32] __attribute__((aligned(4)));
+#endif
 
 // The PWM chip allows for intensity values at a resolution of 1/4096 full scale.
 // Full scale is 4096.
 // This array holds values for the 8 RED LEDs followed by the 8 GREEN LEDs followed
-// by the 8 BLUE LEDs.
-volatile uint32_t g_gsValues[2*32];
+// by the 8 BLUE LEDs. Values are 12 bits so they are stored as 16 bits.
+#ifdef __TI_ARM__
+#pragma DATA_ALIGN(g_gsValues, 4)
+volatile uint16_t g_gsValues[2*32];
+#else
+volatile uint16_t g_gsValues[2*32] __attribute__((aligned(4)));
+#endif
 volatile uint8_t g_count16kHz;
 
-// LED row cyles from 0 to 7 as each LED row is refreshed
+#ifdef GS_PACKED
+// Each half of g_gsValues scaled and packed into 16-bit SSI frames
+#ifdef __TI_ARM__
+#pragma DATA_ALIGN(g_gsPacked, 4)
+volatile uint16_t g_gsPacked[2][GSPACK_ROW_WORDS];
+#else
+volatile uint16_t g_gsPacked[2][GSPACK_ROW_WORDS] __attribute__((aligned(4)));
+#endif
+#endif
+
+// LED current limiter. PWMIntHandler scales every grayscale value it sends
+// by its brightness.
+static tPowerLimiter g_sPower;
+
+#ifdef SPECTRUM_ADC
+// 12-bit audio input samples, double-buffered like the PWM DAC values
+#ifdef __TI_ARM__
+#pragma DATA_ALIGN(g_adcValues, 4)
+volatile uint16_t g_adcValues[2*32];
+#else
+volatile uint16_t g_adcValues[2*32] __attribute__((aligned(4)));
+#endif
+#endif
+
+// LED row lit in each grayscale cycle, as the scan plan gives them, and the
+// cycle's slot in the frame
 volatile uint8_t g_ledRow[2];
+volatile uint8_t g_ledSlot[2];
+
+// Row scan plan. Dark rows are skipped and lit rows get their slots.
+static tRowScan g_sScan;
+
+// Display and audio park state. While parked SysTick stands in for
+// PWMIntHandler.
+static tPark g_sPark;
 
 // Keyboard Row to scan
 uint8_t g_kbRow;
@@ -224,6 +325,11 @@ uint8_t g_kbRow;
 //
 // Data buffers
 //
+// The tables below never change and are declared const so the linker keeps
+// them in flash instead of copying them to SRAM at boot. At the 40 MHz system
+// clock flash runs with no wait states, so reading them costs no more than
+// reading SRAM.
+//
 //*****************************************************************************
 
 //
@@ -245,7 +351,7 @@ uint8_t g_kbRow;
 // Pixel index table for tracing a circle
 //
 #define CIRCLE_PATT_LEN 20
-static char circlePatt[CIRCLE_PATT_LEN] = {
+static const char circlePatt[CIRCLE_PATT_LEN] = {
    2,  3,  4,  5, 14, 23, 31, 39, 47, 54,
   61, 60, 59, 58, 49, 40, 32, 24, 16,  9
 };
@@ -255,7 +361,7 @@ static char circlePatt[CIRCLE_PATT_LEN] = {
 // Array of RBG colors
 //
 #define NUM_COLORS 4
-static uint32_t colors[NUM_COLORS] = {
+static const uint32_t colors[NUM_COLORS] = {
   0x0000FF,  // red
   0x00FF00,  // Green
   0xFF0000,  // Blue
@@ -275,7 +381,7 @@ static uint32_t colors[NUM_COLORS] = {
 //
 // Table to get different trace frequencies for pattern tracing
 //
-static uint32_t traceFreqMap[16] = {
+static const uint32_t traceFreqMap[16] = {
   80, 66, 54, 44,
   36, 29, 24, 20,
   16, 13, 11, 9,
@@ -287,7 +393,7 @@ static uint32_t traceFreqMap[16] = {
 // This is the phase increment every 16000Hz sample. Phase is 16 bits.
 // Frequency runs from 366Hz to 4883Hz.
 //
-static uint32_t toneFreqMap[16] = {
+static const uint32_t toneFreqMap[16] = {
   1500, 1783, 2119, 2518,
   2993, 3557, 4227, 5024,
   5791, 7097, 8434, 10024,
@@ -295,6 +401,7 @@ static uint32_t toneFreqMap[16] = {
 };
 
 
+
 //*****************************************************************************
 //
 // PWMIntHandler
@@ -309,6 +416,11 @@ static uint32_t toneFreqMap[16] = {
 void
 PWMIntHandler(void)
 {
+    uint32_t gsValue;
+#ifdef SPECTRUM_ADC
+    uint32_t adcSample;
+#endif
+
     //
     // Clear the timer interrupt.
     //
@@ -316,11 +428,25 @@ PWMIntHandler(void)
 
     // Increment index into 64-entry double-buffered values
     g_count16kHz = 0x3F & (g_count16kHz + 1);
+    TELEMETRY_INT(TELEMETRY_INT_PWM);
+    TRACE_TICK();
+    LATENCY_TICK();
 
     //
     // Write a new match event value from the table.
     //
     TimerMatchSet(TIMER_PWM_BASE, TIMER_A, g_pwmDacValues[g_count16kHz]);
+    TRACE(TRACE_MATCH, 0, g_pwmDacValues[g_count16kHz]);
+
+#ifdef SPECTRUM_ADC
+    //
+    // Store the input sample converted since the last interrupt and start
+    // the next conversion.
+    //
+    ROM_ADCSequenceDataGet(ADC0_BASE, 3, &adcSample);
+    g_adcValues[g_count16kHz] = adcSample;
+    ROM_ADCProcessorTrigger(ADC0_BASE, 3);
+#endif
 
     if ((g_count16kHz & 0x1F) == 0)
     {
@@ -331,27 +457,64 @@ PWMIntHandler(void)
       //
       // BLANK high
       ROM_GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_7, GPIO_PIN_7);
+      TRACE_PIN_WRITE(GPIO_PORTA_BASE, GPIO_PIN_7, GPIO_PIN_7);
       // Delay about 3 clocks
       SysCtlDelay(1);
       // XLAT high
       ROM_GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_6, GPIO_PIN_6);
+      TRACE_PIN_WRITE(GPIO_PORTA_BASE, GPIO_PIN_6, GPIO_PIN_6);
       // Delay about 3 clocks
       SysCtlDelay(1);
       // XLAT low
       ROM_GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_6, 0);
+      TRACE_PIN_WRITE(GPIO_PORTA_BASE, GPIO_PIN_6, 0);
       // Delay about 3 clocks
       SysCtlDelay(1);
       // BLANK low
       ROM_GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_7, 0);
+      TRACE_PIN_WRITE(GPIO_PORTA_BASE, GPIO_PIN_7, 0);
       // Enable LED row for this grayscale cycle
       ROM_GPIOPinWrite(GPIO_PORT_LEDROW_LO_BASE, GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3, ledRowPin[g_ledRow[g_count16kHz >> 5]]);
       ROM_GPIOPinWrite(GPIO_PORT_LEDROW_HI_BASE, GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7, ledRowPin[g_ledRow[g_count16kHz >> 5]]);
+      TRACE(TRACE_ROW, g_ledRow[g_count16kHz >> 5] | (g_ledSlot[g_count16kHz >> 5] << 3),
+            ledRowPin[g_ledRow[g_count16kHz >> 5]]);
+      LATENCY_XLAT(g_count16kHz);
       g_NewGSCycle = 1;
     }
 
-    // Output grayscale values to the SSI port
-    HWREG(SSI_GS_BASE + SSI_O_DR) = g_gsValues[g_count16kHz];
+#ifdef GS_PACKED
+    // Output the packed frames, already scaled, to the SSI port
+    if ((g_count16kHz & 0x1F) < GSPACK_ROW_WORDS)
+    {
+      gsValue = g_gsPacked[g_count16kHz >> 5][g_count16kHz & 0x1F];
+      HWREG(SSI_GS_BASE + SSI_O_DR) = gsValue;
+      TRACE(TRACE_SSI16, g_count16kHz, gsValue);
+    }
+#else
+    // Output grayscale values, scaled by the current limiter, to the SSI port
+    gsValue = (g_gsValues[g_count16kHz] * g_sPower.ui32Scale) >> POWER_SCALE_SHIFT;
+    HWREG(SSI_GS_BASE + SSI_O_DR) = gsValue;
+    TRACE(TRACE_SSI, g_count16kHz, gsValue);
+#endif
+
+}
 
+//*****************************************************************************
+//
+// The interrupt handler for SysTick.
+// SysTick runs only while the display is parked and PWMIntHandler stopped.
+// Every 2ms it moves the sample count on to the next grayscale cycle, as 32
+// PWM DAC interrupts would have, and starts the next row's tasks.
+//
+//*****************************************************************************
+void
+SysTickIntHandler(void)
+{
+    g_count16kHz = (g_count16kHz & 0x20) ^ 0x20;
+    TELEMETRY_INT(TELEMETRY_INT_SYSTICK);
+    TRACE_ADVANCE(32);
+    LATENCY_ADVANCE(32);
+    g_NewGSCycle = 1;
 }
 
 //*****************************************************************************
@@ -391,10 +554,11 @@ ConfigureSSI(void)
     //
     // Configure and enable the SSI port for SPI master mode.  Use SSI1,
     // system clock supply, idle clock level low and active low clock in
-    // freescale SPI mode, master mode, 1MHz SSI frequency, and 12-bit data.
+    // freescale SPI mode, master mode, 1MHz SSI frequency, and 12-bit data,
+    // or 16-bit with GS_PACKED.
     //
     ROM_SSIConfigSetExpClk(SSI_GS_BASE, SysCtlClockGet(), SSI_FRF_MOTO_MODE_0,
-                           SSI_MODE_MASTER, 1000000, 12);
+                           SSI_MODE_MASTER, 1000000, GS_SSI_BITS);
 
     //
     // Enable the SSI1 module.
@@ -438,7 +602,7 @@ ConfigureRowDriver(void)
 // Inputs: None
 // Outputs: None
 // Description:
-// Configure the UART and its pins.  This must be called before UARTprintf().
+// Configure the UART and its pins.  This must be called before ConsoleFlush().
 //
 //*****************************************************************************
 void
@@ -462,9 +626,9 @@ ConfigureUART(void)
     UARTClockSourceSet(UART0_BASE, UART_CLOCK_PIOSC);
 
     //
-    // Initialize the UART for console I/O.
+    // Initialize the UART for console I/O and the frame stream.
     //
-    UARTStdioConfig(0, 115200, 16000000);
+    UARTStdioConfig(0, STREAM_BAUD, 16000000);
 }
 
 //*****************************************************************************
@@ -573,6 +737,118 @@ ConfigurePWMDAC(void)
     ROM_TimerEnable(TIMER_PWM_BASE, TIMER_A);
 }
 
+//*****************************************************************************
+//
+// ConfigureParkTick
+// Inputs: None
+// Outputs: None
+// Description:
+// Set SysTick to interrupt once a grayscale cycle. It is started only while
+// the display is parked.
+//
+//*****************************************************************************
+void
+ConfigureParkTick(void)
+{
+    ROM_SysTickPeriodSet(GRAYSCALE_CYCLE);
+    ROM_SysTickIntEnable();
+}
+
+//*****************************************************************************
+//
+// ParkOutputs
+// Inputs: None
+// Outputs: None
+// Description:
+// Park the display and the PWM DAC once the grayscale and DAC buffers are
+// dark and silent: mask the PWM DAC timer's interrupt, blank the TLC5941s,
+// stop GSCLK and, once the last word is out, the SSI port, and turn the LED
+// rows and row driver off. SysTick takes over releasing the row tasks.
+//
+//*****************************************************************************
+void
+ParkOutputs(void)
+{
+    //
+    // Stop PWMIntHandler first so it cannot unblank. The timer keeps driving
+    // the pin at half duty, the midpoint the DAC rested at, so the output
+    // filter sees no step; a floating pin would drift with leakage instead.
+    //
+    ROM_TimerIntDisable(TIMER_PWM_BASE, TIMER_CAPA_EVENT);
+    TimerMatchSet(TIMER_PWM_BASE, TIMER_A, PWMDAC_PERIOD/2);
+
+    // BLANK high
+    ROM_GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_BLANK, GPIO_PIN_BLANK);
+    TRACE_PIN_WRITE(GPIO_PORTA_BASE, GPIO_PIN_BLANK, GPIO_PIN_BLANK);
+    ROM_TimerDisable(TIMER0_BASE, TIMER_GSCLK);
+    while (ROM_SSIBusy(SSI_GS_BASE))
+    {
+    }
+    ROM_SSIDisable(SSI_GS_BASE);
+
+    // Turn all rows and the row driver off
+    ROM_GPIOPinWrite(GPIO_PORT_LEDROW_LO_BASE, GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3, 0);
+    ROM_GPIOPinWrite(GPIO_PORT_LEDROW_HI_BASE, GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7, 0);
+    ROM_GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_4, 0);
+
+    ROM_SysTickEnable();
+}
+
+//*****************************************************************************
+//
+// ResumeOutputs
+// Inputs: None
+// Outputs: None
+// Description:
+// Undo ParkOutputs. BLANK stays high until PWMIntHandler's first latch,
+// a row later, which also lights the row.
+//
+//*****************************************************************************
+void
+ResumeOutputs(void)
+{
+    ROM_SysTickDisable();
+
+    ROM_GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_4, GPIO_PIN_4);
+    ROM_SSIEnable(SSI_GS_BASE);
+    ROM_TimerEnable(TIMER0_BASE, TIMER_GSCLK);
+
+    ROM_TimerIntClear(TIMER_PWM_BASE, TIMER_CAPA_EVENT);
+    ROM_TimerIntEnable(TIMER_PWM_BASE, TIMER_CAPA_EVENT);
+}
+
+#ifdef SPECTRUM_ADC
+//*****************************************************************************
+//
+// ConfigureADC
+// Inputs: None
+// Outputs: None
+// Description:
+// Configure ADC0 sequencer 3 to convert AIN9 on pin PE4 when PWMIntHandler
+// triggers it.
+//
+//*****************************************************************************
+void
+ConfigureADC(void)
+{
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_ADC0);
+    ROM_GPIOPinTypeADC(GPIO_PORTE_BASE, GPIO_PIN_4);
+
+    //
+    // One step sequence, converted on a processor trigger
+    //
+    ROM_ADCSequenceConfigure(ADC0_BASE, 3, ADC_TRIGGER_PROCESSOR, 0);
+    ROM_ADCSequenceStepConfigure(ADC0_BASE, 3, 0,
+                                 ADC_CTL_CH9 | ADC_CTL_IE | ADC_CTL_END);
+    ROM_ADCSequenceEnable(ADC0_BASE, 3);
+
+    //
+    // Start the first conversion
+    //
+    ROM_ADCProcessorTrigger(ADC0_BASE, 3);
+}
+#endif
+
 //*****************************************************************************
 //
 // ConfigureKeybdScan
@@ -609,6 +885,15 @@ ConfigureKeybdScan(void)
     GPIOPadConfigSet(GPIO_PORT_KBHI_BASE, GPIO_PIN_KB2 | GPIO_PIN_KB3, GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD_WPD);
 }
 
+//*****************************************************************************
+//
+// Dot correction for every output, 0 to 63, and two of them packed into one
+// 12-bit SSI word
+//
+//*****************************************************************************
+#define DOT_CORRECTION      8
+#define DOT_CORRECTION_PAIR ((DOT_CORRECTION << 6) | DOT_CORRECTION)
+
 //*****************************************************************************
 //
 // WriteDotCorrection
@@ -623,7 +908,10 @@ ConfigureKeybdScan(void)
 void
 WriteDotCorrection(void)
 {
-    uint32_t ticks;
+#ifdef GS_PACKED
+    uint16_t dcValues[16], dcPacked[12];
+    uint32_t idx;
+#endif
 
     //
     // Set mode high for Dot Correction write
@@ -638,37 +926,53 @@ WriteDotCorrection(void)
     // port is set for 12-bit data, these values are output 2 at a time.
     // A 6-bit word, N, sets the output current to Imax * N/63.
     // We only use 12 outputs per chip to distribute power dissipation.
-    // Set current to 1/8 max by writing 8 packed words of 0x208.
+    // Set current to 1/8 max by writing 8 packed words of DOT_CORRECTION
+    // pairs.
     //
 
+#ifdef GS_PACKED
+    //
+    // With 16-bit frames the 16 pairs go as 12 frames, packed as grayscale
+    // rows are
+    //
+    for (idx = 0; idx < 16; idx++)
+    {
+        dcValues[idx] = DOT_CORRECTION_PAIR;
+    }
+    GsPack(dcValues, 16, POWER_SCALE_FULL, dcPacked);
+    for (idx = 0; idx < 12; idx++)
+    {
+        ROM_SSIDataPut(SSI_GS_BASE, dcPacked[idx]);
+    }
+#else
     // Write values for 2nd TLC5941 in daisy-chain
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
     // Write values for 1st TLC5941 in daisy-chain
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
-    ROM_SSIDataPut(SSI_GS_BASE, 0x208);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+    ROM_SSIDataPut(SSI_GS_BASE, DOT_CORRECTION_PAIR);
+#endif
 
     //
     // Wait until SSI1 is done transferring all the data in the transmit FIFO.
+    // SSIBusy stays set until the last bit has been shifted out, so XLAT
+    // can follow at once.
     //
     while(ROM_SSIBusy(SSI_GS_BASE))
     {
     }
-    // Wait 10us to make sure serial data transfer is done
-    ticks = (SysCtlClockGet() / 3) / 100000;
-    SysCtlDelay(ticks);
 
     //
     // Pulse XLAT high, then low. Minimum high is 20ns. With max of 80MHz clock
@@ -700,14 +1004,14 @@ WriteDotCorrection(void)
 #define ABC_PATT_LEN 26
 
 void
-RenderCharacter(char charAddr, char fontTable[128-32][8], uint8_t row, uint32_t color, \
-                uint32_t* gsValues)
+RenderCharacter(char charAddr, const char fontTable[][8], uint8_t row, uint32_t color, \
+                uint16_t* gsValues)
 {
 
   char bitmap;
   uint32_t colIdx;
 
-  bitmap = fontTable[charAddr][row];
+  bitmap = fontTable[(uint8_t)charAddr][row];
   for (colIdx = 0; colIdx < 8; colIdx++)
   {
     // RED grayscale values
@@ -734,7 +1038,7 @@ RenderCharacter(char charAddr, char fontTable[128-32][8], uint8_t row, uint32_t
 //
 //*****************************************************************************
 void
-RenderPixel(uint32_t pixelIdx, uint32_t row, uint32_t color, uint32_t* gsValues)
+RenderPixel(uint32_t pixelIdx, uint32_t row, uint32_t color, uint16_t* gsValues)
 {
   // Turn on the one pixel indicated by pixelIdx
 
@@ -763,33 +1067,176 @@ RenderPixel(uint32_t pixelIdx, uint32_t row, uint32_t color, uint32_t* gsValues)
 // Description:
 // Turn on pixels from beginning to end in each row one at a time until all
 // pixels are on. Then turn them off from end to beginning. Repeat with a
-// different color. pattIdx determines what to turn on or off and what color
-// to use.
+// different color. pattIdx determines which columns are on and what color
+// to use, so every row is rendered in full whatever the buffer held before.
 //
 //*****************************************************************************
 #define DOMINO_PATT_LEN 48
 void
-RenderDomino(uint32_t pattIdx, uint32_t* gsValues)
+RenderDomino(uint32_t pattIdx, uint16_t* gsValues)
 {
   uint32_t colorIdx;
   uint32_t colIdx;
+  uint32_t onCols;
+  uint32_t color;
 
   colorIdx = pattIdx >> 4;
-  if (pattIdx & 0x8)
+  // Columns on: one more each step, then one fewer from the end
+  onCols = (pattIdx & 0x8) ? 7 - (pattIdx & 0x7) : (pattIdx & 0x7) + 1;
+  for (colIdx = 0; colIdx < 8; colIdx++)
+  {
+    color = (colIdx < onCols) ? colors[colorIdx] : 0;
+    gsValues[REDIDX(colIdx)] = (color&0xFF) << 4;
+    gsValues[GREENIDX(colIdx)] = (color&0xFF00) >> 4;
+    gsValues[BLUEIDX(colIdx)] = (color&0xFF0000) >> 12;
+  }
+}
+
+//*****************************************************************************
+//
+// RenderRGBRow
+// Inputs:
+//   1. 12-bit R, G and B values for each column of the row
+//   2. Pointer to grayscale code output buffer
+// Outputs: None
+// Description:
+// Copy one composited row into the grayscale buffer, mapping each column
+// and color to its TLC5941 output.
+//
+//*****************************************************************************
+void
+RenderRGBRow(uint16_t rgbValues[8][3], uint16_t* gsValues)
+{
+  uint32_t colIdx;
+
+  for (colIdx = 0; colIdx < 8; colIdx++)
+  {
+    gsValues[REDIDX(colIdx)] = rgbValues[colIdx][0];
+    gsValues[GREENIDX(colIdx)] = rgbValues[colIdx][1];
+    gsValues[BLUEIDX(colIdx)] = rgbValues[colIdx][2];
+  }
+}
+
+//*****************************************************************************
+//
+// RenderBitboardRow
+// Inputs:
+//   1. Monochrome 8x8 plane
+//   2. Current LED row being scanned
+//   3. Color to output
+//   4. Pointer to grayscale code output buffer
+// Outputs: None
+// Description:
+// Construct grayscale values for one row of a bitboard in one color. The
+// row byte is expanded through bitboardLanes a nibble at a time: the four
+// outputs of a nibble's columns sit next to each other in the grayscale
+// buffer, starting on a word boundary, in column order or reversed (see
+// REDIDX etc.). Each lookup gives the two words that enable the outputs of
+// the columns set, which mask a pair of the color's channel values. Entry
+// n is for outputs in column order, entry 16 + n for reversed order. The
+// masked words are stored a half at a time, as the buffer is declared,
+// which the compiler merges back into word stores.
+//
+//*****************************************************************************
+static const uint32_t bitboardLanes[32][2] = {
+  { 0x00000000, 0x00000000 }, { 0x0000FFFF, 0x00000000 },
+  { 0xFFFF0000, 0x00000000 }, { 0xFFFFFFFF, 0x00000000 },
+  { 0x00000000, 0x0000FFFF }, { 0x0000FFFF, 0x0000FFFF },
+  { 0xFFFF0000, 0x0000FFFF }, { 0xFFFFFFFF, 0x0000FFFF },
+  { 0x00000000, 0xFFFF0000 }, { 0x0000FFFF, 0xFFFF0000 },
+  { 0xFFFF0000, 0xFFFF0000 }, { 0xFFFFFFFF, 0xFFFF0000 },
+  { 0x00000000, 0xFFFFFFFF }, { 0x0000FFFF, 0xFFFFFFFF },
+  { 0xFFFF0000, 0xFFFFFFFF }, { 0xFFFFFFFF, 0xFFFFFFFF },
+  { 0x00000000, 0x00000000 }, { 0x00000000, 0xFFFF0000 },
+  { 0x00000000, 0x0000FFFF }, { 0x00000000, 0xFFFFFFFF },
+  { 0xFFFF0000, 0x00000000 }, { 0xFFFF0000, 0xFFFF0000 },
+  { 0xFFFF0000, 0x0000FFFF }, { 0xFFFF0000, 0xFFFFFFFF },
+  { 0x0000FFFF, 0x00000000 }, { 0x0000FFFF, 0xFFFF0000 },
+  { 0x0000FFFF, 0x0000FFFF }, { 0x0000FFFF, 0xFFFFFFFF },
+  { 0xFFFFFFFF, 0x00000000 }, { 0xFFFFFFFF, 0xFFFF0000 },
+  { 0xFFFFFFFF, 0x0000FFFF }, { 0xFFFFFFFF, 0xFFFFFFFF }
+};
+
+static void
+RenderNibble(uint16_t* gsValues, uint32_t idxFirst, uint32_t idxLast,
+             uint32_t nibble, uint32_t pair)
+{
+  const uint32_t *lanes;
+  uint32_t lo, hi;
+
+  if (idxFirst < idxLast)
   {
-    // Turn off next column
-    colIdx = 7 - (pattIdx & 0x7);
-    gsValues[REDIDX(colIdx)] = 0;
-    gsValues[GREENIDX(colIdx)] = 0;
-    gsValues[BLUEIDX(colIdx)] = 0;
+    lanes = bitboardLanes[nibble];
+    gsValues += idxFirst;
   }
   else
   {
-    // Turn on next column
-    colIdx = pattIdx & 0x7;
-    gsValues[REDIDX(colIdx)] = (colors[colorIdx]&0xFF) << 4;
-    gsValues[GREENIDX(colIdx)] = (colors[colorIdx]&0xFF00) >> 4;
-    gsValues[BLUEIDX(colIdx)] = (colors[colorIdx]&0xFF0000) >> 12;
+    lanes = bitboardLanes[16 + nibble];
+    gsValues += idxLast;
+  }
+  lo = lanes[0] & pair;
+  hi = lanes[1] & pair;
+  gsValues[0] = lo;
+  gsValues[1] = lo >> 16;
+  gsValues[2] = hi;
+  gsValues[3] = hi >> 16;
+}
+
+void
+RenderBitboardRow(tBitboard board, uint32_t row, uint32_t color,
+                  uint16_t* gsValues)
+{
+  uint32_t bits, pair;
+
+  bits = BB_ROW(board, row);
+
+  pair = (color&0xFF) << 4;
+  pair |= pair << 16;
+  RenderNibble(gsValues, REDIDX(0), REDIDX(3), bits & 0xF, pair);
+  RenderNibble(gsValues, REDIDX(4), REDIDX(7), bits >> 4, pair);
+
+  pair = (color&0xFF00) >> 4;
+  pair |= pair << 16;
+  RenderNibble(gsValues, GREENIDX(0), GREENIDX(3), bits & 0xF, pair);
+  RenderNibble(gsValues, GREENIDX(4), GREENIDX(7), bits >> 4, pair);
+
+  pair = (color&0xFF0000) >> 12;
+  pair |= pair << 16;
+  RenderNibble(gsValues, BLUEIDX(0), BLUEIDX(3), bits & 0xF, pair);
+  RenderNibble(gsValues, BLUEIDX(4), BLUEIDX(7), bits >> 4, pair);
+}
+
+//*****************************************************************************
+//
+// RenderPaletteRow
+// Inputs:
+//   1. Palette-indexed frame
+//   2. Palette of 12-bit colors
+//   3. Current LED row being scanned
+//   4. Pointer to grayscale code output buffer
+// Outputs: None
+// Description:
+// Construct grayscale values for one row of a palette frame: each pixel's
+// entry is looked up and its channels, already expanded, copied to the
+// column's outputs.
+//
+//*****************************************************************************
+void
+RenderPaletteRow(const tPaletteFrame* frame, const tPalette* palette,
+                 uint32_t row, uint16_t* gsValues)
+{
+  const uint16_t* rgb;
+  uint32_t pixels;
+  uint32_t colIdx;
+
+  pixels = frame->pui32Row[row];
+  for (colIdx = 0; colIdx < 8; colIdx++)
+  {
+    rgb = palette->ppui16RGB[pixels & 0xF];
+    gsValues[REDIDX(colIdx)] = rgb[0];
+    gsValues[GREENIDX(colIdx)] = rgb[1];
+    gsValues[BLUEIDX(colIdx)] = rgb[2];
+    pixels >>= 4;
   }
 }
 
@@ -850,93 +1297,865 @@ KeybdRead(void)
       keyCode |= 16;
     }
   }
+  TRACE(TRACE_KEY, 0, keyCode);
   return(keyCode);
 }
 
 //*****************************************************************************
 //
-// main
+// FillSineHalf
+// Inputs:
+//   1. Pointer to the half of the PWM DAC buffer to fill
+//   2. Pointer to the current sine phase, advanced by 32 samples
+//   3. Phase increment every 16kHz sample
+//   4. Envelope of the tone
+// Outputs: None
+// Description:
+// Fill one 32-sample half of the PWM DAC buffer with sine wave values,
+// their amplitude ramped along the envelope, or with the midpoint once the
+// envelope is idle.
 //
 //*****************************************************************************
-int
-main(void)
+void
+FillSineHalf(uint16_t* dacValues, uint16_t* sinePhase, uint16_t sineFreq,
+             tEnvelope* envelope)
 {
   uint32_t idx;
-  uint32_t idleCount;
-  uint8_t displayChar;
-  uint32_t gsCycleCount;
-  uint8_t keyCode, keyPressed, keyValue;
-  uint32_t debounceCount;
-  uint32_t pixelIdx, pattIdx;
-  uint32_t freqIdx;
-  uint8_t ledRow;
-  uint8_t gsIdx;
-  uint32_t* gsPtr;
-  // Current phase of sinewave, 0 to 65535
-  uint16_t sinePhase;
-  // Frequency of sine wave = phase increment every 16kHz sample
-  uint16_t sineFreq;
-  uint8_t function;
+  uint16_t phase;
+  int32_t amplitude, step;
 
+  if (!EnvelopeActive(envelope))
+  {
+    for (idx = 0; idx < 32; idx++)
+    {
+      dacValues[idx] = PWMDAC_PERIOD/2;
+    }
+    return;
+  }
 
-    //
-    // Enable lazy stacking for interrupt handlers.  This allows floating-point
-    // instructions to be used within interrupt handlers, but at the expense of
-    // extra stack usage.
-    //
-    ROM_FPULazyStackingEnable();
+  phase = *sinePhase;
+  amplitude = EnvelopeRamp(envelope, 32, 0.45*PWMDAC_PERIOD, &step);
+  for (idx = 0; idx < 32; idx++)
+  {
+    dacValues[idx] = 0.5*PWMDAC_PERIOD +
+                     SineApprox(phase, amplitude >> ENVELOPE_LEVEL_SHIFT);
+    phase += sineFreq;
+    amplitude += step;
+  }
+  *sinePhase = phase;
+}
 
-    //
-    // Set the system clock to run at 40Mhz off PLL with external crystal as
-    // reference.
-    //
-    ROM_SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_XTAL_16MHZ |
-                       SYSCTL_OSC_MAIN);
+//*****************************************************************************
+//
+// ClearOutputHalf
+// Inputs:
+//   1. Pointer to the half of the grayscale buffer to clear
+//   2. Pointer to the half of the PWM DAC buffer to clear
+// Outputs: None
+// Description:
+// Output 0s to one half of the grayscale buffer and rest one half of the
+// PWM DAC buffer at its midpoint, where every tone starts and ends. The
+// values are stored as 16 bits, as they are declared, two at a time; the
+// buffer halves are word aligned, so the compiler merges each pair into a
+// word store.
+//
+//*****************************************************************************
+void
+ClearOutputHalf(uint16_t* gsValues, uint16_t* dacValues)
+{
+  uint32_t idx;
 
-    ROM_IntMasterDisable();
+  for (idx = 0; idx < 32; idx += 2)
+  {
+    gsValues[idx] = 0;
+    gsValues[idx + 1] = 0;
+    dacValues[idx] = PWMDAC_PERIOD/2;
+    dacValues[idx + 1] = PWMDAC_PERIOD/2;
+  }
+}
 
-    /*********************
-     * ENABLE GPIO PORTS *
-     *********************/
-    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
-    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOB);
-    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOC);
-    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOD);
-    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
-    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOF);
+//*****************************************************************************
+//
+// Main loop state. Kept at file scope so that it can be shared by the
+// scheduler tasks.
+//
+//*****************************************************************************
+static uint8_t keyPressed, keyValue;
+static uint32_t debounceCount;
+static uint32_t pixelIdx, pattIdx;
+static uint32_t freqIdx;
+static uint8_t ledRow;
+// Grayscale and PWM DAC buffer half being filled for ledRow
+static uint8_t gsIdx;
+static uint16_t* gsPtr;
+// Dark row rendered off screen, for the scan plan, aligned as g_gsValues
+#ifdef __TI_ARM__
+#pragma DATA_ALIGN(g_gsProbe, 4)
+static uint16_t g_gsProbe[32];
+#else
+static uint16_t g_gsProbe[32] __attribute__((aligned(4)));
+#endif
+// Current phase of sinewave, 0 to 65535
+static uint16_t sinePhase;
+// Frequency of sine wave = phase increment every 16kHz sample
+static uint16_t sineFreq;
 
-    //
-    // Set up the serial console to use for displaying messages.
-    //
-    ConfigureUART();
+//
+// Envelope of the keypad tone: a 5ms attack, a 50ms decay to 7/8 and a
+// 50ms release, in 16kHz samples
+//
+static const tEnvelopeShape g_sToneShape = { 80, 800, 224, 800 };
+static tEnvelope g_sToneEnvelope;
+static uint8_t function;
 
-    //
-    // Enable the GPIO pins for TLC5941 control (PA5 - PA7).
-    //
-    ROM_GPIOPinTypeGPIOOutput(GPIO_PORTA_BASE, GPIO_PIN_MODE | GPIO_PIN_XLAT | GPIO_PIN_BLANK);
+//
+// Display functions selected in turn by each key release
+//
+#define FUNCTION_LETTERS 0
+#define FUNCTION_DOMINO  1
+#define FUNCTION_LAYERS  2
+#define FUNCTION_SCROLL  3
+#define FUNCTION_SPECTRUM 4
+#define FUNCTION_LIFE    5
+#define FUNCTION_PIXEL   6
+#define FUNCTION_PALETTE 7
+#define FUNCTION_EFFECT  8
+#define FUNCTION_ANIM    9
+#define NUM_FUNCTIONS    10
 
-    //
-    // Set MODE high, set XLAT low and set BLANK high).
-    //
-    ROM_GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_MODE, GPIO_PIN_MODE);
+//
+// Scrolling text for FUNCTION_SCROLL, UTF-8 encoded, and the 8x8 window of
+// it that is on the display
+//
+static const char scrollText[] =
+  "IdiotBox \xE2\x99\xA5 Gr\xC3\xBC\xC3\x9F""e \xC3\xA0 tous \xE2\x98\x85 "
+  "\xC2\xA1Ol\xC3\xA9! \xE2\x99\xAA";
+static tFontScroll g_sScroll;
+static char g_pcScrollWindow[1][8];
+
+//
+// Live cells for FUNCTION_LIFE, seeded with the letter of the key pressed
+//
+static tBitboard g_lifeBoard;
+#define LIFE_GENERATIONS 64
+
+//
+// Rings around the center for FUNCTION_PALETTE, drawn once in entries 1 to
+// 15 and animated by cycling the hue wheel through them. The wheel is
+// faded in over PALETTE_FADE_STEPS steps from each key press.
+//
+static tPaletteFrame g_sPaletteFrame;
+static tPalette g_sPaletteWheel;
+static tPalette g_sPalette;
+#define PALETTE_FADE_STEPS 16
+static const uint32_t paletteWheel[PALETTE_ENTRIES - 1] = {
+  0x0000FF, 0x0033CC, 0x006699, 0x009966, 0x00CC33,
+  0x00FF00, 0x33CC00, 0x669900, 0x996600, 0xCC3300,
+  0xFF0000, 0xCC0033, 0x990066, 0x660099, 0x3300CC
+};
+
+//
+// Procedural effect for FUNCTION_EFFECT, chosen by the key pressed
+//
+static tEffect g_sEffect;
+
+//
+// Sample animation for FUNCTION_ANIM, chosen by the key pressed and played
+// from flash a frame at a time
+//
+static tAnimPlayer g_sAnimPlayer;
+static tPaletteFrame g_sAnimFrame;
+static tPalette g_sAnimPalette;
+
+//
+// Spectrum analyser for FUNCTION_SPECTRUM
+//
+static tSpectrum g_sSpectrum;
+
+//
+// Transitions between letters, and the fade to black when a key press
+// expires
+//
+static tTransition g_sTransition;
+
+//*****************************************************************************
+//
+// Layers for the composited display function, bottom first
+//
+//*****************************************************************************
+#define LAYER_BACKGROUND 0
+#define LAYER_SPRITE     1
+#define LAYER_TEXT       2
+#define NUM_LAYERS       3
+static tLayer g_psLayers[NUM_LAYERS];
+
+//*****************************************************************************
+//
+// UpdateLayers
+// Inputs:
+//   1. Pattern index, 0 to CIRCLE_PATT_LEN - 1
+// Outputs: None
+// Description:
+// Redraw the layers for one step of the layered pattern: dim color bands
+// that scroll down the background, a pixel tracing a circle added on top
+// and a letter blended over both.
+//
+//*****************************************************************************
+void
+UpdateLayers(uint32_t pattIdx)
+{
+  int32_t row;
+
+  //
+  // Two-row bands, a row further on each pattern step; on odd steps the
+  // first band starts above the display and is clipped
+  //
+  LayerClear(&g_psLayers[LAYER_BACKGROUND]);
+  for (row = -(int32_t)(pattIdx & 1); row < 8; row += 2)
+  {
+    DrawFillRect(&g_psLayers[LAYER_BACKGROUND], row, 0, row + 1, 7,
+                 colors[((row + pattIdx) >> 1) % NUM_COLORS]);
+  }
+  g_psLayers[LAYER_BACKGROUND].ui8Mode = LAYER_BLEND_ADD;
+  g_psLayers[LAYER_BACKGROUND].ui16Opacity = LAYER_OPAQUE / 8;
+  g_psLayers[LAYER_BACKGROUND].ui8Enabled = 1;
+
+  LayerClear(&g_psLayers[LAYER_SPRITE]);
+  LayerSetPixel(&g_psLayers[LAYER_SPRITE], (circlePatt[pattIdx] >> 3) & 0x7,
+                circlePatt[pattIdx] & 0x7, colors[3]);
+  g_psLayers[LAYER_SPRITE].ui8Mode = LAYER_BLEND_ADD;
+  g_psLayers[LAYER_SPRITE].ui16Opacity = LAYER_OPAQUE;
+  g_psLayers[LAYER_SPRITE].ui8Enabled = 1;
+
+  LayerClear(&g_psLayers[LAYER_TEXT]);
+  LayerDrawBitmap(&g_psLayers[LAYER_TEXT], font8x8_basic['I' - ' '],
+                  colors[2]);
+  g_psLayers[LAYER_TEXT].ui8Mode = LAYER_BLEND_ALPHA;
+  g_psLayers[LAYER_TEXT].ui16Opacity = 3 * LAYER_OPAQUE / 4;
+  g_psLayers[LAYER_TEXT].ui8Enabled = 1;
+}
+
+//*****************************************************************************
+//
+// Scheduler tasks, in the order of the task table at the end of this
+// section
+//
+//*****************************************************************************
+#define TASK_ROW         0
+#define TASK_AUDIO       1
+#define TASK_KEYPAD      2
+#define TASK_FRAME       3
+#define TASK_STREAM      4
+#define TASK_PARK        5
+#define TASK_PATTERN     6
+#define TASK_TELEMETRY   7
+#define TASK_CONSOLE     8
+#define NUM_TASKS        9
+
+static tSchedTask g_psTasks[NUM_TASKS];
+
+//*****************************************************************************
+//
+// TaskKeypad
+// Inputs: None
+// Outputs: None
+// Description:
+// Read and debounce the keypad. A new press of a song key starts its song
+// and each release, once debounced, selects the next display function.
+//
+//*****************************************************************************
+static void
+TaskKeypad(void)
+{
+  uint8_t keyCode;
+
+  keyCode = KeybdRead();
+  if (keyCode & 0x10)
+  {
+    if (!keyPressed)
+    {
+      LATENCY_SCAN();
+      TelemetryKey(keyCode & 0xF, true);
+
+      //
+      // A press shows at once, cutting short a fade out
+      //
+      TransitionCancel(&g_sTransition);
+
+      //
+      // A new press of one of the song keys starts its song
+      //
+      if ((keyCode & 0xF) >= MELODY_FIRST_KEY)
+      {
+        MelodyStart(g_ppui8Songs[(keyCode & 0xF) - MELODY_FIRST_KEY]);
+      }
+    }
+    debounceCount = 50;
+    keyPressed = 1;
+    keyValue = keyCode & 0xF;
+
+    // Select new pattern-trace frequency.
+    freqIdx = keyValue;
+
+    // Select new tone frequency
+    sineFreq = toneFreqMap[freqIdx];
+  }
+  if (debounceCount)
+  {
+    debounceCount--;
+    if (debounceCount == 0)
+    {
+      keyPressed = 0;
+      TelemetryKey(keyValue, false);
+      function = (function + 1 >= NUM_FUNCTIONS) ? 0 : function + 1;
+      TransitionStart(&g_sTransition, TRANSITION_CROSSFADE,
+                      TRANSITION_FRAMES);
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// TaskFrame
+// Inputs: None
+// Outputs: None
+// Description:
+// Run in the last row of a frame. Set the brightness for the next frame
+// from the current this one drew, show the newest streamed frame and
+// advance a transition, then prepare the next frame: the scrolling text
+// window, the layers of the composited display, a new seed for Life, the
+// hue wheel for the palette display, the key's procedural effect or the
+// next frame of the key's animation.
+//
+//*****************************************************************************
+static void
+TaskFrame(void)
+{
+  uint32_t idx;
+
+  PowerFrame(&g_sPower);
+  StreamFrame();
+  TransitionFrame(&g_sTransition);
+
+  if (!keyPressed)
+  {
+    return;
+  }
+  if (function == FUNCTION_SCROLL)
+  {
+    FontScrollRender(&g_sScroll, g_pcScrollWindow[0]);
+  }
+  else if (function == FUNCTION_LAYERS)
+  {
+    UpdateLayers(pattIdx);
+  }
+  else if ((function == FUNCTION_LIFE) && (pattIdx == 0))
+  {
+    g_lifeBoard = BitboardFromGlyph(font8x8_basic['A' + keyValue - ' ']);
+    pattIdx = 1;
+  }
+  else if ((function == FUNCTION_PALETTE) && (pattIdx == 0))
+  {
+    PaletteSetColor(&g_sPaletteWheel, 0, 0);
+    for (idx = 1; idx < PALETTE_ENTRIES; idx++)
+    {
+      PaletteSetColor(&g_sPaletteWheel, idx, paletteWheel[idx - 1]);
+    }
+    PaletteFade(&g_sPalette, &g_sPaletteWheel, 0);
+    pattIdx = 1;
+  }
+  else if ((function == FUNCTION_EFFECT) && (pattIdx == 0))
+  {
+    EffectInit(&g_sEffect, keyValue % EFFECT_NUM_TYPES,
+               0x9E3779B9 * (keyValue + 1));
+    pattIdx = 1;
+  }
+  else if (function == FUNCTION_ANIM)
+  {
+    if (pattIdx == 0)
+    {
+      AnimStart(&g_sAnimPlayer, g_ppsAnims[keyValue % g_ui32NumAnims],
+                &g_sAnimFrame, &g_sAnimPalette);
+      pattIdx = 1;
+    }
+    else
+    {
+      AnimFrame(&g_sAnimPlayer, &g_sAnimFrame);
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// RenderRow
+// Inputs:
+//   1. LED row
+//   2. Pointer to grayscale code output buffer
+// Outputs: None
+// Description:
+// Render an LED row of the streamed frame or the display function, dark
+// when no key is pressed, and blend it into a running transition. Writes
+// only the buffer, so a row can also be rendered just to see whether it is
+// lit; TaskRow records the row it shows with TransitionShown.
+//
+//*****************************************************************************
+static void
+RenderRow(uint32_t row, uint16_t *gsValues)
+{
+  uint8_t displayChar;
+  uint16_t rgbValues[8][3];
+  uint32_t idx;
+
+  if (StreamActive())
+  {
+    //
+    // A PC streaming frames has the display. The keypad still plays.
+    //
+    StreamRow(row, rgbValues);
+    RenderRGBRow(rgbValues, gsValues);
+  }
+  else if (!keyPressed)
+  {
+    for (idx = 0; idx < 32; idx++)
+    {
+      gsValues[idx] = 0;
+    }
+  }
+  else if (function == FUNCTION_LETTERS)
+  {
+    displayChar = pattIdx + 'A';
+    RenderCharacter(displayChar - ' ', font8x8_basic, row, colors[0],
+                    gsValues);
+  }
+  else if (function == FUNCTION_DOMINO)
+  {
+    RenderDomino(pattIdx, gsValues);
+  }
+  else if (function == FUNCTION_SCROLL)
+  {
+    RenderCharacter(0, g_pcScrollWindow, row, colors[3], gsValues);
+  }
+  else if (function == FUNCTION_SPECTRUM)
+  {
+    SpectrumRow(&g_sSpectrum, row, rgbValues);
+    RenderRGBRow(rgbValues, gsValues);
+  }
+  else if (function == FUNCTION_LIFE)
+  {
+    RenderBitboardRow(g_lifeBoard, row, colors[1], gsValues);
+  }
+  else if (function == FUNCTION_PIXEL)
+  {
+    RenderPixel(pixelIdx, row, colors[2], gsValues);
+  }
+  else if (function == FUNCTION_PALETTE)
+  {
+    RenderPaletteRow(&g_sPaletteFrame, &g_sPalette, row, gsValues);
+  }
+  else if (function == FUNCTION_EFFECT)
+  {
+    EffectRow(&g_sEffect, row, rgbValues);
+    RenderRGBRow(rgbValues, gsValues);
+  }
+  else if (function == FUNCTION_ANIM)
+  {
+    RenderPaletteRow(&g_sAnimFrame, &g_sAnimPalette, row, gsValues);
+  }
+  else
+  {
+    CompositeRow(g_psLayers, NUM_LAYERS, row, rgbValues);
+    RenderRGBRow(rgbValues, gsValues);
+  }
+
+  TransitionRow(&g_sTransition, row, gsValues);
+}
+
+//*****************************************************************************
+//
+// TaskRow
+// Inputs: None
+// Outputs: None
+// Description:
+// Render the next LED row into its grayscale buffer half, blanking the PWM
+// DAC half as well when no key is pressed, and keep it as shown for
+// transitions. Scale it for its slots in the scan plan and account for its
+// current in its slot. With GS_PACKED, pack
+// it into 16-bit SSI frames at the current brightness. Then probe a dark
+// row left out of the scan plan, so that it is in the next frame's plan if
+// it has lit up.
+//
+//*****************************************************************************
+static void
+TaskRow(void)
+{
+  uint32_t probeRow;
+
+  if (!keyPressed)
+  {
+    //
+    // If keypad press expired output 0s to Grayscale value and rest the
+    // PWM DAC. TaskAudio runs next and puts back a song that is still
+    // playing or the release of the tone.
+    //
+    ClearOutputHalf(gsPtr, (uint16_t*)&g_pwmDacValues[gsIdx]);
+    pattIdx = 0;
+  }
+  RenderRow(ledRow, gsPtr);
+  TransitionShown(&g_sTransition, ledRow, gsPtr);
+  ScanRow(&g_sScan, ledRow, gsPtr);
+  PowerRow(&g_sPower, ScanSlot(&g_sScan), gsPtr);
+#ifdef GS_PACKED
+  GsPack(gsPtr, 32, g_sPower.ui32Scale, (uint16_t*)g_gsPacked[gsIdx >> 5]);
+#endif
+
+  probeRow = ScanNextProbe(&g_sScan);
+  if (probeRow != SCAN_NO_ROW)
+  {
+    RenderRow(probeRow, g_gsProbe);
+    ScanProbe(&g_sScan, probeRow, g_gsProbe);
+  }
+}
+
+//*****************************************************************************
+//
+// TaskAudio
+// Inputs: None
+// Outputs: None
+// Description:
+// Fill the next half of the PWM DAC buffer with the song or sine wave and
+// analyse it, or the ADC half, for the spectrum display.
+//
+//*****************************************************************************
+static void
+TaskAudio(void)
+{
+  //
+  // A song plays on to its end after the key is released. The tone sounds
+  // while a key is held and no song plays, and a song waits for the tone's
+  // release to finish, so neither cuts the other off.
+  //
+  if (MelodyPlaying() && !EnvelopeActive(&g_sToneEnvelope))
+  {
+    MelodyFill((uint16_t*)&g_pwmDacValues[gsIdx], 32,
+               0.5*PWMDAC_PERIOD, 0.45*PWMDAC_PERIOD);
+  }
+  else
+  {
+    EnvelopeGate(&g_sToneEnvelope, keyPressed && !MelodyPlaying());
+    FillSineHalf((uint16_t*)&g_pwmDacValues[gsIdx], &sinePhase, sineFreq,
+                 &g_sToneEnvelope);
+  }
+
+  if (keyPressed)
+  {
+    //
+    // Analyse one row's slice of audio for the spectrum display
+    //
+    if (function == FUNCTION_SPECTRUM)
+    {
+#ifdef SPECTRUM_ADC
+      SpectrumFeed(&g_sSpectrum, (uint16_t*)&g_adcValues[gsIdx], 32, 2048);
+#else
+      SpectrumFeed(&g_sSpectrum, (uint16_t*)&g_pwmDacValues[gsIdx], 32,
+                   0.5*PWMDAC_PERIOD);
+#endif
+    }
+    LATENCY_RENDER(gsIdx, gsPtr);
+  }
+}
+
+//*****************************************************************************
+//
+// TaskStream
+// Inputs: None
+// Outputs: None
+// Description:
+// Decode the frames streamed in over the UART since the last row.
+//
+//*****************************************************************************
+static void
+TaskStream(void)
+{
+  StreamReceive();
+}
+
+//*****************************************************************************
+//
+// TaskPark
+// Inputs: None
+// Outputs: None
+// Description:
+// Park the display and PWM DAC once nothing has been lit or playing for a
+// few rows, and resume them as soon as a key, stream, sound or transition
+// needs them again.
+//
+//*****************************************************************************
+static void
+TaskPark(void)
+{
+  bool dark;
+
+  dark = !keyPressed && !StreamActive() && !MelodyPlaying() &&
+         !EnvelopeActive(&g_sToneEnvelope) &&
+         !TransitionActive(&g_sTransition);
+#ifdef MODEL1
+  //
+  // The keypad is scanned through the LED row driver
+  //
+  dark = false;
+#endif
+  if (ParkRow(&g_sPark, dark))
+  {
+    if (g_sPark.bParked)
+    {
+      ParkOutputs();
+    }
+    else
+    {
+      ResumeOutputs();
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// TaskPattern
+// Inputs: None
+// Outputs: None
+// Description:
+// Step the pattern of the display function while a key is pressed, and set
+// the period of the next step from the key.
+//
+//*****************************************************************************
+static void
+TaskPattern(void)
+{
+  uint32_t period;
+  tBitboard next;
+
+  if (!keyPressed)
+  {
+    return;
+  }
+
+  period = traceFreqMap[freqIdx];
+  if (function == FUNCTION_LETTERS)
+  {
+    //
+    // Each letter comes in by the next transition type, taking half the
+    // time it shows for, up to TRANSITION_FRAMES
+    //
+    pattIdx = (pattIdx + 1 >= ABC_PATT_LEN) ? 0 : pattIdx + 1;
+    period = 8*traceFreqMap[freqIdx];
+    TransitionStart(&g_sTransition, pattIdx % TRANSITION_NUM_TYPES,
+                    (period / 16 < TRANSITION_FRAMES) ? period / 16 :
+                                                        TRANSITION_FRAMES);
+  }
+  else if (function == FUNCTION_DOMINO)
+  {
+    pattIdx = (pattIdx + 1 >= DOMINO_PATT_LEN) ? 0 : pattIdx + 1;
+  }
+  else if (function == FUNCTION_SCROLL)
+  {
+    FontScrollStep(&g_sScroll);
+  }
+  else if (function == FUNCTION_LAYERS)
+  {
+    pattIdx = (pattIdx + 1 >= CIRCLE_PATT_LEN) ? 0 : pattIdx + 1;
+    period = 8*traceFreqMap[freqIdx];
+  }
+  else if (function == FUNCTION_LIFE)
+  {
+    //
+    // Next generation. Once the cells die out or settle, or after
+    // LIFE_GENERATIONS, the frame task seeds them again.
+    //
+    next = BitboardLifeStep(g_lifeBoard);
+    pattIdx = ((next == g_lifeBoard) || (next == BB_EMPTY) ||
+               (pattIdx + 1 >= LIFE_GENERATIONS)) ? 0 : pattIdx + 1;
+    g_lifeBoard = next;
+  }
+  else if (function == FUNCTION_PIXEL)
+  {
+    pattIdx = (pattIdx + 1 >= CIRCLE_PATT_LEN) ? 0 : pattIdx + 1;
+    pixelIdx = circlePatt[pattIdx];
+  }
+  else if (function == FUNCTION_PALETTE)
+  {
+    //
+    // Only the palette changes: the rings move inwards by one entry
+    //
+    PaletteRotate(&g_sPaletteWheel, 1, PALETTE_ENTRIES - 1);
+    pattIdx = (pattIdx < PALETTE_FADE_STEPS) ? pattIdx + 1 : pattIdx;
+    PaletteFade(&g_sPalette, &g_sPaletteWheel,
+                pattIdx * PALETTE_LEVEL_FULL / PALETTE_FADE_STEPS);
+  }
+  else if (function == FUNCTION_EFFECT)
+  {
+    EffectStep(&g_sEffect);
+  }
+  SchedSetPeriod(&g_psTasks[TASK_PATTERN], period);
+}
+
+//*****************************************************************************
+//
+// TaskTelemetry
+// Inputs: None
+// Outputs: None
+// Description:
+// Queue a telemetry record with the current display function and state
+// when one is due.
+//
+//*****************************************************************************
+static void
+TaskTelemetry(void)
+{
+  uint32_t flags;
+
+  flags = (keyPressed ? TELEMETRY_FLAG_KEY : 0) |
+          (StreamActive() ? TELEMETRY_FLAG_STREAM : 0) |
+          (g_sPark.bParked ? TELEMETRY_FLAG_PARKED : 0) |
+          (MelodyPlaying() ? TELEMETRY_FLAG_SONG : 0);
+  TelemetryFrame(function, freqIdx, pattIdx, flags);
+}
+
+//*****************************************************************************
+//
+// TaskConsole
+// Inputs: None
+// Outputs: None
+// Description:
+// Background console output: the latency, power, stream and park reports,
+// and the task report each time a task overruns its budget or misses its
+// deadline. Then send what the console buffer holds, as far as the UART
+// FIFO has room.
+//
+//*****************************************************************************
+static void
+TaskConsole(void)
+{
+  static uint32_t reportedFaults;
+  uint32_t faults;
+
+  LATENCY_POLL();
+  PowerPoll(&g_sPower);
+  StreamPoll();
+  ParkPoll(&g_sPark);
+
+  faults = SchedFaults();
+  if (faults != reportedFaults)
+  {
+    reportedFaults = faults;
+    SchedReport();
+  }
+  ConsoleFlush();
+}
+
+//*****************************************************************************
+//
+// Task table. Every row the row and PWM DAC half due at the next row
+// boundary are filled first, being the only work with a hard deadline: a
+// late row shows the last one again and a late half repeats old audio. Only
+// an idle task already running when the boundary passes can hold them up,
+// never the frame task, however long it runs. The keypad is read next, so
+// a press shows from the following row, 2ms later. In the last row of a
+// frame the next frame is prepared, after that row is filled and before
+// the first row of the next. The bytes streamed in over the last row are
+// decoded, then the outputs are parked or resumed for what was decided,
+// before pattern steps, telemetry and the console, which come last.
+// Budgets are in 40MHz CPU cycles; a row is 80000.
+//
+//*****************************************************************************
+static tSchedTask g_psTasks[NUM_TASKS] =
+{
+  { "row",       TaskRow,       SCHED_ROW,    0, 0,   8000 },
+  { "audio",     TaskAudio,     SCHED_ROW,    1, 0,  12000 },
+  { "keypad",    TaskKeypad,    SCHED_ROW,    2, 0,   2000 },
+  { "frame",     TaskFrame,     SCHED_FRAME,  3, 0,   8000 },
+  { "stream",    TaskStream,    SCHED_ROW,    4, 0,  10000 },
+  { "park",      TaskPark,      SCHED_ROW,    5, 0,   1000 },
+  { "pattern",   TaskPattern,   SCHED_PERIOD, 6, 80,  2000 },
+  { "telemetry", TaskTelemetry, SCHED_FRAME,  7, 0,   3000 },
+  { "console",   TaskConsole,   SCHED_IDLE,   8, 0,      0 },
+};
+
+//*****************************************************************************
+//
+// ConfigureBoard
+// Inputs: None
+// Outputs: None
+// Description:
+// Set up the clock, all peripherals, the TLC5941 chips and the output
+// buffers. Processor interrupts are left disabled.
+//
+//*****************************************************************************
+void
+ConfigureBoard(void)
+{
+  uint32_t idx;
+
+    //
+    // Enable lazy stacking for interrupt handlers.  This allows floating-point
+    // instructions to be used within interrupt handlers, but at the expense of
+    // extra stack usage.
+    //
+    ROM_FPULazyStackingEnable();
+
+    //
+    // Set the system clock to run at 40Mhz off PLL with external crystal as
+    // reference.
+    //
+    ROM_SysCtlClockSet(SYSCTL_SYSDIV_5 | SYSCTL_USE_PLL | SYSCTL_XTAL_16MHZ |
+                       SYSCTL_OSC_MAIN);
+    BootTimeStart();
+
+    ROM_IntMasterDisable();
+
+    /*********************
+     * ENABLE GPIO PORTS *
+     *********************/
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOA);
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOB);
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOC);
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOD);
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOE);
+    ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_GPIOF);
+
+    //
+    // Set up the serial console to use for displaying messages, and start
+    // receiving streamed frames on it.
+    //
+    ConfigureUART();
+    StreamInit();
+
+    //
+    // Enable the GPIO pins for TLC5941 control (PA5 - PA7).
+    //
+    ROM_GPIOPinTypeGPIOOutput(GPIO_PORTA_BASE, GPIO_PIN_MODE | GPIO_PIN_XLAT | GPIO_PIN_BLANK);
+
+    //
+    // Set MODE high, set XLAT low and set BLANK high).
+    //
+    ROM_GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_MODE, GPIO_PIN_MODE);
+    TRACE_PIN_WRITE(GPIO_PORTA_BASE, GPIO_PIN_MODE, GPIO_PIN_MODE);
     ROM_GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_XLAT, 0);
     ROM_GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_BLANK, GPIO_PIN_BLANK);
 
-    UARTprintf("TLC5941 controls configured\n");
+    BootTimeMark("TLC5941 controls configured");
 
     /************************
      * SETUP LED ROW DRIVER *
      ************************/
 
     ConfigureRowDriver();
-    UARTprintf("Row driver configured\n");
+    BootTimeMark("Row driver configured");
 
     /*******************************************
      * SETUP SPI PORT TO WRITE DATA TO TLC5941 *
      *******************************************/
 
     ConfigureSSI();
-    UARTprintf("SSI configured\n");
+    BootTimeMark("SSI configured");
 
     /*******************************************
      * SETUP Keyboard row pins and outputs and *
@@ -944,14 +2163,14 @@ main(void)
      *******************************************/
 
     ConfigureKeybdScan();
-    UARTprintf("Keyboard scan configured\n");
+    BootTimeMark("Keyboard scan configured");
 
     /****************************************
      * WRITE DOT CORRECTION DATA TO TLC5941 *
      ****************************************/
 
     WriteDotCorrection();
-    UARTprintf("Dot correction data written\n");
+    BootTimeMark("Dot correction data written");
 
     /*****************************
      * WRITE PWM DATA TO TLC5941 *
@@ -967,12 +2186,24 @@ main(void)
     // Set mode low for PWM write
     //
     ROM_GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_MODE, 0);
+    TRACE_PIN_WRITE(GPIO_PORTA_BASE, GPIO_PIN_MODE, 0);
 
     // Enable LED row driver (only for model 1)
     ROM_GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_4, GPIO_PIN_4);
     ledRow = 0;
     g_ledRow[0] = 0;
     g_ledRow[1] = 0;
+    g_ledSlot[0] = 0;
+    g_ledSlot[1] = 0;
+#ifdef MODEL1
+    //
+    // The keypad rows are scanned with the LED rows, so every row must
+    // have its slot
+    //
+    ScanInit(&g_sScan, false);
+#else
+    ScanInit(&g_sScan, true);
+#endif
     g_count16kHz = 0;
 
     // Clear keyboard row selector
@@ -984,26 +2215,113 @@ main(void)
      *************************/
 
     ConfigureGSCLK();
-    UARTprintf("Grayscale clock configured\n");
+    BootTimeMark("Grayscale clock configured");
 
     /*****************************
      * SETUP PWM DAC for speaker *
      *****************************/
 
     ConfigurePWMDAC();
-    UARTprintf("PWM DAC configured\n");
+    BootTimeMark("PWM DAC configured");
+    ConfigureParkTick();
+    ParkInit(&g_sPark);
+
+#ifdef SPECTRUM_ADC
+    ConfigureADC();
+    BootTimeMark("ADC configured");
+#endif
 
     //
-    // Load 1 kHz sine wave into PWM DAC buffer
+    // Rest the PWM DAC at its midpoint until a tone starts
     //
+    for (idx = 0; idx < 64; idx++)
+    {
+      g_pwmDacValues[idx] = PWMDAC_PERIOD/2;
+    }
     sinePhase = 0;
     sineFreq = toneFreqMap[0];
+    EnvelopeInit(&g_sToneEnvelope, &g_sToneShape);
+
+    //displayChar = 32;
+
+    freqIdx = 0;
+    pattIdx = 0;
+    pixelIdx = circlePatt[pattIdx];
+    function = FUNCTION_LETTERS;
+    FontScrollInit(&g_sScroll, &g_sFontIdiotBox, scrollText, 8);
+    SpectrumInit(&g_sSpectrum);
+
+    //
+    // Rings for the palette display: entry 1 at the center, 15 in the
+    // corners, by squared distance from the center
+    //
     for (idx = 0; idx < 64; idx++)
     {
-      g_pwmDacValues[idx] = 0.5*PWMDAC_PERIOD + SineApprox(sinePhase, 0.45*PWMDAC_PERIOD);
-      sinePhase += sineFreq;
+      PaletteFrameSet(&g_sPaletteFrame, idx >> 3, idx & 7, 1 +
+                      ((2 * (idx & 7) - 7) * (2 * (idx & 7) - 7) +
+                       (2 * (idx >> 3) - 7) * (2 * (idx >> 3) - 7)) *
+                      (PALETTE_ENTRIES - 1) / 99);
+    }
+    PowerInit(&g_sPower, DOT_CORRECTION, POWER_PEAK_BUDGET_MA,
+              POWER_AVERAGE_BUDGET_MA);
+    TransitionInit(&g_sTransition);
+    for (idx = 0; idx < 8; idx++)
+    {
+      g_sTransition.pui8ChannelColumn[REDIDX(idx)] = idx;
+      g_sTransition.pui8ChannelColumn[GREENIDX(idx)] = idx;
+      g_sTransition.pui8ChannelColumn[BLUEIDX(idx)] = idx;
     }
-    UARTprintf("PWM DAC configured\n");
+    SchedInit(g_psTasks, NUM_TASKS);
+    TelemetryInit(&g_psTasks[TASK_ROW], &g_psTasks[TASK_AUDIO]);
+    BootTimeMark("Tasks initialized");
+}
+
+//*****************************************************************************
+//
+// RunTasks
+// Inputs: None
+// Outputs: True if a released task ran, false if only idle work was left
+// Description:
+// One pass of the main loop. When PWMIntHandler has latched a row, advance
+// the LED row and buffer half and release the tasks due at this row
+// boundary. Then run the most urgent task, or an idle task.
+//
+//*****************************************************************************
+bool
+RunTasks(void)
+{
+  if (g_NewGSCycle != 0)
+  {
+    g_NewGSCycle = 0;
+
+    //
+    // Set next LED row from the scan plan
+    //
+    //ledRow = 0x7 & (ledRow + 1);
+    ledRow = ScanNext(&g_sScan);
+    g_ledRow[(g_count16kHz >> 5) ^ 1] = ledRow;
+    g_ledSlot[(g_count16kHz >> 5) ^ 1] = ScanSlot(&g_sScan);
+    //
+    // Set next Grayscale and PWM DAC buffer half
+    //
+    gsIdx = (g_count16kHz & 0x20) ^ 0x20;
+    gsPtr = (uint16_t*)&g_gsValues[gsIdx];
+
+    BootTimeRow();
+    SchedRelease(ScanSlot(&g_sScan) == SCAN_SLOTS - 1);
+  }
+  return SchedRunNext();
+}
+
+//*****************************************************************************
+//
+// main
+//
+//*****************************************************************************
+int
+main(void)
+{
+    ConfigureBoard();
 
     //
     // Enable processor interrupts.
@@ -1011,136 +2329,13 @@ main(void)
     ROM_IntMasterEnable();
 
     //
-    // Loop while the grayscale cycle interrupt toggles blank to start
-    // a new grayscale cycle.
+    // Run the tasks released each time the grayscale cycle interrupt
+    // toggles blank to start a new grayscale cycle, and the idle tasks in
+    // between.
     //
-    idleCount = 0;
-    //displayChar = 32;
-
-    freqIdx = 0;
-    gsCycleCount = traceFreqMap[freqIdx];
-    pattIdx = 0;
-    pixelIdx = circlePatt[pattIdx];
-    function = 0;
     while(1)
     {
-      if (g_NewGSCycle != 0)
-      {
-        //
-        // Set next LED row
-        //
-        //ledRow = 0x7 & (ledRow + 1);
-        ledRow = 0x7 & (g_ledRow[g_count16kHz >> 5] + 1);
-        g_ledRow[(g_count16kHz >> 5) ^ 1] = ledRow;
-        //
-        // Set next Grayscale and PWM DAC buffer half
-        //
-        gsIdx = (g_count16kHz & 0x20) ^ 0x20;
-        gsPtr = (uint32_t*)&g_gsValues[gsIdx];
-
-        //
-        // Read the keypad and debounce
-        //
-        keyCode = KeybdRead();
-        if (keyCode & 0x10)
-        {
-          debounceCount = 50;
-          keyPressed = 1;
-          keyValue = keyCode & 0xF;
-        }
-        if (debounceCount)
-        {
-          debounceCount--;
-          if (debounceCount == 0)
-          {
-            keyPressed = 0;
-            function = 1 ^ function;
-          }
-        }
-
-        if (keyPressed)
-        {
-          //
-          // If Keypad pressed perform display and sound function
-          //
-
-          // Select new display character
-          //displayChar = keyCodeMap[keyCode & 0xF];
-
-          // Select new pattern-trace frequency.
-          freqIdx = keyValue;
-
-          // Select new tone frequency
-          sineFreq = toneFreqMap[freqIdx];
-
-          //RenderPixel(pixelIdx, ledRow, colors[0], gsPtr);
-          //RenderCharacter( 0, circle, g_ledRow[ledRow], colors[0], &g_gsValues[g_gsIdx]);
-          //RenderCharacter((gsCycleCount&0x100) >> 8, HeartMap, g_ledRow[ledRow], colors[1], &g_gsValues[g_gsIdx]);
-          if (function == 0)
-          {
-            displayChar = pattIdx + 'A';
-            RenderCharacter(displayChar - ' ', font8x8_basic, ledRow, colors[0], gsPtr);
-          }
-          else
-          {
-            RenderDomino(pattIdx, gsPtr);
-          }
-
-          //
-          // Fill half of PWM DAC buffer with sine wave values.
-          //
-          for (idx = 0; idx < 32; idx++)
-          {
-            g_pwmDacValues[gsIdx + idx] = 0.5*PWMDAC_PERIOD + SineApprox(sinePhase, 0.45*PWMDAC_PERIOD);
-            sinePhase += sineFreq;
-          }
-
-          //
-          // Update the grayscale cycle count
-          //
-          if (gsCycleCount)
-          {
-            gsCycleCount--;
-          }
-
-          if (gsCycleCount == 0)
-          {
-            //pattIdx = (pattIdx + 1 >= CIRCLE_PATT_LEN) ? 0 : pattIdx + 1;
-            //pixelIdx = circlePatt[pattIdx];
-            if (function == 0)
-            {
-              pattIdx = (pattIdx + 1 >= ABC_PATT_LEN) ? 0 : pattIdx + 1;
-              gsCycleCount = 8*traceFreqMap[freqIdx];
-            }
-            else
-            {
-              pattIdx = (pattIdx + 1 >= DOMINO_PATT_LEN) ? 0 : pattIdx + 1;
-              gsCycleCount = traceFreqMap[freqIdx];
-            }
-          }
-
-        }
-
-        else
-        {
-          //
-          // If keypad press expired output 0s to Grayscale value and PWM DAC
-          //
-          for (idx = 0; idx < 32; idx++)
-          {
-            gsPtr[idx] = 0;
-            g_pwmDacValues[gsIdx + idx] = 0;
-          }
-          pattIdx = 0;
-        }
-
-        g_NewGSCycle = 0;
-        idleCount = 0;
-      }
-      else
-      {
-        idleCount++;
-      }
+      RunTasks();
     }
 
 }
@@ -0,0 +1,121 @@
+//*****************************************************************************
+//
+// trace.c - Binary event trace of display and audio output.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+//*****************************************************************************
+//
+// Records SSI words, TLC5941 control and row GPIO writes, PWM DAC timer match
+// values and keypad reads into a RAM ring. When the ring is full the oldest
+// records are overwritten, so a debugger halt always finds the most recent
+// TRACE_RING_SIZE events. TraceRead drains the ring for the host build.
+// The record layout is described in trace.h.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "driverlib/interrupt.h"
+#include "trace.h"
+
+#ifdef TRACE_ENABLE
+
+//*****************************************************************************
+//
+// Globals
+//
+//*****************************************************************************
+
+// Sample counter used as the timestamp, advanced by PWMIntHandler, or by
+// SysTickIntHandler a row at a time while the display is parked
+volatile uint32_t g_ui32TraceTick;
+
+// Header and ring, laid out as a trace file
+struct
+{
+    tTraceHeader sHeader;
+    tTraceRecord psRing[TRACE_RING_SIZE];
+}
+g_sTrace = {
+    { TRACE_MAGIC, TRACE_VERSION, sizeof(tTraceRecord), TRACE_TICK_HZ,
+      TRACE_RING_SIZE, 0, 0 }
+};
+
+//*****************************************************************************
+//
+// TraceLog
+// Inputs:
+//   1. Record type, TRACE_SSI etc.
+//   2. Type specific argument
+//   3. Type specific value
+// Outputs: None
+// Description:
+// Append one record to the ring, overwriting the oldest when full. Called from
+// both PWMIntHandler and the main loop, so the ring update is done with
+// interrupts masked on the target.
+//
+//*****************************************************************************
+void
+TraceLog(uint8_t ui8Type, uint8_t ui8Arg, uint16_t ui16Value)
+{
+  tTraceRecord *psRecord;
+  uint32_t head;
+  bool wasDisabled;
+
+  wasDisabled = IntMasterDisable();
+
+  head = g_sTrace.sHeader.ui32Head;
+  psRecord = &g_sTrace.psRing[head];
+  psRecord->ui32Tick = g_ui32TraceTick;
+  psRecord->ui8Type = ui8Type;
+  psRecord->ui8Arg = ui8Arg;
+  psRecord->ui16Value = ui16Value;
+  g_sTrace.sHeader.ui32Head = (head + 1 >= TRACE_RING_SIZE) ? 0 : head + 1;
+  if (g_sTrace.sHeader.ui32Count < TRACE_RING_SIZE)
+  {
+    g_sTrace.sHeader.ui32Count++;
+  }
+
+  if (!wasDisabled)
+  {
+    IntMasterEnable();
+  }
+}
+
+//*****************************************************************************
+//
+// TraceRead
+// Inputs:
+//   1. Buffer for records
+//   2. Size of the buffer in records
+// Outputs: Number of records copied
+// Description:
+// Remove up to ui32Max of the oldest records from the ring.
+//
+//*****************************************************************************
+uint32_t
+TraceRead(tTraceRecord *psRecords, uint32_t ui32Max)
+{
+  uint32_t count, tail;
+
+  count = 0;
+  while ((count < ui32Max) && g_sTrace.sHeader.ui32Count)
+  {
+    tail = g_sTrace.sHeader.ui32Head + TRACE_RING_SIZE -
+           g_sTrace.sHeader.ui32Count;
+    if (tail >= TRACE_RING_SIZE)
+    {
+      tail -= TRACE_RING_SIZE;
+    }
+    psRecords[count++] = g_sTrace.psRing[tail];
+    g_sTrace.sHeader.ui32Count--;
+  }
+  return(count);
+}
+
+#endif // TRACE_ENABLE
@@ -0,0 +1,99 @@
+//*****************************************************************************
+//
+// trace.h - Binary event trace of display and audio output.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// A trace is a tTraceHeader followed by ui32Capacity 8-byte records used as
+// a ring. The oldest record is at (ui32Head - ui32Count) mod ui32Capacity.
+// g_sTrace has this layout in RAM, so saving g_sTrace from the debugger gives
+// a valid trace file. The host build writes the same layout with
+// ui32Capacity == ui32Count and ui32Head == 0.
+//
+// Timestamps count PWMIntHandler interrupts (16kHz samples), and while the
+// display is parked SysTick advances them a row of 32 at a time. Records
+// within a sample are in program order.
+//
+//*****************************************************************************
+#define TRACE_MAGIC             0x52544249  // "IBTR"
+#define TRACE_VERSION           2
+#define TRACE_TICK_HZ           16000
+
+//
+// Record types and the meaning of ui8Arg and ui16Value
+//
+#define TRACE_SSI               1   // arg: g_gsValues index, value: SSI word
+#define TRACE_GPIO              2   // arg: pins, value: port << 8 | pin levels
+#define TRACE_MATCH             3   // arg: 0, value: PWM DAC timer match
+#define TRACE_ROW               4   // arg: LED row enabled | slot << 3,
+                                    // value: row pins
+#define TRACE_KEY               5   // arg: 0, value: KeybdRead key code
+#define TRACE_SSI16             6   // arg: g_gsValues index, value: 16-bit
+                                    // SSI frame, built with GS_PACKED
+
+//
+// Port number stored in TRACE_GPIO records, from the GPIO base address
+//
+#define TRACE_PORT(base)        (((base) >> 12) & 0xFF)
+
+typedef struct
+{
+    uint32_t ui32Magic;
+    uint16_t ui16Version;
+    uint16_t ui16RecordSize;
+    uint32_t ui32TickHz;
+    uint32_t ui32Capacity;
+    uint32_t ui32Head;
+    uint32_t ui32Count;
+}
+tTraceHeader;
+
+typedef struct
+{
+    uint32_t ui32Tick;
+    uint8_t ui8Type;
+    uint8_t ui8Arg;
+    uint16_t ui16Value;
+}
+tTraceRecord;
+
+//*****************************************************************************
+//
+// Recording is compiled in only when TRACE_ENABLE is defined. The ring holds
+// TRACE_RING_SIZE records; one row period produces about 70.
+//
+//*****************************************************************************
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE         1024
+#endif
+
+#ifdef TRACE_ENABLE
+#define TRACE(type, arg, value) TraceLog((type), (arg), (value))
+#define TRACE_PIN_WRITE(base, pins, val)                                      \
+        TraceLog(TRACE_GPIO, (pins), (TRACE_PORT(base) << 8) | ((val) & (pins)))
+#define TRACE_TICK()            (g_ui32TraceTick++)
+#define TRACE_ADVANCE(ticks)    (g_ui32TraceTick += (ticks))
+#else
+#define TRACE(type, arg, value)
+#define TRACE_PIN_WRITE(base, pins, val)
+#define TRACE_TICK()
+#define TRACE_ADVANCE(ticks)
+#endif
+
+extern volatile uint32_t g_ui32TraceTick;
+
+extern void TraceLog(uint8_t ui8Type, uint8_t ui8Arg, uint16_t ui16Value);
+extern uint32_t TraceRead(tTraceRecord *psRecords, uint32_t ui32Max);
+
+#endif // __TRACE_H__
@@ -0,0 +1,266 @@
+//*****************************************************************************
+//
+// transition.c - Crossfade, wipe and dissolve between displayed frames.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "transition.h"
+
+//*****************************************************************************
+//
+// Ordering tables: the rank of each pixel, row by row, and the shift that
+// sets how much of the transition each pixel's own fade takes. The last
+// rank plus 256 >> shift is 256, so every pixel is done by the end.
+//
+// The wipe sweeps across the columns with a soft edge a quarter of the
+// transition wide. The dissolve ranks the pixels by the 8x8 ordered dither
+// matrix scaled to 0 to 240, so each pixel fades in a sixteenth of the
+// transition in an even scatter.
+//
+//*****************************************************************************
+static const uint8_t transitionRank[TRANSITION_NUM_TYPES][64] = {
+  {
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,
+  },
+  {
+      0,  27,  54,  82, 109, 137, 164, 192,
+      0,  27,  54,  82, 109, 137, 164, 192,
+      0,  27,  54,  82, 109, 137, 164, 192,
+      0,  27,  54,  82, 109, 137, 164, 192,
+      0,  27,  54,  82, 109, 137, 164, 192,
+      0,  27,  54,  82, 109, 137, 164, 192,
+      0,  27,  54,  82, 109, 137, 164, 192,
+      0,  27,  54,  82, 109, 137, 164, 192,
+  },
+  {
+      0, 121,  30, 152,   7, 129,  38, 160,
+    182,  60, 213,  91, 190,  68, 220,  99,
+     45, 167,  15, 137,  53, 175,  22, 144,
+    228, 106, 198,  76, 236, 114, 205,  83,
+     11, 133,  41, 163,   3, 125,  34, 156,
+    194,  72, 224, 102, 186,  64, 217,  95,
+     57, 179,  26, 148,  49, 171,  19, 140,
+    240, 118, 209,  87, 232, 110, 201,  80,
+  },
+};
+static const uint8_t transitionShift[TRANSITION_NUM_TYPES] = { 0, 2, 4 };
+
+//*****************************************************************************
+//
+// TransitionInit
+// Inputs:
+//   1. Transition state
+// Outputs: None
+// Description:
+// Clear the state, with every output driving no LED. The caller then sets
+// the column of each output that does in pui8ChannelColumn.
+//
+//*****************************************************************************
+void
+TransitionInit(tTransition *psTransition)
+{
+  uint32_t row, idx;
+
+  for (idx = 0; idx < 32; idx++)
+  {
+    psTransition->pui8ChannelColumn[idx] = TRANSITION_NO_PIXEL;
+  }
+  for (row = 0; row < 8; row++)
+  {
+    for (idx = 0; idx < 32; idx++)
+    {
+      psTransition->ppui16Shown[row][idx] = 0;
+      psTransition->ppui16From[row][idx] = 0;
+    }
+  }
+  psTransition->ui8Type = TRANSITION_CROSSFADE;
+  psTransition->ui8Active = 0;
+  psTransition->ui16Frames = TRANSITION_FRAMES;
+  psTransition->ui16Frame = 0;
+  psTransition->ui16Progress = 0;
+  psTransition->ui32Started = 0;
+}
+
+//*****************************************************************************
+//
+// TransitionStart
+// Inputs:
+//   1. Transition state
+//   2. TRANSITION_CROSSFADE, TRANSITION_WIPE or TRANSITION_DISSOLVE
+//   3. Length in frames, at least 1
+// Outputs: None
+// Description:
+// Freeze the frame as shown as the outgoing frame. Rows rendered from now
+// on blend from it, showing it unchanged until the next frame starts.
+//
+//*****************************************************************************
+void
+TransitionStart(tTransition *psTransition, uint32_t type, uint32_t frames)
+{
+  uint32_t row, idx;
+
+  for (row = 0; row < 8; row++)
+  {
+    for (idx = 0; idx < 32; idx++)
+    {
+      psTransition->ppui16From[row][idx] = psTransition->ppui16Shown[row][idx];
+    }
+  }
+  psTransition->ui8Type = (type < TRANSITION_NUM_TYPES) ? type :
+                                                          TRANSITION_CROSSFADE;
+  psTransition->ui16Frames = frames ? frames : 1;
+  psTransition->ui16Frame = 0;
+  psTransition->ui16Progress = 0;
+  psTransition->ui8Active = 1;
+  psTransition->ui32Started++;
+}
+
+//*****************************************************************************
+//
+// TransitionCancel
+// Inputs:
+//   1. Transition state
+// Outputs: None
+// Description:
+// End a transition at once; rows show as rendered from now on.
+//
+//*****************************************************************************
+void
+TransitionCancel(tTransition *psTransition)
+{
+  psTransition->ui8Active = 0;
+}
+
+//*****************************************************************************
+//
+// TransitionFrame
+// Inputs:
+//   1. Transition state
+// Outputs: None
+// Description:
+// Called as each frame starts. Advance the progress of a transition, and
+// end it once the incoming frame is shown in full.
+//
+//*****************************************************************************
+void
+TransitionFrame(tTransition *psTransition)
+{
+  if (!psTransition->ui8Active)
+  {
+    return;
+  }
+  psTransition->ui16Frame++;
+  if (psTransition->ui16Frame >= psTransition->ui16Frames)
+  {
+    psTransition->ui8Active = 0;
+    return;
+  }
+  psTransition->ui16Progress = (psTransition->ui16Frame << 8) /
+                               psTransition->ui16Frames;
+}
+
+//*****************************************************************************
+//
+// TransitionRow
+// Inputs:
+//   1. Transition state
+//   2. LED row just rendered
+//   3. Pointer to the 32 grayscale values of the row
+// Outputs: None
+// Description:
+// Blend a newly rendered row with the outgoing frame while a transition
+// runs. The alphas of the row's 8 pixels come first, with a ninth of 256
+// for outputs that drive no LED, then each output that differs from the
+// outgoing frame is blended.
+//
+//*****************************************************************************
+void
+TransitionRow(tTransition *psTransition, uint32_t row, uint16_t *gsValues)
+{
+  const uint8_t *rank;
+  const uint16_t *from;
+  uint32_t alpha[9], col, idx, shift;
+  int32_t step, to;
+
+  if (!psTransition->ui8Active)
+  {
+    return;
+  }
+
+  rank = &transitionRank[psTransition->ui8Type][row * 8];
+  shift = transitionShift[psTransition->ui8Type];
+  for (col = 0; col < 8; col++)
+  {
+    step = (int32_t)psTransition->ui16Progress - rank[col];
+    step = (step > 0) ? (step << shift) : 0;
+    alpha[col] = (step < 256) ? step : 256;
+  }
+  alpha[TRANSITION_NO_PIXEL] = 256;
+
+  from = psTransition->ppui16From[row];
+  for (idx = 0; idx < 32; idx++)
+  {
+    to = gsValues[idx];
+    if (to != from[idx])
+    {
+      to = from[idx] + (((to - from[idx]) *
+            (int32_t)alpha[psTransition->pui8ChannelColumn[idx]]) >> 8);
+      gsValues[idx] = to;
+    }
+  }
+}
+
+//*****************************************************************************
+//
+// TransitionShown
+// Inputs:
+//   1. Transition state
+//   2. LED row
+//   3. Pointer to the 32 grayscale values it is shown with
+// Outputs: None
+// Description:
+// Keep a row as shown, blended, for the next transition to start from.
+//
+//*****************************************************************************
+void
+TransitionShown(tTransition *psTransition, uint32_t row,
+                const uint16_t *gsValues)
+{
+  uint16_t *shown;
+  uint32_t idx;
+
+  shown = psTransition->ppui16Shown[row];
+  for (idx = 0; idx < 32; idx++)
+  {
+    shown[idx] = gsValues[idx];
+  }
+}
+
+//*****************************************************************************
+//
+// TransitionActive
+// Inputs:
+//   1. Transition state
+// Outputs: True while a transition runs
+// Description:
+// For callers that hold off changes until a transition is done.
+//
+//*****************************************************************************
+bool
+TransitionActive(const tTransition *psTransition)
+{
+  return psTransition->ui8Active != 0;
+}
@@ -0,0 +1,83 @@
+//*****************************************************************************
+//
+// transition.h - Crossfade, wipe and dissolve between displayed frames.
+//
+// Copyright (c) 2013 Idiotronics Incorporated.  All rights reserved.
+//
+// This is part of revision 1.0 of the Idiotbox Firmware Package.
+//
+//*****************************************************************************
+
+#ifndef __TRANSITION_H__
+#define __TRANSITION_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//*****************************************************************************
+//
+// TransitionShown is given every row as it is sent to the display and
+// keeps a copy of the frame as shown. TransitionStart freezes that copy as
+// the outgoing frame, and for the next frames TransitionRow blends each
+// newly rendered row, the incoming frame, with the outgoing one:
+//
+//   out = from + (((to - from) * alpha) >> 8)
+//
+// alpha, 0 to 256, is worked out for each pixel from the progress of the
+// transition, 0 to 256 over its frames, and the pixel's rank in the
+// transition type's ordering table:
+//
+//   alpha = clamp((progress - rank) << shift, 0, 256)
+//
+// A crossfade ranks every pixel 0 with a shift of 0, so alpha is the
+// progress. A wipe ranks pixels by column and a dissolve by an ordered
+// dither matrix, with a shift that makes each pixel's fade a short part of
+// the whole. Every type costs the same: 8 alphas and a pass over the 32
+// outputs of the row, blending only those that differ.
+//
+// Starting a transition while one runs starts from what is shown, part way
+// through. TransitionRow changes only the row it is given, so a row can be
+// rendered and blended without being shown, as the scan plan's probes are.
+//
+//*****************************************************************************
+#define TRANSITION_CROSSFADE    0
+#define TRANSITION_WIPE         1
+#define TRANSITION_DISSOLVE     2
+#define TRANSITION_NUM_TYPES    3
+
+//
+// Default length, 256ms at 62.5 frames per second
+//
+#define TRANSITION_FRAMES       16
+
+//
+// Column of an output that drives no LED
+//
+#define TRANSITION_NO_PIXEL     8
+
+typedef struct
+{
+    uint8_t pui8ChannelColumn[32];  // column of each output's LED
+    uint16_t ppui16Shown[8][32];    // each row as last shown
+    uint16_t ppui16From[8][32];     // outgoing frame
+    uint8_t ui8Type;
+    uint8_t ui8Active;
+    uint16_t ui16Frames;            // length of the transition
+    uint16_t ui16Frame;             // frames into it
+    uint16_t ui16Progress;          // 0 to 256
+    uint32_t ui32Started;           // transitions since boot
+}
+tTransition;
+
+extern void TransitionInit(tTransition *psTransition);
+extern void TransitionStart(tTransition *psTransition, uint32_t type,
+                            uint32_t frames);
+extern void TransitionCancel(tTransition *psTransition);
+extern void TransitionFrame(tTransition *psTransition);
+extern void TransitionRow(tTransition *psTransition, uint32_t row,
+                          uint16_t *gsValues);
+extern void TransitionShown(tTransition *psTransition, uint32_t row,
+                            const uint16_t *gsValues);
+extern bool TransitionActive(const tTransition *psTransition);
+
+#endif // __TRANSITION_H__